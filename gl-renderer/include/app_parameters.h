@@ -14,17 +14,33 @@ namespace renderer
 struct AppParameters
 {
 	AppParameters():
-		screenWidth(1366), screenHeight(768), isFullScreen(false), useSmoothing(false), enableDebug(false), isEditorMode(false)
+		screenWidth(1366), screenHeight(768), uploadKilobytesPerFrame(8192), pointLightAmount(0), targetFrameTime(0.f), renderScale(1.f), isFullScreen(false), useSmoothing(false),
+		useTemporalUpscaling(false), enableDebug(false), isEditorMode(false), isBenchmarkMode(false), benchmarkFrameAmount(0), benchmarkOutputPath("benchmark.json"),
+		isLightSweep(false)
 	{
 	}
 
 	unsigned int screenWidth;
 	unsigned int screenHeight;
 	std::string scenePath;
+	std::string archivePath; //Empty if assets are read from separate files
+	std::string comparedPostprocessingEffect; //If not empty, fragment and compute shaders of the effect are timed at startup. For measurements
+	unsigned int uploadKilobytesPerFrame; //Limit of streaming transfers to videocard
+	int pointLightAmount; //If not 0, scene point lights are replaced with generated ones. For measurements
+	float targetFrameTime; //Milliseconds. If not 0, scene resolution is scaled to fit GPU frame time into it
+	float renderScale; //Scene resolution relative to window, initial one if target frame time is set
 	bool isFullScreen;
 	bool useSmoothing;
+	bool useTemporalUpscaling; //Jittered frames of reduced resolution are accumulated
 	bool enableDebug;
 	bool isEditorMode;
+
+	//Benchmark mode: hidden window, camera follows the path, frame statistics are written on exit
+	bool isBenchmarkMode;
+	std::string cameraPathPath;
+	int benchmarkFrameAmount;
+	std::string benchmarkOutputPath;
+	bool isLightSweep; //Camera path is run with several amounts of generated point lights, frame times of each run are reported
 };
 
 }
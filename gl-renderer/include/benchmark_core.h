@@ -0,0 +1,70 @@
+/* benchmark_core.h
+ * Core module for offscreen benchmarks: camera follows a path for a fixed amount of frames
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <GLFW/glfw3.h>
+
+#include "app_parameters.h"
+#include "core.h"
+#include "data/camera_path.h"
+#include "graphics_lib/operations/counted_calls.h"
+
+namespace renderer
+{
+
+class BenchmarkCore: public Core
+{
+	static constexpr int LIGHT_SWEEP_STEPS = 4;
+	static constexpr int LIGHT_SWEEP_AMOUNTS[LIGHT_SWEEP_STEPS] = {1, 16, 256, 1024};
+
+public:
+	static constexpr int LIGHT_SWEEP_MAX_AMOUNT = 1024; //Generated before renderer is built, every sweep step takes the first lights
+
+	BenchmarkCore(GLFWwindow *wnd, renderer::graphics_lib::FrameRenderer *frameRend, renderer::visibility::TCameraController &camera, renderer::managers::SceneManager &sceneMgr,
+		renderer::graphics_lib::ShaderManager &shaderMgr, const renderer::data::CameraPath &path, const renderer::AppParameters &parameters);
+	virtual ~BenchmarkCore();
+
+	/*
+	@brief Renders frames along camera path without user inputs, then writes statistics
+	*/
+	virtual void mainLoop();
+
+private:
+	/*
+	@brief Renders frames along camera path. Statistics of the previous run are replaced
+	*/
+	void runCameraPath();
+
+	/*
+	@brief Runs camera path for every light amount of sweep and keeps frame times of each run
+	@return false if renderer can't replace point lights
+	*/
+	bool runLightSweep();
+
+	/*
+	@brief Writes frame time, triangle, draw call and OpenGL call statistics as JSON
+	*/
+	bool writeReport() const;
+
+
+
+	renderer::data::CameraPath cameraPath;
+	const renderer::AppParameters &appParameters;
+
+	std::vector<float> frameTimes; //Milliseconds
+	std::vector<int> triangleCounts;
+	std::vector<int> drawCallCounts; //Scene meshes
+	std::vector<renderer::graphics_lib::operations::CallCounters> callCounters; //All passes
+
+	std::vector<std::pair<int, std::vector<float>>> lightSweepFrameTimes; //Point light amount and frame times of its run
+};
+
+}
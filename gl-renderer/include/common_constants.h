@@ -13,6 +13,14 @@ namespace renderer
 
 constexpr float POINT_LIGHT_POWER = 50.f;
 
+constexpr float PROJECTION_FAR_CLIPPING = 125.f; //Also range of depth in render queue sort keys
+
 const glm::vec3 LIGHT_DIFFUSE_NIGHT_COLOUR = glm::vec3(0.f, 0.f, 0.f);
 
+constexpr const char *POSTPROCESSING_COMPUTE_SUFFIX = ":compute"; //Added to effect in chain to use compute shader, e.g. postprocessing:emboss:compute
+
+//Startup timer group and step, particles are transfered to videocard in several places
+constexpr const char *STARTUP_GROUP_PARTICLES = "Particles";
+constexpr const char *STARTUP_STEP_TRANSFER = "Transfer to videocard";
+
 }
@@ -11,10 +11,13 @@
 
 #include <GLFW/glfw3.h>
 
+#include "data/camera_path.h"
 #include "data/chunk_margins.h"
 #include "data/visibility_flags.h"
+#include "frame_time_history.h"
 #include "graphics_lib/frame_renderer.h"
 #include "graphics_lib/shader_manager.h"
+#include "graphics_lib/upload_service.h"
 #include "managers/scene_manager.h"
 #include "simulation/simulation_model.h"
 #include "visibility/camera_controller.h"
@@ -24,10 +27,14 @@ namespace renderer
 
 class Core
 {
-	static constexpr int PRESSED_KEYS_ARRAY_SIZE = 3;
+	static constexpr int PRESSED_KEYS_ARRAY_SIZE = 7;
 	static constexpr int PRESSED_F5_INDEX = 0;
 	static constexpr int PRESSED_F8_INDEX = 1;
 	static constexpr int PRESSED_F11_INDEX = 2;
+	static constexpr int PRESSED_F6_INDEX = 3;
+	static constexpr int PRESSED_F9_INDEX = 4;
+	static constexpr int PRESSED_F12_INDEX = 5;
+	static constexpr int PRESSED_F7_INDEX = 6;
 
 public:
 	Core(GLFWwindow *wnd, renderer::graphics_lib::FrameRenderer *frameRend, renderer::visibility::TCameraController &camera, renderer::managers::SceneManager &sceneMgr,
@@ -41,6 +48,11 @@ public:
 
 	void onResize(int width, int height);
 
+	/*
+	@brief Sets staging ring which is processed every frame. Can be nullptr
+	*/
+	void setUploadService(renderer::graphics_lib::UploadService *uploader);
+
 protected:
 	/*
 	@brief Obtains info on pressed keys and mouse movements and updates camera
@@ -67,6 +79,36 @@ protected:
 	*/
 	void loadCameraData();
 
+	/*
+	@brief Appends camera pose to recorded path if keyframe interval has passed. Called every frame while recording
+	*/
+	void recordCameraKeyframe();
+
+	/*
+	@brief Finishes recording and saves the path to file
+	*/
+	void stopRecording();
+
+	/*
+	@brief Starts driving camera, visibility, wave animation and simulation by replay clock
+	@param[in] path - camera path to follow
+	@param[in] timeStep - replay clock advance per frame, seconds. Doesn't depend on real frame time, so runs are identical
+	*/
+	void startReplay(const renderer::data::CameraPath &path, float timeStep);
+
+	/*
+	@brief Moves replay clock by one step and applies the state at that time
+	@return false if path is over
+	*/
+	bool advanceReplay();
+
+	void stopReplay();
+
+	/*
+	@brief Advances replay if it is active, stops it at the end of path
+	*/
+	void processReplay();
+
 	/*
 	@brief Initializes the class
 	*/
@@ -83,7 +125,8 @@ protected:
 	float horizontalRotation;
 	float verticalRotation;
 
-	float deltaTime;
+	float deltaTime; //Seconds
+	renderer::FrameTimeHistory frameTimeHistory;
 
 	GLFWwindow *window;
 
@@ -91,7 +134,17 @@ protected:
 
 	renderer::managers::SceneManager &sceneManager;
 	renderer::graphics_lib::ShaderManager &shaderManager;
+	renderer::graphics_lib::UploadService *uploadService; //Non-owning pointer
+
+	renderer::data::CameraPath recordedPath;
+	bool isRecording;
+	float recordingTime; //Seconds
 
+	renderer::data::CameraPath replayedPath;
+	bool isReplaying;
+	int replayFrame;
+	float replayTimeStep; //Seconds
+	bool isSimulationReplayed; //Simulation thread is paused, model is computed from replay clock
 
 	renderer::simulation::SimulationModel simulationModel;
 	std::thread *simulationThread;
@@ -0,0 +1,29 @@
+/* camera_path.h
+ * Camera poses along a path, for replays and benchmarks
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+namespace renderer::data
+{
+
+struct CameraKeyframe
+{
+	float time = 0.f; //Seconds from path start
+	glm::vec3 position = glm::vec3(0.f);
+	float horizontalRotationRadians = 0.f;
+	float verticalRotationRadians = 0.f;
+};
+
+struct CameraPath
+{
+	std::vector<CameraKeyframe> keyframes; //Sorted by time
+};
+
+}
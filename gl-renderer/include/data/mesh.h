@@ -47,6 +47,28 @@ struct Mesh
 		return *this;
 	}
 
+	Mesh(Mesh &&other)
+	{
+		this->vertices = std::move(other.vertices);
+		this->uvs = std::move(other.uvs);
+		this->normals = std::move(other.normals);
+		this->tangent = std::move(other.tangent);
+		this->bitangent = std::move(other.bitangent);
+		this->floatsPerVertex = other.floatsPerVertex;
+	}
+
+	Mesh& operator=(Mesh &&other)
+	{
+		this->vertices = std::move(other.vertices);
+		this->uvs = std::move(other.uvs);
+		this->normals = std::move(other.normals);
+		this->tangent = std::move(other.tangent);
+		this->bitangent = std::move(other.bitangent);
+		this->floatsPerVertex = other.floatsPerVertex;
+
+		return *this;
+	}
+
 	std::vector<float> vertices;
 	std::vector<float> uvs;
 	std::vector<float> normals;
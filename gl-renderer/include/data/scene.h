@@ -40,6 +40,21 @@ struct Light
 	float x, y, z;
 };
 
+struct PointLight
+{
+	PointLight():
+		x(0.f), y(0.f), z(0.f), power(0.f), red(0), green(0), blue(0)
+	{}
+
+	PointLight(float xPos, float yPos, float zPos, float lightPower, int redColour, int greenColour, int blueColour):
+		x(xPos), y(yPos), z(zPos), power(lightPower), red(redColour), green(greenColour), blue(blueColour)
+	{}
+
+	float x, y, z;
+	float power;
+	int red, green, blue;
+};
+
 struct Fog
 {
 	bool enable;
@@ -100,7 +115,10 @@ struct Scene
 {
 	Camera camera;
 	Light light;
+	std::vector<PointLight> pointLights; //Additional lights, e.g. lanterns. Deferred and Forward+ renderers only
 	std::string rendererType;
+	bool depthPrepass = false; //Forward and deferred renderers. Forward+ always has it
+	bool weightedBlendedTransparency = false; //Order-independent transparency instead of sorted alpha blending
 	Fog fog;
 	std::string postprocessingEffect;
 	std::string terrainTexturing;
@@ -27,6 +27,8 @@ struct ShaderFlags
 	static constexpr unsigned long long FEATURE_TEXTURE_BOMBING_AND_TRIPLANAR_MAPPING = 0x800ull;
 	static constexpr unsigned long long FEATURE_SMALL_WAVES = 0x1000ull;
 	static constexpr unsigned long long FEATURE_GLITTER = 0x2000ull;
+	static constexpr unsigned long long FEATURE_CLUSTERED_LIGHTS = 0x4000ull;
+	static constexpr unsigned long long FEATURE_WEIGHTED_BLENDED_OIT = 0x8000ull;
 };
 
 struct PostprocessingFlags
@@ -35,6 +37,11 @@ struct PostprocessingFlags
 	static constexpr unsigned long long POSTPROCESSING_VIGNETTE = 0x2ull;
 	static constexpr unsigned long long POSTPROCESSING_DROPS_ON_LENS = 0x4ull;
 	static constexpr unsigned long long POSTPROCESSING_EMBOSS = 0x8ull;
+
+	static constexpr unsigned long long POSTPROCESSING_COMPUTE = 0x10ull; //Not an effect. Marks compute shader variant of neighbourhood effect
+
+	//Effects reading only their own pixel. Consecutive ones in a chain are fused into a single pass
+	static constexpr unsigned long long PER_PIXEL_EFFECTS = POSTPROCESSING_GRAYSCALE | POSTPROCESSING_VIGNETTE;
 };
 
 struct ShaderProperties
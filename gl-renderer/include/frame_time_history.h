@@ -0,0 +1,70 @@
+/* frame_time_history.h
+ * Frame times of the session with percentiles and hitch counts of recent frames
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace renderer
+{
+
+/*
+Recent frames are kept in a ring for the graph, all frames of the session are kept for export.
+Percentiles are recalculated on demand (once per second), so adding a frame stays cheap.
+Hitch is a frame longer than HITCH_MEDIAN_FACTOR medians, median is taken from the last recalculation.
+*/
+class FrameTimeHistory
+{
+	static constexpr int RECENT_FRAME_AMOUNT = 512;
+	static constexpr float HITCH_MEDIAN_FACTOR = 2.f;
+
+public:
+	FrameTimeHistory();
+
+	/*
+	@param[in] frameTime - milliseconds
+	*/
+	void addFrame(float frameTime);
+
+	/*
+	@brief Recalculates percentiles and hitch count of recent frames
+	*/
+	void updateStatistics();
+
+	/*
+	@brief Writes frame times of the whole session, one frame per line
+	*/
+	bool writeCsv(const std::string &path) const;
+
+	const float* getRecentTimes() const;
+	int getRecentAmount() const;
+	int getRecentOffset() const; //Index of the oldest frame in the ring
+
+	float getPercentile50() const;
+	float getPercentile95() const;
+	float getPercentile99() const;
+	float getMaxTime() const; //Recent frames
+	int getHitchCount() const; //Recent frames
+	int getSessionHitchCount() const;
+
+private:
+	float recentTimes[RECENT_FRAME_AMOUNT]; //Milliseconds
+	int recentAmount;
+	int nextRecent;
+
+	std::vector<float> sessionTimes;
+	std::vector<float> sortedTimes; //Kept between recalculations to avoid allocations
+
+	float percentile50;
+	float percentile95;
+	float percentile99;
+	float maxTime;
+	int hitchCount;
+	int sessionHitchCount;
+};
+
+}
@@ -8,12 +8,17 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <glm/glm.hpp>
 
+#include "data/scene.h"
 #include "data/visibility_flags.h"
 #include "graphics_lib/abstract_renderer.h"
+#include "graphics_lib/gpu_pass_timer.h"
+#include "graphics_lib/render_queue.h"
+#include "graphics_lib/weighted_blended_transparency.h"
 #include "graphics_lib/videocard_data/rendering_scene.h"
 #include "graphics_lib/videocard_data/shader_ids.h"
 
@@ -23,6 +28,7 @@ namespace renderer::graphics_lib
 class Base3DRenderer: public AbstractRenderer
 {
 	static constexpr int RENDER_METHODS = 10;
+	static constexpr int SAMPLE_QUERY_AMOUNT = 2; //Result is read one frame later
 
 public:
 	Base3DRenderer(const std::vector<renderer::graphics_lib::videocard_data::ShaderIds> &shaderIds, const renderer::graphics_lib::videocard_data::ShaderIds &sky,
@@ -30,12 +36,17 @@ public:
 	virtual ~Base3DRenderer();
 
 	/*
-	@brief Draws all opaque objects, particles, and terrain
+	@brief Draws all opaque objects, particles, and terrain in render queue order
 	*/
 	void renderOpaqueMeshes();
 
 	void renderTransparentMeshes();
 
+	/*
+	@brief Fills depth buffer with opaque meshes using depth-only shaders. Colour buffer is not changed
+	*/
+	void renderDepthPrepass();
+
 	//----- Forward rendering or geometry pass of deferred rendering -----
 
 	/*
@@ -52,23 +63,24 @@ public:
 
 	/*
 	@brief Draws 3D objects; directional light
+	@param[in] firstInstance, instanceAmount - range of instance positions in node
 	*/
-	void renderObjectsDirectional(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances);
+	void renderObjectsDirectional(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount);
 
 	/*
 	@brief Draws 3D objects; directional light, normalmap
 	*/
-	void renderObjectsDirectionalNormalmap(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances);
+	void renderObjectsDirectionalNormalmap(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount);
 
 	/*
 	@brief Draws 3D objects; directional light, waves as normals
 	*/
-	void renderObjectsDirectionalWaves(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances);
+	void renderObjectsDirectionalWaves(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount);
 
 	/*
 	@brief Draws 3D objects; directional light, glitter
 	*/
-	void renderObjectsDirectionalGlitter(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances);
+	void renderObjectsDirectionalGlitter(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount);
 
 	/*
 	@brief Draws 3D objects; directional light, geometry instancing
@@ -78,22 +90,22 @@ public:
 	/*
 	@brief Draws 3D objects; point light
 	*/
-	void renderObjectsPoint(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances);
+	void renderObjectsPoint(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount);
 
 	/*
 	@brief Draws 3D objects; point light, normalmap
 	*/
-	void renderObjectsPointNormalmap(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances);
+	void renderObjectsPointNormalmap(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount);
 
 	/*
 	@brief Draws 3D objects; point light, waves as normals
 	*/
-	void renderObjectsPointWaves(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances);
+	void renderObjectsPointWaves(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount);
 
 	/*
 	@brief Draws 3D objects; point light, glitter
 	*/
-	void renderObjectsPointGlitter(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances);
+	void renderObjectsPointGlitter(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount);
 
 	/*
 	@brief Draws 3D objects; point light, geometry instancing
@@ -122,20 +134,84 @@ public:
 	*/
 	virtual void setAmbientLightColour(const glm::vec3 &colour);
 
+	/*
+	@brief Sets size of the part of target framebuffer the scene is drawn to. Changed by dynamic resolution
+	*/
+	virtual void setViewportSize(int width, int height);
+
+	/*
+	@brief Replaces additional point lights, e.g. for benchmark light sweep
+	@return false if renderer doesn't shade additional point lights
+	*/
+	virtual bool setPointLights(const std::vector<renderer::data::PointLight> &lights);
+
+	/*
+	@brief Sets projection to scene, depth pre-pass and sky shaders. Changed every frame by temporal upscaling jitter
+	*/
+	void setProjection(const glm::mat4 &projection);
+
+	/*
+	@brief Sets time of waves animation. Negative value returns to real time
+	@param[in] seconds - time of replay clock
+	*/
+	void setSceneTime(float seconds);
 
 	//Update data
 	void updateCamera(const glm::mat4 &newViewMatrix);
 	void setVisibilityFlags(std::vector<renderer::data::VisibilityFlags> *visibility);
 	void setCameraPosition(glm::vec3 *viewPosition);
 	void setRenderingScene(renderer::graphics_lib::videocard_data::RenderingScene *scene);
+	void setDepthPrepassShaders(const std::vector<renderer::graphics_lib::videocard_data::ShaderIds> &shaderIds); //Order must match with "shaders" array
+	void setWeightedBlendedTransparency(std::unique_ptr<renderer::graphics_lib::WeightedBlendedTransparency> transparency); //Transparent meshes must use OIT shaders
+	void setGpuPassTimer(renderer::graphics_lib::GpuPassTimer *timer); //Can be nullptr
 	renderer::graphics_lib::videocard_data::RenderingScene* getRenderingScene(); //Editor-specific
 
 	int getDrawnTriangleCount() const;
+	int getDrawCallCount() const; //Scene meshes only, fullscreen passes aren't counted
+
+	/*
+	@brief Returns amount of samples that passed depth test in opaque shading pass of the previous frame
+	*/
+	unsigned int getShadedSampleCount() const;
+
+	/*
+	@brief Returns time of render queue filling and sorting in the last frame, microseconds
+	*/
+	float getRenderQueueTime() const;
 
 protected:
 	void initialize(const std::map<int, unsigned long long> &shaderFlags, bool isDirectional);
 	void copyShaderArray(const std::vector<renderer::graphics_lib::videocard_data::ShaderIds> &shaderIds);
 
+	/*
+	@brief Fills render queue with visible meshes and sorts it. Called once per frame, before any mesh is drawn
+	*/
+	void prepareRenderQueue();
+
+	/*
+	@brief Draws queue items in sorted order, switching shaders only when they change
+	@param[in] first, last - range of positions in sorted queue, last is excluded
+	*/
+	void renderQueueItems(int first, int last);
+
+	/*
+	@brief Draws transparent meshes with sorted alpha blending or weighted blended transparency, whichever is set
+	*/
+	void renderTransparency();
+
+	//Wrap opaque shading pass
+	void beginShadedSampleQuery();
+	void endShadedSampleQuery();
+
+	/*
+	@brief Returns scene time if it is set, otherwise real time. Seconds
+	*/
+	float getAnimationTime() const;
+
+	//Wrap passes measured by GPU pass timer, if it is set
+	void beginGpuPass(const char *name);
+	void endGpuPass();
+
 
 
 	/*
@@ -146,7 +222,7 @@ protected:
 	/*
 	@brief Pointer to object rendering methods. Concrete method depends on properties required by object
 	*/
-	void (Base3DRenderer:: *renderObjects[RENDER_METHODS])(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances); //Order of shaders must match with "shaders" array
+	void (Base3DRenderer:: *renderObjects[RENDER_METHODS])(const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount); //Order of shaders must match with "shaders" array
 
 	/*
 	@brief Pointer to particle rendering method. Concrete method depends on properties required by object
@@ -158,6 +234,7 @@ protected:
 	int previousShader;
 	renderer::graphics_lib::videocard_data::ShaderIds *shaders;
 	int shaderAmount;
+	renderer::graphics_lib::videocard_data::ShaderIds *depthPrepassShaders; //Empty fragment shaders. The same uniforms as in "shaders"
 
 	renderer::graphics_lib::videocard_data::RenderingScene *renderingScene;
 	std::vector<renderer::data::VisibilityFlags> *visibilityFlagsPtr; //Non-owning pointer
@@ -168,6 +245,21 @@ protected:
 	glm::vec3 *cameraPositionPtr; //Non-owning pointer
 
 	int triangleCount;
+	int drawCallCount;
+
+	float sceneTime; //Seconds, negative if real time is used
+
+	renderer::graphics_lib::GpuPassTimer *gpuPassTimer; //Non-owning pointer
+
+	unsigned int shadedSampleQueryIds[SAMPLE_QUERY_AMOUNT];
+	bool isSampleQueryUsed[SAMPLE_QUERY_AMOUNT];
+	int currentSampleQuery;
+	unsigned int shadedSampleCount;
+
+	renderer::graphics_lib::RenderQueue renderQueue;
+	float renderQueueTime;
+
+	std::unique_ptr<renderer::graphics_lib::WeightedBlendedTransparency> weightedBlendedTransparency; //Null for sorted alpha blending
 };
 
 }
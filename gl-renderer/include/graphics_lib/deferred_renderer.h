@@ -7,19 +7,21 @@
 
 #pragma once
 
+#include <memory>
+
 #include "graphics_lib/base_3d_renderer.h"
+#include "graphics_lib/light_clusters.h"
 
 namespace renderer::graphics_lib
 {
 
 class DeferredRenderer: public Base3DRenderer
 {
-	static constexpr int TOTAL_TEXTURES = 4;
+	//Position is reconstructed from depth, so G-buffer is 8 bytes per pixel plus depth
+	static constexpr int TOTAL_TEXTURES = 2;
 
-	static constexpr int TEXTURE_INDEX_POSITION = 0;
-	static constexpr int TEXTURE_INDEX_UV = 1;
-	static constexpr int TEXTURE_INDEX_NORMAL = 2;
-	static constexpr int TEXTURE_INDEX_DIFFUSE = 3;
+	static constexpr int TEXTURE_INDEX_DIFFUSE = 0; //RGBA8 albedo
+	static constexpr int TEXTURE_INDEX_NORMAL = 1; //RG16, octahedral encoding
 
 public:
 	DeferredRenderer(const std::vector<renderer::graphics_lib::videocard_data::ShaderIds> &shaderIds, const renderer::graphics_lib::videocard_data::ShaderIds &sky,
@@ -34,17 +36,27 @@ public:
 
 	void setWriteFramebufferId(unsigned int writeBuffer);
 
+	/*
+	@brief Enables shading of additional point lights by clusters
+	*/
+	void setLightClusters(std::unique_ptr<renderer::graphics_lib::LightClusters> clusters, const renderer::graphics_lib::videocard_data::ShaderIds &clusteredLightPass);
+
 	//Simulation staff
 	virtual void setLightDirection(const glm::vec3 &direction) override;
 	virtual void setDiffuseLightColour(const glm::vec3 &colour) override;
 	virtual void setAmbientLightColour(const glm::vec3 &colour) override;
 
+	virtual void setViewportSize(int width, int height) override;
+
+	virtual bool setPointLights(const std::vector<renderer::data::PointLight> &lights) override;
+
 private:
 	void initializeBuffer();
 
 	void performStencilPass();
 	void performDirectionalLightPass();
 	void performPointLightPass();
+	void performClusteredLightPass();
 	void drawSkyAsForwardRendering();
 
 
@@ -54,11 +66,15 @@ private:
 	const int framebufferWidth;
 	const int framebufferHeight;
 
+	int viewportWidth; //Smaller than framebuffer with dynamic resolution
+	int viewportHeight;
+
 	unsigned int framebufferId = -1u;
 	unsigned int textureIds[TOTAL_TEXTURES];
-	unsigned int depthTextureId = -1u; //Now stored for deletion only
+	unsigned int depthTextureId = -1u; //Sampled by light passes for position reconstruction
 
 	unsigned int quadVaoId = -1u;
+	unsigned int quadVboId = -1u;
 
 	bool useFog;
 
@@ -70,6 +86,9 @@ private:
 	glm::vec3 pointLightPosition;
 
 	bool isDeferredLightDirectional;
+
+	std::unique_ptr<renderer::graphics_lib::LightClusters> lightClusters; //Null if scene has no additional point lights
+	renderer::graphics_lib::videocard_data::ShaderIds clusteredLightPassShaderId;
 };
 
 }
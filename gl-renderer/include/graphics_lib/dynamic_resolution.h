@@ -0,0 +1,102 @@
+/* dynamic_resolution.h
+ * Renders scene at reduced resolution chosen by GPU frame time, then upscales it with sharpening
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <glm/glm.hpp>
+
+#include "graphics_lib/temporal_upscaler.h"
+#include "graphics_lib/videocard_data/shader_ids.h"
+
+namespace renderer::graphics_lib
+{
+
+/*
+Scene target is allocated at full resolution, the scene is drawn into its bottom-left part of scaled size.
+Scale changes only the viewport, so nothing is reallocated when it changes.
+GPU time of scene rendering and upscaling is measured with timer queries and read a few frames later.
+Without target frame time the scale stays fixed.
+*/
+class DynamicResolution
+{
+	static constexpr int TIMER_QUERY_AMOUNT = 3; //Results are read with delay, waiting for them would stall the pipeline
+
+public:
+	DynamicResolution(const renderer::graphics_lib::videocard_data::ShaderIds &upscale, int width, int height, float initialScale, float targetFrameTime);
+	~DynamicResolution();
+
+	/*
+	@brief Updates scale from finished timer queries, starts a new one, binds scene target with scaled viewport
+	*/
+	void beginFrame();
+
+	/*
+	@brief Draws scaled scene to the whole output framebuffer with sharpening, finishes timer query. With temporal upscaler the scene is resolved into its history first
+	@param[in] outputFramebufferId - screen or postprocessing framebuffer
+	*/
+	void upscale(unsigned int outputFramebufferId);
+
+	/*
+	@brief Enables accumulation of jittered frames instead of plain upscaling
+	*/
+	void setTemporalUpscaler(std::unique_ptr<renderer::graphics_lib::TemporalUpscaler> upscaler);
+
+	bool isTemporalUpscaling() const;
+
+	/*
+	@brief Returns jittered projection of the current frame. Valid only with temporal upscaler
+	*/
+	const glm::mat4& getJitteredProjection() const;
+
+	void updateCamera(const glm::mat4 &newViewMatrix);
+
+	unsigned int getFramebufferId() const;
+
+	int getScaledWidth() const;
+	int getScaledHeight() const;
+
+	float getScale() const;
+	float getTargetFrameTime() const; //Milliseconds, 0 for fixed scale
+	float getGpuFrameTime() const; //Milliseconds, smoothed
+
+private:
+	void initializeBuffer();
+
+	/*
+	@brief Picks scale for measured GPU time. Goes down at once when frame is too long, goes up by steps when there is headroom
+	*/
+	void updateScale();
+
+
+
+	const int framebufferWidth;
+	const int framebufferHeight;
+
+	unsigned int framebufferId = -1u;
+	unsigned int textureId = -1u;
+	unsigned int depthTextureId = -1u;
+
+	unsigned int quadVaoId = -1u;
+	unsigned int quadVboId = -1u;
+
+	renderer::graphics_lib::videocard_data::ShaderIds upscaleShaderId;
+
+	unsigned int timerQueryIds[TIMER_QUERY_AMOUNT];
+	bool isTimerQueryUsed[TIMER_QUERY_AMOUNT];
+	int currentTimerQuery;
+
+	float scale;
+	float targetFrameTime;
+	float gpuFrameTime;
+	int framesSinceScaleChange;
+
+	std::unique_ptr<renderer::graphics_lib::TemporalUpscaler> temporalUpscaler; //Null for plain upscaling
+};
+
+}
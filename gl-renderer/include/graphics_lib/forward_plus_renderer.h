@@ -0,0 +1,40 @@
+/* forward_plus_renderer.h
+ * Forward+ renderer implementation: depth pre-pass, light clustering, forward shading with point lights from clusters
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "graphics_lib/base_3d_renderer.h"
+#include "graphics_lib/light_clusters.h"
+
+namespace renderer::graphics_lib
+{
+
+class ForwardPlusRenderer: public Base3DRenderer
+{
+public:
+	/*
+	@param[in] sceneLights - scene light if it is a point one, clustered together with additional lights
+	*/
+	ForwardPlusRenderer(const std::vector<renderer::graphics_lib::videocard_data::ShaderIds> &shaderIds, const renderer::graphics_lib::videocard_data::ShaderIds &sky,
+		const std::map<int, unsigned long long> &shaderFlags, std::unique_ptr<renderer::graphics_lib::LightClusters> clusters, const std::vector<renderer::data::PointLight> &sceneLights);
+	virtual ~ForwardPlusRenderer();
+
+	virtual void render();
+
+	virtual void setTargetFramebuffer();
+
+	virtual bool setPointLights(const std::vector<renderer::data::PointLight> &lights) override;
+
+private:
+	std::unique_ptr<renderer::graphics_lib::LightClusters> lightClusters;
+	std::vector<renderer::data::PointLight> scenePointLights; //Kept when additional lights are replaced
+};
+
+}
@@ -7,13 +7,19 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <glm/glm.hpp>
 
 #include "data/visibility_flags.h"
+#include "frame_time_history.h"
+#include "graphics_lib/dynamic_resolution.h"
 #include "graphics_lib/forward_renderer.h"
+#include "graphics_lib/gpu_pass_timer.h"
+#include "graphics_lib/operations/counted_calls.h"
 #include "graphics_lib/postprocessing_renderer.h"
 
 namespace renderer::graphics_lib
@@ -21,7 +27,7 @@ namespace renderer::graphics_lib
 
 class FrameRenderer
 {
-	static constexpr int UI_STR_MAX_LENGTH = 40;
+	static constexpr int UI_STR_MAX_LENGTH = 64;
 
 public:
 	FrameRenderer(renderer::graphics_lib::Base3DRenderer *mainRend, renderer::graphics_lib::PostprocessingRenderer *postprocessingRend, bool isDeferred);
@@ -54,6 +60,17 @@ public:
 	//Pass-through
 	void setAmbientLightColour(const glm::vec3 &colour);
 
+	/*
+	@brief Replaces additional point lights. Pass-through
+	@return false if main renderer doesn't shade them
+	*/
+	bool setPointLights(const std::vector<renderer::data::PointLight> &lights);
+
+	/*
+	@brief Sets time of waves animation, negative for real time. Pass-through
+	*/
+	void setSceneTime(float seconds);
+
 	//----- Setters -----
 
 	/*
@@ -71,8 +88,19 @@ public:
 	*/
 	void setRendererLibraryProperties();
 
+	/*
+	@brief Enables rendering of the scene at reduced resolution with upscaling
+	*/
+	void setDynamicResolution(std::unique_ptr<renderer::graphics_lib::DynamicResolution> resolution);
+
 
 	int getDrawnTriangleCount() const;
+	int getDrawCallCount() const;
+	const renderer::graphics_lib::operations::CallCounters& getFrameCallCounters() const; //The previous frame, editor drawing and calls between frames included
+	unsigned int getShadedSampleCount() const;
+	float getRenderQueueTime() const; //Microseconds
+	const renderer::graphics_lib::DynamicResolution* getDynamicResolution() const; //Null if resolution is fixed
+	const renderer::graphics_lib::PostprocessingRenderer* getPostprocessingRenderer() const; //Null without postprocessing
 
 	/*
 	@brief Sets FPS count and drawn triangle amount info
@@ -81,14 +109,61 @@ public:
 
 	void setSimulationLine(const std::string &str);
 
+	/*
+	@brief Sets staging ring queue info
+	*/
+	void setUploadLine(const std::string &str);
+
+	/*
+	@brief Sets opaque pass info, e.g. samples passed depth test and render queue sorting time
+	*/
+	void setRenderingLine(const std::string &str);
+
+	/*
+	@brief Sets dynamic resolution info: current scale, target and measured GPU time
+	*/
+	void setResolutionLine(const std::string &str);
+
+	/*
+	@brief Sets GPU time of each postprocessing pass
+	*/
+	void setPostprocessingLine(const std::string &str);
+
+	/*
+	@brief Sets CPU profiler zones of main thread to show next to GPU passes
+	@param[in] zoneTimes - zone names and time per frame, milliseconds
+	*/
+	void setCpuZoneTimes(const std::vector<std::pair<const char*, float>> &zoneTimes);
+
+	/*
+	@brief Sets frame times to show as a graph with percentiles. Can be nullptr
+	*/
+	void setFrameTimeHistory(const renderer::FrameTimeHistory *history);
+
 protected:
 	renderer::graphics_lib::Base3DRenderer *mainRenderer;
 	renderer::graphics_lib::PostprocessingRenderer *postprocessingRenderer;
 
 	bool isDeferredRenderer;
 
+	std::unique_ptr<renderer::graphics_lib::DynamicResolution> dynamicResolution; //Null if resolution is fixed
+	int viewportWidth; //Last size passed to main renderer, 0 if not passed yet
+	int viewportHeight;
+
 	char statisticsString[UI_STR_MAX_LENGTH];
 	char simulationString[UI_STR_MAX_LENGTH];
+	char uploadString[UI_STR_MAX_LENGTH];
+	char renderingString[UI_STR_MAX_LENGTH];
+	char resolutionString[UI_STR_MAX_LENGTH];
+	char postprocessingString[UI_STR_MAX_LENGTH];
+
+	std::unique_ptr<renderer::graphics_lib::GpuPassTimer> gpuPassTimer;
+	std::vector<std::pair<const char*, float>> gpuPassTimes; //Filled from GPU pass timer for UI
+	std::vector<std::pair<const char*, float>> cpuZoneTimes;
+
+	renderer::graphics_lib::operations::CallCounters frameCallCounters;
+
+	const renderer::FrameTimeHistory *frameTimeHistory; //Non-owning pointer
 };
 
 }
@@ -0,0 +1,64 @@
+/* gpu_pass_timer.h
+ * Measures GPU time of frame passes with timestamp queries
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <vector>
+
+namespace renderer::graphics_lib
+{
+
+/*
+Timestamps are taken at pass begin and end, so passes can be measured inside GL_TIME_ELAPSED queries of dynamic resolution and postprocessing,
+which can't be nested.
+Queries of a frame are read a few frames later, if they aren't ready yet the frame is skipped.
+*/
+class GpuPassTimer
+{
+	static constexpr int QUERY_FRAMES = 3; //Results are read with delay, waiting for them would stall the pipeline
+	static constexpr int MAX_PASS_AMOUNT = 16; //Per frame, the rest aren't measured
+
+public:
+	GpuPassTimer();
+	~GpuPassTimer();
+
+	/*
+	@brief Takes results of the oldest frame, its queries are reused for the current frame
+	*/
+	void beginFrame();
+
+	/*
+	@brief Marks pass start. Passes must not overlap
+	@param[in] name - string literal, only the pointer is stored
+	*/
+	void beginPass(const char *name);
+
+	void endPass();
+
+	int getPassAmount() const;
+	const char* getPassName(int index) const;
+	float getPassTime(int index) const; //Milliseconds, smoothed
+
+private:
+	/*
+	@brief Adds measured pass time to smoothed results
+	*/
+	void addPassTime(const char *name, float time);
+
+
+
+	unsigned int queryIds[QUERY_FRAMES][MAX_PASS_AMOUNT * 2]; //Begin and end timestamps
+	const char *framePassNames[QUERY_FRAMES][MAX_PASS_AMOUNT];
+	int framePassAmount[QUERY_FRAMES];
+	int currentFrame;
+	bool isPassStarted;
+
+	std::vector<const char*> passNames; //In order of the first appearance
+	std::vector<float> passTimes;
+};
+
+}
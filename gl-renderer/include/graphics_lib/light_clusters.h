@@ -0,0 +1,68 @@
+/* light_clusters.h
+ * Bins point lights into view frustum clusters with compute shader
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "data/scene.h"
+#include "graphics_lib/videocard_data/shader_ids.h"
+
+namespace renderer::graphics_lib
+{
+
+/*
+Cluster is a part of view frustum: one of CLUSTER_TILES_X * CLUSTER_TILES_Y screen tiles cut by one of CLUSTER_DEPTH_SLICES exponential depth slices.
+Shader storage buffers, binding points match clustering and shading shaders:
+	0 - lights: world space position and bounding sphere radius, colour and power
+	1 - light amount for each cluster
+	2 - light indices, CLUSTER_MAX_LIGHTS slots for each cluster
+*/
+class LightClusters
+{
+public:
+	//Passed to clustering and shading shaders as defines by ShaderManager
+	static constexpr int CLUSTER_TILES_X = 16;
+	static constexpr int CLUSTER_TILES_Y = 9;
+	static constexpr int CLUSTER_DEPTH_SLICES = 24;
+	static constexpr int CLUSTER_MAX_LIGHTS = 256;
+
+	static constexpr int CLUSTER_AMOUNT = CLUSTER_TILES_X * CLUSTER_TILES_Y * CLUSTER_DEPTH_SLICES;
+
+	LightClusters(const renderer::graphics_lib::videocard_data::ShaderIds &clustering);
+	~LightClusters();
+
+	/*
+	@brief Transfers lights to videocard. Bounding sphere radius is computed from light power
+	*/
+	void setLights(const std::vector<renderer::data::PointLight> &lights);
+
+	/*
+	@brief Rebuilds light lists of all clusters for camera. Lists are visible to shaders executed after this call
+	*/
+	void update(const glm::mat4 &viewMatrix);
+
+	/*
+	@brief Binds light and cluster buffers for shading pass
+	*/
+	void bindBuffers();
+
+	int getLightAmount() const;
+
+private:
+	renderer::graphics_lib::videocard_data::ShaderIds clusteringShaderId;
+
+	unsigned int lightBufferId = -1u;
+	unsigned int lightCountBufferId = -1u;
+	unsigned int lightIndexBufferId = -1u;
+
+	int lightAmount;
+};
+
+}
@@ -1,5 +1,5 @@
 /* main_renderer_builder.h
- * Initializes all the shaders for ForwardRenderer and DeferredRenderer classes
+ * Initializes all the shaders for ForwardRenderer, ForwardPlusRenderer and DeferredRenderer classes
  * OpenGL 4.5
  *
  * Author: Artem Hiblov
@@ -20,7 +20,8 @@ namespace renderer::graphics_lib
 {
 
 std::unique_ptr<renderer::graphics_lib::Base3DRenderer> buildMainRenderer(renderer::managers::ObjectManager *objectManager, renderer::graphics_lib::ShaderManager *shaderManager,
-	int screenWidth, int screenHeight, const renderer::data::Light &light, const renderer::data::Fog &fog, const std::map<int, unsigned long long> &shaderFlags,
-	std::vector<renderer::graphics_lib::videocard_data::ShaderIds> &shaderIds, bool isDirectional, bool isDeferred);
+	int screenWidth, int screenHeight, const renderer::data::Light &light, const std::vector<renderer::data::PointLight> &pointLights, const renderer::data::Fog &fog,
+	const std::map<int, unsigned long long> &shaderFlags, std::vector<renderer::graphics_lib::videocard_data::ShaderIds> &shaderIds, bool isDirectional, bool isDeferred,
+	bool isForwardPlus, bool useDepthPrepass, bool useWeightedBlendedTransparency);
 
 }
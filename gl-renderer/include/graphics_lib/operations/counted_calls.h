@@ -0,0 +1,55 @@
+/* counted_calls.h
+ * Thin wrappers over OpenGL calls of per-frame rendering, counting them for statistics
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+namespace renderer::graphics_lib::operations
+{
+
+/*
+Amount of calls since the last reset. Counters are touched only by rendering thread, so they aren't atomic.
+Program switches and binds are counted as issued, redundant ones included, so they show how well render queue sorting works.
+*/
+struct CallCounters
+{
+	int drawCalls = 0;
+	int instances = 0;
+	int programSwitches = 0;
+	int vaoBinds = 0;
+	int textureBinds = 0;
+	int uniformUploads = 0;
+};
+
+/*
+@brief Returns counters gathered since the last reset
+*/
+const CallCounters& getCallCounters();
+
+/*
+@brief Zeroes all counters. Called at frame start
+*/
+void resetCallCounters();
+
+void useProgram(unsigned int programId);
+void bindVertexArray(unsigned int vaoId);
+void bindTextureUnit(unsigned int unit, unsigned int textureId);
+void bindTexture(unsigned int target, unsigned int textureId);
+
+void drawArrays(unsigned int mode, int first, int vertexAmount);
+void drawArraysInstanced(unsigned int mode, int first, int vertexAmount, int instanceAmount);
+
+void uniform1i(int location, int value);
+void uniform1ui(int location, unsigned int value);
+void uniform1f(int location, float value);
+void uniform2f(int location, float value0, float value1);
+void uniform2fv(int location, int count, const float *value);
+void uniform3fv(int location, int count, const float *value);
+void uniform4fv(int location, int count, const float *value);
+void uniformMatrix3fv(int location, int count, unsigned char transpose, const float *value);
+void uniformMatrix4fv(int location, int count, unsigned char transpose, const float *value);
+
+}
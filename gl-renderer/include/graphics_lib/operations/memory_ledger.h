@@ -0,0 +1,78 @@
+/* memory_ledger.h
+ * Creates and deletes buffers and textures, keeping videocard memory they take per category and owner
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace renderer::graphics_lib::operations
+{
+
+enum class MemoryCategory
+{
+	MESHES,
+	TERRAIN,
+	PARTICLES,
+	TEXTURES,
+	RENDER_TARGETS,
+	LIGHTS,
+	STAGING
+};
+
+constexpr int MEMORY_CATEGORY_AMOUNT = 7;
+
+/*
+Resources alive in category. Ledger is touched only by rendering thread, so it isn't locked
+*/
+struct MemoryUsage
+{
+	int64_t bytes = 0;
+	int resourceAmount = 0;
+};
+
+/*
+@brief Creates buffer with immutable storage and records it
+@param[in] data - can be nullptr
+@param[in] flags - storage flags, e.g. for persistent mapping
+@param[in] owner - file path or renderer part the buffer belongs to
+@return Buffer ID
+*/
+unsigned int createTrackedBuffer(int64_t size, const void *data, unsigned int flags, MemoryCategory category, const std::string &owner);
+
+/*
+@brief Creates 2D texture with immutable storage and records size of all its levels
+@param[in] format - sized internal format
+@return Texture ID
+*/
+unsigned int createTrackedTexture(int levels, unsigned int format, int width, int height, MemoryCategory category, const std::string &owner);
+
+/*
+@brief Deletes buffer and its record. Unknown IDs, e.g. -1u of absent mesh components, are ignored by ledger
+*/
+void deleteTrackedBuffer(unsigned int bufferId);
+
+void deleteTrackedTexture(unsigned int textureId);
+
+const MemoryUsage& getMemoryUsage(MemoryCategory category);
+
+/*
+@brief Returns sum of all categories
+*/
+MemoryUsage getTotalMemoryUsage();
+
+const char* getMemoryCategoryName(MemoryCategory category);
+
+/*
+@brief Returns owners taking the most memory, sorted by size
+@param[in] amount - maximum amount of owners
+*/
+std::vector<std::pair<std::string, int64_t>> getLargestMemoryOwners(int amount);
+
+}
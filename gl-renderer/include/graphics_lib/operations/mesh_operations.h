@@ -7,28 +7,57 @@
 
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "data/mesh.h"
+#include "graphics_lib/upload_service.h"
 #include "graphics_lib/videocard_data/object_rendering_data.h"
 
 namespace renderer::graphics_lib::operations
 {
 
+/*
+Mesh arrays already written to staging ring, e.g. by loader thread. Absent arrays have zero size
+*/
+struct StagedMesh
+{
+	renderer::graphics_lib::StagingAllocation vertices;
+	renderer::graphics_lib::StagingAllocation uvs;
+	renderer::graphics_lib::StagingAllocation normals;
+	renderer::graphics_lib::StagingAllocation tangent;
+	renderer::graphics_lib::StagingAllocation bitangent;
+
+	int floatsPerVertex = 0;
+};
+
 /*
 @brief Fills mesh-related structure fields with data needed for mesh rendering
+@param[in] owner - mesh path for memory ledger
+*/
+bool makeMesh(const renderer::data::Mesh &meshData, const std::string &owner, renderer::graphics_lib::videocard_data::ObjectRenderingData &meshIds);
+
+/*
+@brief Same as above, buffers are filled by copies from staging ring after UploadService::processUploads(). Data isn't touched by this thread
+@param[in] meshData - allocations are committed to uploadService
+*/
+bool makeMesh(const StagedMesh &meshData, renderer::graphics_lib::UploadService &uploadService, const std::string &owner, renderer::graphics_lib::videocard_data::ObjectRenderingData &meshIds);
+
+/*
+@brief Returns staged arrays to the ring when mesh isn't created from them
 */
-bool makeMesh(const renderer::data::Mesh &meshData, renderer::graphics_lib::videocard_data::ObjectRenderingData &meshIds);
+void discardMesh(const StagedMesh &meshData, renderer::graphics_lib::UploadService &uploadService);
 
 bool makeMeshWithClonedVbo(const renderer::graphics_lib::videocard_data::ObjectRenderingData &data, renderer::graphics_lib::videocard_data::ObjectRenderingData &meshIds);
 
 /*
 @brief Creates full-screen quad for texture output
+@param[out] vboId - must be deleted with deleteTrackedBuffer() after VAO
 */
-void initializeQuadMesh(unsigned int &vaoId);
+void initializeQuadMesh(unsigned int &vaoId, unsigned int &vboId);
 
 /*
-@brief Detetes all mesh components from videocard
+@brief Detetes all mesh components from videocard. Cloned VAOs share buffers, they are deleted with deleteContainer()
 */
 void deleteMesh(const renderer::graphics_lib::videocard_data::ObjectRenderingData &objectIds);
 
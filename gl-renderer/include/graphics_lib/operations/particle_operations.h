@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <string>
+
 #include <glm/glm.hpp>
 
 #include "graphics_lib/videocard_data/particle_rendering_data.h"
@@ -16,8 +18,9 @@ namespace renderer::graphics_lib::operations
 
 /*
 @brief Fills particle-related fields
+@param[in] owner - particle group name for memory ledger
 */
-bool makeParticleGroup(const glm::vec3 *arrangement, const float *rotation, int recordAmount, renderer::graphics_lib::videocard_data::ParticleRenderingData &groupIds);
+bool makeParticleGroup(const glm::vec3 *arrangement, const float *rotation, int recordAmount, const std::string &owner, renderer::graphics_lib::videocard_data::ParticleRenderingData &groupIds);
 
 /*
 @brief Detetes all particle components from videocard. Mesh is deleted by ObjectManager
@@ -15,4 +15,9 @@ namespace renderer::graphics_lib::operations
 @brief Compiles and links shaders
 */
 bool makeShader(const std::string &vertexShader, const std::string &fragmentShader, unsigned int &shaderId, unsigned int &vertexShaderId, unsigned int &fragmentShaderId);
+
+/*
+@brief Compiles and links compute shader
+*/
+bool makeComputeShader(const std::string &computeShader, unsigned int &shaderId, unsigned int &computeShaderId);
 }
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "data/mesh.h"
 #include "graphics_lib/videocard_data/object_rendering_data.h"
 
@@ -15,8 +17,9 @@ namespace renderer::graphics_lib::operations
 
 /*
 @brief Fills mesh-related structure fields with data needed for terrain rendering
+@param[in] owner - chunk name for memory ledger
 */
-bool makeTerrain(const renderer::data::Mesh &terrainData, renderer::graphics_lib::videocard_data::ObjectRenderingData &terrainIds);
+bool makeTerrain(const renderer::data::Mesh &terrainData, const std::string &owner, renderer::graphics_lib::videocard_data::ObjectRenderingData &terrainIds);
 
 /*
 @brief Deletes all terrain components from videocard
@@ -7,16 +7,38 @@
 
 #pragma once
 
+#include <string>
+
 #include "data/texture.h"
+#include "graphics_lib/upload_service.h"
 #include "graphics_lib/videocard_data/object_rendering_data.h"
 
 namespace renderer::graphics_lib::operations
 {
 
+/*
+Pixels already written to staging ring, e.g. by loader thread
+*/
+struct StagedTexture
+{
+	renderer::graphics_lib::StagingAllocation pixels;
+
+	int width = 0;
+	int height = 0;
+	int bytesPerPixel = 0;
+};
+
 /*
 @brief Fills texture-related structure fields
+@param[in] owner - texture path for memory ledger
+*/
+bool makeTexture(const renderer::data::Texture &texture, const std::string &owner, unsigned int &textureId);
+
+/*
+@brief Same as above, texture is filled by copy from staging ring after UploadService::processUploads(). Pixels aren't touched by this thread
+@param[in] texture - allocation is committed to uploadService
 */
-bool makeTexture(const renderer::data::Texture &texture, unsigned int &textureId);
+bool makeTexture(const StagedTexture &texture, renderer::graphics_lib::UploadService &uploadService, const std::string &owner, unsigned int &textureId);
 
 /*
 @brief Deletes texture on videocard
@@ -0,0 +1,24 @@
+/* postprocessing_backend_comparison.h
+ * Measures GPU time of postprocessing effect with fragment and compute shaders
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <string>
+
+#include "graphics_lib/shader_manager.h"
+
+namespace renderer::graphics_lib
+{
+
+/*
+@brief Renders effect offscreen at several resolutions with both shader types, writes GPU times to log.
+Must be called before postprocessing renderer is built, because it changes uniforms of shared shaders
+@param[in] effect - neighbourhood effect having compute variant, e.g. "postprocessing:emboss"
+*/
+void comparePostprocessingBackends(const std::string &effect, renderer::graphics_lib::ShaderManager *shaderManager);
+
+}
@@ -1,5 +1,5 @@
 /* postprocessing_renderer.h
- * Applies 2D fullscreen effects on framebuffer
+ * Applies chain of 2D fullscreen effects on framebuffer
  * OpenGL 4.5
  *
  * Author: Artem Hiblov
@@ -7,16 +7,34 @@
 
 #pragma once
 
+#include <vector>
+
 #include "graphics_lib/abstract_renderer.h"
+#include "graphics_lib/gpu_pass_timer.h"
 #include "graphics_lib/videocard_data/postprocessing_shader_ids.h"
 
 namespace renderer::graphics_lib
 {
 
+/*
+Each pass reads the previous result and writes the next one, the last pass writes to the screen.
+Scene target is reused for ping-pong once the first pass has read it, so only one more target is allocated for chains.
+Compute passes can't write to the screen, so the last of them writes to a target which is copied by fragment shader.
+Blit can't be used there, because the screen is multisampled with smoothing.
+GPU time of each pass is measured with timer queries and read a few frames later.
+*/
 class PostprocessingRenderer: public AbstractRenderer
 {
+	static constexpr int TARGET_AMOUNT = 2; //Scene target and ping-pong target
+	static constexpr int TIMER_QUERY_FRAMES = 3; //Results are read with delay, waiting for them would stall the pipeline
+	static constexpr int COMPUTE_TILE_SIDE = 16; //Work group size of tile-filter-comp.glsl
+
 public:
-	PostprocessingRenderer(renderer::graphics_lib::videocard_data::PostprocessingShaderIds &ids, int width, int height);
+	/*
+	@param[in] outputCopy - fused shader without effects, used when the last pass is compute one
+	*/
+	PostprocessingRenderer(const std::vector<renderer::graphics_lib::videocard_data::PostprocessingShaderIds> &passes,
+		const renderer::graphics_lib::videocard_data::PostprocessingShaderIds &outputCopy, int width, int height);
 	virtual ~PostprocessingRenderer();
 
 	virtual void render();
@@ -25,21 +43,61 @@ public:
 
 	unsigned int getFramebufferId() const;
 
+	/*
+	@brief Sets framebuffer the last pass writes to instead of the screen. It must be of the same size
+	*/
+	void setOutputFramebuffer(unsigned int id);
+
+	int getPassAmount() const;
+	float getPassTime(int index) const; //Milliseconds, smoothed. Output copy after compute pass isn't included
+
+	/*
+	@brief Sets timer which measures the whole chain as a frame pass. Can be nullptr
+	*/
+	void setGpuPassTimer(renderer::graphics_lib::GpuPassTimer *timer);
+
 private:
-	void initializeFramebuffer();
+	void initializeFramebuffers();
 
+	/*
+	@brief Runs single effect. Output framebuffer of the last pass must be bound and cleared by caller
+	@param[in] source - index of target to read
+	*/
+	void renderPass(int index, int source, bool isLastPass);
 
+	/*
+	@brief Draws result of compute pass to bound output framebuffer
+	@param[in] source - index of target to read
+	*/
+	void copyToOutput(int source);
 
-	renderer::graphics_lib::videocard_data::PostprocessingShaderIds postprocessingIds;
+	/*
+	@brief Takes results of the oldest frame queries, they are reused for the current frame
+	*/
+	void readTimerQueries();
 
-	unsigned int framebufferId = -1u;
-	unsigned int textureId = -1u;
+
+
+	std::vector<renderer::graphics_lib::videocard_data::PostprocessingShaderIds> passIds;
+	renderer::graphics_lib::videocard_data::PostprocessingShaderIds outputCopyId;
+
+	unsigned int framebufferIds[TARGET_AMOUNT]; //Scene target is the first one
+	unsigned int textureIds[TARGET_AMOUNT];
 	unsigned int depthTextureId = -1u; //Now stored for deletion only
+	unsigned int outputFramebufferId;
 
 	unsigned int quadVaoId = -1u;
+	unsigned int quadVboId = -1u;
 
 	int framebufferWidth;
 	int framebufferHeight;
+
+	std::vector<unsigned int> timerQueryIds; //TIMER_QUERY_FRAMES x pass amount
+	bool isTimerQueryUsed[TIMER_QUERY_FRAMES];
+	int currentTimerFrame;
+	std::vector<float> passTimes;
+
+	renderer::graphics_lib::GpuPassTimer *gpuPassTimer; //Non-owning pointer
 };
 
 }
@@ -1,5 +1,5 @@
 /* postprocessing_renderer_builder.h
- * Initializes all the shaders for PostprocessingRenderer class
+ * Initializes all the shaders for PostprocessingRenderer and DynamicResolution classes
  * OpenGL 4.5
  *
  * Author: Artem Hiblov
@@ -9,13 +9,27 @@
 
 #include <memory>
 
+#include "graphics_lib/dynamic_resolution.h"
 #include "graphics_lib/postprocessing_renderer.h"
 #include "graphics_lib/shader_manager.h"
 
 namespace renderer::graphics_lib
 {
 
+/*
+@brief Creates passes for effect chain. Consecutive per-pixel effects are fused into one pass
+@param[in] postprocessingEffect - comma-separated effects in applying order, e.g. "postprocessing:grayscale,postprocessing:vignette"
+*/
 std::unique_ptr<renderer::graphics_lib::PostprocessingRenderer> buildPostprocessingRenderer(float screenWidth, float screenHeight, const std::string &postprocessingEffect,
 	renderer::graphics_lib::ShaderManager *shaderManager);
 
+/*
+@brief Creates scaled scene target and upscaling shaders
+@param[in] initialScale - scene resolution relative to screen
+@param[in] targetFrameTime - GPU time the scale is adjusted to, milliseconds. 0 for fixed scale
+@param[in] useTemporalUpscaling - accumulate jittered frames instead of plain upscaling
+*/
+std::unique_ptr<renderer::graphics_lib::DynamicResolution> buildDynamicResolution(int screenWidth, int screenHeight, float initialScale, float targetFrameTime, bool useTemporalUpscaling,
+	renderer::graphics_lib::ShaderManager *shaderManager);
+
 }
@@ -0,0 +1,90 @@
+/* render_queue.h
+ * Per-frame list of visible meshes ordered by 64-bit sort keys
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "graphics_lib/videocard_data/quad_subdivision.h"
+
+namespace renderer::graphics_lib
+{
+
+/*
+Sort key layout, most significant bits first:
+	opaque:      pass (4) | shader (12) | texture (24) | depth (24) - state changes are grouped, front-to-back inside group
+	transparent: pass (4) | inverted depth (24) | shader (12) | texture (24) - back-to-front
+Depth is view space distance quantized over far clipping distance. Opaque object node takes depth of its nearest instance.
+*/
+class RenderQueue
+{
+	static constexpr int RADIX_BITS = 8;
+	static constexpr int RADIX_SIZE = 1 << RADIX_BITS;
+
+public:
+	enum class ItemType
+	{
+		OBJECT_INSTANCE,
+		PARTICLE_GROUP,
+		TERRAIN_CHUNK
+	};
+
+	struct Item
+	{
+		ItemType type;
+		int shaderIndex;
+		const renderer::graphics_lib::videocard_data::ObjectQuadSubdivision::ObjectNode *objectNode; //For OBJECT_INSTANCE
+		const renderer::graphics_lib::videocard_data::ParticleQuadSubdivision::ParticleNode *particleNode; //For PARTICLE_GROUP
+		int index; //First instance index in object node or chunk index
+		int amount; //Instance amount for OBJECT_INSTANCE
+	};
+
+	RenderQueue();
+	~RenderQueue();
+
+	/*
+	@brief Removes all items. Memory is kept for the next frame
+	*/
+	void clear();
+
+	void addOpaque(const Item &item, unsigned int textureId, float depth);
+	void addTransparent(const Item &item, unsigned int textureId, float depth);
+
+	/*
+	@brief Orders items by keys with LSD radix sort. Opaque items go before transparent ones
+	*/
+	void sort();
+
+	int getItemAmount() const;
+
+	/*
+	@brief Index of the first transparent item in sorted order
+	*/
+	int getTransparentStart() const;
+
+	/*
+	@param[in] position - position in sorted order
+	*/
+	const Item& getItem(int position) const;
+
+private:
+	std::vector<Item> items;
+	std::vector<uint64_t> keys;
+
+	//Sorted keys and item indices, with scratch arrays for radix sort passes
+	std::vector<uint64_t> sortedKeys;
+	std::vector<int> order;
+	std::vector<uint64_t> scratchKeys;
+	std::vector<int> scratchOrder;
+
+	int opaqueAmount;
+};
+
+}
@@ -9,6 +9,7 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "data/shader_properties.h"
@@ -26,26 +27,58 @@ public:
 
 	void setLightType(bool directional);
 
+	/*
+	@brief Requests point lights from light clusters in forward shaders. Forward+ renderer only
+	*/
+	void setClusteredLights(bool enable);
+
+	/*
+	@brief Requests accumulation outputs instead of blended colour in shaders of transparent objects
+	*/
+	void setWeightedBlendedTransparency(bool enable);
+
 	/*
 	@brief Creates shader if neccessary and returns its ID
 	*/
 	bool getShaderId(const std::string &shaderName, renderer::graphics_lib::videocard_data::ShaderIds &id);
 
+	/*
+	@brief Creates compute shader if neccessary and returns its ID. Description keeps its path instead of vertex shader path
+	*/
+	bool getComputeShaderId(const std::string &shaderName, renderer::graphics_lib::videocard_data::ShaderIds &id);
+
 	/*
 	@brief Collects indices in property flags container. Does not create shader
+	@param[in] isTransparent - object has transparent texture
 	*/
-	bool getShaderIndexByProperty(const std::string &property, bool enableFog, bool isDeferredRenderer, int &shaderIndex);
+	bool getShaderIndexByProperty(const std::string &property, bool enableFog, bool isDeferredRenderer, bool isTransparent, int &shaderIndex);
 
 	/*
 	@brief Creates all the shaders needed for scene
 	*/
 	std::vector<renderer::graphics_lib::videocard_data::ShaderIds>& createNeededShaders(std::map<int, unsigned long long> &shaderFlags);
 
+	/*
+	@brief Creates depth-only shaders for depth pre-pass. Order matches createNeededShaders result. Must be called after it
+	*/
+	std::vector<renderer::graphics_lib::videocard_data::ShaderIds>& createDepthPrepassShaders();
+
 	/*
 	@brief Creates shader for posteffect if neccessary and returns its ID
 	*/
 	bool getPostprocessingShaderId(const std::string &property, renderer::graphics_lib::videocard_data::PostprocessingShaderIds **id);
 
+	/*
+	@brief Generates and compiles single shader applying per-pixel effects in the given order if neccessary
+	@param[in] properties - postprocessing properties, each one must be in PostprocessingFlags::PER_PIXEL_EFFECTS. Empty list gives plain copy
+	*/
+	bool getFusedPostprocessingShaderId(const std::vector<std::string> &properties, renderer::graphics_lib::videocard_data::PostprocessingShaderIds **id);
+
+	/*
+	@brief Creates compute shader variant of neighbourhood effect if neccessary. Effect source is appended to shared tile loading code
+	*/
+	bool getComputePostprocessingShaderId(const std::string &property, renderer::graphics_lib::videocard_data::PostprocessingShaderIds **id);
+
 	//----- Getters. External usage -----
 
 	unsigned long long getPostprocessingShaderFlags(const std::string &property) const;
@@ -55,6 +88,7 @@ public:
 
 	const std::map<int, unsigned long long>& getShaderFlags() const;
 	std::vector<renderer::graphics_lib::videocard_data::ShaderIds>& getOrderedShaderIds();
+	std::vector<renderer::graphics_lib::videocard_data::ShaderIds>& getDepthPrepassShaderIds();
 
 private:
 	//----- Properties-related stuff -----
@@ -76,16 +110,50 @@ private:
 	*/
 	bool readShaders(const std::string &shaderName, std::string &vertexShader, std::string &fragmentShader);
 
+	/*
+	@brief Finds shader in description by property flags. Features enabled by defines are ignored
+	*/
+	bool findDescriptionShaderName(unsigned long long flags, std::string &shaderName);
+
+	/*
+	@brief Compiles shader from description with defines for the flags if neccessary
+	*/
+	bool getShaderIdWithDefines(const std::string &shaderName, unsigned long long defineFlags, renderer::graphics_lib::videocard_data::ShaderIds &id);
+
+	//----- Uber-shader permutations -----
+
+	/*
+	@brief Checks if all features can be enabled in uber-shader by defines
+	*/
+	bool isUberShaderPermutation(unsigned long long flags) const;
+
+	/*
+	@brief Generates uber-shader source with defines matching the flags and compiles it if neccessary
+	*/
+	bool getPermutationShaderId(unsigned long long flags, renderer::graphics_lib::videocard_data::ShaderIds &id);
+
+	//----- Depth pre-pass -----
+
+	/*
+	@brief Compiles shading pass vertex shader with empty fragment shader if neccessary
+	*/
+	bool getDepthPrepassShaderId(unsigned long long flags, renderer::graphics_lib::videocard_data::ShaderIds &id);
+
 
 
 	std::map<std::string, renderer::data::ShaderProperties> description;
+	std::unordered_map<unsigned long long, std::string> descriptionByFlags; //Shader name for property flags. Postprocessing shaders aren't included
 
 	std::map<std::string, renderer::graphics_lib::videocard_data::ShaderIds> ids; //All created shaders
 	std::map<std::string, renderer::graphics_lib::videocard_data::PostprocessingShaderIds> postprocessingIds;
 
 	std::vector<renderer::graphics_lib::videocard_data::ShaderIds> orderedShaderIds; //The order matches neededShaders indices. Only shaders required by getShaderIndexByProperty
+	std::vector<renderer::graphics_lib::videocard_data::ShaderIds> depthPrepassShaderIds; //The same order as in orderedShaderIds
 	std::map<int, unsigned long long> neededShaders;
+	std::unordered_map<unsigned long long, int> neededShaderIndices; //Reverse of neededShaders
 	bool directionalLight;
+	bool clusteredLights;
+	bool weightedBlendedTransparency;
 
 	std::vector<unsigned int> shaderObjects; //For shader deletion
 };
@@ -19,7 +19,10 @@ public:
 	SplashRenderer(const renderer::graphics_lib::videocard_data::ObjectRenderingData &data, const renderer::graphics_lib::videocard_data::ShaderIds &id);
 	~SplashRenderer();
 
-	void render();
+	/*
+	@param[in] progress - loading progress [0; 1] shown as bar
+	*/
+	void render(float progress);
 
 private:
 	renderer::graphics_lib::videocard_data::ObjectRenderingData objectData;
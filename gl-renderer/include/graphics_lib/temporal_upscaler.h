@@ -0,0 +1,83 @@
+/* temporal_upscaler.h
+ * Accumulates jittered frames of reduced resolution into full resolution history
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "graphics_lib/videocard_data/shader_ids.h"
+
+namespace renderer::graphics_lib
+{
+
+/*
+Each frame projection is shifted by a sub-pixel offset, so scaled frames sample different points of the full resolution image.
+Resolve pass reprojects history by camera motion restored from depth, clamps it to the current frame neighbourhood and blends.
+Scene is static apart from waves, so camera motion is the only velocity source.
+*/
+class TemporalUpscaler
+{
+	static constexpr int HISTORY_AMOUNT = 2; //Read previous, write current
+	static constexpr int JITTER_SEQUENCE_LENGTH = 8;
+
+public:
+	TemporalUpscaler(const renderer::graphics_lib::videocard_data::ShaderIds &resolve, int width, int height);
+	~TemporalUpscaler();
+
+	/*
+	@brief Takes the next jitter offset
+	@param[in] scaledWidth, scaledHeight - viewport size of the current frame
+	*/
+	void beginFrame(int scaledWidth, int scaledHeight);
+
+	/*
+	@brief Blends the current frame into history
+	@param[in] sceneTextureId, sceneDepthTextureId - scaled scene target
+	@param[in] renderScale - part of scene target covered by the current frame
+	*/
+	void resolve(unsigned int sceneTextureId, unsigned int sceneDepthTextureId, const glm::vec2 &renderScale);
+
+	void updateCamera(const glm::mat4 &newViewMatrix);
+
+	/*
+	@brief Returns projection shifted by the current jitter offset. For all scene shaders
+	*/
+	const glm::mat4& getJitteredProjection() const;
+
+	/*
+	@brief Returns full resolution result of the last resolve
+	*/
+	unsigned int getResolvedTextureId() const;
+
+private:
+	void initializeBuffers();
+
+
+
+	const int framebufferWidth;
+	const int framebufferHeight;
+
+	unsigned int framebufferIds[HISTORY_AMOUNT];
+	unsigned int textureIds[HISTORY_AMOUNT];
+	int currentHistory;
+	bool isHistoryValid; //There is nothing to reproject in the first frame
+
+	unsigned int quadVaoId = -1u;
+	unsigned int quadVboId = -1u;
+
+	renderer::graphics_lib::videocard_data::ShaderIds resolveShaderId;
+
+	glm::mat4 projection;
+	glm::mat4 jitteredProjection;
+	glm::vec2 jitter; //Scaled pixels
+	int jitterIndex;
+
+	glm::mat4 viewMatrix;
+	glm::mat4 previousViewProjection;
+};
+
+}
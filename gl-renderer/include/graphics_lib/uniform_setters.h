@@ -7,12 +7,19 @@
 
 #pragma once
 
+#include <glm/glm.hpp>
+
 #include "data/scene.h"
 #include "graphics_lib/videocard_data/shader_ids.h"
 
 namespace renderer::graphics_lib
 {
 
+/*
+@brief Returns projection matrix common for all 3D shaders
+*/
+glm::mat4 makeProjectionMatrix(float screenRatio);
+
 void setDirectionalShaderUniforms(renderer::graphics_lib::videocard_data::ShaderIds &shaderId, float screenRatio, const renderer::data::Light &light);
 void setPointShaderUniforms(renderer::graphics_lib::videocard_data::ShaderIds &shaderId, float screenRatio, const renderer::data::Light &light);
 void setGlitterShaderUniforms(renderer::graphics_lib::videocard_data::ShaderIds &shaderId, float materialAlphaX, float materialAlphaY);
@@ -22,5 +29,6 @@ void setStencilPassShaderUniforms(renderer::graphics_lib::videocard_data::Shader
 void setDeferredDirectionalLightPassShaderUniforms(renderer::graphics_lib::videocard_data::ShaderIds &shaderId, float screenWidth, float screenHeight, const renderer::data::Light &light,
 	const renderer::data::Fog &fog);
 void setDeferredPointLightPassShaderUniforms(renderer::graphics_lib::videocard_data::ShaderIds &shaderId, float screenWidth, float screenHeight, const renderer::data::Light &light);
+void setLightClusteringShaderUniforms(renderer::graphics_lib::videocard_data::ShaderIds &shaderId, float screenWidth, float screenHeight);
 
 }
@@ -0,0 +1,165 @@
+/* upload_service.h
+ * Streams data to videocard through persistently mapped staging ring
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+namespace renderer::graphics_lib
+{
+
+/*
+@brief Region of staging ring reserved for one upload
+*/
+struct StagingAllocation
+{
+	char *data = nullptr; //Write upload data here
+	size_t offset = 0; //Offset in staging buffer
+	size_t size = 0;
+	uint64_t sequence = 0;
+};
+
+/*
+Usage:
+	1. Any thread: reserve() space, write data into StagingAllocation::data, then commit copy to target or discard()
+	2. GL thread, once per frame: processUploads() issues copy commands and reclaims finished regions
+Ring regions are reclaimed in reservation order by fences, so the ring is never overwritten while videocard reads it
+*/
+class UploadService
+{
+public:
+	UploadService(size_t ringSize, size_t bytesPerFrame);
+	~UploadService();
+
+	/*
+	@brief Creates and maps staging buffer. Must be called from GL thread
+	*/
+	bool init();
+
+	//----- Any thread -----
+
+	/*
+	@brief Reserves contiguous region of staging ring
+	@return false if ring has no space now or size is bigger than ring
+	*/
+	bool reserve(size_t size, StagingAllocation &allocation);
+
+	/*
+	@brief Queues copy of the whole allocation into buffer. Target buffer must have storage
+	*/
+	void commitBufferCopy(const StagingAllocation &allocation, unsigned int bufferId, size_t targetOffset);
+
+	/*
+	@brief Queues copy of the whole allocation into texture level 0 and mipmap generation. Target texture must have storage
+	@param[in] bytesPerPixel - 3 for BGR, 4 for BGRA
+	*/
+	void commitTextureCopy(const StagingAllocation &allocation, unsigned int textureId, int width, int height, int bytesPerPixel);
+
+	/*
+	@brief Returns allocation to the ring without copying
+	*/
+	void discard(const StagingAllocation &allocation);
+
+	//----- GL thread -----
+
+	/*
+	@brief Reclaims finished regions and issues queued copies within bytes-per-frame limit
+	*/
+	void processUploads();
+
+	/*
+	@brief Issues all queued copies ignoring the limit. Used during loading
+	*/
+	void flush();
+
+	//----- Metrics -----
+
+	void setBytesPerFrameLimit(size_t bytesPerFrame);
+	size_t getBytesPerFrameLimit() const;
+
+	int getQueueDepth(); //Copies waiting to be issued
+	size_t getQueuedBytes();
+	size_t getUsedRingBytes(); //Queued and not yet finished
+	size_t getBytesLastFrame() const; //Copied during the last processUploads() call
+	uint64_t getTotalBytes() const;
+
+private:
+	enum class CopyType
+	{
+		BUFFER,
+		TEXTURE
+	};
+
+	struct CopyRequest
+	{
+		StagingAllocation allocation;
+		CopyType type;
+		unsigned int targetId;
+		size_t targetOffset;
+		int width;
+		int height;
+		int bytesPerPixel;
+	};
+
+	struct Reservation
+	{
+		uint64_t sequence;
+		size_t end; //Tail moves here when reservation is reclaimed
+		size_t consumedBytes; //Size with padding skipped at the ring end
+		uint64_t submitFrame; //0 until copy is issued
+		bool isSubmitted;
+	};
+
+	struct Fence
+	{
+		void *sync; //GLsync
+		uint64_t frame;
+	};
+
+	/*
+	@brief Issues copies from queue
+	@param[in] byteLimit - copying stops after this amount is exceeded, at least one copy is issued
+	*/
+	void issueCopies(size_t byteLimit);
+
+	/*
+	@brief Checks fences and frees ring regions of finished copies
+	*/
+	void reclaim();
+
+	void markSubmitted(uint64_t sequence, uint64_t frame);
+
+
+
+	unsigned int bufferId;
+	char *mappedData;
+
+	size_t ringSize;
+	size_t head;
+	size_t tail;
+	size_t usedBytes;
+
+	std::deque<Reservation> reservations; //In reservation order
+	std::deque<CopyRequest> copyQueue; //In commit order
+	std::deque<Fence> fences;
+
+	uint64_t nextSequence;
+	uint64_t currentFrame;
+	uint64_t completedFrame;
+
+	size_t bytesPerFrameLimit;
+	size_t queuedBytes;
+	size_t bytesLastFrame;
+	uint64_t totalBytes;
+
+	std::mutex accessLock;
+};
+
+}
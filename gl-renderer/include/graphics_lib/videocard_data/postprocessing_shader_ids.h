@@ -18,6 +18,9 @@ struct PostprocessingShaderIds
 
 	unsigned int unifTextureId = -1u; //Framebuffer ID
 
+	bool isCompute = false; //Tiled compute shader writing to image instead of fullscreen quad
+	unsigned int unifResultImageId = -1u; //Compute shaders only
+
 	//Shader-specific
 	unsigned int unifScreenRatio = -1u; //Vignette and Drops on Lens
 	unsigned int unifScreenWidthHeight = -1u; //Emboss
@@ -42,11 +42,32 @@ struct ShaderIds
 	unsigned int unifFogColour = -1u; //Fog
 
 	//Deferred
-	unsigned int unifPositionComponentId = -1u;
+	unsigned int unifDepthComponentId = -1u;
 	unsigned int unifNormalComponentId = -1u;
 	unsigned int unifDiffuseComponentId = -1u;
 	unsigned int unifScreenSize = -1u;
 	unsigned int unifLightParameters = -1u;
+	unsigned int unifInverseProjection = -1u; //Position reconstruction from depth
+	unsigned int unifInverseView = -1u;
+
+	//Clustered lights
+	unsigned int unifClusterDepthRange = -1u;
+	unsigned int unifLightAmount = -1u;
+
+	//Weighted blended transparency
+	unsigned int unifAccumulationId = -1u;
+	unsigned int unifRevealageId = -1u;
+
+	//Dynamic resolution upscaling
+	unsigned int unifSceneTextureId = -1u;
+	unsigned int unifRenderScale = -1u;
+	unsigned int unifSharpness = -1u;
+
+	//Temporal upscaling
+	unsigned int unifHistoryTextureId = -1u;
+	unsigned int unifJitter = -1u;
+	unsigned int unifReprojection = -1u;
+	unsigned int unifHistoryWeight = -1u;
 
 	//2D shader
 
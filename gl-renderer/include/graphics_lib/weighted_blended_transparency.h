@@ -0,0 +1,70 @@
+/* weighted_blended_transparency.h
+ * Order-independent transparency: accumulation and revealage targets with composite pass
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include "graphics_lib/videocard_data/shader_ids.h"
+
+namespace renderer::graphics_lib
+{
+
+/*
+Transparent meshes are drawn in any order with shaders compiled with FEATURE_WEIGHTED_BLENDED_OIT.
+Each fragment adds its weighted premultiplied colour to accumulation target and multiplies revealage by (1 - alpha).
+Composite pass divides accumulated colour by accumulated alpha and blends it over opaque scene.
+*/
+class WeightedBlendedTransparency
+{
+	static constexpr int TOTAL_TEXTURES = 2;
+
+	static constexpr int TEXTURE_INDEX_ACCUMULATION = 0; //RGBA16F
+	static constexpr int TEXTURE_INDEX_REVEALAGE = 1; //R8
+
+public:
+	WeightedBlendedTransparency(const renderer::graphics_lib::videocard_data::ShaderIds &composite, int width, int height);
+	~WeightedBlendedTransparency();
+
+	/*
+	@brief Copies opaque depth from currently bound framebuffer and binds accumulation targets. Depth writes are disabled
+	Bound framebuffer must have 24-bit depth with 8-bit stencil and the same size, it may be multisampled.
+	Otherwise depth isn't copied and transparent meshes aren't hidden by opaque ones
+	*/
+	void beginAccumulation();
+
+	/*
+	@brief Blends accumulated transparent meshes over framebuffer that was bound before beginAccumulation()
+	*/
+	void composite();
+
+private:
+	void initializeBuffer();
+
+	/*
+	@brief Checks that depth can be blitted from target framebuffer
+	*/
+	bool isTargetDepthCompatible() const;
+
+
+
+	const int framebufferWidth;
+	const int framebufferHeight;
+
+	unsigned int framebufferId = -1u;
+	unsigned int textureIds[TOTAL_TEXTURES];
+	unsigned int depthTextureId = -1u; //Copy of opaque depth, transparent fragments are tested against it
+
+	unsigned int quadVaoId = -1u;
+	unsigned int quadVboId = -1u;
+
+	int targetFramebufferId; //Screen or postprocessing framebuffer
+	int checkedFramebufferId; //Target which depth format was checked last
+	bool canBlitDepth;
+
+	renderer::graphics_lib::videocard_data::ShaderIds compositeShaderId;
+};
+
+}
@@ -0,0 +1,94 @@
+/* asset_archive.h
+ * Packed archive with meshes, textures and terrain chunks. Read through memory mapping
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "loaders/file_mapping.h"
+
+namespace renderer::loaders
+{
+
+/*
+Archive layout:
+	ArchiveHeader
+	ArchiveIndexEntry[entryAmount], sorted by name hash
+	Entry names without '\0'
+	Entry data blobs, each aligned to ARCHIVE_BLOB_ALIGNMENT
+Entry name is the original file path (as written in description files)
+*/
+
+struct ArchiveHeader
+{
+	char signature[8];
+	uint32_t version;
+	uint32_t entryAmount;
+	uint64_t indexOffset;
+	uint64_t namesOffset;
+};
+
+struct ArchiveIndexEntry
+{
+	uint64_t nameHash;
+	uint64_t dataOffset;
+	uint64_t dataSize;
+	uint32_t nameOffset; //Relative to ArchiveHeader::namesOffset
+	uint32_t nameLength;
+};
+
+class AssetArchive
+{
+public:
+	AssetArchive();
+	~AssetArchive();
+
+	/*
+	@brief Maps archive into memory and validates its index
+	*/
+	bool open(const std::string &path);
+
+	/*
+	@brief Finds file data in archive. Data is valid while archive is alive
+	@param[in] name - original file path
+	@param[out] data - pointer to mapped file data
+	@param[out] size - file size
+	@return false if there is no such file
+	*/
+	bool getEntry(const std::string &name, const char **data, size_t &size) const;
+
+	int getEntryAmount() const;
+
+private:
+	FileMapping mapping;
+
+	const ArchiveIndexEntry *index;
+	const char *names;
+	int entryAmount;
+};
+
+/*
+@brief Read-only stream buffer over memory block, e.g. archive entry. Doesn't copy data
+*/
+class MemoryStreamBuffer: public std::streambuf
+{
+public:
+	MemoryStreamBuffer(const char *data, size_t size);
+
+protected:
+	pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override;
+	pos_type seekpos(pos_type position, std::ios_base::openmode which) override;
+};
+
+/*
+@brief Packs files into archive. File paths become entry names
+*/
+bool writeAssetArchive(const std::string &path, const std::vector<std::string> &files);
+
+}
@@ -0,0 +1,80 @@
+/* background_loader.h
+ * Runs file reading on worker threads and videocard transfers in time slices on the calling thread
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace renderer::loaders
+{
+
+class BackgroundLoader
+{
+public:
+	BackgroundLoader();
+	~BackgroundLoader();
+
+	/*
+	@brief Adds task. Must be called before start()
+	@param[in] load - reading part, runs on worker thread
+	@param[in] submit - transfer part, runs in processLoaded() after load part succeeds
+	*/
+	void addTask(std::function<bool()> load, std::function<bool()> submit);
+
+	/*
+	@brief Starts worker threads
+	*/
+	void start(int threadAmount);
+
+	/*
+	@brief Runs transfer parts of loaded tasks until time budget is spent. Waits for loaded tasks within budget
+	*/
+	void processLoaded(std::chrono::microseconds budget);
+
+	bool isFinished() const;
+
+	/*
+	@return [0; 1], reading and transfer parts have equal weights
+	*/
+	float getProgress() const;
+
+	int getFailedAmount() const;
+
+private:
+	struct Task
+	{
+		std::function<bool()> load;
+		std::function<bool()> submit;
+	};
+
+	void runWorker();
+
+	void stopWorkers();
+
+
+
+	std::vector<Task> tasks;
+	std::vector<std::thread> workers;
+
+	std::deque<int> loadedTasks; //Indices of tasks ready for transfer
+	std::mutex accessLock;
+	std::condition_variable loadedCondition;
+
+	std::atomic<int> nextTaskIndex;
+	std::atomic<int> loadedAmount;
+	std::atomic<int> submittedAmount;
+	std::atomic<int> failedAmount;
+	std::atomic<bool> needTerminate;
+};
+
+}
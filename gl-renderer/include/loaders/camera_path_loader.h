@@ -0,0 +1,26 @@
+/* camera_path_loader.h
+ * Loads and saves camera path for replays and benchmarks
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <string>
+
+#include "data/camera_path.h"
+
+namespace renderer::loaders
+{
+
+/*
+@brief Loads camera path from given file
+*/
+bool loadCameraPath(const std::string &path, renderer::data::CameraPath &cameraPath);
+
+/*
+@brief Saves camera path in the format read by loadCameraPath
+*/
+bool saveCameraPath(const std::string &path, const renderer::data::CameraPath &cameraPath);
+
+}
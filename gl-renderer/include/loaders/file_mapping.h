@@ -0,0 +1,39 @@
+/* file_mapping.h
+ * Maps file into memory for reading. Implementation is platform-specific
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace renderer::loaders
+{
+
+class FileMapping
+{
+public:
+	FileMapping();
+	~FileMapping();
+
+	FileMapping(const FileMapping&) = delete;
+	FileMapping& operator=(const FileMapping&) = delete;
+
+	/*
+	@brief Maps the whole file as read-only memory
+	*/
+	bool open(const std::string &path);
+
+	void close();
+
+	const char* getData() const;
+	size_t getSize() const;
+
+private:
+	const char *data;
+	size_t size;
+};
+
+}
@@ -0,0 +1,37 @@
+/* load_timing.h
+ * Maps whole files into memory and keeps time the calling thread spent on file reading and decoding
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace renderer::loaders
+{
+
+struct LoadTimes
+{
+	std::chrono::steady_clock::duration readTime = std::chrono::steady_clock::duration::zero();
+	std::chrono::steady_clock::duration decodeTime = std::chrono::steady_clock::duration::zero(); //Including reading of mapped archive pages
+};
+
+/*
+@brief Returns times of the calling thread accumulated since the last reset
+*/
+LoadTimes getLoadTimes();
+
+void resetLoadTimes();
+
+void addDecodeTime(std::chrono::steady_clock::duration time);
+
+/*
+@brief Maps the whole file and reads every its page, so decoding doesn't wait for disk. Time is added to file reading time of the calling thread
+@param[out] data - mapping of the calling thread, valid until its next call. Data isn't copied, decoding copies it once as stream reading did
+*/
+bool readWholeFile(const std::string &path, const char **data, size_t &size);
+
+}
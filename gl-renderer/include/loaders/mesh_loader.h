@@ -6,18 +6,47 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #include "data/mesh.h"
 #include "data/object_file_paths.h"
+#include "loaders/asset_archive.h"
 
 namespace renderer::loaders
 {
 
 /*
-@brief Reads mesh from file
+Mesh arrays inside file data, as they are stored in mesh file. Absent arrays have zero size
 */
-bool loadMesh(const std::string &path, renderer::data::Mesh &mesh);
+struct MeshFileArrays
+{
+	const char *vertices = nullptr;
+	const char *uvs = nullptr;
+	const char *normals = nullptr;
+	const char *tangent = nullptr;
+	const char *bitangent = nullptr;
+
+	//Sizes in bytes
+	size_t vertexSize = 0;
+	size_t uvSize = 0;
+	size_t normalSize = 0;
+	size_t tangentSize = 0; //Bitangent has the same size
+
+	int floatsPerVertex = 0;
+};
+
+/*
+@brief Reads mesh from archive if it has the file, otherwise from file
+@param[in] archive - can be nullptr
+*/
+bool loadMesh(const std::string &path, const AssetArchive *archive, renderer::data::Mesh &mesh);
+
+/*
+@brief Finds mesh arrays in archive entry or mapped file without copying, so they can be decoded straight to their destination
+@param[out] arrays - valid until the next file reading by the calling thread, see readWholeFile()
+*/
+bool mapMesh(const std::string &path, const AssetArchive *archive, MeshFileArrays &arrays);
 
 bool loadObjectDescription(const std::string &path, std::map<std::string, renderer::data::ObjectFilePaths> &description);
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 
 namespace renderer::loaders
@@ -17,4 +18,10 @@ namespace renderer::loaders
 */
 bool loadShader(const std::string &path, std::string &code);
 
+/*
+@brief Reads shader from file and inserts "#define" lines right after "#version" directive
+@param[in] defines - macro names without "#define", a value can follow the name after space
+*/
+bool loadShaderWithDefines(const std::string &path, const std::vector<std::string> &defines, std::string &code);
+
 }
\ No newline at end of file
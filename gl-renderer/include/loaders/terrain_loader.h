@@ -12,21 +12,28 @@
 #include "data/heightmap.h"
 #include "data/mesh.h"
 #include "data/terrain_file_paths.h"
+#include "loaders/asset_archive.h"
 
 namespace renderer::loaders
 {
 
 /*
-@brief Reads terrain from file
+@brief Reads terrain from archive if it has the file, otherwise from file
 @param[in] path - path to file
+@param[in] archive - can be nullptr
 @param[out] chunk - structure to store data
 @param[out] heightmap - heights for all vertices
 @param[out] sideLength - chunk side length
 */
-bool loadTerrain(const std::string &path, renderer::data::Mesh &chunk, renderer::data::Heightmap &heightmap, float &sideLength);
+bool loadTerrain(const std::string &path, const AssetArchive *archive, renderer::data::Mesh &chunk, renderer::data::Heightmap &heightmap, float &sideLength);
 
 bool loadTerrainDescription(const std::string &path, std::map<std::string, renderer::data::TerrainFilePaths> &description);
 
-float readChunkDimensions(const std::string &path);
+/*
+@brief Writes description in the format read by loadTerrainDescription
+*/
+bool saveTerrainDescription(const std::string &path, const std::map<std::string, renderer::data::TerrainFilePaths> &description);
+
+float readChunkDimensions(const std::string &path, const AssetArchive *archive);
 
 }
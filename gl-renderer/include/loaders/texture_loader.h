@@ -6,16 +6,38 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #include "data/texture.h"
+#include "loaders/asset_archive.h"
 
 namespace renderer::loaders
 {
 
 /*
-@brief Loads texture from file
+Pixels inside file data. Rows are bottom to top, BGR or BGRA as videocard reads them
 */
-bool loadTexture(const std::string &path, renderer::data::Texture &texture);
+struct TextureFilePixels
+{
+	const char *data = nullptr;
+	size_t size = 0; //Rows are padded to 4 bytes as in file, it matches default unpack alignment
+
+	int width = 0;
+	int height = 0;
+	int bytesPerPixel = 0;
+};
+
+/*
+@brief Loads texture from archive if it has the file, otherwise from file
+@param[in] archive - can be nullptr
+*/
+bool loadTexture(const std::string &path, const AssetArchive *archive, renderer::data::Texture &texture);
+
+/*
+@brief Finds pixels in archive entry or mapped file without copying, so they can be decoded straight to their destination
+@param[out] pixels - valid until the next file reading by the calling thread, see readWholeFile()
+*/
+bool mapTexture(const std::string &path, const AssetArchive *archive, TextureFilePixels &pixels);
 
 }
\ No newline at end of file
@@ -12,9 +12,12 @@
 
 #include "thirdparty/glfw_tools.h" //GLFW must be included after GLEW
 #include "app_parameters.h"
+#include "benchmark_core.h"
 #include "editor_core.h"
 #include "graphics_lib/shader_manager.h"
 #include "graphics_lib/splash_renderer_builder.h"
+#include "graphics_lib/upload_service.h"
+#include "loaders/asset_archive.h"
 #include "managers/object_manager.h"
 #include "managers/particle_manager.h"
 #include "managers/scene_manager.h"
@@ -50,10 +53,19 @@ public:
 	void run();
 
 private:
+	/*
+	@brief Reads scene chunks and objects on worker threads while splash with progress is shown
+	*/
+	void loadSceneResources();
+
+
+
 	//Dispatching
 	std::unique_ptr<renderer::Core> core;
 
 	//Resources
+	std::unique_ptr<renderer::loaders::AssetArchive> assetArchive;
+	std::unique_ptr<renderer::graphics_lib::UploadService> uploadService;
 	std::unique_ptr<renderer::managers::SceneManager> sceneManager;
 	std::unique_ptr<renderer::managers::TerrainManager> terrainManager;
 	std::unique_ptr<renderer::managers::ObjectManager> objectManager;
@@ -62,6 +74,8 @@ private:
 	std::unique_ptr<renderer::graphics_lib::ShaderManager> shaderManager;
 
 	std::unique_ptr<renderer::graphics_lib::SplashRenderer> splashRenderer;
+
+	renderer::data::CameraPath cameraPath; //Benchmark mode only
 public:
 	GLFWwindow *window;
 	private:
@@ -12,6 +12,8 @@
 
 #include "data/object_file_paths.h"
 #include "graphics_lib/videocard_data/object_rendering_data.h"
+#include "loaders/asset_archive.h"
+#include "managers/resource_cache.h"
 
 namespace renderer::managers
 {
@@ -19,7 +21,11 @@ namespace renderer::managers
 class ObjectManager
 {
 public:
-	ObjectManager(const std::string &descriptionPath);
+	/*
+	@param[in] archive - packed files to be used instead of separate ones. Can be nullptr
+	@param[in] uploadService - staging ring for transfers to videocard. Can be nullptr
+	*/
+	ObjectManager(const std::string &descriptionPath, const renderer::loaders::AssetArchive *archive, renderer::graphics_lib::UploadService *uploadService);
 	~ObjectManager();
 
 	/*
@@ -36,7 +42,11 @@ public:
 	*/
 	bool getRenderingDataWithClonedVbo(const std::string &name, renderer::graphics_lib::videocard_data::ObjectRenderingData &data);
 
-	int getTransferedBytesAmount();
+	/*
+	@brief Reads object files without transfer to videocard. Can be called from loader threads
+	@param[in] name - object name
+	*/
+	bool preloadObjectData(const std::string &name);
 
 	bool isTextureTransparent(const std::string &name);
 
@@ -70,7 +80,7 @@ private:
 	std::vector<unsigned int> clonedVaos;
 	std::map<std::string, renderer::data::ObjectFilePaths> description;
 
-	int transferedBytes; //How many bytes transfered to videocard
+	ResourceCache resourceCache; //Meshes and textures shared between objects
 };
 
 }
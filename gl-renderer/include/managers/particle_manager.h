@@ -30,8 +30,6 @@ public:
 	*/
 	bool getRenderingData(const renderer::data::ParticleSet &particleSet, const renderer::data::ChunkData &chunk, renderer::graphics_lib::videocard_data::ParticleRenderingData &data);
 
-	int getTransferedBytesAmount();
-
 private:
 	/*
 	@brief Initializes particle positions and rotations
@@ -43,8 +41,6 @@ private:
 
 	std::vector<renderer::graphics_lib::videocard_data::ParticleRenderingData> groupIds;
     renderer::managers::TerrainManager *terrainManager;
-
-    int transferedBytes; //How many bytes transfered to videocard
 };
 
 }
@@ -0,0 +1,166 @@
+/* resource_cache.h
+ * Shares meshes and textures between objects. Resources are found by file path or content hash and counted by references
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "data/mesh.h"
+#include "data/texture.h"
+#include "graphics_lib/operations/mesh_operations.h"
+#include "graphics_lib/operations/texture_operations.h"
+#include "graphics_lib/upload_service.h"
+#include "graphics_lib/videocard_data/object_rendering_data.h"
+#include "loaders/asset_archive.h"
+
+namespace renderer::managers
+{
+
+class ResourceCache
+{
+public:
+	/*
+	@param[in] archive - packed files to be used instead of separate ones. Can be nullptr
+	@param[in] uploader - staging ring for transfers to videocard. Can be nullptr
+	*/
+	ResourceCache(const renderer::loaders::AssetArchive *archive, renderer::graphics_lib::UploadService *uploader);
+	~ResourceCache();
+
+	/*
+	@brief Reads mesh file and decodes it into staging ring without transfer to videocard. Thread-safe, each path is read once
+	*/
+	bool preloadMesh(const std::string &path);
+
+	/*
+	@brief Reads texture file and decodes it into staging ring without transfer to videocard. Thread-safe, each path is read once
+	*/
+	bool preloadTexture(const std::string &path);
+
+	/*
+	@brief Loads mesh and transfers it to videocard if the same mesh isn't there yet. Preloaded data is used if exists
+	@param[in] path - mesh file path
+	@param[out] meshIds - VAO, VBOs and vertex amount are filled, textures are untouched
+	*/
+	bool acquireMesh(const std::string &path, renderer::graphics_lib::videocard_data::ObjectRenderingData &meshIds);
+
+	/*
+	@brief Loads texture and transfers it to videocard if the same texture isn't there yet. Preloaded data is used if exists
+	@param[in] path - texture file path
+	@param[out] textureId - texture ID on videocard
+	@param[out] bytesPerPixel - 3 or 4
+	*/
+	bool acquireTexture(const std::string &path, unsigned int &textureId, int &bytesPerPixel);
+
+	/*
+	@brief Decrements mesh reference counter. Mesh is deleted from videocard with the last reference
+	@param[in] vaoId - VAO returned by acquireMesh
+	*/
+	void releaseMesh(unsigned int vaoId);
+
+	/*
+	@brief Decrements texture reference counter. Texture is deleted from videocard with the last reference
+	*/
+	void releaseTexture(unsigned int textureId);
+
+private:
+	struct CachedMesh
+	{
+		renderer::graphics_lib::videocard_data::ObjectRenderingData meshIds;
+		int references;
+		std::string path; //The first file with this content, reread to check content on hash match
+	};
+
+	struct CachedTexture
+	{
+		unsigned int textureId;
+		int bytesPerPixel;
+		int references;
+		std::string path;
+	};
+
+	/*
+	Mesh decoded into staging ring, or into memory if ring has no space
+	*/
+	struct LoadedMesh
+	{
+		renderer::graphics_lib::operations::StagedMesh stagedMesh;
+		renderer::data::Mesh mesh;
+		bool isStaged = false;
+		uint64_t hash = 0; //Computed from file data, staging ring isn't readable
+	};
+
+	struct LoadedTexture
+	{
+		renderer::graphics_lib::operations::StagedTexture stagedTexture;
+		renderer::data::Texture texture;
+		bool isStaged = false;
+		uint64_t hash = 0;
+	};
+
+	/*
+	@brief Reads mesh file and decodes it. Thread-safe
+	*/
+	bool decodeMesh(const std::string &path, LoadedMesh &loaded);
+
+	/*
+	@brief Reads texture file and decodes it. Thread-safe
+	*/
+	bool decodeTexture(const std::string &path, LoadedTexture &loaded);
+
+	/*
+	@brief Takes preloaded mesh. Waits if it's being read by another thread
+	@return false if mesh wasn't preloaded
+	*/
+	bool takePreloadedMesh(const std::string &path, LoadedMesh &loaded);
+
+	/*
+	@brief Takes preloaded texture. Waits if it's being read by another thread
+	@return false if texture wasn't preloaded
+	*/
+	bool takePreloadedTexture(const std::string &path, LoadedTexture &loaded);
+
+	/*
+	@brief Finds key of cached mesh with the same content. On hash match both files are compared, colliding mesh gets the next free key
+	@param[in] path - file of the mesh
+	@param[out] isCached - true if the same mesh is on videocard
+	*/
+	uint64_t findMeshKey(uint64_t hash, const std::string &path, bool &isCached);
+
+	/*
+	@brief Same as above for texture
+	*/
+	uint64_t findTextureKey(uint64_t hash, const std::string &path, bool &isCached);
+
+
+
+	//Content key is hash of data mixed with its size, incremented on collision
+	std::unordered_map<std::string, uint64_t> meshKeyByPath;
+	std::unordered_map<unsigned int, uint64_t> meshKeyByVao;
+	std::unordered_map<uint64_t, CachedMesh> meshes;
+
+	std::unordered_map<std::string, uint64_t> textureKeyByPath;
+	std::unordered_map<unsigned int, uint64_t> textureKeyById;
+	std::unordered_map<uint64_t, CachedTexture> textures;
+
+	//Data read by loader threads, guarded by preloadLock
+	std::unordered_map<std::string, LoadedMesh> preloadedMeshes;
+	std::unordered_map<std::string, LoadedTexture> preloadedTextures;
+	std::unordered_set<std::string> requestedMeshPaths;
+	std::unordered_set<std::string> requestedTexturePaths;
+	std::unordered_set<std::string> pendingPaths; //Being read now
+	std::mutex preloadLock;
+	std::condition_variable preloadCondition;
+
+	const renderer::loaders::AssetArchive *assetArchive; //Non-owning pointer
+	renderer::graphics_lib::UploadService *uploadService; //Non-owning pointer
+};
+
+}
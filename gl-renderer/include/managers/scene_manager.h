@@ -37,11 +37,21 @@ public:
 	bool isPostprocessingRequired() const;
 	const std::string& getPostprocessingEffect() const;
 	bool isDeferredRendering() const;
+	bool isForwardPlusRendering() const;
+	bool isDepthPrepassEnabled() const;
+	bool isWeightedBlendedTransparency() const;
 
 	//----- Setters -----
 
 	void appendChunkDimensions(renderer::managers::TerrainManager *terrainManager);
 
+	/*
+	@brief Replaces scene point lights with lights scattered above terrain. Placement is the same on every run
+	@param[in] amount - light amount
+	@param[in] terrainManager - must have heightmaps of scene chunks
+	*/
+	void generatePointLights(int amount, renderer::managers::TerrainManager *terrainManager);
+
 private:
 	void initialize(const std::string &scenePath);
 
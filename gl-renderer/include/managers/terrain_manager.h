@@ -7,11 +7,15 @@
 #pragma once
 
 #include <map>
+#include <mutex>
 #include <string>
 
 #include "data/heightmap.h"
+#include "data/mesh.h"
+#include "data/texture.h"
 #include "data/terrain_file_paths.h"
 #include "graphics_lib/videocard_data/object_rendering_data.h"
+#include "loaders/asset_archive.h"
 
 namespace renderer::managers
 {
@@ -19,11 +23,26 @@ namespace renderer::managers
 class TerrainManager
 {
 public:
-	TerrainManager(const std::string &descriptionPath);
+	/*
+	@param[in] archive - packed files to be used instead of separate ones. Can be nullptr
+	*/
+	TerrainManager(const std::string &descriptionPath, const renderer::loaders::AssetArchive *archive);
 	~TerrainManager();
 
 	float getChunkDimensions(const std::string &chunkName);
 
+	/*
+	@brief Reads chunk files without transfer to videocard. Can be called from loader threads
+	@param[in] name - chunk name
+	*/
+	bool preloadChunk(const std::string &name);
+
+	/*
+	@brief Reads only chunk heightmap and dimensions, nothing is transfered to videocard. For height queries in tools without OpenGL context
+	@param[in] name - chunk name
+	*/
+	bool loadHeightmap(const std::string &name);
+
 	/*
 	@brief Initializes structure needed for chunk rendering
 	@param[in] name - chunk name
@@ -42,9 +61,15 @@ public:
 	*/
 	float getHeight(float xOffset, float zOffset, const std::string &chunkName, float xCoord, float zCoord);
 
-	int getTransferedBytesAmount() const;
-
 private:
+	struct PreloadedChunk
+	{
+		renderer::data::Mesh mesh;
+		renderer::data::Heightmap heightmap;
+		renderer::data::Texture texture;
+		float sideLength;
+	};
+
 	/*
 	@brief Loads descriptions from file
 	*/
@@ -62,7 +87,10 @@ private:
 	std::map<std::string, float> dimensions;
 	std::map<std::string, renderer::data::TerrainFilePaths> description;
 
-	int transferedBytes;
+	std::map<std::string, PreloadedChunk> preloadedChunks;
+	std::mutex preloadLock;
+
+	const renderer::loaders::AssetArchive *assetArchive; //Non-owning pointer
 };
 
 }
@@ -0,0 +1,125 @@
+/* profiler.h
+ * CPU profiler with scoped zones, implemented as Singleton. Capture is exported as Chrome trace
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+Zones are compiled only with RENDERER_PROFILING defined (Debug target), otherwise the macros are empty.
+Zone name must be a string literal, only the pointer is stored. Functions are named with class or namespace, e.g. "Core::processUserInputs",
+so zones of equally named functions don't merge.
+*/
+#ifdef RENDERER_PROFILING
+	#define PROFILER_CONCATENATE_IMPL(first, second) first##second
+	#define PROFILER_CONCATENATE(first, second) PROFILER_CONCATENATE_IMPL(first, second)
+
+	#define PROFILE_ZONE(name) renderer::ProfilerZone PROFILER_CONCATENATE(profilerZone, __LINE__)(name)
+	#define PROFILE_THREAD_NAME(name) renderer::Profiler::getInstance().setThreadName(name)
+#else
+	#define PROFILE_ZONE(name)
+	#define PROFILE_THREAD_NAME(name)
+#endif
+
+namespace renderer
+{
+
+/*
+Every thread writes to its own ring of events, so recording takes no locks. A lock is taken only once per thread, when its ring is created.
+Rings of finished threads are kept until exit, so loader workers are present in the capture.
+Recording is paused during export, events finished meanwhile are dropped.
+*/
+class Profiler
+{
+	static constexpr uint64_t THREAD_EVENT_CAPACITY = 1 << 16; //Oldest events are overwritten
+
+	struct ProfilerEvent
+	{
+		const char *name;
+		uint64_t startTime; //Nanoseconds from profiler creation
+		uint64_t duration;
+	};
+
+	struct ThreadEvents
+	{
+		int threadIndex;
+		std::atomic<const char*> threadName;
+		std::unique_ptr<ProfilerEvent[]> events;
+		std::atomic<uint64_t> writtenAmount; //Only the owning thread writes
+		std::atomic<bool> isWriting; //Set while the owning thread writes an event, export waits for it
+	};
+
+public:
+	static Profiler& getInstance();
+
+	/*
+	@brief Returns nanoseconds from profiler creation
+	*/
+	uint64_t getTime() const;
+
+	/*
+	@brief Records finished zone of the calling thread
+	*/
+	void addEvent(const char *name, uint64_t startTime, uint64_t endTime);
+
+	/*
+	@brief Sums durations of the calling thread zones which started after given time, by zone name. Other threads aren't read, they may write meanwhile
+	@param[in] sinceTime - nanoseconds from profiler creation
+	@param[out] zoneTimes - zone names in order of the first appearance and their total time, milliseconds
+	*/
+	void getThreadZoneTimes(uint64_t sinceTime, std::vector<std::pair<const char*, float>> &zoneTimes) const;
+
+	/*
+	@brief Names the calling thread in capture
+	*/
+	void setThreadName(const char *name);
+
+	/*
+	@brief Writes all recorded events in Chrome trace format, readable by chrome://tracing and Perfetto
+	*/
+	bool exportChromeTrace(const std::string &path);
+
+private:
+	Profiler();
+	~Profiler();
+
+	/*
+	@brief Returns ring of the calling thread, creates it on the first call
+	*/
+	ThreadEvents* getThreadEvents();
+
+
+
+	const std::chrono::steady_clock::time_point creationTime;
+
+	std::mutex registrationLock;
+	std::vector<std::unique_ptr<ThreadEvents>> threadEvents;
+
+	std::atomic<bool> isPaused;
+};
+
+/*
+Measures time from construction to destruction
+*/
+class ProfilerZone
+{
+public:
+	explicit ProfilerZone(const char *zoneName);
+	~ProfilerZone();
+
+private:
+	const char *name;
+	uint64_t startTime;
+};
+
+}
@@ -13,4 +13,9 @@ namespace renderer::simulation
 
 void performSimulation(SimulationModel &model, bool &needTerminate);
 
+/*
+@brief Computes day and night state for given time since simulation start. Used by simulation thread and by replay clock
+*/
+void simulateAtTime(SimulationModel &model, double seconds);
+
 }
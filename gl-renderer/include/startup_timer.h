@@ -0,0 +1,90 @@
+/* startup_timer.h
+ * Startup phase timing, implemented as Singleton. Phases are logged as a tree and appended to report file
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace renderer
+{
+
+/*
+A phase begun while another one is active becomes its child. Phases are begun and ended by the main thread.
+Loader threads add time to groups of the active phase, so group time is a sum over threads and may exceed wall time of the phase.
+Recording stops after finish(), later calls are ignored, e.g. shader compilation in editor.
+*/
+class StartupTimer
+{
+	struct Phase
+	{
+		std::string name;
+		int parent; //-1 for top level phase
+		std::chrono::steady_clock::time_point start;
+		std::chrono::steady_clock::duration time;
+		int callAmount;
+		bool isSummed; //Added by addTime(), not measured as wall time
+	};
+
+public:
+	static StartupTimer& getInstance();
+
+	void beginPhase(const std::string &name);
+	void endPhase();
+
+	/*
+	@brief Adds time to a group of the active phase. Can be called from loader threads
+	@param[in] group - child of the active phase, e.g. resource type
+	@param[in] name - child of the group, e.g. loading step. Can be empty, then time is added to the group only
+	*/
+	void addTime(const std::string &group, const std::string &name, std::chrono::steady_clock::duration time);
+
+	/*
+	@brief Ends all active phases, logs the tree and appends it to report as a single JSON line, so cold and warm cache runs are kept together
+	@param[in] scenePath - tells runs apart in report
+	*/
+	void finish(const std::string &reportPath, const std::string &scenePath);
+
+private:
+	StartupTimer();
+
+	/*
+	@brief Returns index of parent child with given name, adds it if there is no such child
+	*/
+	int findOrAddChild(int parent, const std::string &name, bool isSummed);
+
+	void endActivePhase();
+
+	void logPhase(int index, int depth) const;
+
+	/*
+	@param[in] path - names of parent phases separated with '/'
+	*/
+	void writePhase(std::ofstream &data, int index, const std::string &path, bool &isFirst) const;
+
+
+
+	std::vector<Phase> phases;
+	std::vector<int> activePhases; //Innermost is the last
+
+	std::mutex phaseLock;
+	bool isFinished;
+};
+
+/*
+Begins phase on construction, ends it on destruction
+*/
+class StartupPhase
+{
+public:
+	explicit StartupPhase(const std::string &name);
+	~StartupPhase();
+};
+
+}
@@ -0,0 +1,25 @@
+/* camera_path_tools.h
+ * Camera pose computation along a path
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include "data/camera_path.h"
+
+namespace renderer::utils
+{
+
+/*
+@brief Interpolates camera pose between keyframes with Catmull-Rom spline. Time out of path is clamped to its ends
+@param[in] time - seconds from path start
+*/
+void sampleCameraPath(const renderer::data::CameraPath &cameraPath, float time, renderer::data::CameraKeyframe &pose);
+
+/*
+@brief Returns time of the last keyframe, seconds
+*/
+float getCameraPathDuration(const renderer::data::CameraPath &cameraPath);
+
+}
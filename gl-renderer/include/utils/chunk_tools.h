@@ -8,6 +8,9 @@
 
 #include <vector>
 
+#include <glm/glm.hpp>
+
+#include "data/chunk_margins.h"
 #include "data/scene.h"
 
 namespace renderer::utils
@@ -18,4 +21,17 @@ namespace renderer::utils
 */
 void findChunk(std::vector<renderer::data::ChunkData> &chunks, float x, float z, int &chunkIndex);
 
+/*
+@brief Returns quad index for given coordinates
+*/
+int findQuad(const renderer::data::ChunkMargins &margins, float x, float z);
+
+/*
+@brief Makes model and rotation matrices of instances and sorts them by chunk quads
+@param[in] positions - x, y, z, rotation angle for each instance
+@param[out] arrangement - 4 arrays of model matrices, one per quad
+@param[out] rotation - 4 arrays of rotation matrices, one per quad
+*/
+void arrangeInstances(const std::vector<float> &positions, const renderer::data::ChunkMargins &margins, std::vector<glm::mat4> *arrangement, std::vector<glm::mat3> *rotation);
+
 }
@@ -0,0 +1,26 @@
+/* hash_tools.h
+ * Non-cryptographic hashes for names and data blocks
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace renderer::utils
+{
+
+/*
+@brief FNV-1a hash. Suits short strings, e.g. names and paths
+*/
+uint64_t hashString(const char *data, size_t length);
+
+/*
+@brief Hashes large memory blocks 8 bytes per step
+@param[in] seed - previous hash to chain several blocks
+*/
+uint64_t hashData(const void *data, size_t size, uint64_t seed);
+
+}
@@ -0,0 +1,19 @@
+/* json_tools.h
+ * Helpers for JSON reports
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <string>
+
+namespace renderer::utils
+{
+
+/*
+@brief Escapes string to be put between quotes in JSON. Control characters are written as escape sequences
+*/
+std::string escapeJsonString(const std::string &str);
+
+}
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <glm/vec3.hpp>
 
 namespace renderer::utils
@@ -18,4 +20,18 @@ glm::vec3 slerp(const glm::vec3 &vector1, const glm::vec3 &vector2, float t);
 */
 float computeBoundingSphereRadius(float lightPower);
 
+/*
+@brief Returns element of low-discrepancy Halton sequence, in [0, 1)
+@param[in] index - element index, starting from 1
+@param[in] base - prime number, different for each dimension
+*/
+float computeHaltonValue(int index, int base);
+
+/*
+@brief Returns value below which the given part of values lies, nearest rank method
+@param[in] sortedValues - values sorted in ascending order, not empty
+@param[in] percentile - [0, 100]
+*/
+float computePercentile(const std::vector<float> &sortedValues, float percentile);
+
 }
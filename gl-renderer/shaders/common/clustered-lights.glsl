@@ -0,0 +1,61 @@
+//Point lights from light clusters for forward shading. ShaderManager appends this file to fragment shaders with FEATURE_CLUSTERED_LIGHTS,
+//host shader declares "uniform mat4 view" and calculateClusteredLights() prototype. CLUSTER_* defines are made from LightClusters constants
+
+const uvec3 clusterGrid = uvec3(CLUSTER_TILES_X, CLUSTER_TILES_Y, CLUSTER_DEPTH_SLICES);
+const uint maxLightsPerCluster = CLUSTER_MAX_LIGHTS;
+
+struct PointLight
+{
+	vec4 positionRadius; //World space position, bounding sphere radius
+	vec4 colourPower;
+};
+
+layout(std430, binding = 0) readonly buffer LightBuffer
+{
+	PointLight lights[];
+};
+
+layout(std430, binding = 1) readonly buffer LightCountBuffer
+{
+	uint lightCounts[];
+};
+
+layout(std430, binding = 2) readonly buffer LightIndexBuffer
+{
+	uint lightIndices[];
+};
+
+uniform vec2 screenSize;
+uniform vec2 clusterDepthRange; //X - near clipping plane, Y - far clipping plane
+
+//Sums point lights from the fragment cluster. Position and normal are in world space
+vec3 calculateClusteredLights(vec3 positionWld, vec3 normalWld)
+{
+	float depthCam = -(view * vec4(positionWld, 1.0)).z;
+	float slice = log(depthCam / clusterDepthRange.x) / log(clusterDepthRange.y / clusterDepthRange.x) * float(clusterGrid.z);
+
+	uvec2 tile = min(uvec2(gl_FragCoord.xy / screenSize * vec2(clusterGrid.xy)), clusterGrid.xy - 1);
+	uint sliceIndex = uint(clamp(slice, 0.0, float(clusterGrid.z - 1)));
+	uint clusterIndex = tile.x + clusterGrid.x * (tile.y + clusterGrid.y * sliceIndex);
+
+	uint lightCount = lightCounts[clusterIndex];
+
+	vec3 lightSum = vec3(0.0);
+	for(uint i = 0; i < lightCount; i++)
+	{
+		PointLight light = lights[lightIndices[clusterIndex * maxLightsPerCluster + i]];
+
+		vec3 lightDirection = positionWld - light.positionRadius.xyz;
+		float distanceToLight = max(length(lightDirection), 0.01);
+		lightDirection /= distanceToLight;
+
+		float cosTheta = clamp(dot(normalWld, -lightDirection), 0.0, 1.0);
+
+		//Light fades to zero at bounding sphere, so cluster borders aren't visible
+		float window = clamp(1.0 - pow(distanceToLight / light.positionRadius.w, 4.0), 0.0, 1.0);
+
+		lightSum += light.colourPower.rgb * light.colourPower.w * cosTheta * window * window / (distanceToLight * distanceToLight);
+	}
+
+	return lightSum;
+}
\ No newline at end of file
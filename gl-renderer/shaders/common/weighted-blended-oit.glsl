@@ -0,0 +1,14 @@
+//Weighted blended order-independent transparency. ShaderManager appends this file to fragment shaders with FEATURE_WEIGHTED_BLENDED_OIT,
+//host shader declares writeWeightedBlended() prototype and calls it at the end of main()
+
+layout(location = 0) out vec4 accumulation;
+layout(location = 1) out float revealage;
+
+//Closer and more opaque fragments get larger weight
+void writeWeightedBlended(vec3 shadedColour, float alpha)
+{
+	float weight = clamp(pow(min(1.0, alpha * 10.0) + 0.01, 3.0) * 1e8 * pow(1.0 - gl_FragCoord.z * 0.9, 3.0), 1e-2, 3e3);
+
+	accumulation = vec4(shadedColour * alpha, alpha) * weight;
+	revealage = alpha;
+}
\ No newline at end of file
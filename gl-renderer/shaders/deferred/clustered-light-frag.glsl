@@ -0,0 +1,96 @@
+#version 450
+
+//Shades point lights from the fragment cluster. Added to directional light pass result
+
+const uvec3 clusterGrid = uvec3(CLUSTER_TILES_X, CLUSTER_TILES_Y, CLUSTER_DEPTH_SLICES); //ShaderManager defines them from LightClusters constants
+const uint maxLightsPerCluster = CLUSTER_MAX_LIGHTS;
+
+struct PointLight
+{
+	vec4 positionRadius; //World space position, bounding sphere radius
+	vec4 colourPower;
+};
+
+layout(std430, binding = 0) readonly buffer LightBuffer
+{
+	PointLight lights[];
+};
+
+layout(std430, binding = 1) readonly buffer LightCountBuffer
+{
+	uint lightCounts[];
+};
+
+layout(std430, binding = 2) readonly buffer LightIndexBuffer
+{
+	uint lightIndices[];
+};
+
+uniform sampler2D depthComponent;
+uniform sampler2D normalComponent;
+uniform sampler2D diffuseComponent;
+
+uniform mat4 inverseProjection;
+uniform mat4 inverseView;
+uniform vec2 clusterDepthRange; //X - near clipping plane, Y - far clipping plane
+
+in vec2 passUv;
+
+out vec3 colour;
+
+//Inverse of octahedral encoding from geometry pass
+vec3 decodeNormal(vec2 encoded)
+{
+	encoded = encoded * 2.0 - 1.0;
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float t = clamp(-n.z, 0.0, 1.0);
+	n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+	return normalize(n);
+}
+
+uint findClusterIndex(float depthCam)
+{
+	float slice = log(depthCam / clusterDepthRange.x) / log(clusterDepthRange.y / clusterDepthRange.x) * float(clusterGrid.z);
+
+	uvec2 tile = min(uvec2(passUv * vec2(clusterGrid.xy)), clusterGrid.xy - 1);
+	uint sliceIndex = uint(clamp(slice, 0.0, float(clusterGrid.z - 1)));
+
+	return tile.x + clusterGrid.x * (tile.y + clusterGrid.y * sliceIndex);
+}
+
+void main()
+{
+	ivec2 texel = ivec2(gl_FragCoord.xy); //G-buffer may be filled only partly with dynamic resolution
+	float depth = texelFetch(depthComponent, texel, 0).r;
+	if(depth == 1.0) //Nothing is drawn here
+		discard;
+
+	vec4 positionCam = inverseProjection * vec4(vec3(passUv, depth) * 2.0 - 1.0, 1.0);
+	positionCam /= positionCam.w;
+
+	vec3 fragmentPosition = (inverseView * positionCam).xyz;
+	vec3 fragmentNormal = decodeNormal(texelFetch(normalComponent, texel, 0).rg);
+	vec3 fragmentDiffuseColour = texelFetch(diffuseComponent, texel, 0).rgb;
+
+	uint clusterIndex = findClusterIndex(-positionCam.z);
+	uint lightCount = lightCounts[clusterIndex];
+
+	vec3 lightSum = vec3(0.0);
+	for(uint i = 0; i < lightCount; i++)
+	{
+		PointLight light = lights[lightIndices[clusterIndex * maxLightsPerCluster + i]];
+
+		vec3 lightDirection = fragmentPosition - light.positionRadius.xyz;
+		float distanceToLight = max(length(lightDirection), 0.01);
+		lightDirection /= distanceToLight;
+
+		float cosTheta = clamp(dot(fragmentNormal, -lightDirection), 0.0, 1.0);
+
+		//Light fades to zero at bounding sphere, so cluster borders aren't visible
+		float window = clamp(1.0 - pow(distanceToLight / light.positionRadius.w, 4.0), 0.0, 1.0);
+
+		lightSum += light.colourPower.rgb * light.colourPower.w * cosTheta * window * window / (distanceToLight * distanceToLight);
+	}
+
+	colour = fragmentDiffuseColour * lightSum;
+}
\ No newline at end of file
@@ -9,10 +9,16 @@ in vec3 passNormal;
 const float cellAmount = 4.f;
 const float triplanarMappingSharpness = 5.0f;
 
-layout(location = 0) out vec3 positionWld;
-layout(location = 1) out vec3 uv;
-layout(location = 2) out vec3 normal;
-layout(location = 3) out vec3 diffuse;
+layout(location = 0) out vec4 diffuse;
+layout(location = 1) out vec2 normal;
+
+//Octahedral normal encoding, result is in [0, 1] range to fit unsigned normalized texture
+vec2 encodeNormal(vec3 n)
+{
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+	vec2 encoded = n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	return encoded * 0.5 + 0.5;
+}
 
 //https://www.shadertoy.com/view/4djSRW
 vec2 hash22(vec2 cell)
@@ -64,9 +70,7 @@ vec3 performTriplanarMapping(vec3 point, vec3 normal, float sharpness)
 
 void main()
 {
-	positionWld = passPosition;
-	uv = vec3(passUv, 0.0);
-	normal = passNormal;
+	normal = encodeNormal(passNormal);
 	
-	diffuse = performTriplanarMapping(passPosition, passNormal, triplanarMappingSharpness);
+	diffuse = vec4(performTriplanarMapping(passPosition, passNormal, triplanarMappingSharpness), 1.0);
 }
\ No newline at end of file
@@ -1,6 +1,6 @@
 #version 450
 
-uniform sampler2D positionComponent;
+uniform sampler2D depthComponent;
 uniform sampler2D normalComponent;
 uniform sampler2D diffuseComponent;
 
@@ -8,7 +8,7 @@ uniform vec3 lightDirection;
 uniform vec3 diffuseLightColour;
 uniform vec3 ambientLightColour;
 
-uniform mat4 view;
+uniform mat4 inverseProjection;
 uniform float fogDensity;
 uniform vec4 fogColour;
 
@@ -16,6 +16,24 @@ in vec2 passUv;
 
 out vec3 colour;
 
+//Inverse of octahedral encoding from geometry pass
+vec3 decodeNormal(vec2 encoded)
+{
+	encoded = encoded * 2.0 - 1.0;
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float t = clamp(-n.z, 0.0, 1.0);
+	n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+	return normalize(n);
+}
+
+//Position is not stored in G-buffer, it is restored from depth
+vec3 reconstructPositionCam(vec2 uv, ivec2 texel)
+{
+	float depth = texelFetch(depthComponent, texel, 0).r;
+	vec4 positionCam = inverseProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+	return positionCam.xyz / positionCam.w;
+}
+
 float calculateFogFactor(float fragmentDepth)
 {
 	float factor = exp(-fogDensity * fragmentDepth);
@@ -24,13 +42,14 @@ float calculateFogFactor(float fragmentDepth)
 
 void main()
 {
-	vec3 normal = texture(normalComponent, passUv).rgb;
+	ivec2 texel = ivec2(gl_FragCoord.xy); //G-buffer may be filled only partly with dynamic resolution
+	vec3 normal = decodeNormal(texelFetch(normalComponent, texel, 0).rg);
 	
-	vec3 textureDiffuseColour = texture(diffuseComponent, passUv).rgb;
+	vec3 textureDiffuseColour = texelFetch(diffuseComponent, texel, 0).rgb;
 	vec3 textureAmbientColour = textureDiffuseColour * vec3(0.25, 0.25, 0.25);
 
 	vec3 resultColour  = textureAmbientColour * ambientLightColour + textureDiffuseColour * clamp(dot(normal, -lightDirection), 0.0, 1.0) * diffuseLightColour;
-	vec4 vertexPosition = view * texture(positionComponent, passUv);
+	vec3 vertexPosition = reconstructPositionCam(passUv, texel);
 
 	colour = mix(resultColour, fogColour.rgb, calculateFogFactor(abs(vertexPosition.z)));
 }
\ No newline at end of file
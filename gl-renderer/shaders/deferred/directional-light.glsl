@@ -11,11 +11,22 @@ in vec2 passUv;
 
 out vec3 colour;
 
+//Inverse of octahedral encoding from geometry pass
+vec3 decodeNormal(vec2 encoded)
+{
+	encoded = encoded * 2.0 - 1.0;
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float t = clamp(-n.z, 0.0, 1.0);
+	n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+	return normalize(n);
+}
+
 void main()
 {
-	vec3 normal = texture(normalComponent, passUv).rgb;
+	ivec2 texel = ivec2(gl_FragCoord.xy); //G-buffer may be filled only partly with dynamic resolution
+	vec3 normal = decodeNormal(texelFetch(normalComponent, texel, 0).rg);
 	
-	vec3 textureDiffuseColour = texture(diffuseComponent, passUv).rgb;
+	vec3 textureDiffuseColour = texelFetch(diffuseComponent, texel, 0).rgb;
 	vec3 textureAmbientColour = textureDiffuseColour * vec3(0.25, 0.25, 0.25);
 
 	colour = textureAmbientColour * ambientLightColour + textureDiffuseColour * clamp(dot(normal, -lightDirection), 0.0, 1.0) * diffuseLightColour;
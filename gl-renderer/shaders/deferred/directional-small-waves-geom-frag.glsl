@@ -15,10 +15,16 @@ const float waveSpeed[4] = float[4](1.0, 0.7, 0.8, 1.2);
 const vec2 waveDirection[4] = vec2[4](vec2(-0.98481, 0.17365), vec2(-0.34202, 0.93969), vec2(0.17365, 0.98481), vec2(0.5, 0.86603)); //170, 110, 80, 60
 const float amplitude[4] = float[4](0.01, 0.02, 0.015, 0.06);
 
-layout(location = 0) out vec3 positionWld;
-layout(location = 1) out vec3 uv;
-layout(location = 2) out vec3 normal;
-layout(location = 3) out vec3 diffuse;
+layout(location = 0) out vec4 diffuse;
+layout(location = 1) out vec2 normal;
+
+//Octahedral normal encoding, result is in [0, 1] range to fit unsigned normalized texture
+vec2 encodeNormal(vec3 n)
+{
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+	vec2 encoded = n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	return encoded * 0.5 + 0.5;
+}
 
 //https://www.jayconrod.com/posts/34/water-simulation-in-glsl
 
@@ -57,9 +63,7 @@ vec3 calculateWaveNormal(float x, float y)
 
 void main()
 {
-	positionWld = passPosition;
-	uv = vec3(passUv, 0.0);
-	normal = calculateWaveNormal(passPosition.x, passPosition.z);
+	normal = encodeNormal(calculateWaveNormal(passPosition.x, passPosition.z));
 	
-	diffuse = texture(colourTexture, passUv).rgb;
+	diffuse = vec4(texture(colourTexture, passUv).rgb, 1.0);
 }
\ No newline at end of file
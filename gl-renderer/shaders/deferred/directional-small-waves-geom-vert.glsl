@@ -13,6 +13,8 @@ uniform mat3 rotation;
 out vec3 passPosition;
 out vec2 passUv;
 
+invariant gl_Position;
+
 void main()
 {
 	passPosition = (model * vec4(positionMdl, 1.0)).xyz;
@@ -0,0 +1,99 @@
+#version 450
+
+//Bins point lights into clusters: screen tiles cut by exponential depth slices. One work group per cluster
+
+layout(local_size_x = 64) in;
+
+const uvec3 clusterGrid = uvec3(CLUSTER_TILES_X, CLUSTER_TILES_Y, CLUSTER_DEPTH_SLICES); //ShaderManager defines them from LightClusters constants
+const uint maxLightsPerCluster = CLUSTER_MAX_LIGHTS;
+
+struct PointLight
+{
+	vec4 positionRadius; //World space position, bounding sphere radius
+	vec4 colourPower;
+};
+
+layout(std430, binding = 0) readonly buffer LightBuffer
+{
+	PointLight lights[];
+};
+
+layout(std430, binding = 1) writeonly buffer LightCountBuffer
+{
+	uint lightCounts[];
+};
+
+layout(std430, binding = 2) writeonly buffer LightIndexBuffer
+{
+	uint lightIndices[];
+};
+
+uniform mat4 view;
+uniform mat4 inverseProjection;
+uniform vec2 clusterDepthRange; //X - near clipping plane, Y - far clipping plane
+uniform uint lightAmount;
+
+shared vec3 clusterMin;
+shared vec3 clusterMax;
+shared uint clusterLightCount;
+
+//Point on near plane in camera space
+vec3 screenToCamera(vec2 ndc)
+{
+	vec4 position = inverseProjection * vec4(ndc, -1.0, 1.0);
+	return position.xyz / position.w;
+}
+
+//Camera space bounding box of the cluster
+void computeClusterBounds()
+{
+	vec2 tileSize = 2.0 / vec2(clusterGrid.xy);
+	vec3 minPoint = screenToCamera(vec2(gl_WorkGroupID.xy) * tileSize - 1.0);
+	vec3 maxPoint = screenToCamera(vec2(gl_WorkGroupID.xy + 1) * tileSize - 1.0);
+
+	float depthRatio = clusterDepthRange.y / clusterDepthRange.x;
+	float sliceNear = clusterDepthRange.x * pow(depthRatio, float(gl_WorkGroupID.z) / float(clusterGrid.z));
+	float sliceFar = clusterDepthRange.x * pow(depthRatio, float(gl_WorkGroupID.z + 1) / float(clusterGrid.z));
+
+	//Tile corners are moved along view rays to slice depths. Camera looks along -Z
+	vec3 minNear = minPoint * (sliceNear / -minPoint.z);
+	vec3 minFar = minPoint * (sliceFar / -minPoint.z);
+	vec3 maxNear = maxPoint * (sliceNear / -maxPoint.z);
+	vec3 maxFar = maxPoint * (sliceFar / -maxPoint.z);
+
+	clusterMin = min(min(minNear, minFar), min(maxNear, maxFar));
+	clusterMax = max(max(minNear, minFar), max(maxNear, maxFar));
+}
+
+void main()
+{
+	uint clusterIndex = gl_WorkGroupID.x + clusterGrid.x * (gl_WorkGroupID.y + clusterGrid.y * gl_WorkGroupID.z);
+
+	if(gl_LocalInvocationIndex == 0)
+	{
+		computeClusterBounds();
+		clusterLightCount = 0;
+	}
+
+	barrier();
+
+	for(uint i = gl_LocalInvocationIndex; i < lightAmount; i += gl_WorkGroupSize.x)
+	{
+		vec3 centre = (view * vec4(lights[i].positionRadius.xyz, 1.0)).xyz;
+		float radius = lights[i].positionRadius.w;
+
+		//Sphere and box intersection
+		vec3 distance = clamp(centre, clusterMin, clusterMax) - centre;
+		if(dot(distance, distance) <= radius * radius)
+		{
+			uint slot = atomicAdd(clusterLightCount, 1);
+			if(slot < maxLightsPerCluster)
+				lightIndices[clusterIndex * maxLightsPerCluster + slot] = i;
+		}
+	}
+
+	barrier();
+
+	if(gl_LocalInvocationIndex == 0)
+		lightCounts[clusterIndex] = min(clusterLightCount, maxLightsPerCluster);
+}
\ No newline at end of file
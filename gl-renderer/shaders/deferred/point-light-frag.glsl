@@ -1,6 +1,6 @@
 #version 450
 
-uniform sampler2D positionComponent;
+uniform sampler2D depthComponent;
 uniform sampler2D normalComponent;
 uniform sampler2D diffuseComponent;
 
@@ -8,18 +8,40 @@ uniform vec3 lightPositionWld;
 uniform vec3 diffuseLightColour;
 uniform vec3 ambientLightColour;
 
-uniform vec2 screenSize;
+uniform mat4 inverseProjection;
+uniform mat4 inverseView;
+
+uniform vec2 screenSize; //Viewport size, smaller than G-buffer with dynamic resolution
 uniform vec2 lightParameters; //X - light power, Y - sphere radius
 
 out vec3 colour;
 
+//Inverse of octahedral encoding from geometry pass
+vec3 decodeNormal(vec2 encoded)
+{
+	encoded = encoded * 2.0 - 1.0;
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float t = clamp(-n.z, 0.0, 1.0);
+	n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+	return normalize(n);
+}
+
+//Position is not stored in G-buffer, it is restored from depth
+vec3 reconstructPositionWld(vec2 uv, ivec2 texel)
+{
+	float depth = texelFetch(depthComponent, texel, 0).r;
+	vec4 positionCam = inverseProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+	return (inverseView * vec4(positionCam.xyz / positionCam.w, 1.0)).xyz;
+}
+
 void main()
 {
 	vec2 uv = gl_FragCoord.xy / screenSize;
+	ivec2 texel = ivec2(gl_FragCoord.xy);
 	
-	vec3 fragmentPosition = texture(positionComponent, uv).rgb;
-	vec3 fragmentNormal = normalize(texture(normalComponent, uv).rgb);
-	vec3 fragmentDiffuseColour = texture(diffuseComponent, uv).rgb;
+	vec3 fragmentPosition = reconstructPositionWld(uv, texel);
+	vec3 fragmentNormal = decodeNormal(texelFetch(normalComponent, texel, 0).rg);
+	vec3 fragmentDiffuseColour = texelFetch(diffuseComponent, texel, 0).rgb;
 	
 	vec3 lightDirection = fragmentPosition - lightPositionWld;
 	float distanceToLight = length(lightDirection);
@@ -0,0 +1,7 @@
+#version 450
+
+//Depth pre-pass: vertex shader is taken from shading pass, colour writes are disabled
+
+void main()
+{
+}
\ No newline at end of file
@@ -15,6 +15,13 @@ in vec3 passNormal;
 const float cellAmount = 4.f;
 const float triplanarMappingSharpness = 5.0f;
 
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+uniform mat4 view;
+
+//Appended by ShaderManager from shaders/common/clustered-lights.glsl
+vec3 calculateClusteredLights(vec3 positionWld, vec3 normalWld);
+#endif
+
 out vec4 colour;
 
 float calculateFogFactor()
@@ -116,5 +123,10 @@ void main()
 	vec4 textureAmbientColour = textureDiffuseColour * vec4(0.25, 0.25, 0.25, 1.0);
 	
 	vec4 resultColour = textureAmbientColour * vec4(ambientLightColour, 1.0) + textureDiffuseColour * clamp(dot(passNormal, -lightDirection), 0.0, 1.0) * vec4(diffuseLightColour, 1.0);
+
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+	resultColour.rgb += textureDiffuseColour.rgb * calculateClusteredLights(passPosition, passNormal);
+#endif
+
 	colour = mix(resultColour, fogColour, calculateFogFactor());
 }
\ No newline at end of file
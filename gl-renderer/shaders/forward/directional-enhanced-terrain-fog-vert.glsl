@@ -15,6 +15,8 @@ out vec4 passVertexPositionCam;
 out vec2 passUv;
 out vec3 passNormal;
 
+invariant gl_Position;
+
 void main()
 {
 	vec4 positionWld = model * vec4(positionMdl, 1.0);
@@ -12,6 +12,13 @@ in vec3 passNormal;
 const float cellAmount = 4.f;
 const float triplanarMappingSharpness = 5.0f;
 
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+uniform mat4 view;
+
+//Appended by ShaderManager from shaders/common/clustered-lights.glsl
+vec3 calculateClusteredLights(vec3 positionWld, vec3 normalWld);
+#endif
+
 out vec4 colour;
 
 //https://www.shadertoy.com/view/4djSRW
@@ -105,4 +112,8 @@ void main()
 	vec4 textureAmbientColour = textureDiffuseColour * vec4(0.25, 0.25, 0.25, 1.0);
 	
 	colour = textureAmbientColour * vec4(ambientLightColour, 1.0) + textureDiffuseColour * clamp(dot(passNormal, -lightDirection), 0.0, 1.0) * vec4(diffuseLightColour, 1.0);
+
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+	colour.rgb += textureDiffuseColour.rgb * calculateClusteredLights(passPosition, passNormal);
+#endif
 }
\ No newline at end of file
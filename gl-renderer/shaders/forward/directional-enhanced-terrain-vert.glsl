@@ -14,6 +14,8 @@ out vec3 passPosition;
 out vec2 passUv;
 out vec3 passNormal;
 
+invariant gl_Position;
+
 void main()
 {
 	passPosition = (model * vec4(positionMdl, 1.0)).xyz;
@@ -36,7 +36,21 @@ in vec3 passNormalWld;
 in vec3 passTangentWld;
 in vec3 passBitangentWld;
 
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+uniform mat4 view;
+
+//Appended by ShaderManager from shaders/common/clustered-lights.glsl
+vec3 calculateClusteredLights(vec3 positionWld, vec3 normalWld);
+#endif
+
+#if defined(FEATURE_WEIGHTED_BLENDED_OIT)
+vec4 colour; //Shaded colour, written to accumulation targets at the end
+
+//Appended by ShaderManager from shaders/common/weighted-blended-oit.glsl
+void writeWeightedBlended(vec3 shadedColour, float alpha);
+#else
 out vec4 colour;
+#endif
 
 //Beckmann distribution
 float p22_beckmann_anisotropic(float x, float y, float alpha_x, float alpha_y)
@@ -396,4 +410,12 @@ void main()
 	colour = textureAmbientColour * vec4(ambientLightColour, 1.0) +
 		textureDiffuseColour * clamp(dot(passNormalWld, -lightDirection), 0.0, 1.0) * vec4(diffuseLightColour, 1.0) +
 		vec4(radianceSpecular, 1.0);
+
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+	colour.rgb += textureDiffuseColour.rgb * calculateClusteredLights(passPositionWld, passNormalWld);
+#endif
+
+#if defined(FEATURE_WEIGHTED_BLENDED_OIT)
+	writeWeightedBlended(colour.rgb, textureDiffuseColour.a);
+#endif
 }
\ No newline at end of file
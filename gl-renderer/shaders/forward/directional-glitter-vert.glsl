@@ -16,6 +16,8 @@ out vec3 passNormalWld;
 out vec3 passTangentWld;
 out vec3 passBitangentWld;
 
+invariant gl_Position;
+
 void main()
 {
 	passPositionWld = (model * vec4(positionMdl, 1.0)).xyz;
@@ -14,6 +14,8 @@ out vec2 passUv;
 out vec3 passPositionWld;
 out vec4 passVertexPositionCam;
 
+invariant gl_Position;
+
 void main()
 {
 	passUv = uv;
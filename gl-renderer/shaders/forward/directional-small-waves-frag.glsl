@@ -21,7 +21,19 @@ const float waveSpeed[4] = float[4](1.0, 0.7, 0.8, 1.2);
 const vec2 waveDirection[4] = vec2[4](vec2(-0.98481, 0.17365), vec2(-0.34202, 0.93969), vec2(0.17365, 0.98481), vec2(0.5, 0.86603)); //170, 110, 80, 60
 const float amplitude[4] = float[4](0.01, 0.02, 0.015, 0.06);
 
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+//Appended by ShaderManager from shaders/common/clustered-lights.glsl
+vec3 calculateClusteredLights(vec3 positionWld, vec3 normalWld);
+#endif
+
+#if defined(FEATURE_WEIGHTED_BLENDED_OIT)
+vec4 colour; //Shaded colour, written to accumulation targets at the end
+
+//Appended by ShaderManager from shaders/common/weighted-blended-oit.glsl
+void writeWeightedBlended(vec3 shadedColour, float alpha);
+#else
 out vec4 colour;
+#endif
 
 //https://www.jayconrod.com/posts/34/water-simulation-in-glsl
 
@@ -76,4 +88,12 @@ void main()
 	colour = textureAmbientColour * vec4(ambientLightColour, 1.0) +
 		textureDiffuseColour * clamp(dot(normal, -lightDirection), 0.0, 1.0) * vec4(diffuseLightColour, 1.0) +
 		specularColour * specularCoefficient * pow(cosAlpha, 3.0) * vec4(diffuseLightColour, 1.0);
+
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+	colour.rgb += textureDiffuseColour.rgb * calculateClusteredLights(passPositionWld, normal.xzy); //Wave normal is Z-up
+#endif
+
+#if defined(FEATURE_WEIGHTED_BLENDED_OIT)
+	writeWeightedBlended(colour.rgb, textureDiffuseColour.a);
+#endif
 }
\ No newline at end of file
@@ -15,6 +15,8 @@ out vec2 passUv;
 out vec3 passNormal;
 out vec3 passPositionWld;
 
+invariant gl_Position;
+
 void main()
 {
 	vec4 positionCam = view * model * vec4(positionMdl, 1.0);
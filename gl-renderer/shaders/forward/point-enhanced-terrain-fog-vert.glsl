@@ -16,6 +16,8 @@ out vec3 passNormalCam;
 out vec3 passNormalMdl;
 out vec4 passVertexPositionCam;
 
+invariant gl_Position;
+
 void main()
 {
 	vec4 positionCam = view * model * vec4(positionMdl, 1.0);
@@ -37,4 +39,4 @@ void main()
    
 	passNormalCam = normalize((view * model * vec4(normalMdl, 0.0)).xyz);
 	passNormalMdl = normalize(normalMdl);
-}
+}
\ No newline at end of file
@@ -15,6 +15,8 @@ out vec3 passLightDirectionCam;
 out vec3 passNormalCam;
 out vec3 passNormalMdl;
 
+invariant gl_Position;
+
 void main()
 {
 	vec4 positionCam = view * model * vec4(positionMdl, 1.0);
@@ -35,4 +37,4 @@ void main()
    
 	passNormalCam = normalize((view * model * vec4(normalMdl, 0.0)).xyz);
 	passNormalMdl = normalize(normalMdl);
-}
+}
\ No newline at end of file
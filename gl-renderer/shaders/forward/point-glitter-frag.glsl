@@ -36,7 +36,14 @@ in vec3 passBitangentWld;
 
 in vec3 passLightDirectionCam;
 
+#if defined(FEATURE_WEIGHTED_BLENDED_OIT)
+vec4 colour; //Shaded colour, written to accumulation targets at the end
+
+//Appended by ShaderManager from shaders/common/weighted-blended-oit.glsl
+void writeWeightedBlended(vec3 shadedColour, float alpha);
+#else
 out vec4 colour;
+#endif
 
 //Beckmann distribution
 float p22_beckmann_anisotropic(float x, float y, float alpha_x, float alpha_y)
@@ -402,4 +409,8 @@ void main()
 	colour = vec4(ambientColor + 
 		diffuseColor * lightPower * cosTheta / (distanceToLight * distanceToLight)) +
 		vec4(radianceSpecular, 1.0);
+
+#if defined(FEATURE_WEIGHTED_BLENDED_OIT)
+	writeWeightedBlended(colour.rgb, diffuseColor.a);
+#endif
 }
\ No newline at end of file
@@ -19,6 +19,8 @@ out vec3 passBitangentWld;
 
 out vec3 passLightDirectionCam;
 
+invariant gl_Position;
+
 void main()
 {
 	passPositionWld = (model * vec4(positionMdl, 1.0)).xyz;
@@ -38,4 +40,4 @@ void main()
 	passLightDirectionCam = normalize(lightPositionCam + eyeDirectionCam); //Halfway vector
 
 	gl_Position = projection * positionCam;
-}
+}
\ No newline at end of file
@@ -14,6 +14,8 @@ out vec3 passPositionWld;
 out vec3 passLightDirectionCam;
 out vec4 passVertexPositionCam;
 
+invariant gl_Position;
+
 void main()
 {
 	vec4 positionCam = view * model * vec4(positionMdl, 1.0);
@@ -33,4 +35,4 @@ void main()
 	passLightDirectionCam = normalize(lightPositionCam + eyeDirectionCam); //Halfway vector
 	
 	passVertexPositionCam = positionCam;
-}
+}
\ No newline at end of file
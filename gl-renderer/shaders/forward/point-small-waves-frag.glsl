@@ -18,7 +18,14 @@ const float waveSpeed[4] = float[4](1.0, 0.7, 0.8, 1.2);
 const vec2 waveDirection[4] = vec2[4](vec2(-0.98481, 0.17365), vec2(-0.34202, 0.93969), vec2(0.17365, 0.98481), vec2(0.5, 0.86603)); //170, 110, 80, 60
 const float amplitude[4] = float[4](0.01, 0.02, 0.015, 0.06);
 
+#if defined(FEATURE_WEIGHTED_BLENDED_OIT)
+vec4 colour; //Shaded colour, written to accumulation targets at the end
+
+//Appended by ShaderManager from shaders/common/weighted-blended-oit.glsl
+void writeWeightedBlended(vec3 shadedColour, float alpha);
+#else
 out vec4 colour;
+#endif
 
 //https://www.jayconrod.com/posts/34/water-simulation-in-glsl
 
@@ -78,4 +85,8 @@ void main()
 	colour = vec4(ambientColor + 
 		diffuseColor * lightPower * cosTheta / distanceToLightSquare +
 		specularColor * specularCoefficient * lightPower * pow(cosAlpha, 3.0) / distanceToLightSquare);
+
+#if defined(FEATURE_WEIGHTED_BLENDED_OIT)
+	writeWeightedBlended(colour.rgb, diffuseColor.a);
+#endif
 }
\ No newline at end of file
@@ -14,6 +14,8 @@ out vec3 passPositionWld;
 out vec3 passLightDirectionCam;
 out vec3 passEyeDirectionCam;
 
+invariant gl_Position;
+
 void main()
 {
 	vec4 positionCam = view * model * vec4(positionMdl, 1.0);
@@ -31,4 +33,4 @@ void main()
 	//Vector that goes from the vertex to the light, in camera space
 	vec3 lightPositionCam = (view * vec4(lightPositionWld, 1.0)).xyz;
 	passLightDirectionCam = normalize(lightPositionCam + passEyeDirectionCam); //Halfway vector
-}
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+//Appended to tile-filter-comp.glsl
+
+const vec3 embossKernel[3] = vec3[3](
+	vec3(-1.0, -1.0, -1.0),
+	vec3(-1.0, 0.0, 1.0),
+	vec3(1.0, 1.0, 1.0)); //Positive and negative values are flipped so that objects are "pressed" above their background
+
+vec3 filterTile(ivec2 tilePosition)
+{
+	vec3 sumUpColour = vec3(0.0);
+	for(int y = -1; y <= 1; y++)
+	{
+		for(int x = -1; x <= 1; x++)
+			sumUpColour += tileTexel(tilePosition + ivec2(x, y)) * embossKernel[y + 1][x + 1];
+	}
+	sumUpColour /= 8.0;
+	sumUpColour += 0.5;
+
+	float lumene = dot(sumUpColour, vec3(0.299, 0.587, 0.114));
+	return vec3(lumene);
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#version 450
+
+in vec2 passUv;
+
+out vec3 colour;
+
+uniform sampler2D renderedTexture;
+uniform float screenRatio; //Vignette
+
+//Per-pixel effects. Each one reads only its own pixel, so several of them are fused into a single pass
+//main() is generated and applies the effects in chain order
+
+vec3 applyGrayscale(vec3 fragmentColour)
+{
+	float gradient = dot(fragmentColour, vec3(0.299, 0.587, 0.114));
+	return vec3(gradient);
+}
+
+vec3 applyVignette(vec3 fragmentColour)
+{
+	vec2 transformedUv = passUv - 0.5; // [-0.5, 0.5]
+	transformedUv.x *= screenRatio;
+	float dist = length(transformedUv);
+	float vignette = smoothstep(0.7, 1.0, dist);
+	
+	return mix(fragmentColour, vec3(0.0, 0.0, 0.0), vignette);
+}
\ No newline at end of file
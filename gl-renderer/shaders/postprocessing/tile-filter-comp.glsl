@@ -0,0 +1,46 @@
+#version 450
+
+//Neighbourhood filters on compute shaders. Work group loads its tile with apron into shared memory once,
+//so each texel is fetched once per group instead of once per neighbour. Effect source defining filterTile() is appended
+
+layout(local_size_x = 16, local_size_y = 16) in;
+
+const int tileSide = 16; //Must match local size and PostprocessingRenderer constant
+const int apron = 1; //Kernel radius, enough for 3x3 kernels
+const int sharedSide = tileSide + 2 * apron;
+
+uniform sampler2D renderedTexture;
+layout(rgba8) writeonly uniform image2D resultImage;
+
+shared vec3 tile[sharedSide][sharedSide];
+
+//Filters pixel at position in tile. Apron is included in position, so neighbours are reachable by offsets up to apron
+vec3 filterTile(ivec2 tilePosition);
+
+vec3 tileTexel(ivec2 tilePosition)
+{
+	return tile[tilePosition.y][tilePosition.x];
+}
+
+void main()
+{
+	ivec2 textureSide = textureSize(renderedTexture, 0);
+	ivec2 tileOrigin = ivec2(gl_WorkGroupID.xy) * tileSide - apron;
+	
+	//Tile with apron has more texels than the group has invocations, so some of them load two texels
+	for(int i = int(gl_LocalInvocationIndex); i < sharedSide * sharedSide; i += tileSide * tileSide)
+	{
+		ivec2 sharedPosition = ivec2(i % sharedSide, i / sharedSide);
+		ivec2 texelPosition = clamp(tileOrigin + sharedPosition, ivec2(0), textureSide - 1); //The same as clamp to edge
+		tile[sharedPosition.y][sharedPosition.x] = texelFetch(renderedTexture, texelPosition, 0).rgb;
+	}
+	
+	barrier();
+	
+	ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+	if(any(greaterThanEqual(pixel, textureSide))) //Border groups are partially outside
+		return;
+	
+	vec3 result = filterTile(ivec2(gl_LocalInvocationID.xy) + apron);
+	imageStore(resultImage, pixel, vec4(result, 1.0));
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#version 450
+
+uniform sampler2D sceneTexture;
+uniform sampler2D depthComponent;
+uniform sampler2D historyTexture;
+
+uniform vec2 renderScale; //Part of scene textures covered by the current frame
+uniform vec2 jitter; //Sub-pixel offset of the current frame, scaled pixels
+uniform mat4 reprojection; //Current clip space to previous clip space, both without jitter
+uniform float historyWeight; //0 - history is discarded
+
+in vec2 passUv;
+
+out vec4 colour;
+
+void main()
+{
+	vec2 sceneSize = vec2(textureSize(sceneTexture, 0));
+	vec2 scaledSize = sceneSize * renderScale;
+	ivec2 maxTexel = ivec2(scaledSize) - 1;
+
+	//Jitter moved the geometry, so this pixel was shaded at shifted position
+	vec2 scenePosition = passUv * scaledSize + jitter;
+	ivec2 centreTexel = clamp(ivec2(scenePosition), ivec2(0), maxTexel);
+
+	vec3 current = texture(sceneTexture, clamp(scenePosition, vec2(0.5), scaledSize - 0.5) / sceneSize).rgb;
+
+	vec3 neighbourhoodMin = current;
+	vec3 neighbourhoodMax = current;
+	float closestDepth = 1.0;
+	for(int y = -1; y <= 1; y++)
+	{
+		for(int x = -1; x <= 1; x++)
+		{
+			ivec2 texel = clamp(centreTexel + ivec2(x, y), ivec2(0), maxTexel);
+
+			vec3 neighbour = texelFetch(sceneTexture, texel, 0).rgb;
+			neighbourhoodMin = min(neighbourhoodMin, neighbour);
+			neighbourhoodMax = max(neighbourhoodMax, neighbour);
+
+			closestDepth = min(closestDepth, texelFetch(depthComponent, texel, 0).r);
+		}
+	}
+
+	//Velocity from camera motion. The closest depth keeps edges of near objects from trailing
+	vec4 previousClip = reprojection * vec4(vec3(passUv, closestDepth) * 2.0 - 1.0, 1.0);
+	vec2 previousUv = previousClip.xy / previousClip.w * 0.5 + 0.5;
+
+	float weight = historyWeight;
+	if(any(lessThan(previousUv, vec2(0.0))) || any(greaterThan(previousUv, vec2(1.0)))) //Was outside the screen
+		weight = 0.0;
+
+	//Clamping rejects history that doesn't match the current frame, e.g. disoccluded surfaces and waves
+	vec3 history = clamp(texture(historyTexture, previousUv).rgb, neighbourhoodMin, neighbourhoodMax);
+
+	colour = vec4(mix(current, history, weight), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#version 450
+
+//Uber-shader for regular objects. ShaderManager inserts FEATURE_* defines after the version line
+
+uniform sampler2D colourTexture;
+#if defined(FEATURE_NORMALMAP)
+uniform sampler2D normalTexture;
+#endif
+
+#if defined(FEATURE_POINT_LIGHT)
+uniform vec3 lightPositionWld;
+#else
+uniform mat4 view;
+uniform vec3 lightDirection;
+uniform vec3 diffuseLightColour;
+uniform vec3 ambientLightColour;
+#endif
+
+#if defined(FEATURE_FOG)
+uniform float fogDensity;
+uniform vec4 fogColour;
+#endif
+
+in vec2 passUv;
+
+#if defined(FEATURE_DEFERRED_GEOMETRY)
+#if defined(FEATURE_NORMALMAP)
+in mat3 passTangentToWorld;
+#else
+in vec3 passNormal;
+#endif
+
+layout(location = 0) out vec4 diffuse;
+layout(location = 1) out vec2 normal;
+
+#else
+#if defined(FEATURE_POINT_LIGHT)
+in vec3 passPositionWld;
+#if defined(FEATURE_NORMALMAP)
+in vec3 passLightDirectionTang;
+#else
+in vec3 passLightDirectionCam;
+in vec3 passNormalCam;
+#endif
+
+#else //Directional light
+#if defined(FEATURE_NORMALMAP)
+in vec3 passLightDirectionTang;
+#else
+in vec3 passNormal;
+#endif
+#endif
+
+#if defined(FEATURE_SPECULAR)
+in vec3 passEyeDirection;
+#endif
+
+#if defined(FEATURE_FOG)
+in vec4 passVertexPositionCam;
+#endif
+
+#if defined(FEATURE_CLUSTERED_LIGHTS) //Directional light only
+in vec3 passClusteredPositionWld;
+in vec3 passClusteredNormalWld; //Geometry normal, normalmap is not applied
+#endif
+
+#if defined(FEATURE_WEIGHTED_BLENDED_OIT)
+vec4 colour; //Shaded colour, written to accumulation targets at the end
+
+//Appended by ShaderManager from shaders/common/weighted-blended-oit.glsl
+void writeWeightedBlended(vec3 shadedColour, float alpha);
+#else
+out vec4 colour;
+#endif
+#endif
+
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+//Appended by ShaderManager from shaders/common/clustered-lights.glsl
+vec3 calculateClusteredLights(vec3 positionWld, vec3 normalWld);
+#endif
+
+#if defined(FEATURE_DEFERRED_GEOMETRY)
+//Octahedral normal encoding, result is in [0, 1] range to fit unsigned normalized texture
+vec2 encodeNormal(vec3 n)
+{
+	n /= abs(n.x) + abs(n.y) + abs(n.z);
+	vec2 encoded = n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+	return encoded * 0.5 + 0.5;
+}
+#endif
+
+#if defined(FEATURE_FOG) && !defined(FEATURE_DEFERRED_GEOMETRY)
+float calculateFogFactor()
+{
+	float fragmentDepth = abs(passVertexPositionCam.z / passVertexPositionCam.w);
+
+	float factor = exp(-fogDensity * fragmentDepth);
+	return 1.0 - clamp(factor, 0.0, 1.0);
+}
+#endif
+
+void main()
+{
+	vec4 textureDiffuseColour = texture(colourTexture, passUv);
+
+#if defined(FEATURE_DEFERRED_GEOMETRY)
+#if defined(FEATURE_NORMALMAP)
+	normal = encodeNormal(normalize(passTangentToWorld * (texture(normalTexture, passUv).rgb * 2.0 - 1.0)));
+#else
+	normal = encodeNormal(normalize(passNormal));
+#endif
+	diffuse = vec4(textureDiffuseColour.rgb, 1.0);
+
+#else
+	vec4 textureAmbientColour = textureDiffuseColour * vec4(0.25, 0.25, 0.25, 1.0);
+	vec4 specularColour = vec4(0.7, 0.7, 0.7, 1.0);
+
+	//Normal, light and eye directions are in the same space: tangent one for normalmap, otherwise camera or world one
+#if defined(FEATURE_NORMALMAP)
+	vec3 surfaceNormal = normalize(texture(normalTexture, passUv) * 2.0 - 1.0).xyz;
+#elif defined(FEATURE_POINT_LIGHT)
+	vec3 surfaceNormal = passNormalCam;
+#else
+	vec3 surfaceNormal = passNormal;
+#endif
+
+#if defined(FEATURE_POINT_LIGHT)
+	float lightPower = 50.0;
+
+#if defined(FEATURE_NORMALMAP)
+	vec3 directionToLight = passLightDirectionTang;
+#else
+	vec3 directionToLight = passLightDirectionCam;
+#endif
+
+	float distanceToLightSquare = length(lightPositionWld - passPositionWld);
+	distanceToLightSquare *= distanceToLightSquare;
+
+	float cosTheta = clamp(dot(surfaceNormal, directionToLight), 0.0, 1.0);
+
+	vec4 resultColour = textureAmbientColour +
+		textureDiffuseColour * lightPower * cosTheta / distanceToLightSquare;
+
+#if defined(FEATURE_SPECULAR)
+	vec3 reflectedLight = reflect(-directionToLight, surfaceNormal);
+	float cosAlpha = clamp(dot(normalize(passEyeDirection), reflectedLight), 0.0, 1.0);
+
+	resultColour += specularColour * lightPower * pow(cosAlpha, 3.0) / distanceToLightSquare;
+#endif
+
+#else //Directional light
+#if defined(FEATURE_NORMALMAP)
+	vec3 directionToLight = -passLightDirectionTang;
+#elif defined(FEATURE_SPECULAR)
+	vec3 directionToLight = (view * vec4(-lightDirection, 0.0)).xyz;
+#else
+	vec3 directionToLight = -lightDirection;
+#endif
+
+	vec4 resultColour = textureAmbientColour * vec4(ambientLightColour, 1.0) +
+		textureDiffuseColour * clamp(dot(surfaceNormal, directionToLight), 0.0, 1.0) * vec4(diffuseLightColour, 1.0);
+
+#if defined(FEATURE_SPECULAR)
+	vec3 reflectedLight = reflect(-directionToLight, surfaceNormal);
+	float cosAlpha = clamp(dot(normalize(passEyeDirection), reflectedLight), 0.0, 1.0);
+
+	resultColour += specularColour * pow(cosAlpha, 3.0) * vec4(diffuseLightColour, 1.0);
+#endif
+#endif
+
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+	resultColour.rgb += textureDiffuseColour.rgb * calculateClusteredLights(passClusteredPositionWld, normalize(passClusteredNormalWld));
+#endif
+
+#if defined(FEATURE_FOG)
+	colour = mix(resultColour, fogColour, calculateFogFactor());
+#else
+	colour = resultColour;
+#endif
+
+#if defined(FEATURE_WEIGHTED_BLENDED_OIT)
+	writeWeightedBlended(colour.rgb, textureDiffuseColour.a);
+#endif
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#version 450
+
+//Uber-shader for regular objects. ShaderManager inserts FEATURE_* defines after the version line
+
+layout(location = 0) in vec3 positionMdl;
+layout(location = 1) in vec2 uv;
+layout(location = 2) in vec3 normalMdl;
+#if defined(FEATURE_NORMALMAP)
+layout(location = 3) in vec3 tangentMdl;
+layout(location = 4) in vec3 bitangentMdl;
+#elif defined(FEATURE_INSTANCING)
+layout(location = 3) in vec3 instanceOffsetMdl;
+layout(location = 4) in float instanceRotationMdl;
+#endif
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+uniform mat3 rotation;
+
+#if defined(FEATURE_POINT_LIGHT)
+uniform vec3 lightPositionWld;
+#else
+uniform vec3 lightDirection;
+#endif
+
+out vec2 passUv;
+
+#if defined(FEATURE_DEFERRED_GEOMETRY)
+#if defined(FEATURE_NORMALMAP)
+out mat3 passTangentToWorld;
+#else
+out vec3 passNormal;
+#endif
+
+#elif defined(FEATURE_POINT_LIGHT)
+out vec3 passPositionWld;
+#if defined(FEATURE_NORMALMAP)
+out vec3 passLightDirectionTang;
+#else
+out vec3 passLightDirectionCam;
+out vec3 passNormalCam;
+#endif
+
+#else //Directional light
+#if defined(FEATURE_NORMALMAP)
+out vec3 passLightDirectionTang;
+#else
+out vec3 passNormal;
+#endif
+#endif
+
+#if defined(FEATURE_SPECULAR) && !defined(FEATURE_DEFERRED_GEOMETRY)
+out vec3 passEyeDirection; //In the same space as the normal
+#endif
+
+#if defined(FEATURE_FOG)
+out vec4 passVertexPositionCam;
+#endif
+
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+out vec3 passClusteredPositionWld;
+out vec3 passClusteredNormalWld;
+#endif
+
+invariant gl_Position; //Depth pre-pass compiles the same code with another fragment shader
+
+void main()
+{
+#if defined(FEATURE_INSTANCING)
+	float c = cos(instanceRotationMdl);
+	float s = sin(instanceRotationMdl);
+	mat3 particleRotation = mat3(
+		vec3(c, 0.0, s),
+		vec3(0.0, 1.0, 0.0),
+		vec3(-s, 0.0, c));
+
+	vec3 vertexMdl = instanceOffsetMdl + particleRotation * positionMdl;
+	vec3 normalWld = normalize(particleRotation * normalMdl); //Model matrix is identity for instances
+	vec3 normalCam = normalize((view * model * vec4(particleRotation * normalMdl, 0.0)).xyz);
+#else
+	vec3 vertexMdl = positionMdl;
+	vec3 normalWld = normalize(rotation * normalMdl);
+	vec3 normalCam = normalize((view * model * vec4(normalMdl, 0.0)).xyz);
+#endif
+
+	vec4 positionCam = view * model * vec4(vertexMdl, 1.0);
+	gl_Position = projection * positionCam;
+
+	passUv = uv;
+
+	//Vector that goes from the vertex to the camera, in camera space
+	vec3 eyeDirectionCam = vec3(0.0, 0.0, 0.0) - positionCam.xyz;
+
+#if defined(FEATURE_NORMALMAP) && defined(FEATURE_DEFERRED_GEOMETRY)
+	mat3 model3 = mat3(model); //For deferred shading calculate in world space since we convert from tangent to world
+
+	//Normal must have the same rotation as normalmap
+	passTangentToWorld = mat3(
+		model3 * tangentMdl,
+		model3 * bitangentMdl,
+		model3 * normalMdl);
+#elif defined(FEATURE_NORMALMAP)
+	mat3 modelView3 = mat3(view * model);
+
+	//For model space to tangent space transformations. Normal must have the same rotation as normalmap
+	mat3 tbnInverted = transpose(mat3(
+		modelView3 * tangentMdl,
+		modelView3 * bitangentMdl,
+		modelView3 * normalMdl));
+#endif
+
+#if defined(FEATURE_DEFERRED_GEOMETRY)
+#if !defined(FEATURE_NORMALMAP)
+	passNormal = normalWld;
+#endif
+
+#elif defined(FEATURE_POINT_LIGHT)
+	passPositionWld = (model * vec4(vertexMdl, 1.0)).xyz;
+
+	//Vector that goes from the vertex to the light, in camera space
+	vec3 lightPositionCam = (view * vec4(lightPositionWld, 1.0)).xyz;
+	vec3 lightDirectionCam = normalize(lightPositionCam + eyeDirectionCam); //Halfway vector
+
+#if defined(FEATURE_NORMALMAP)
+	passLightDirectionTang = tbnInverted * lightDirectionCam;
+#else
+	passLightDirectionCam = lightDirectionCam;
+	passNormalCam = normalCam;
+#endif
+
+#else //Directional light
+#if defined(FEATURE_NORMALMAP)
+	passLightDirectionTang = tbnInverted * mat3(view) * lightDirection;
+#elif defined(FEATURE_SPECULAR)
+	passNormal = normalCam; //Specular highlight is calculated in camera space
+#else
+	passNormal = normalWld;
+#endif
+#endif
+
+#if defined(FEATURE_DEFERRED_GEOMETRY)
+	//Specular highlight is not stored in G-buffer
+#elif defined(FEATURE_SPECULAR) && defined(FEATURE_NORMALMAP)
+	passEyeDirection = tbnInverted * eyeDirectionCam;
+#elif defined(FEATURE_SPECULAR)
+	passEyeDirection = eyeDirectionCam;
+#endif
+
+#if defined(FEATURE_FOG)
+	passVertexPositionCam = positionCam;
+#endif
+
+#if defined(FEATURE_CLUSTERED_LIGHTS)
+	passClusteredPositionWld = (model * vec4(vertexMdl, 1.0)).xyz;
+	passClusteredNormalWld = normalWld;
+#endif
+}
\ No newline at end of file
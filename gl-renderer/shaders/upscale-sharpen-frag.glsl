@@ -0,0 +1,29 @@
+#version 450
+
+uniform sampler2D sceneTexture;
+uniform vec2 renderScale; //Part of scene texture covered by the rendered image
+uniform float sharpness;
+
+in vec2 passUv;
+
+out vec3 colour;
+
+void main()
+{
+	vec2 texelSize = 1.0 / vec2(textureSize(sceneTexture, 0));
+	vec2 maxUv = renderScale - 0.5 * texelSize; //Unused part of the texture must not bleed into the edge
+	vec2 uv = passUv * renderScale;
+
+	vec3 centre = texture(sceneTexture, min(uv, maxUv)).rgb;
+	vec3 north = texture(sceneTexture, min(uv + vec2(0.0, texelSize.y), maxUv)).rgb;
+	vec3 south = texture(sceneTexture, min(uv - vec2(0.0, texelSize.y), maxUv)).rgb;
+	vec3 east = texture(sceneTexture, min(uv + vec2(texelSize.x, 0.0), maxUv)).rgb;
+	vec3 west = texture(sceneTexture, min(uv - vec2(texelSize.x, 0.0), maxUv)).rgb;
+
+	//Unsharp mask restores edges blurred by bilinear filtering, clamping to neighbourhood prevents halos
+	vec3 neighbourhoodMin = min(centre, min(min(north, south), min(east, west)));
+	vec3 neighbourhoodMax = max(centre, max(max(north, south), max(east, west)));
+	vec3 sharpened = centre + (4.0 * centre - north - south - east - west) * sharpness;
+
+	colour = clamp(sharpened, neighbourhoodMin, neighbourhoodMax);
+}
\ No newline at end of file
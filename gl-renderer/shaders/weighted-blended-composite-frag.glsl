@@ -0,0 +1,29 @@
+#version 450
+
+//Weighted blended transparency: resolves accumulated transparent fragments over opaque scene
+
+in vec2 passUv;
+
+out vec4 colour;
+
+uniform sampler2D accumulationTexture;
+uniform sampler2D revealageTexture;
+
+void main()
+{
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+
+	float revealage = texelFetch(revealageTexture, texel, 0).r;
+	if(revealage == 1.0) //No transparent fragments
+		discard;
+
+	vec4 accumulation = texelFetch(accumulationTexture, texel, 0);
+
+	//Weights of many overlapping fragments may overflow half float
+	if(isinf(max(max(abs(accumulation.r), abs(accumulation.g)), abs(accumulation.b))))
+		accumulation.rgb = vec3(accumulation.a);
+
+	vec3 averageColour = accumulation.rgb / max(accumulation.a, 0.00001);
+
+	colour = vec4(averageColour, 1.0 - revealage);
+}
\ No newline at end of file
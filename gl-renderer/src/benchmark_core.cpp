@@ -0,0 +1,280 @@
+/* benchmark_core.cpp
+ * Core module for offscreen benchmarks: camera follows a path for a fixed amount of frames
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "benchmark_core.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+#include <GL/glew.h>
+
+#include "log.h"
+#include "graphics_lib/operations/memory_ledger.h"
+#include "utils/camera_path_tools.h"
+#include "utils/json_tools.h"
+#include "utils/math_tools.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace renderer;
+using namespace renderer::data;
+using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
+using namespace renderer::managers;
+using namespace renderer::utils;
+using namespace renderer::visibility;
+
+namespace
+{
+	constexpr float PERCENTILES[] = {50.f, 95.f, 99.f};
+	constexpr float LIGHT_SWEEP_LOGGED_PERCENTILE = 95.f;
+
+
+
+	/*
+	@brief Writes JSON object with mean, percentiles and maximum of frame times
+	*/
+	void writeFrameTimes(ofstream &data, const vector<float> &frameTimes);
+
+	/*
+	@brief Writes JSON object with mean and maximum of values
+	*/
+	template<typename T>
+	void writeMeanAndMax(ofstream &data, const char *name, const vector<T> &values);
+
+	/*
+	@brief Picks one counter of every frame
+	*/
+	vector<int> selectCounter(const vector<CallCounters> &counters, int CallCounters::*field);
+
+	/*
+	@brief Writes JSON object with bytes of every memory ledger category at the end of run
+	*/
+	void writeMemoryUsage(ofstream &data);
+}
+
+BenchmarkCore::BenchmarkCore(GLFWwindow *wnd, FrameRenderer *frameRend, TCameraController &camera, SceneManager &sceneMgr, ShaderManager &shaderMgr, const CameraPath &path,
+	const AppParameters &parameters):
+	Core(wnd, frameRend, camera, sceneMgr, shaderMgr), cameraPath(path), appParameters(parameters)
+{
+}
+
+BenchmarkCore::~BenchmarkCore()
+{
+}
+
+void BenchmarkCore::mainLoop()
+{
+	if(!window)
+	{
+		Log::getInstance().error("Window is null");
+		return;
+	}
+
+	if(appParameters.isLightSweep)
+	{
+		if(!runLightSweep())
+		{
+			Log::getInstance().error("Light sweep is stopped");
+			return;
+		}
+	}
+	else runCameraPath();
+
+	if(!writeReport())
+		Log::getInstance().error("Can't write benchmark report");
+}
+
+void BenchmarkCore::runCameraPath()
+{
+	const int frameAmount = appParameters.benchmarkFrameAmount;
+	const float frameStep = getCameraPathDuration(cameraPath) / max(frameAmount - 1, 1); //The last frame is at the last keyframe
+
+	Log::getInstance().info(string("Running benchmark for ") + to_string(frameAmount) + " frames");
+
+	frameTimes.clear();
+	triangleCounts.clear();
+	drawCallCounts.clear();
+	callCounters.clear();
+
+	frameTimes.reserve(frameAmount);
+	triangleCounts.reserve(frameAmount);
+	drawCallCounts.reserve(frameAmount);
+	callCounters.reserve(frameAmount);
+
+	visibilityFlags.resize(chunkMargins->size());
+
+	//Replay clock moves camera, visibility and waves, so runs are identical whatever frame time is
+	startReplay(cameraPath, frameStep);
+
+	for(int frame = 0; frame < frameAmount && !glfwWindowShouldClose(window); frame++)
+	{
+		steady_clock::time_point frameStartTime = steady_clock::now();
+
+		if(!advanceReplay())
+			break;
+
+		glfwPollEvents();
+
+		if(uploadService)
+			uploadService->processUploads();
+
+		frameRenderer->renderFrame(); //Overlay isn't drawn, it isn't a part of scene workload
+
+		glfwSwapBuffers(window);
+		glFinish(); //Otherwise driver queues several frames and CPU time doesn't include GPU work
+
+		frameTimes.push_back(duration<float, milli>(steady_clock::now() - frameStartTime).count());
+		triangleCounts.push_back(frameRenderer->getDrawnTriangleCount());
+		drawCallCounts.push_back(frameRenderer->getDrawCallCount());
+		callCounters.push_back(getCallCounters()); //Frame renderer keeps the previous frame, these are of the current one
+	}
+
+	stopReplay();
+}
+
+bool BenchmarkCore::runLightSweep()
+{
+	const vector<PointLight> &generatedLights = sceneManager.getScene().pointLights;
+
+	for(auto amount: LIGHT_SWEEP_AMOUNTS)
+	{
+		if(amount > static_cast<int>(generatedLights.size()))
+		{
+			Log::getInstance().error(string("Only ") + to_string(generatedLights.size()) + " point lights are generated for sweep");
+			return false;
+		}
+
+		if(!frameRenderer->setPointLights(vector<PointLight>(generatedLights.begin(), generatedLights.begin() + amount)))
+			return false;
+
+		Log::getInstance().info(string("Light sweep step: ") + to_string(amount) + " point lights");
+		runCameraPath();
+
+		if(frameTimes.empty())
+			return false;
+
+		vector<float> sortedFrameTimes(frameTimes);
+		sort(sortedFrameTimes.begin(), sortedFrameTimes.end());
+
+		stringstream message;
+		message << amount << " point lights: mean " << fixed << setprecision(3) << accumulate(frameTimes.begin(), frameTimes.end(), 0.) / frameTimes.size() <<
+			" ms, p95 " << computePercentile(sortedFrameTimes, LIGHT_SWEEP_LOGGED_PERCENTILE) << " ms";
+		Log::getInstance().info(message.str());
+
+		lightSweepFrameTimes.emplace_back(amount, frameTimes);
+	}
+
+	return true;
+}
+
+bool BenchmarkCore::writeReport() const
+{
+	if(frameTimes.empty())
+		return false;
+
+	ofstream data(appParameters.benchmarkOutputPath);
+	if(!data.is_open())
+		return false;
+
+	data << fixed << setprecision(3);
+	data << "{\n";
+	data << "\t\"scene\": \"" << escapeJsonString(appParameters.scenePath) << "\",\n";
+	data << "\t\"resolution\": [" << appParameters.screenWidth << ", " << appParameters.screenHeight << "],\n";
+	data << "\t\"frames\": " << frameTimes.size() << ",\n";
+
+	data << "\t\"frameTimeMs\": ";
+	writeFrameTimes(data, frameTimes);
+	data << ",\n";
+
+	//Statistics above are of the last step, it has the most lights
+	if(!lightSweepFrameTimes.empty())
+	{
+		data << "\t\"lightSweep\": [\n";
+		for(size_t i = 0; i < lightSweepFrameTimes.size(); i++)
+		{
+			data << "\t\t{\"pointLights\": " << lightSweepFrameTimes[i].first << ", \"frameTimeMs\": ";
+			writeFrameTimes(data, lightSweepFrameTimes[i].second);
+			data << "}" << (i + 1 < lightSweepFrameTimes.size() ? ",\n" : "\n");
+		}
+		data << "\t],\n";
+	}
+
+	writeMeanAndMax(data, "triangles", triangleCounts);
+	data << ",\n";
+	writeMeanAndMax(data, "drawCalls", drawCallCounts);
+	data << ",\n";
+
+	writeMeanAndMax(data, "glDrawCalls", selectCounter(callCounters, &CallCounters::drawCalls));
+	data << ",\n";
+	writeMeanAndMax(data, "instances", selectCounter(callCounters, &CallCounters::instances));
+	data << ",\n";
+	writeMeanAndMax(data, "programSwitches", selectCounter(callCounters, &CallCounters::programSwitches));
+	data << ",\n";
+	writeMeanAndMax(data, "vaoBinds", selectCounter(callCounters, &CallCounters::vaoBinds));
+	data << ",\n";
+	writeMeanAndMax(data, "textureBinds", selectCounter(callCounters, &CallCounters::textureBinds));
+	data << ",\n";
+	writeMeanAndMax(data, "uniformUploads", selectCounter(callCounters, &CallCounters::uniformUploads));
+	data << ",\n";
+
+	writeMemoryUsage(data);
+	data << "\n}\n";
+
+	if(!data)
+		return false;
+
+	Log::getInstance().info(string("Benchmark report is written to ") + appParameters.benchmarkOutputPath);
+
+	return true;
+}
+
+namespace
+{
+	void writeFrameTimes(ofstream &data, const vector<float> &frameTimes)
+	{
+		vector<float> sortedFrameTimes(frameTimes);
+		sort(sortedFrameTimes.begin(), sortedFrameTimes.end());
+
+		data << "{\"mean\": " << accumulate(frameTimes.begin(), frameTimes.end(), 0.) / frameTimes.size();
+		for(auto current: PERCENTILES)
+			data << ", \"p" << static_cast<int>(current) << "\": " << computePercentile(sortedFrameTimes, current);
+		data << ", \"max\": " << sortedFrameTimes.back() << "}";
+	}
+
+	template<typename T>
+	void writeMeanAndMax(ofstream &data, const char *name, const vector<T> &values)
+	{
+		double sum = accumulate(values.begin(), values.end(), 0.);
+		data << "\t\"" << name << "\": {\"mean\": " << sum / values.size() << ", \"max\": " << *max_element(values.begin(), values.end()) << "}";
+	}
+
+	vector<int> selectCounter(const vector<CallCounters> &counters, int CallCounters::*field)
+	{
+		vector<int> values;
+		values.reserve(counters.size());
+
+		for(auto &current: counters)
+			values.push_back(current.*field);
+
+		return values;
+	}
+
+	void writeMemoryUsage(ofstream &data)
+	{
+		data << "\t\"gpuMemoryBytes\": {";
+		for(int i = 0; i < MEMORY_CATEGORY_AMOUNT; i++)
+		{
+			const MemoryCategory category = static_cast<MemoryCategory>(i);
+			data << "\"" << getMemoryCategoryName(category) << "\": " << getMemoryUsage(category).bytes << ", ";
+		}
+		data << "\"Total\": " << getTotalMemoryUsage().bytes << "}";
+	}
+}
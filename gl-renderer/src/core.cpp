@@ -8,15 +8,21 @@
 
 #include "core.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 
 #include <glm/glm.hpp>
 
 #include "log.h"
 #include "graphics_lib/uniform_setters.h"
+#include "loaders/camera_path_loader.h"
+#include "profiler.h"
 #include "simulation/simulation_thread.h"
+#include "utils/camera_path_tools.h"
 #include "utils/math_tools.h"
 #include "visibility/region_visibility_calculation.h"
 
@@ -28,6 +34,7 @@ using namespace renderer::data;
 using namespace renderer::managers;
 using namespace renderer::graphics_lib;
 using namespace renderer::graphics_lib::videocard_data;
+using namespace renderer::loaders;
 using namespace renderer::simulation;
 using namespace renderer::utils;
 using namespace renderer::visibility;
@@ -39,6 +46,12 @@ namespace
 	constexpr float TIME_MILLISECONDS_IN_SECOND = 1000.f;
 
 	const char *CAMERA_FILENAME = "camera";
+	const char *CAMERA_PATH_FILENAME = "camera-path";
+	const char *PROFILER_TRACE_FILENAME = "trace.json";
+	const char *FRAME_TIMES_FILENAME = "frame-times.csv";
+
+	constexpr float RECORDING_KEYFRAME_INTERVAL = 0.1f; //Seconds. Spline smooths the motion between keyframes
+	constexpr float REPLAY_TIME_STEP = 1.f / 60.f; //Seconds
 	const char *DIRECTIONAL_LIGHT_STRING = "directional";
 
 	const glm::vec3 LIGHT_DIRECTION1 = glm::vec3(-1.f, -0.05f, -0.02f); //Sunrise
@@ -83,7 +96,8 @@ namespace
 
 Core::Core(GLFWwindow *wnd, FrameRenderer *frameRend, TCameraController &camera, SceneManager &sceneMgr, ShaderManager &shaderMgr):
 	frameRenderer(frameRend), cameraController(camera), horizontalRotation(0), verticalRotation(0), deltaTime(0), window(wnd), sceneManager(sceneMgr), shaderManager(shaderMgr),
-	simulationThread(nullptr), needTerminate(false)
+	uploadService(nullptr), isRecording(false), recordingTime(0.f), isReplaying(false), replayFrame(0), replayTimeStep(0.f), isSimulationReplayed(false), simulationThread(nullptr),
+	needTerminate(false)
 {
 	initialize(sceneManager.getCameraData());
 }
@@ -110,6 +124,7 @@ void Core::mainLoop()
 	visibilityFlags.resize(chunkMargins->size());
 	recalculateVisibility(chunkMargins, cameraPosition.x, cameraPosition.z, visibilityFlags);
 	frameRenderer->setVisibilityFlags(&visibilityFlags);
+	frameRenderer->setFrameTimeHistory(&frameTimeHistory);
 
 	steady_clock::time_point secondAgo, prevTime, curTime;
 	secondAgo = prevTime = curTime = steady_clock::now();
@@ -117,24 +132,75 @@ void Core::mainLoop()
 	int fps = 0, maxFps = 0;
 	stringstream ss;
 
+	vector<pair<const char*, float>> zoneTimes;
+	uint64_t zoneTimesStart = Profiler::getInstance().getTime();
+
 	while((glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS) && !glfwWindowShouldClose(window))
 	{
+		PROFILE_ZONE("Frame");
+
 		prevTime = curTime;
 		curTime = steady_clock::now();
-		deltaTime = duration_cast<milliseconds>(curTime - prevTime).count() / TIME_MILLISECONDS_IN_SECOND;
+		deltaTime = duration<float>(curTime - prevTime).count(); //Not truncated to milliseconds, otherwise fast frames have zero time
+		frameTimeHistory.addFrame(deltaTime * TIME_MILLISECONDS_IN_SECOND);
 
 		fps++;
-		if(duration_cast<milliseconds>(curTime - secondAgo).count() >= TIME_MILLISECONDS_IN_SECOND)
+		if(curTime - secondAgo >= 1s)
 		{
-			recalculateVisibility(chunkMargins, cameraPosition.x, cameraPosition.z, visibilityFlags);
-			frameRenderer->setVisibilityFlags(&visibilityFlags);
+			frameTimeHistory.updateStatistics();
+
+			if(!isReplaying) //Replay recalculates visibility by its own clock
+			{
+				recalculateVisibility(chunkMargins, cameraPosition.x, cameraPosition.z, visibilityFlags);
+				frameRenderer->setVisibilityFlags(&visibilityFlags);
+			}
 
 			ss.clear();
 			ss.seekp(0, ios::beg);
 			ss.str(string());
-			ss << fps << " FPS  " << frameRenderer->getDrawnTriangleCount() << " triangles drawn";
+			ss << fps << " FPS (" << fixed << setprecision(2) << TIME_MILLISECONDS_IN_SECOND / max(fps, 1) << " ms)  " << frameRenderer->getDrawnTriangleCount() << " triangles drawn";
 			frameRenderer->setStatisticsLine(ss.str());
 
+			ss.clear();
+			ss.seekp(0, ios::beg);
+			ss.str(string());
+			ss << "Shaded samples: " << frameRenderer->getShadedSampleCount() << "  Queue: " << fixed << setprecision(1) << frameRenderer->getRenderQueueTime() << " us";
+			frameRenderer->setRenderingLine(ss.str());
+
+			const DynamicResolution *dynamicResolution = frameRenderer->getDynamicResolution();
+			if(dynamicResolution)
+			{
+				ss.clear();
+				ss.seekp(0, ios::beg);
+				ss.str(string());
+				ss << "Scale: " << static_cast<int>(dynamicResolution->getScale() * 100.f + 0.5f) << (dynamicResolution->isTemporalUpscaling() ? "% TAAU" : "%") << fixed <<
+					setprecision(1);
+				if(dynamicResolution->getTargetFrameTime() > 0.f)
+					ss << "  Target: " << dynamicResolution->getTargetFrameTime() << " ms";
+				ss << "  GPU: " << dynamicResolution->getGpuFrameTime() << " ms";
+				frameRenderer->setResolutionLine(ss.str());
+			}
+
+			const PostprocessingRenderer *postprocessingRenderer = frameRenderer->getPostprocessingRenderer();
+			if(postprocessingRenderer)
+			{
+				ss.clear();
+				ss.seekp(0, ios::beg);
+				ss.str(string());
+				ss << "Post passes:" << fixed << setprecision(2);
+				for(int i = 0; i < postprocessingRenderer->getPassAmount(); i++)
+					ss << " " << postprocessingRenderer->getPassTime(i);
+				ss << " ms";
+				frameRenderer->setPostprocessingLine(ss.str());
+			}
+
+			//Main thread zones per frame, for the table next to GPU passes
+			Profiler::getInstance().getThreadZoneTimes(zoneTimesStart, zoneTimes);
+			for(auto &current: zoneTimes)
+				current.second /= max(fps, 1);
+			frameRenderer->setCpuZoneTimes(zoneTimes);
+			zoneTimesStart = Profiler::getInstance().getTime();
+
 			if(maxFps < fps)
 				maxFps = fps;
 			fps = 0;
@@ -144,19 +210,39 @@ void Core::mainLoop()
 			ss.clear();
 			ss.seekp(0, ios::beg);
 			ss.str(string());
-			ss << (simulationThread ? "Simulation is ON": "Simulation is OFF");
+			ss << ((simulationThread || isSimulationReplayed) ? "Simulation is ON": "Simulation is OFF");
+			if(isRecording)
+				ss << "  Recording path";
+			else if(isReplaying)
+				ss << "  Replaying path";
 			frameRenderer->setSimulationLine(ss.str());
+
+			if(uploadService)
+			{
+				ss.clear();
+				ss.seekp(0, ios::beg);
+				ss.str(string());
+				ss << "Uploads: " << uploadService->getQueueDepth() << " queued, " << uploadService->getBytesLastFrame() / 1024 << " KB/frame";
+				frameRenderer->setUploadLine(ss.str());
+			}
 		}
 
 		glfwPollEvents();
 		processUserInputs();
+		processReplay();
 
 		processSimulationChanges();
 
+		if(uploadService)
+			uploadService->processUploads();
+
 		frameRenderer->renderFrame();
 		frameRenderer->renderUi();
 
-		glfwSwapBuffers(window);
+		{
+			PROFILE_ZONE("Swap buffers"); //Includes waiting for videocard
+			glfwSwapBuffers(window);
+		}
 	}
 
 	Log::getInstance().info(to_string(maxFps) + " FPS max in this scene");
@@ -164,6 +250,8 @@ void Core::mainLoop()
 
 void Core::processUserInputs()
 {
+	PROFILE_ZONE("Core::processUserInputs");
+
 	static double prevXPosition = initXPosition(window), prevYPosition = initYPosition(window);
 	double xPosition, yPosition;
 	glfwGetCursorPos(window, &xPosition, &yPosition);
@@ -197,8 +285,14 @@ void Core::processUserInputs()
 		rightDelta = deltaTime * MOVEMENT_SPEED_FACTOR;
 	}
 
-	cameraController.update(horizontalRotation, verticalRotation, forwardDelta, rightDelta);
-	frameRenderer->updateCamera(cameraController.getViewMatrix());
+	if(!isReplaying) //Otherwise camera is driven by replay
+	{
+		cameraController.update(horizontalRotation, verticalRotation, forwardDelta, rightDelta);
+		frameRenderer->updateCamera(cameraController.getViewMatrix());
+	}
+
+	if(isRecording)
+		recordCameraKeyframe();
 
 	if(glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS)
 		pressedKeys[PRESSED_F5_INDEX] = true;
@@ -216,11 +310,64 @@ void Core::processUserInputs()
 		pressedKeys[PRESSED_F8_INDEX] = false;
 	}
 
+	if(glfwGetKey(window, GLFW_KEY_F6) == GLFW_PRESS)
+		pressedKeys[PRESSED_F6_INDEX] = true;
+	else if(pressedKeys[PRESSED_F6_INDEX])
+	{
+		if(isRecording)
+			stopRecording();
+		else if(!isReplaying)
+		{
+			Log::getInstance().info("Recording camera path");
+
+			recordedPath.keyframes.clear();
+			recordingTime = 0.f;
+			isRecording = true;
+			recordCameraKeyframe();
+		}
+
+		pressedKeys[PRESSED_F6_INDEX] = false;
+	}
+
+	if(glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS)
+		pressedKeys[PRESSED_F9_INDEX] = true;
+	else if(pressedKeys[PRESSED_F9_INDEX])
+	{
+		if(isReplaying)
+			stopReplay();
+		else if(!isRecording)
+		{
+			CameraPath path;
+			if(loadCameraPath(CAMERA_PATH_FILENAME, path))
+				startReplay(path, REPLAY_TIME_STEP);
+		}
+
+		pressedKeys[PRESSED_F9_INDEX] = false;
+	}
+
+	if(glfwGetKey(window, GLFW_KEY_F12) == GLFW_PRESS)
+		pressedKeys[PRESSED_F12_INDEX] = true;
+	else if(pressedKeys[PRESSED_F12_INDEX])
+	{
+		Profiler::getInstance().exportChromeTrace(PROFILER_TRACE_FILENAME);
+		pressedKeys[PRESSED_F12_INDEX] = false;
+	}
+
+	if(glfwGetKey(window, GLFW_KEY_F7) == GLFW_PRESS)
+		pressedKeys[PRESSED_F7_INDEX] = true;
+	else if(pressedKeys[PRESSED_F7_INDEX])
+	{
+		frameTimeHistory.writeCsv(FRAME_TIMES_FILENAME);
+		pressedKeys[PRESSED_F7_INDEX] = false;
+	}
+
 	if(glfwGetKey(window, GLFW_KEY_F11) == GLFW_PRESS)
 		pressedKeys[PRESSED_F11_INDEX] = true;
 	else if(pressedKeys[PRESSED_F11_INDEX])
 	{
-		if(!simulationThread)
+		if(isReplaying)
+			Log::getInstance().warning("Simulation can't be switched during replay");
+		else if(!simulationThread)
 		{
 			if(sceneManager.getScene().light.lightType == DIRECTIONAL_LIGHT_STRING)
 				startSimulation();
@@ -238,7 +385,9 @@ void Core::processUserInputs()
 
 void Core::processSimulationChanges()
 {
-	if(!simulationThread)
+	PROFILE_ZONE("Core::processSimulationChanges");
+
+	if(!simulationThread && !isSimulationReplayed)
 		return;
 
 	bool update;
@@ -359,6 +508,11 @@ void Core::restoreLight()
 	frameRenderer->setLightDirection(lightDirection);
 }
 
+void Core::setUploadService(UploadService *uploader)
+{
+	uploadService = uploader;
+}
+
 void Core::saveCameraData()
 {
 	ofstream data(CAMERA_FILENAME);
@@ -398,6 +552,123 @@ void Core::loadCameraData()
 	frameRenderer->setVisibilityFlags(&visibilityFlags);
 }
 
+void Core::recordCameraKeyframe()
+{
+	if(!recordedPath.keyframes.empty())
+	{
+		recordingTime += deltaTime;
+		if(recordingTime - recordedPath.keyframes.back().time < RECORDING_KEYFRAME_INTERVAL)
+			return;
+	}
+
+	CameraKeyframe keyframe;
+	keyframe.time = recordingTime;
+	keyframe.position = cameraController.getPosition();
+	keyframe.horizontalRotationRadians = horizontalRotation;
+	keyframe.verticalRotationRadians = verticalRotation;
+
+	recordedPath.keyframes.push_back(keyframe);
+}
+
+void Core::stopRecording()
+{
+	isRecording = false;
+
+	//The last pose is kept even if keyframe interval hasn't passed
+	if(!recordedPath.keyframes.empty() && recordedPath.keyframes.back().time < recordingTime)
+	{
+		CameraKeyframe keyframe;
+		keyframe.time = recordingTime;
+		keyframe.position = cameraController.getPosition();
+		keyframe.horizontalRotationRadians = horizontalRotation;
+		keyframe.verticalRotationRadians = verticalRotation;
+
+		recordedPath.keyframes.push_back(keyframe);
+	}
+
+	saveCameraPath(CAMERA_PATH_FILENAME, recordedPath);
+}
+
+void Core::startReplay(const CameraPath &path, float timeStep)
+{
+	if(path.keyframes.empty())
+		return;
+
+	replayedPath = path;
+	replayTimeStep = timeStep;
+	replayFrame = 0;
+	isReplaying = true;
+
+	//Simulation thread runs by real time, so the model is computed from replay clock instead
+	if(simulationThread)
+	{
+		stopSimulation();
+		isSimulationReplayed = true;
+	}
+
+	Log::getInstance().info(string("Replaying camera path, ") + to_string(getCameraPathDuration(replayedPath)) + " s");
+}
+
+bool Core::advanceReplay()
+{
+	if(!isReplaying)
+		return false;
+
+	const float time = replayFrame * replayTimeStep; //Not accumulated, so rounding errors don't add up
+	if(time > getCameraPathDuration(replayedPath) + replayTimeStep * 0.5f)
+		return false;
+
+	CameraKeyframe pose;
+	sampleCameraPath(replayedPath, time, pose);
+
+	glm::vec3 &cameraPosition = cameraController.getPosition();
+	cameraPosition = pose.position;
+	horizontalRotation = pose.horizontalRotationRadians;
+	verticalRotation = pose.verticalRotationRadians;
+
+	cameraController.update(horizontalRotation, verticalRotation, 0.f, 0.f);
+	frameRenderer->updateCamera(cameraController.getViewMatrix());
+
+	//Once per second of replay clock, as in real-time loop
+	if(replayFrame == 0 || floor(time) > floor(time - replayTimeStep))
+	{
+		recalculateVisibility(chunkMargins, cameraPosition.x, cameraPosition.z, visibilityFlags);
+		frameRenderer->setVisibilityFlags(&visibilityFlags);
+	}
+
+	frameRenderer->setSceneTime(time);
+
+	if(isSimulationReplayed)
+		simulateAtTime(simulationModel, time);
+
+	replayFrame++;
+
+	return true;
+}
+
+void Core::stopReplay()
+{
+	if(!isReplaying)
+		return;
+
+	isReplaying = false;
+	frameRenderer->setSceneTime(-1.f);
+
+	if(isSimulationReplayed)
+	{
+		isSimulationReplayed = false;
+		startSimulation();
+	}
+
+	Log::getInstance().info(string("Replay is finished after ") + to_string(replayFrame) + " frames");
+}
+
+void Core::processReplay()
+{
+	if(isReplaying && !advanceReplay())
+		stopReplay();
+}
+
 void Core::initialize(const Camera &camera)
 {
 	horizontalRotation = camera.horizontalRotationRadians;
@@ -437,6 +708,28 @@ void Core::onResize(int width, int height)
 		{
 			setPointShaderUniforms(current, static_cast<float>(width) / height, sceneManager.getLightData());
 		}
+
+		if(flags & ShaderFlags::FEATURE_CLUSTERED_LIGHTS)
+		{
+			setLightClusteringShaderUniforms(current, width, height);
+		}
+	}
+
+	vector<ShaderIds> &depthPrepassShaderIds = shaderManager.getDepthPrepassShaderIds(); //Empty if renderer has no depth pre-pass
+	if(depthPrepassShaderIds.empty())
+		return;
+
+	for(auto &[index, flags]: shaderFlags)
+	{
+		ShaderIds &current = depthPrepassShaderIds[index];
+		glUseProgram(current.id);
+
+		//Only projection is used
+		if(flags & ShaderFlags::FEATURE_DIRECTIONAL_LIGHT)
+			setDirectionalShaderUniforms(current, static_cast<float>(width) / height, sceneManager.getLightData());
+
+		if(flags & ShaderFlags::FEATURE_POINT_LIGHT)
+			setPointShaderUniforms(current, static_cast<float>(width) / height, sceneManager.getLightData());
 	}
 }
 
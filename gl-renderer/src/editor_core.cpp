@@ -19,12 +19,14 @@
 #include "editor_commands/insert_new_instance.h"
 #include "editor_commands/set_camera_position.h"
 #include "graphics_lib/rendering_scene_builder.h"
+#include "profiler.h"
 #include "utils/chunk_tools.h"
 #include "utils/editor_tools.h"
 #include "visibility/region_visibility_calculation.h"
 
 using namespace std;
 using namespace std::chrono;
+using namespace std::chrono_literals;
 using namespace renderer;
 using namespace renderer::data;
 using namespace renderer::editor_commands;
@@ -36,7 +38,6 @@ using namespace renderer::visibility;
 
 namespace
 {
-	constexpr float TIME_MILLISECONDS_IN_SECOND = 1000.f;
 	constexpr float EDITOR_INSTANCE_MOVEMENT_SPEED = 3.f;
 	constexpr float EDITOR_INSTANCE_ROTATION_SPEED = 15.f;
 	constexpr int EDITOR_FLOATS_PER_INSTANCE = 4;
@@ -93,15 +94,20 @@ void EditorCore::mainLoop()
 
 	while((glfwGetKey(window, GLFW_KEY_ESCAPE) != GLFW_PRESS) && !glfwWindowShouldClose(window))
 	{
+		PROFILE_ZONE("Frame");
+
 		prevTime = curTime;
 		curTime = steady_clock::now();
-		deltaTime = duration_cast<milliseconds>(curTime - prevTime).count() / TIME_MILLISECONDS_IN_SECOND;
+		deltaTime = duration<float>(curTime - prevTime).count(); //Not truncated to milliseconds, otherwise fast frames have zero time
 
 		fps++;
-		if(duration_cast<milliseconds>(curTime - secondAgo).count() >= TIME_MILLISECONDS_IN_SECOND)
+		if(curTime - secondAgo >= 1s)
 		{
-			recalculateVisibility(chunkMargins, cameraPosition.x, cameraPosition.z, visibilityFlags);
-			frameRenderer->setVisibilityFlags(&visibilityFlags);
+			if(!isReplaying) //Replay recalculates visibility by its own clock
+			{
+				recalculateVisibility(chunkMargins, cameraPosition.x, cameraPosition.z, visibilityFlags);
+				frameRenderer->setVisibilityFlags(&visibilityFlags);
+			}
 
 			ss.clear();
 			ss.seekp(0, ios::beg);
@@ -117,6 +123,10 @@ void EditorCore::mainLoop()
 
 		glfwPollEvents();
 		processUserInputs();
+		processReplay();
+
+		if(uploadService)
+			uploadService->processUploads();
 
 		editorFrameRenderer.renderFrame();
 		editorFrameRenderer.renderEditorUi();
@@ -0,0 +1,124 @@
+/* frame_time_history.cpp
+ * Frame times of the session with percentiles and hitch counts of recent frames
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "frame_time_history.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#include "log.h"
+#include "utils/math_tools.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::utils;
+
+FrameTimeHistory::FrameTimeHistory():
+	recentAmount(0), nextRecent(0), percentile50(0.f), percentile95(0.f), percentile99(0.f), maxTime(0.f), hitchCount(0), sessionHitchCount(0)
+{
+	sortedTimes.reserve(RECENT_FRAME_AMOUNT);
+}
+
+void FrameTimeHistory::addFrame(float frameTime)
+{
+	recentTimes[nextRecent] = frameTime;
+	nextRecent = (nextRecent + 1) % RECENT_FRAME_AMOUNT;
+	if(recentAmount < RECENT_FRAME_AMOUNT)
+		recentAmount++;
+
+	sessionTimes.push_back(frameTime);
+
+	if(percentile50 > 0.f && frameTime > percentile50 * HITCH_MEDIAN_FACTOR)
+		sessionHitchCount++;
+}
+
+void FrameTimeHistory::updateStatistics()
+{
+	if(recentAmount == 0)
+		return;
+
+	sortedTimes.assign(recentTimes, recentTimes + recentAmount);
+	sort(sortedTimes.begin(), sortedTimes.end());
+
+	percentile50 = computePercentile(sortedTimes, 50.f);
+	percentile95 = computePercentile(sortedTimes, 95.f);
+	percentile99 = computePercentile(sortedTimes, 99.f);
+	maxTime = sortedTimes.back();
+
+	const float hitchTime = percentile50 * HITCH_MEDIAN_FACTOR;
+	hitchCount = sortedTimes.end() - upper_bound(sortedTimes.begin(), sortedTimes.end(), hitchTime);
+}
+
+bool FrameTimeHistory::writeCsv(const string &path) const
+{
+	ofstream data(path);
+	if(!data.is_open())
+	{
+		Log::getInstance().error(path + " can't be created");
+		return false;
+	}
+
+	data << fixed << setprecision(3);
+	data << "frame,time_ms\n";
+	for(size_t i = 0; i < sessionTimes.size(); i++)
+		data << i << "," << sessionTimes[i] << "\n";
+
+	if(!data)
+	{
+		Log::getInstance().error(string("Can't write ") + path);
+		return false;
+	}
+
+	Log::getInstance().info(to_string(sessionTimes.size()) + " frame times are written to " + path);
+
+	return true;
+}
+
+const float* FrameTimeHistory::getRecentTimes() const
+{
+	return recentTimes;
+}
+
+int FrameTimeHistory::getRecentAmount() const
+{
+	return recentAmount;
+}
+
+int FrameTimeHistory::getRecentOffset() const
+{
+	return (recentAmount < RECENT_FRAME_AMOUNT) ? 0 : nextRecent;
+}
+
+float FrameTimeHistory::getPercentile50() const
+{
+	return percentile50;
+}
+
+float FrameTimeHistory::getPercentile95() const
+{
+	return percentile95;
+}
+
+float FrameTimeHistory::getPercentile99() const
+{
+	return percentile99;
+}
+
+float FrameTimeHistory::getMaxTime() const
+{
+	return maxTime;
+}
+
+int FrameTimeHistory::getHitchCount() const
+{
+	return hitchCount;
+}
+
+int FrameTimeHistory::getSessionHitchCount() const
+{
+	return sessionHitchCount;
+}
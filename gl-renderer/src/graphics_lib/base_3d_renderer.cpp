@@ -7,44 +7,70 @@
 
 #include "graphics_lib/base_3d_renderer.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include <GL/glew.h>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "log.h"
+#include "common_constants.h"
 #include "data/shader_properties.h"
 #include "graphics_lib/light_setters.h"
+#include "graphics_lib/operations/counted_calls.h"
+#include "profiler.h"
 
 using namespace std;
 using namespace std::chrono;
 using namespace renderer;
 using namespace renderer::data;
 using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
 using namespace renderer::graphics_lib::videocard_data;
 
 namespace
 {
 	constexpr float MILLISECONDS_IN_SECOND = 1000.f;
+	constexpr float NANOSECONDS_IN_MICROSECOND = 1000.f;
 
 	const int8_t quadFlagsMaskArray[4] = { VisibilityFlags::QUAD1_FLAG, VisibilityFlags::QUAD2_FLAG, VisibilityFlags::QUAD3_FLAG, VisibilityFlags::QUAD4_FLAG };
+
+
+
+	/*
+	@brief Distance from camera along view direction to model matrix origin
+	*/
+	float calculateViewDepth(const glm::mat4 &viewMatrix, const glm::mat4 &model);
 }
 
 Base3DRenderer::Base3DRenderer(const vector<ShaderIds> &shaderIds, const ShaderIds &sky, const map<int, unsigned long long> &shaderFlags, bool isDirectional):
-	previousShader(-1), shaders(nullptr), shaderAmount(0), renderingScene(nullptr), visibilityFlagsPtr(nullptr), cameraPositionPtr(nullptr), skyShader(sky), triangleCount(0)
+	previousShader(-1), shaders(nullptr), shaderAmount(0), depthPrepassShaders(nullptr), renderingScene(nullptr), visibilityFlagsPtr(nullptr), cameraPositionPtr(nullptr), skyShader(sky), triangleCount(0), drawCallCount(0), sceneTime(-1.f), gpuPassTimer(nullptr),
+	currentSampleQuery(0), shadedSampleCount(0), renderQueueTime(0.f)
 {
 	initialize(shaderFlags, isDirectional);
 	copyShaderArray(shaderIds);
+
+	glCreateQueries(GL_SAMPLES_PASSED, SAMPLE_QUERY_AMOUNT, shadedSampleQueryIds);
+	for(int i = 0; i < SAMPLE_QUERY_AMOUNT; i++)
+		isSampleQueryUsed[i] = false;
 }
 
 Base3DRenderer::~Base3DRenderer()
 {
+	glDeleteQueries(SAMPLE_QUERY_AMOUNT, shadedSampleQueryIds);
+
 	if(shaders)
 	{
 		delete[] shaders;
 		shaders = nullptr;
 	}
 
+	if(depthPrepassShaders)
+	{
+		delete[] depthPrepassShaders;
+		depthPrepassShaders = nullptr;
+	}
+
 	if(renderingScene)
 	{
 		delete renderingScene;
@@ -54,133 +80,41 @@ Base3DRenderer::~Base3DRenderer()
 
 void Base3DRenderer::renderOpaqueMeshes()
 {
-	const int chunkAmount = renderingScene->chunkAmount;
-
-	//Opaque objects
-	for(int chunkIndex = 0; chunkIndex < chunkAmount; chunkIndex++)
-	{
-		const VisibilityFlags &chunkFlags = (*visibilityFlagsPtr)[chunkIndex];
-
-		if(!(chunkFlags.isChunkVisible))
-			continue;
-
-		for(int quadIndex = 0; quadIndex < 4; quadIndex++)
-		{
-			if(!(chunkFlags.quadVisibility & quadFlagsMaskArray[quadIndex]))
-				continue;
-
-			const int objectsInQuad = renderingScene->opaqueObjects[chunkIndex].quad[quadIndex].amount;
-
-			if(objectsInQuad == 0)
-				continue;
-
-			const ObjectQuadSubdivision::ObjectNode *objectArray = renderingScene->opaqueObjects[chunkIndex].quad[quadIndex].objectsInQuad;
-
-			for(int i = 0; i < objectsInQuad; i++)
-			{
-				if(previousShader != objectArray[i].shaderIndex)
-				{
-					glUseProgram(shaders[objectArray[i].shaderIndex].id);
-					previousShader = objectArray[i].shaderIndex;
-				}
-
-				glUniformMatrix4fv(shaders[objectArray[i].shaderIndex].unifView, 1, GL_FALSE, &viewMatrix[0][0]); //viewMatrix is common for objects, terrain and particles
-
-				(this->*renderObjects[objectArray[i].shaderIndex])(objectArray[i]);
-			}
-		}
-	}
-
-	//Particles
-	for(int chunkIndex = 0; chunkIndex < chunkAmount; chunkIndex++)
-	{
-		const VisibilityFlags &chunkFlags = (*visibilityFlagsPtr)[chunkIndex];
-
-		if(!(chunkFlags.isChunkVisible))
-			continue;
-
-		for(int quadIndex = 0; quadIndex < 4; quadIndex++)
-		{
-			if(!(chunkFlags.quadVisibility & quadFlagsMaskArray[quadIndex]))
-				continue;
-
-			const int groupsInQuad = renderingScene->particles[chunkIndex].quad[quadIndex].amount;
+	PROFILE_ZONE("Base3DRenderer::renderOpaqueMeshes");
 
-			if(groupsInQuad == 0)
-				continue;
-
-			const ParticleQuadSubdivision::ParticleNode *particleArray = renderingScene->particles[chunkIndex].quad[quadIndex].groupsInQuad;
-
-			for(int i = 0; i < groupsInQuad; i++)
-			{
-				if(previousShader != particleArray[i].shaderIndex)
-				{
-					glUseProgram(shaders[particleArray[i].shaderIndex].id);
-					previousShader = particleArray[i].shaderIndex;
-				}
-
-				glUniformMatrix4fv(shaders[particleArray[i].shaderIndex].unifView, 1, GL_FALSE, &viewMatrix[0][0]); //viewMatrix is common for objects, terrain and particles
-
-				(this->*renderParticles)(particleArray[i]);
-			}
-		}
-	}
-
-	//Terrain (opaque)
-
-	glUseProgram(shaders[renderingScene->terrain[0].shaderIndex].id); //The same shader for all chunks
-	glUniformMatrix4fv(shaders[renderingScene->terrain[0].shaderIndex].unifView, 1, GL_FALSE, &viewMatrix[0][0]); //viewMatrix is common for objects, terrain and particles
-	previousShader = renderingScene->terrain[0].shaderIndex;
-
-	for(int i = 0; i < renderingScene->chunkAmount; i++)
-	{
-		if(!((*visibilityFlagsPtr)[i].isChunkVisible))
-			continue;
-
-		(this->*renderTerrain)(i);
-	}
+	renderQueueItems(0, renderQueue.getTransparentStart());
 }
 
 void Base3DRenderer::renderTransparentMeshes()
 {
-	if(!renderingScene->transparentObjects)
-		return;
-
-	const int chunkAmount = renderingScene->chunkAmount;
-
-	for(int chunkIndex = 0; chunkIndex < chunkAmount; chunkIndex++)
-	{
-		const VisibilityFlags &chunkFlags = (*visibilityFlagsPtr)[chunkIndex];
-
-		if(!(chunkFlags.isChunkVisible))
-			continue;
+	PROFILE_ZONE("Base3DRenderer::renderTransparentMeshes");
 
-		for(int quadIndex = 0; quadIndex < 4; quadIndex++)
-		{
-			if(!(chunkFlags.quadVisibility & quadFlagsMaskArray[quadIndex]))
-				continue;
+	renderQueueItems(renderQueue.getTransparentStart(), renderQueue.getItemAmount());
+}
 
-			const int objectsInQuad = renderingScene->transparentObjects[chunkIndex].quad[quadIndex].amount;
+void Base3DRenderer::renderDepthPrepass()
+{
+	PROFILE_ZONE("Base3DRenderer::renderDepthPrepass");
 
-			if(objectsInQuad == 0)
-				continue;
+	if(!depthPrepassShaders)
+		return;
 
-			const ObjectQuadSubdivision::ObjectNode *objectArray = renderingScene->transparentObjects[chunkIndex].quad[quadIndex].objectsInQuad;
+	//Rendering methods take uniforms from "shaders" array, so depth-only shaders replace it for a while
+	ShaderIds *shadingShaders = shaders;
+	shaders = depthPrepassShaders;
+	previousShader = -1;
 
-			for(int i = 0; i < objectsInQuad; i++)
-			{
-				if(previousShader != objectArray[i].shaderIndex)
-				{
-					glUseProgram(shaders[objectArray[i].shaderIndex].id);
-					previousShader = objectArray[i].shaderIndex;
-				}
+	int shadingTriangleCount = triangleCount;
+	int shadingDrawCallCount = drawCallCount;
 
-				glUniformMatrix4fv(shaders[objectArray[i].shaderIndex].unifView, 1, GL_FALSE, &viewMatrix[0][0]); //viewMatrix is common for objects, terrain and particles
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	renderOpaqueMeshes();
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
-				(this->*renderObjects[objectArray[i].shaderIndex])(objectArray[i]);
-			}
-		}
-	}
+	triangleCount = shadingTriangleCount; //Only shaded triangles are counted
+	drawCallCount = shadingDrawCallCount;
+	shaders = shadingShaders;
+	previousShader = -1;
 }
 
 void Base3DRenderer::renderTerrainDirectional(int index)
@@ -188,17 +122,18 @@ void Base3DRenderer::renderTerrainDirectional(int index)
 	RenderingTerrain &currentRenderingChunk = renderingScene->terrain[index];
 	ObjectRenderingData &terrainData = renderingScene->terrain[index].terrainData;
 
-	glBindVertexArray(terrainData.vaoId);
-	glBindTextureUnit(0, terrainData.textureId);
+	bindVertexArray(terrainData.vaoId);
+	bindTextureUnit(0, terrainData.textureId);
 
-	glUniform1i(shaders[currentRenderingChunk.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[currentRenderingChunk.shaderIndex].unifTextureId, 0);
 
-	glUniformMatrix4fv(shaders[currentRenderingChunk.shaderIndex].unifModel, 1, GL_FALSE, &(currentRenderingChunk.position)[0][0]);
+	uniformMatrix4fv(shaders[currentRenderingChunk.shaderIndex].unifModel, 1, GL_FALSE, &(currentRenderingChunk.position)[0][0]);
 	static glm::mat3 rotation(1.f); //No rotation support for terrain
-	glUniformMatrix3fv(shaders[currentRenderingChunk.shaderIndex].unifRotation, 1, GL_FALSE, &rotation[0][0]);
+	uniformMatrix3fv(shaders[currentRenderingChunk.shaderIndex].unifRotation, 1, GL_FALSE, &rotation[0][0]);
 
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, terrainData.vertexAmount);
+	drawArrays(GL_TRIANGLE_STRIP, 0, terrainData.vertexAmount);
 	triangleCount += terrainData.vertexAmount / 3;
+	drawCallCount++;
 }
 
 void Base3DRenderer::renderTerrainPoint(int index)
@@ -206,97 +141,100 @@ void Base3DRenderer::renderTerrainPoint(int index)
 	RenderingTerrain &currentRenderingChunk = renderingScene->terrain[index];
 	ObjectRenderingData &terrainData = renderingScene->terrain[index].terrainData;
 
-	glBindVertexArray(terrainData.vaoId);
-	glBindTextureUnit(0, terrainData.textureId);
+	bindVertexArray(terrainData.vaoId);
+	bindTextureUnit(0, terrainData.textureId);
 
-	glUniform1i(shaders[currentRenderingChunk.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[currentRenderingChunk.shaderIndex].unifTextureId, 0);
 
-	glUniformMatrix4fv(shaders[currentRenderingChunk.shaderIndex].unifModel, 1, GL_FALSE, &(currentRenderingChunk.position)[0][0]);
+	uniformMatrix4fv(shaders[currentRenderingChunk.shaderIndex].unifModel, 1, GL_FALSE, &(currentRenderingChunk.position)[0][0]);
 
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, terrainData.vertexAmount);
+	drawArrays(GL_TRIANGLE_STRIP, 0, terrainData.vertexAmount);
 	triangleCount += terrainData.vertexAmount / 3;
+	drawCallCount++;
 }
 
-void Base3DRenderer::renderObjectsDirectional(const ObjectQuadSubdivision::ObjectNode &objectInstances)
+void Base3DRenderer::renderObjectsDirectional(const ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount)
 {
 	const ObjectRenderingData &objectData = objectInstances.objectData;
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
 
-	glUniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
 
-	for(int i = 0; i < objectInstances.amount; i++) //Iterate all positions of object instances
+	for(int i = firstInstance; i < firstInstance + instanceAmount; i++) //Iterate positions of object instances
 	{
-		glUniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
-		glUniformMatrix3fv(shaders[objectInstances.shaderIndex].unifRotation, 1, GL_FALSE, &objectInstances.rotation[i][0][0]);
+		uniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
+		uniformMatrix3fv(shaders[objectInstances.shaderIndex].unifRotation, 1, GL_FALSE, &objectInstances.rotation[i][0][0]);
 
-		glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+		drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
 		triangleCount += objectData.vertexAmount / 3;
+		drawCallCount++;
 	}
 }
 
-void Base3DRenderer::renderObjectsDirectionalNormalmap(const ObjectQuadSubdivision::ObjectNode &objectInstances)
+void Base3DRenderer::renderObjectsDirectionalNormalmap(const ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount)
 {
 	const ObjectRenderingData &objectData = objectInstances.objectData;
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
-	glBindTextureUnit(1, objectData.normalTextureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
+	bindTextureUnit(1, objectData.normalTextureId);
 
-	glUniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
-	glUniform1i(shaders[objectInstances.shaderIndex].unifNormalTextureId, 1);
+	uniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[objectInstances.shaderIndex].unifNormalTextureId, 1);
 
-	for(int i = 0; i < objectInstances.amount; i++) //Iterate all positions of object instances
+	for(int i = firstInstance; i < firstInstance + instanceAmount; i++) //Iterate positions of object instances
 	{
-		glUniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
-		glUniformMatrix3fv(shaders[objectInstances.shaderIndex].unifRotation, 1, GL_FALSE, &objectInstances.rotation[i][0][0]);
+		uniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
+		uniformMatrix3fv(shaders[objectInstances.shaderIndex].unifRotation, 1, GL_FALSE, &objectInstances.rotation[i][0][0]);
 
-		glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+		drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
 		triangleCount += objectData.vertexAmount / 3;
+		drawCallCount++;
 	}
 }
 
-void Base3DRenderer::renderObjectsDirectionalWaves(const ObjectQuadSubdivision::ObjectNode &objectInstances)
+void Base3DRenderer::renderObjectsDirectionalWaves(const ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount)
 {
 	const ObjectRenderingData &objectData = objectInstances.objectData;
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
 
-	glUniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
 
-	steady_clock::time_point curTime = steady_clock::now();
-	float fTime = duration_cast<milliseconds>(curTime.time_since_epoch()).count() / MILLISECONDS_IN_SECOND;
-	glUniform1f(shaders[objectInstances.shaderIndex].unifTime, fTime);
+	uniform1f(shaders[objectInstances.shaderIndex].unifTime, getAnimationTime());
 
-	for(int i = 0; i < objectInstances.amount; i++) //Iterate all positions of object instances
+	for(int i = firstInstance; i < firstInstance + instanceAmount; i++) //Iterate positions of object instances
 	{
-		glUniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
-		glUniformMatrix3fv(shaders[objectInstances.shaderIndex].unifRotation, 1, GL_FALSE, &objectInstances.rotation[i][0][0]);
+		uniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
+		uniformMatrix3fv(shaders[objectInstances.shaderIndex].unifRotation, 1, GL_FALSE, &objectInstances.rotation[i][0][0]);
 
-		glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+		drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
 		triangleCount += objectData.vertexAmount / 3;
+		drawCallCount++;
 	}
 }
 
-void Base3DRenderer::renderObjectsDirectionalGlitter(const ObjectQuadSubdivision::ObjectNode &objectInstances)
+void Base3DRenderer::renderObjectsDirectionalGlitter(const ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount)
 {
 	const ObjectRenderingData &objectData = objectInstances.objectData;
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
 
-	glUniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
 
-	for(int i = 0; i < objectInstances.amount; i++) //Iterate all positions of object instances
+	for(int i = firstInstance; i < firstInstance + instanceAmount; i++) //Iterate positions of object instances
 	{
-		glUniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
-		glUniformMatrix3fv(shaders[objectInstances.shaderIndex].unifRotation, 1, GL_FALSE, &objectInstances.rotation[i][0][0]);
-		glUniform3fv(shaders[objectInstances.shaderIndex].unifCameraPosition, 1, &((*cameraPositionPtr)[0]));
+		uniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
+		uniformMatrix3fv(shaders[objectInstances.shaderIndex].unifRotation, 1, GL_FALSE, &objectInstances.rotation[i][0][0]);
+		uniform3fv(shaders[objectInstances.shaderIndex].unifCameraPosition, 1, &((*cameraPositionPtr)[0]));
 
-		glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+		drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
 		triangleCount += objectData.vertexAmount / 3;
+		drawCallCount++;
 	}
 }
 
@@ -305,95 +243,98 @@ void Base3DRenderer::renderObjectsDirectionalInstancing(const ParticleQuadSubdiv
 	const ParticleRenderingData &particleData = instanceGroup.data;
     const ObjectRenderingData &objectData = particleData.objectData;
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
 
-	glUniform1i(shaders[instanceGroup.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[instanceGroup.shaderIndex].unifTextureId, 0);
 
 	glm::mat3 unit(1.f);
-	glUniformMatrix4fv(shaders[instanceGroup.shaderIndex].unifModel, 1, GL_FALSE, &instanceGroup.arrangement[0][0]);
-	glUniformMatrix3fv(shaders[instanceGroup.shaderIndex].unifRotation, 1, GL_FALSE, &unit[0][0]); //Rotation is defined per-particle
+	uniformMatrix4fv(shaders[instanceGroup.shaderIndex].unifModel, 1, GL_FALSE, &instanceGroup.arrangement[0][0]);
+	uniformMatrix3fv(shaders[instanceGroup.shaderIndex].unifRotation, 1, GL_FALSE, &unit[0][0]); //Rotation is defined per-particle
 
-    glDrawArraysInstanced(GL_TRIANGLES, 0, objectData.vertexAmount, particleData.particleAmount);
+    drawArraysInstanced(GL_TRIANGLES, 0, objectData.vertexAmount, particleData.particleAmount);
     triangleCount += (objectData.vertexAmount / 3) * particleData.particleAmount;
+    drawCallCount++;
 }
 
-void Base3DRenderer::renderObjectsPoint(const ObjectQuadSubdivision::ObjectNode &objectInstances)
+void Base3DRenderer::renderObjectsPoint(const ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount)
 {
 	const ObjectRenderingData &objectData = objectInstances.objectData;
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
 
-	glUniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
 
-	for(int i = 0; i < objectInstances.amount; i++) //Iterate all positions of object instances
+	for(int i = firstInstance; i < firstInstance + instanceAmount; i++) //Iterate positions of object instances
 	{
-		glUniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
+		uniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
 
-		glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+		drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
 		triangleCount += objectData.vertexAmount / 3;
+		drawCallCount++;
 	}
 }
 
-void Base3DRenderer::renderObjectsPointNormalmap(const ObjectQuadSubdivision::ObjectNode &objectInstances)
+void Base3DRenderer::renderObjectsPointNormalmap(const ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount)
 {
 	const ObjectRenderingData &objectData = objectInstances.objectData;
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
-	glBindTextureUnit(1, objectData.normalTextureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
+	bindTextureUnit(1, objectData.normalTextureId);
 
-	glUniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
-	glUniform1i(shaders[objectInstances.shaderIndex].unifNormalTextureId, 1);
+	uniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[objectInstances.shaderIndex].unifNormalTextureId, 1);
 
-	for(int i = 0; i < objectInstances.amount; i++) //Iterate all positions of object instances
+	for(int i = firstInstance; i < firstInstance + instanceAmount; i++) //Iterate positions of object instances
 	{
-		glUniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
+		uniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
 
-		glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+		drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
 		triangleCount += objectData.vertexAmount / 3;
+		drawCallCount++;
 	}
 }
 
-void Base3DRenderer::renderObjectsPointWaves(const ObjectQuadSubdivision::ObjectNode &objectInstances)
+void Base3DRenderer::renderObjectsPointWaves(const ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount)
 {
 	const ObjectRenderingData &objectData = objectInstances.objectData;
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
 
-	glUniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
 
-	steady_clock::time_point curTime = steady_clock::now();
-	float fTime = duration_cast<milliseconds>(curTime.time_since_epoch()).count() / MILLISECONDS_IN_SECOND;
-	glUniform1f(shaders[objectInstances.shaderIndex].unifTime, fTime);
+	uniform1f(shaders[objectInstances.shaderIndex].unifTime, getAnimationTime());
 
-	for(int i = 0; i < objectInstances.amount; i++) //Iterate all positions of object instances
+	for(int i = firstInstance; i < firstInstance + instanceAmount; i++) //Iterate positions of object instances
 	{
-		glUniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
+		uniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
 
-		glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+		drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
 		triangleCount += objectData.vertexAmount / 3;
+		drawCallCount++;
 	}
 }
 
-void Base3DRenderer::renderObjectsPointGlitter(const ObjectQuadSubdivision::ObjectNode &objectInstances)
+void Base3DRenderer::renderObjectsPointGlitter(const ObjectQuadSubdivision::ObjectNode &objectInstances, int firstInstance, int instanceAmount)
 {
 	const ObjectRenderingData &objectData = objectInstances.objectData;
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
 
-	glUniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[objectInstances.shaderIndex].unifTextureId, 0);
 
-	for(int i = 0; i < objectInstances.amount; i++) //Iterate all positions of object instances
+	for(int i = firstInstance; i < firstInstance + instanceAmount; i++) //Iterate positions of object instances
 	{
-		glUniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
-		glUniform3fv(shaders[objectInstances.shaderIndex].unifCameraPosition, 1, &((*cameraPositionPtr)[0]));
+		uniformMatrix4fv(shaders[objectInstances.shaderIndex].unifModel, 1, GL_FALSE, &objectInstances.arrangement[i][0][0]);
+		uniform3fv(shaders[objectInstances.shaderIndex].unifCameraPosition, 1, &((*cameraPositionPtr)[0]));
 
-		glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+		drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
 		triangleCount += objectData.vertexAmount / 3;
+		drawCallCount++;
 	}
 }
 
@@ -402,33 +343,35 @@ void Base3DRenderer::renderObjectsPointInstancing(const ParticleQuadSubdivision:
 	const ParticleRenderingData &particleData = instanceGroup.data;
 	const ObjectRenderingData &objectData = particleData.objectData;
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
 
-	glUniform1i(shaders[instanceGroup.shaderIndex].unifTextureId, 0);
+	uniform1i(shaders[instanceGroup.shaderIndex].unifTextureId, 0);
 
 	glm::mat3 unit(1.f);
-	glUniformMatrix4fv(shaders[instanceGroup.shaderIndex].unifModel, 1, GL_FALSE, &instanceGroup.arrangement[0][0]);
-	glUniformMatrix3fv(shaders[instanceGroup.shaderIndex].unifRotation, 1, GL_FALSE, &unit[0][0]); //Rotation is defined per-particle
+	uniformMatrix4fv(shaders[instanceGroup.shaderIndex].unifModel, 1, GL_FALSE, &instanceGroup.arrangement[0][0]);
+	uniformMatrix3fv(shaders[instanceGroup.shaderIndex].unifRotation, 1, GL_FALSE, &unit[0][0]); //Rotation is defined per-particle
 
-    glDrawArraysInstanced(GL_TRIANGLES, 0, objectData.vertexAmount, particleData.particleAmount);
+    drawArraysInstanced(GL_TRIANGLES, 0, objectData.vertexAmount, particleData.particleAmount);
     triangleCount += (objectData.vertexAmount / 3) * particleData.particleAmount;
+    drawCallCount++;
 }
 
 void Base3DRenderer::renderSky()
 {
 	auto &objectData = renderingScene->sky;
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
 
-	glUniform1i(skyShader.unifTextureId, 0);
+	uniform1i(skyShader.unifTextureId, 0);
 
 	glm::mat4 model = glm::translate(glm::mat4(1.), *cameraPositionPtr);
-	glUniformMatrix4fv(skyShader.unifModel, 1, GL_FALSE, &model[0][0]);
+	uniformMatrix4fv(skyShader.unifModel, 1, GL_FALSE, &model[0][0]);
 
-	glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+	drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
 	triangleCount += objectData.vertexAmount / 3;
+	drawCallCount++;
 }
 
 void Base3DRenderer::setLightDirection(const glm::vec3 &direction)
@@ -438,7 +381,7 @@ void Base3DRenderer::setLightDirection(const glm::vec3 &direction)
 		if(!shaders[i].isDirectionalLight)
 			continue;
 
-		glUseProgram(shaders[i].id);
+		useProgram(shaders[i].id);
 		setCustomLightDirection(shaders[i], direction);
 	}
 
@@ -452,7 +395,7 @@ void Base3DRenderer::setDiffuseLightColour(const glm::vec3 &colour)
 		if(!shaders[i].isDirectionalLight)
 			continue;
 
-		glUseProgram(shaders[i].id);
+		useProgram(shaders[i].id);
 		setCustomDiffuseLightColour(shaders[i], colour);
 	}
 
@@ -466,13 +409,60 @@ void Base3DRenderer::setAmbientLightColour(const glm::vec3 &colour)
 		if(!shaders[i].isDirectionalLight)
 			continue;
 
-		glUseProgram(shaders[i].id);
+		useProgram(shaders[i].id);
 		setCustomAmbientLightColour(shaders[i], colour);
 	}
 
 	previousShader = -1; //Request to set appropriate shader when needed
 }
 
+void Base3DRenderer::setViewportSize(int width, int height)
+{
+	//Forward+ shaders find fragment cluster by window coordinates
+	const glm::vec2 screenSize(width, height);
+	for(int i = 0; i < shaderAmount; i++)
+	{
+		if(shaders[i].unifScreenSize == -1u)
+			continue;
+
+		useProgram(shaders[i].id);
+		uniform2fv(shaders[i].unifScreenSize, 1, &screenSize[0]);
+	}
+
+	previousShader = -1;
+}
+
+bool Base3DRenderer::setPointLights(const vector<PointLight> &lights)
+{
+	Log::getInstance().error("Forward renderer doesn't shade additional point lights");
+	return false;
+}
+
+void Base3DRenderer::setProjection(const glm::mat4 &projection)
+{
+	for(int i = 0; i < shaderAmount; i++)
+	{
+		useProgram(shaders[i].id);
+		uniformMatrix4fv(shaders[i].unifProjection, 1, GL_FALSE, &projection[0][0]);
+
+		if(depthPrepassShaders)
+		{
+			useProgram(depthPrepassShaders[i].id);
+			uniformMatrix4fv(depthPrepassShaders[i].unifProjection, 1, GL_FALSE, &projection[0][0]);
+		}
+	}
+
+	useProgram(skyShader.id);
+	uniformMatrix4fv(skyShader.unifProjection, 1, GL_FALSE, &projection[0][0]);
+
+	previousShader = -1;
+}
+
+void Base3DRenderer::setSceneTime(float seconds)
+{
+	sceneTime = seconds;
+}
+
 void Base3DRenderer::updateCamera(const glm::mat4 &newViewMatrix)
 {
 	viewMatrix = newViewMatrix;
@@ -493,6 +483,32 @@ void Base3DRenderer::setRenderingScene(RenderingScene *scene)
 	renderingScene = scene;
 }
 
+void Base3DRenderer::setDepthPrepassShaders(const vector<ShaderIds> &shaderIds)
+{
+	if(shaderIds.size() != static_cast<size_t>(shaderAmount))
+	{
+		Log::getInstance().error("Depth pre-pass shaders don't match scene shaders");
+		return;
+	}
+
+	if(depthPrepassShaders)
+		delete[] depthPrepassShaders;
+
+	depthPrepassShaders = new ShaderIds [shaderAmount];
+	for(int i = 0; i < shaderAmount; i++)
+		depthPrepassShaders[i] = shaderIds[i];
+}
+
+void Base3DRenderer::setWeightedBlendedTransparency(unique_ptr<WeightedBlendedTransparency> transparency)
+{
+	weightedBlendedTransparency = move(transparency);
+}
+
+void Base3DRenderer::setGpuPassTimer(GpuPassTimer *timer)
+{
+	gpuPassTimer = timer;
+}
+
 RenderingScene* Base3DRenderer::getRenderingScene()
 {
 	return renderingScene;
@@ -504,6 +520,21 @@ int Base3DRenderer::getDrawnTriangleCount() const
 	return triangleCount;
 }
 
+int Base3DRenderer::getDrawCallCount() const
+{
+	return drawCallCount;
+}
+
+unsigned int Base3DRenderer::getShadedSampleCount() const
+{
+	return shadedSampleCount;
+}
+
+float Base3DRenderer::getRenderQueueTime() const
+{
+	return renderQueueTime;
+}
+
 void Base3DRenderer::initialize(const map<int, unsigned long long> &shaderFlags, bool isDirectional)
 {
 	renderTerrain = isDirectional ? &Base3DRenderer::renderTerrainDirectional: &Base3DRenderer::renderTerrainPoint;
@@ -588,6 +619,48 @@ void Base3DRenderer::initialize(const map<int, unsigned long long> &shaderFlags,
 	}
 }
 
+void Base3DRenderer::beginShadedSampleQuery()
+{
+	glBeginQuery(GL_SAMPLES_PASSED, shadedSampleQueryIds[currentSampleQuery]);
+}
+
+void Base3DRenderer::endShadedSampleQuery()
+{
+	glEndQuery(GL_SAMPLES_PASSED);
+	isSampleQueryUsed[currentSampleQuery] = true;
+
+	//Query of the previous frame. Waiting for the current one would stall the pipeline
+	currentSampleQuery = (currentSampleQuery + 1) % SAMPLE_QUERY_AMOUNT;
+	if(!isSampleQueryUsed[currentSampleQuery])
+		return;
+
+	int isAvailable = 0;
+	glGetQueryObjectiv(shadedSampleQueryIds[currentSampleQuery], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+	if(isAvailable)
+		glGetQueryObjectuiv(shadedSampleQueryIds[currentSampleQuery], GL_QUERY_RESULT, &shadedSampleCount);
+}
+
+void Base3DRenderer::beginGpuPass(const char *name)
+{
+	if(gpuPassTimer)
+		gpuPassTimer->beginPass(name);
+}
+
+void Base3DRenderer::endGpuPass()
+{
+	if(gpuPassTimer)
+		gpuPassTimer->endPass();
+}
+
+float Base3DRenderer::getAnimationTime() const
+{
+	if(sceneTime >= 0.f)
+		return sceneTime;
+
+	steady_clock::time_point curTime = steady_clock::now();
+	return duration_cast<milliseconds>(curTime.time_since_epoch()).count() / MILLISECONDS_IN_SECOND;
+}
+
 void Base3DRenderer::copyShaderArray(const vector<ShaderIds> &shaderIds)
 {
 	shaderAmount = shaderIds.size();
@@ -596,3 +669,168 @@ void Base3DRenderer::copyShaderArray(const vector<ShaderIds> &shaderIds)
 	for(int i = 0; i < shaderAmount; i++)
 		shaders[i] = shaderIds[i];
 }
+
+void Base3DRenderer::prepareRenderQueue()
+{
+	PROFILE_ZONE("Base3DRenderer::prepareRenderQueue");
+
+	steady_clock::time_point startTime = steady_clock::now();
+
+	renderQueue.clear();
+
+	const int chunkAmount = renderingScene->chunkAmount;
+	for(int chunkIndex = 0; chunkIndex < chunkAmount; chunkIndex++)
+	{
+		const VisibilityFlags &chunkFlags = (*visibilityFlagsPtr)[chunkIndex];
+
+		if(!(chunkFlags.isChunkVisible))
+			continue;
+
+		for(int quadIndex = 0; quadIndex < 4; quadIndex++)
+		{
+			if(!(chunkFlags.quadVisibility & quadFlagsMaskArray[quadIndex]))
+				continue;
+
+			//Opaque objects, one item per node, so all its instances are drawn with one call. Node is sorted by the nearest instance
+
+			const ObjectQuadSubdivision &opaqueQuad = renderingScene->opaqueObjects[chunkIndex].quad[quadIndex];
+			for(int i = 0; i < opaqueQuad.amount; i++)
+			{
+				const ObjectQuadSubdivision::ObjectNode &node = opaqueQuad.objectsInQuad[i];
+
+				float nearestDepth = PROJECTION_FAR_CLIPPING;
+				for(int instance = 0; instance < node.amount; instance++)
+					nearestDepth = min(nearestDepth, calculateViewDepth(viewMatrix, node.arrangement[instance]));
+
+				RenderQueue::Item item = {RenderQueue::ItemType::OBJECT_INSTANCE, node.shaderIndex, &node, nullptr, 0, node.amount};
+				renderQueue.addOpaque(item, node.objectData.textureId, nearestDepth);
+			}
+
+			//Particles, one item per group
+
+			const ParticleQuadSubdivision &particleQuad = renderingScene->particles[chunkIndex].quad[quadIndex];
+			for(int i = 0; i < particleQuad.amount; i++)
+			{
+				const ParticleQuadSubdivision::ParticleNode &group = particleQuad.groupsInQuad[i];
+
+				RenderQueue::Item item = {RenderQueue::ItemType::PARTICLE_GROUP, group.shaderIndex, nullptr, &group, 0, 0};
+				renderQueue.addOpaque(item, group.data.objectData.textureId, calculateViewDepth(viewMatrix, group.arrangement));
+			}
+
+			//Transparent objects
+
+			if(!renderingScene->transparentObjects)
+				continue;
+
+			const ObjectQuadSubdivision &transparentQuad = renderingScene->transparentObjects[chunkIndex].quad[quadIndex];
+			for(int i = 0; i < transparentQuad.amount; i++)
+			{
+				const ObjectQuadSubdivision::ObjectNode &node = transparentQuad.objectsInQuad[i];
+
+				if(weightedBlendedTransparency) //Order doesn't matter, all instances are drawn at once
+				{
+					RenderQueue::Item item = {RenderQueue::ItemType::OBJECT_INSTANCE, node.shaderIndex, &node, nullptr, 0, node.amount};
+					renderQueue.addTransparent(item, node.objectData.textureId, 0.f);
+					continue;
+				}
+
+				for(int instance = 0; instance < node.amount; instance++)
+				{
+					RenderQueue::Item item = {RenderQueue::ItemType::OBJECT_INSTANCE, node.shaderIndex, &node, nullptr, instance, 1};
+					renderQueue.addTransparent(item, node.objectData.textureId, calculateViewDepth(viewMatrix, node.arrangement[instance]));
+				}
+			}
+		}
+
+		//Terrain (opaque)
+
+		const RenderingTerrain &chunk = renderingScene->terrain[chunkIndex];
+
+		RenderQueue::Item item = {RenderQueue::ItemType::TERRAIN_CHUNK, chunk.shaderIndex, nullptr, nullptr, chunkIndex, 0};
+		renderQueue.addOpaque(item, chunk.terrainData.textureId, calculateViewDepth(viewMatrix, chunk.position));
+	}
+
+	renderQueue.sort();
+
+	renderQueueTime = duration_cast<nanoseconds>(steady_clock::now() - startTime).count() / NANOSECONDS_IN_MICROSECOND;
+}
+
+void Base3DRenderer::renderQueueItems(int first, int last)
+{
+	int position = first;
+	while(position < last)
+	{
+		const RenderQueue::Item &item = renderQueue.getItem(position);
+
+		if(previousShader != item.shaderIndex)
+		{
+			useProgram(shaders[item.shaderIndex].id);
+			uniformMatrix4fv(shaders[item.shaderIndex].unifView, 1, GL_FALSE, &viewMatrix[0][0]); //viewMatrix is common for objects, terrain and particles
+			previousShader = item.shaderIndex;
+		}
+
+		switch(item.type)
+		{
+		case RenderQueue::ItemType::OBJECT_INSTANCE:
+		{
+			//Neighbouring transparent instances of the same node are drawn with one call
+			int instanceAmount = item.amount;
+			int itemAmount = 1;
+			while(position + itemAmount < last)
+			{
+				const RenderQueue::Item &next = renderQueue.getItem(position + itemAmount);
+				if(next.objectNode != item.objectNode || next.index != item.index + instanceAmount)
+					break;
+
+				instanceAmount += next.amount;
+				itemAmount++;
+			}
+
+			(this->*renderObjects[item.shaderIndex])(*item.objectNode, item.index, instanceAmount);
+			position += itemAmount;
+			break;
+		}
+
+		case RenderQueue::ItemType::PARTICLE_GROUP:
+			(this->*renderParticles)(*item.particleNode);
+			position++;
+			break;
+
+		case RenderQueue::ItemType::TERRAIN_CHUNK:
+			(this->*renderTerrain)(item.index);
+			position++;
+			break;
+		}
+	}
+}
+
+void Base3DRenderer::renderTransparency()
+{
+	previousShader = -1; //After sky
+
+	if(!weightedBlendedTransparency)
+	{
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		renderTransparentMeshes();
+		glDisable(GL_BLEND);
+		return;
+	}
+
+	if(renderQueue.getTransparentStart() == renderQueue.getItemAmount()) //No visible transparent meshes
+		return;
+
+	weightedBlendedTransparency->beginAccumulation();
+	renderTransparentMeshes();
+	weightedBlendedTransparency->composite();
+
+	previousShader = -1; //After composite pass
+}
+
+namespace
+{
+	float calculateViewDepth(const glm::mat4 &viewMatrix, const glm::mat4 &model)
+	{
+		return -(viewMatrix * model[3]).z; //Camera looks along negative Z
+	}
+}
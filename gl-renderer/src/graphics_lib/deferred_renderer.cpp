@@ -13,75 +13,121 @@
 #include "common_constants.h"
 #include "log.h"
 #include "graphics_lib/light_setters.h"
+#include "graphics_lib/operations/counted_calls.h"
+#include "graphics_lib/operations/memory_ledger.h"
 #include "graphics_lib/operations/mesh_operations.h"
 #include "utils/math_tools.h"
 
 using namespace std;
 using namespace renderer;
+using namespace renderer::data;
 using namespace renderer::graphics_lib;
 using namespace renderer::graphics_lib::operations;
 using namespace renderer::graphics_lib::videocard_data;
 using namespace renderer::utils;
 
+namespace
+{
+	const char *MEMORY_OWNER = "G-buffer";
+}
+
 DeferredRenderer::DeferredRenderer(const vector<ShaderIds> &shaderIds, const ShaderIds &sky, const map<int, unsigned long long> &shaderFlags, const ObjectRenderingData &sphere, bool isDirectional,
 	bool isDeferredDirectional, bool isFog, const ShaderIds &directionalLightPass, const ShaderIds &stencilPass, const ShaderIds &pointLightPass, const glm::vec3 &lightPosition, int width, int height):
-	Base3DRenderer(shaderIds, sky, shaderFlags, isDirectional), writeFramebufferId(0), framebufferWidth(width), framebufferHeight(height), useFog(isFog), directionalLightPassShaderId(directionalLightPass),
-	stencilPassId(stencilPass), pointLightPassShaderId(pointLightPass), lightSphere(sphere), pointLightPosition(lightPosition), isDeferredLightDirectional(isDeferredDirectional)
+	Base3DRenderer(shaderIds, sky, shaderFlags, isDirectional), writeFramebufferId(0), framebufferWidth(width), framebufferHeight(height), viewportWidth(width), viewportHeight(height),
+	useFog(isFog), directionalLightPassShaderId(directionalLightPass), stencilPassId(stencilPass), pointLightPassShaderId(pointLightPass), lightSphere(sphere), pointLightPosition(lightPosition),
+	isDeferredLightDirectional(isDeferredDirectional)
 {
 	initializeBuffer();
-	initializeQuadMesh(quadVaoId);
+	initializeQuadMesh(quadVaoId, quadVboId);
 }
 
 DeferredRenderer::~DeferredRenderer()
 {
-	glDeleteTextures(1, &depthTextureId);
+	deleteTrackedTexture(depthTextureId);
 	glDeleteVertexArrays(1, &quadVaoId);
-	glDeleteTextures(TOTAL_TEXTURES, textureIds);
+	deleteTrackedBuffer(quadVboId);
+	for(int i = 0; i < TOTAL_TEXTURES; i++)
+		deleteTrackedTexture(textureIds[i]);
 	glDeleteFramebuffers(1, &framebufferId);
 }
 
 void DeferredRenderer::render()
 {
 	triangleCount = 0;
+	drawCallCount = 0;
 	previousShader = -1; //Other classes may set their own shaders
 
+	prepareRenderQueue(); //Shared by depth pre-pass and shading pass
+
 	glEnable(GL_DEPTH_TEST);
 	glDepthMask(GL_TRUE);
 
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); //this
+
+	if(depthPrepassShaders) //G-buffer is written only for visible fragments
+	{
+		beginGpuPass("Depth pre-pass");
+		renderDepthPrepass();
+		endGpuPass();
+
+		glDepthFunc(GL_EQUAL);
+		glDepthMask(GL_FALSE);
+	}
+
+	beginGpuPass("Geometry");
+	beginShadedSampleQuery();
 	renderOpaqueMeshes(); //Geometry pass
+	endShadedSampleQuery();
+	endGpuPass();
 
+	glDepthFunc(GL_LEQUAL);
 	glDepthMask(GL_FALSE);
 
 	if(!isDeferredLightDirectional) //Stencil pass
+	{
+		beginGpuPass("Stencil");
 		performStencilPass();
+		endGpuPass();
+	}
 
 	glDisable(GL_DEPTH_TEST);
 
 	//Light passes
 
 	glBindFramebuffer(GL_FRAMEBUFFER, writeFramebufferId);
-	glViewport(0, 0, framebufferWidth, framebufferHeight);
+	glViewport(0, 0, viewportWidth, viewportHeight);
 
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); //this
+	beginGpuPass("Directional light");
 	performDirectionalLightPass();
+	endGpuPass();
 
 	if(!isDeferredLightDirectional)
+	{
+		beginGpuPass("Point lights");
 		performPointLightPass();
+		endGpuPass();
+	}
 
+	if(lightClusters)
+	{
+		beginGpuPass("Clustered lights");
+		performClusteredLightPass();
+		endGpuPass();
+	}
 
-	glBlitNamedFramebuffer(framebufferId, writeFramebufferId, 0, 0, framebufferWidth, framebufferHeight, 0, 0, framebufferWidth, framebufferHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	glBlitNamedFramebuffer(framebufferId, writeFramebufferId, 0, 0, viewportWidth, viewportHeight, 0, 0, viewportWidth, viewportHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
 	glBindFramebuffer(GL_FRAMEBUFFER, writeFramebufferId);
 
 	glEnable(GL_DEPTH_TEST);
 
+	beginGpuPass("Sky");
 	drawSkyAsForwardRendering();
+	endGpuPass();
 
-	previousShader = -1; //After sky
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	renderTransparentMeshes(); //Forward rendering
-	glDisable(GL_BLEND);
+	beginGpuPass("Transparency");
+	renderTransparency(); //Forward rendering
+	endGpuPass();
 
 	glDisable(GL_DEPTH_TEST);
 }
@@ -89,7 +135,7 @@ void DeferredRenderer::render()
 void DeferredRenderer::setTargetFramebuffer()
 {
 	glBindFramebuffer(GL_FRAMEBUFFER, framebufferId);
-	glViewport(0, 0, framebufferWidth, framebufferHeight);
+	glViewport(0, 0, viewportWidth, viewportHeight);
 }
 
 void DeferredRenderer::setWriteFramebufferId(unsigned int writeBuffer)
@@ -97,13 +143,19 @@ void DeferredRenderer::setWriteFramebufferId(unsigned int writeBuffer)
 	writeFramebufferId = writeBuffer;
 }
 
+void DeferredRenderer::setLightClusters(unique_ptr<LightClusters> clusters, const ShaderIds &clusteredLightPass)
+{
+	lightClusters = move(clusters);
+	clusteredLightPassShaderId = clusteredLightPass;
+}
+
 void DeferredRenderer::setLightDirection(const glm::vec3 &direction)
 {
 	Base3DRenderer::setLightDirection(direction);
 
 	if(directionalLightPassShaderId.isDirectionalLight)
 	{
-		glUseProgram(directionalLightPassShaderId.id);
+		useProgram(directionalLightPassShaderId.id);
 		setCustomLightDirection(directionalLightPassShaderId, direction);
 	}
 }
@@ -114,7 +166,7 @@ void DeferredRenderer::setDiffuseLightColour(const glm::vec3 &colour)
 
 	if(directionalLightPassShaderId.isDirectionalLight)
 	{
-		glUseProgram(directionalLightPassShaderId.id);
+		useProgram(directionalLightPassShaderId.id);
 		setCustomDiffuseLightColour(directionalLightPassShaderId, colour);
 	}
 }
@@ -125,19 +177,45 @@ void DeferredRenderer::setAmbientLightColour(const glm::vec3 &colour)
 
 	if(directionalLightPassShaderId.isDirectionalLight)
 	{
-		glUseProgram(directionalLightPassShaderId.id);
+		useProgram(directionalLightPassShaderId.id);
 		setCustomAmbientLightColour(directionalLightPassShaderId, colour);
 	}
 }
 
+void DeferredRenderer::setViewportSize(int width, int height)
+{
+	Base3DRenderer::setViewportSize(width, height);
+
+	viewportWidth = width;
+	viewportHeight = height;
+
+	//Point light pass restores position from window coordinates
+	const glm::vec2 screenSize(width, height);
+	useProgram(pointLightPassShaderId.id);
+	uniform2fv(pointLightPassShaderId.unifScreenSize, 1, &screenSize[0]);
+}
+
+bool DeferredRenderer::setPointLights(const vector<PointLight> &lights)
+{
+	if(!lightClusters)
+	{
+		Log::getInstance().error("Renderer is built without additional point lights, they can't be replaced");
+		return false;
+	}
+
+	lightClusters->setLights(lights);
+	return true;
+}
+
 void DeferredRenderer::initializeBuffer()
 {
 	glCreateFramebuffers(1, &framebufferId);
 
-	glCreateTextures(GL_TEXTURE_2D, TOTAL_TEXTURES, textureIds);
+	static const GLenum textureFormats[TOTAL_TEXTURES] = {GL_RGBA8, GL_RG16};
+
 	for(int i = 0; i < TOTAL_TEXTURES; i++)
 	{
-		glTextureStorage2D(textureIds[i], 1, GL_RGB32F, framebufferWidth, framebufferHeight);
+		textureIds[i] = createTrackedTexture(1, textureFormats[i], framebufferWidth, framebufferHeight, MemoryCategory::RENDER_TARGETS, MEMORY_OWNER);
 		glTextureParameteri(textureIds[i], GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTextureParameteri(textureIds[i], GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glTextureParameteri(textureIds[i], GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -146,12 +224,16 @@ void DeferredRenderer::initializeBuffer()
 		glNamedFramebufferTexture(framebufferId, GL_COLOR_ATTACHMENT0 + i, textureIds[i], 0);
 	}
 
-	glCreateTextures(GL_TEXTURE_2D, 1, &depthTextureId);
-	glTextureStorage2D(depthTextureId, 1, GL_DEPTH24_STENCIL8, framebufferWidth, framebufferHeight); //The depth is 24-bit instead of 32 so that sky is drawn correctly
+	depthTextureId = createTrackedTexture(1, GL_DEPTH24_STENCIL8, framebufferWidth, framebufferHeight, MemoryCategory::RENDER_TARGETS, MEMORY_OWNER); //The depth is 24-bit instead of 32 so that sky is drawn correctly
+	glTextureParameteri(depthTextureId, GL_DEPTH_STENCIL_TEXTURE_MODE, GL_DEPTH_COMPONENT);
+	glTextureParameteri(depthTextureId, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTextureParameteri(depthTextureId, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTextureParameteri(depthTextureId, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(depthTextureId, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
 	glNamedFramebufferTexture(framebufferId, GL_DEPTH_STENCIL_ATTACHMENT, depthTextureId, 0);
 
-	GLenum drawBuffers[TOTAL_TEXTURES] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3};
+	GLenum drawBuffers[TOTAL_TEXTURES] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
 	glNamedFramebufferDrawBuffers(framebufferId, TOTAL_TEXTURES, drawBuffers); //Multi-render target
 }
 
@@ -159,7 +241,7 @@ void DeferredRenderer::performStencilPass()
 {
 	glEnable(GL_STENCIL_TEST);
 
-	glUseProgram(stencilPassId.id);
+	useProgram(stencilPassId.id);
 
 	glDrawBuffer(GL_NONE);
 	glDisable(GL_CULL_FACE);
@@ -172,15 +254,15 @@ void DeferredRenderer::performStencilPass()
 	float sphereRadius = computeBoundingSphereRadius(POINT_LIGHT_POWER);
 	modelMatrix = glm::scale(modelMatrix, glm::vec3(sphereRadius, sphereRadius, sphereRadius));
 	modelMatrix = glm::translate(modelMatrix, pointLightPosition);
-	glUniformMatrix4fv(pointLightPassShaderId.unifModel, 1, GL_FALSE, &modelMatrix[0][0]);
-	glUniformMatrix4fv(pointLightPassShaderId.unifView, 1, GL_FALSE, &viewMatrix[0][0]);
+	uniformMatrix4fv(pointLightPassShaderId.unifModel, 1, GL_FALSE, &modelMatrix[0][0]);
+	uniformMatrix4fv(pointLightPassShaderId.unifView, 1, GL_FALSE, &viewMatrix[0][0]);
 
-	glBindVertexArray(lightSphere.vaoId);
+	bindVertexArray(lightSphere.vaoId);
 
-	glDrawArrays(GL_TRIANGLES, 0, lightSphere.vertexAmount);
+	drawArrays(GL_TRIANGLES, 0, lightSphere.vertexAmount);
 
 	glEnable(GL_CULL_FACE);
-	static const GLenum drawBuffers[TOTAL_TEXTURES] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3};
+	static const GLenum drawBuffers[TOTAL_TEXTURES] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
 	glDrawBuffers(TOTAL_TEXTURES, drawBuffers);
 
 	glDisable(GL_STENCIL_TEST);
@@ -188,30 +270,28 @@ void DeferredRenderer::performStencilPass()
 
 void DeferredRenderer::performDirectionalLightPass()
 {
-	glUseProgram(directionalLightPassShaderId.id);
+	useProgram(directionalLightPassShaderId.id);
 
 	if(useFog)
 	{
-		glUniformMatrix4fv(directionalLightPassShaderId.unifView, 1, GL_FALSE, &viewMatrix[0][0]);
-
-		glBindTextureUnit(0, textureIds[TEXTURE_INDEX_POSITION]);
-		glUniform1i(directionalLightPassShaderId.unifPositionComponentId, 0);
+		bindTextureUnit(0, depthTextureId);
+		uniform1i(directionalLightPassShaderId.unifDepthComponentId, 0);
 	}
 
-	glBindVertexArray(quadVaoId);
+	bindVertexArray(quadVaoId);
 
-	glBindTextureUnit(2, textureIds[TEXTURE_INDEX_NORMAL]);
-	glUniform1i(directionalLightPassShaderId.unifNormalComponentId, 2);
+	bindTextureUnit(2, textureIds[TEXTURE_INDEX_NORMAL]);
+	uniform1i(directionalLightPassShaderId.unifNormalComponentId, 2);
 
-	glBindTextureUnit(3, textureIds[TEXTURE_INDEX_DIFFUSE]);
-	glUniform1i(directionalLightPassShaderId.unifDiffuseComponentId, 3);
+	bindTextureUnit(3, textureIds[TEXTURE_INDEX_DIFFUSE]);
+	uniform1i(directionalLightPassShaderId.unifDiffuseComponentId, 3);
 
-	glDrawArrays(GL_TRIANGLES, 0, 6);
+	drawArrays(GL_TRIANGLES, 0, 6);
 }
 
 void DeferredRenderer::performPointLightPass()
 {
-	glUseProgram(pointLightPassShaderId.id);
+	useProgram(pointLightPassShaderId.id);
 
 	glStencilFunc(GL_NOTEQUAL, 0, 0xff);
 
@@ -223,31 +303,63 @@ void DeferredRenderer::performPointLightPass()
 	glBlendFunc(GL_ONE, GL_ONE);
 
 	glm::mat4 translationMatrix = glm::translate(glm::mat4(1.), pointLightPosition);
-	glUniformMatrix4fv(pointLightPassShaderId.unifModel, 1, GL_FALSE, &translationMatrix[0][0]);
-	glUniformMatrix4fv(pointLightPassShaderId.unifView, 1, GL_FALSE, &viewMatrix[0][0]);
+	uniformMatrix4fv(pointLightPassShaderId.unifModel, 1, GL_FALSE, &translationMatrix[0][0]);
+	uniformMatrix4fv(pointLightPassShaderId.unifView, 1, GL_FALSE, &viewMatrix[0][0]);
+
+	const glm::mat4 inverseView = glm::inverse(viewMatrix);
+	uniformMatrix4fv(pointLightPassShaderId.unifInverseView, 1, GL_FALSE, &inverseView[0][0]);
 
-	glBindVertexArray(lightSphere.vaoId);
+	bindVertexArray(lightSphere.vaoId);
 
-	glBindTextureUnit(0, textureIds[TEXTURE_INDEX_POSITION]);
-	glUniform1i(pointLightPassShaderId.unifPositionComponentId, 0);
+	bindTextureUnit(0, depthTextureId);
+	uniform1i(pointLightPassShaderId.unifDepthComponentId, 0);
 
-	glBindTextureUnit(2, textureIds[TEXTURE_INDEX_NORMAL]);
-	glUniform1i(pointLightPassShaderId.unifNormalComponentId, 2);
+	bindTextureUnit(2, textureIds[TEXTURE_INDEX_NORMAL]);
+	uniform1i(pointLightPassShaderId.unifNormalComponentId, 2);
 
-	glBindTextureUnit(3, textureIds[TEXTURE_INDEX_DIFFUSE]);
-	glUniform1i(pointLightPassShaderId.unifDiffuseComponentId, 3);
+	bindTextureUnit(3, textureIds[TEXTURE_INDEX_DIFFUSE]);
+	uniform1i(pointLightPassShaderId.unifDiffuseComponentId, 3);
 
-	glDrawArrays(GL_TRIANGLES, 0, lightSphere.vertexAmount);
+	drawArrays(GL_TRIANGLES, 0, lightSphere.vertexAmount);
 
 	glDisable(GL_BLEND);
 	glCullFace(GL_BACK);
 }
 
+void DeferredRenderer::performClusteredLightPass()
+{
+	lightClusters->update(viewMatrix);
+
+	useProgram(clusteredLightPassShaderId.id);
+
+	glEnable(GL_BLEND);
+	glBlendEquation(GL_FUNC_ADD);
+	glBlendFunc(GL_ONE, GL_ONE);
+
+	const glm::mat4 inverseView = glm::inverse(viewMatrix);
+	uniformMatrix4fv(clusteredLightPassShaderId.unifInverseView, 1, GL_FALSE, &inverseView[0][0]);
+
+	bindVertexArray(quadVaoId);
+
+	bindTextureUnit(0, depthTextureId);
+	uniform1i(clusteredLightPassShaderId.unifDepthComponentId, 0);
+
+	bindTextureUnit(2, textureIds[TEXTURE_INDEX_NORMAL]);
+	uniform1i(clusteredLightPassShaderId.unifNormalComponentId, 2);
+
+	bindTextureUnit(3, textureIds[TEXTURE_INDEX_DIFFUSE]);
+	uniform1i(clusteredLightPassShaderId.unifDiffuseComponentId, 3);
+
+	drawArrays(GL_TRIANGLES, 0, 6);
+
+	glDisable(GL_BLEND);
+}
+
 void DeferredRenderer::drawSkyAsForwardRendering()
 {
 	glDepthMask(GL_FALSE);
-	glUseProgram(skyShader.id);
-	glUniformMatrix4fv(skyShader.unifView, 1, GL_FALSE, &viewMatrix[0][0]);
+	useProgram(skyShader.id);
+	uniformMatrix4fv(skyShader.unifView, 1, GL_FALSE, &viewMatrix[0][0]);
 
 	renderSky();
 
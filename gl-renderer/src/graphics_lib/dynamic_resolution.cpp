@@ -0,0 +1,241 @@
+/* dynamic_resolution.cpp
+ * Renders scene at reduced resolution chosen by GPU frame time, then upscales it with sharpening
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "graphics_lib/dynamic_resolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "graphics_lib/operations/counted_calls.h"
+#include "graphics_lib/operations/memory_ledger.h"
+#include "graphics_lib/operations/mesh_operations.h"
+
+using namespace std;
+using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
+using namespace renderer::graphics_lib::videocard_data;
+
+namespace
+{
+	constexpr float colourClearValue[4] = {0., 0., 0., 1.};
+	constexpr float depthClearValue = 1.;
+
+	constexpr float MIN_SCALE = 0.5f;
+	constexpr float MAX_SCALE = 1.f;
+	constexpr float SCALE_STEP = 0.05f; //Scale is quantized, so tiny time changes don't move the viewport every frame
+
+	constexpr float UPSCALE_HEADROOM = 0.85f; //Scale goes up only when frame is well below the target
+	constexpr int SCALE_CHANGE_INTERVAL = 8; //Frames. Measurements after a change come with query delay
+	constexpr float GPU_TIME_SMOOTHING = 0.2f;
+
+	constexpr float MAX_SHARPNESS = 0.25f; //At minimal scale
+	constexpr float TEMPORAL_SHARPNESS = 0.1f; //History blending softens the image at any scale
+	constexpr float NANOSECONDS_IN_MILLISECOND = 1000000.f;
+
+	const char *MEMORY_OWNER = "Dynamic resolution";
+}
+
+DynamicResolution::DynamicResolution(const ShaderIds &upscale, int width, int height, float initialScale, float targetTime):
+	framebufferWidth(width), framebufferHeight(height), upscaleShaderId(upscale), currentTimerQuery(0), scale(clamp(initialScale, MIN_SCALE, MAX_SCALE)), targetFrameTime(targetTime),
+	gpuFrameTime(0.f), framesSinceScaleChange(0)
+{
+	initializeBuffer();
+	initializeQuadMesh(quadVaoId, quadVboId);
+
+	glCreateQueries(GL_TIME_ELAPSED, TIMER_QUERY_AMOUNT, timerQueryIds);
+	for(int i = 0; i < TIMER_QUERY_AMOUNT; i++)
+		isTimerQueryUsed[i] = false;
+}
+
+DynamicResolution::~DynamicResolution()
+{
+	glDeleteQueries(TIMER_QUERY_AMOUNT, timerQueryIds);
+	glDeleteVertexArrays(1, &quadVaoId);
+	deleteTrackedBuffer(quadVboId);
+	deleteTrackedTexture(depthTextureId);
+	deleteTrackedTexture(textureId);
+	glDeleteFramebuffers(1, &framebufferId);
+}
+
+void DynamicResolution::beginFrame()
+{
+	//The oldest query is reused for this frame, so its result is taken first
+	if(isTimerQueryUsed[currentTimerQuery])
+	{
+		int isAvailable = 0;
+		glGetQueryObjectiv(timerQueryIds[currentTimerQuery], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+		if(isAvailable)
+		{
+			GLuint64 elapsedTime = 0;
+			glGetQueryObjectui64v(timerQueryIds[currentTimerQuery], GL_QUERY_RESULT, &elapsedTime);
+
+			float frameTime = elapsedTime / NANOSECONDS_IN_MILLISECOND;
+			gpuFrameTime = (gpuFrameTime == 0.f) ? frameTime : glm::mix(gpuFrameTime, frameTime, GPU_TIME_SMOOTHING);
+
+			updateScale();
+		}
+	}
+
+	glBeginQuery(GL_TIME_ELAPSED, timerQueryIds[currentTimerQuery]);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+	glViewport(0, 0, getScaledWidth(), getScaledHeight());
+
+	glClearBufferfv(GL_COLOR, 0, colourClearValue);
+	glClearBufferfv(GL_DEPTH, 0, &depthClearValue);
+
+	if(temporalUpscaler)
+		temporalUpscaler->beginFrame(getScaledWidth(), getScaledHeight());
+}
+
+void DynamicResolution::upscale(unsigned int outputFramebufferId)
+{
+	const glm::vec2 renderScale(static_cast<float>(getScaledWidth()) / framebufferWidth, static_cast<float>(getScaledHeight()) / framebufferHeight);
+
+	glDisable(GL_DEPTH_TEST);
+
+	if(temporalUpscaler)
+		temporalUpscaler->resolve(textureId, depthTextureId, renderScale);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, outputFramebufferId);
+	glViewport(0, 0, framebufferWidth, framebufferHeight);
+
+	useProgram(upscaleShaderId.id);
+
+	bindVertexArray(quadVaoId);
+
+	if(temporalUpscaler) //History is already of full resolution
+	{
+		bindTextureUnit(0, temporalUpscaler->getResolvedTextureId());
+		uniform2f(upscaleShaderId.unifRenderScale, 1.f, 1.f);
+		uniform1f(upscaleShaderId.unifSharpness, TEMPORAL_SHARPNESS);
+	}
+	else
+	{
+		bindTextureUnit(0, textureId);
+		uniform2fv(upscaleShaderId.unifRenderScale, 1, &renderScale[0]);
+
+		//Bilinear upscaling blurs more at lower scale, native resolution is copied as is
+		uniform1f(upscaleShaderId.unifSharpness, MAX_SHARPNESS * (MAX_SCALE - scale) / (MAX_SCALE - MIN_SCALE));
+	}
+
+	uniform1i(upscaleShaderId.unifSceneTextureId, 0);
+
+	drawArrays(GL_TRIANGLES, 0, 6);
+
+	glEnable(GL_DEPTH_TEST);
+
+	glEndQuery(GL_TIME_ELAPSED);
+	isTimerQueryUsed[currentTimerQuery] = true;
+	currentTimerQuery = (currentTimerQuery + 1) % TIMER_QUERY_AMOUNT;
+}
+
+void DynamicResolution::setTemporalUpscaler(unique_ptr<TemporalUpscaler> upscaler)
+{
+	temporalUpscaler = move(upscaler);
+}
+
+bool DynamicResolution::isTemporalUpscaling() const
+{
+	return temporalUpscaler != nullptr;
+}
+
+const glm::mat4& DynamicResolution::getJitteredProjection() const
+{
+	return temporalUpscaler->getJitteredProjection();
+}
+
+void DynamicResolution::updateCamera(const glm::mat4 &newViewMatrix)
+{
+	if(temporalUpscaler)
+		temporalUpscaler->updateCamera(newViewMatrix);
+}
+
+unsigned int DynamicResolution::getFramebufferId() const
+{
+	return framebufferId;
+}
+
+int DynamicResolution::getScaledWidth() const
+{
+	return static_cast<int>(framebufferWidth * scale + 0.5f);
+}
+
+int DynamicResolution::getScaledHeight() const
+{
+	return static_cast<int>(framebufferHeight * scale + 0.5f);
+}
+
+float DynamicResolution::getScale() const
+{
+	return scale;
+}
+
+float DynamicResolution::getTargetFrameTime() const
+{
+	return targetFrameTime;
+}
+
+float DynamicResolution::getGpuFrameTime() const
+{
+	return gpuFrameTime;
+}
+
+void DynamicResolution::initializeBuffer()
+{
+	glCreateFramebuffers(1, &framebufferId);
+
+	textureId = createTrackedTexture(1, GL_RGBA8, framebufferWidth, framebufferHeight, MemoryCategory::RENDER_TARGETS, MEMORY_OWNER);
+	glTextureParameteri(textureId, GL_TEXTURE_MIN_FILTER, GL_LINEAR); //Bilinear upscaling
+	glTextureParameteri(textureId, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTextureParameteri(textureId, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTextureParameteri(textureId, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	glNamedFramebufferTexture(framebufferId, GL_COLOR_ATTACHMENT0, textureId, 0);
+
+	depthTextureId = createTrackedTexture(1, GL_DEPTH24_STENCIL8, framebufferWidth, framebufferHeight, MemoryCategory::RENDER_TARGETS, MEMORY_OWNER); //The same format as G-buffer depth, so it can be blitted
+	glTextureParameteri(depthTextureId, GL_DEPTH_STENCIL_TEXTURE_MODE, GL_DEPTH_COMPONENT); //Sampled by temporal resolve
+	glTextureParameteri(depthTextureId, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTextureParameteri(depthTextureId, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glNamedFramebufferTexture(framebufferId, GL_DEPTH_STENCIL_ATTACHMENT, depthTextureId, 0);
+
+	GLenum drawBuffers[1] = {GL_COLOR_ATTACHMENT0};
+	glNamedFramebufferDrawBuffers(framebufferId, 1, drawBuffers);
+}
+
+void DynamicResolution::updateScale()
+{
+	if(targetFrameTime <= 0.f) //Fixed scale
+		return;
+
+	framesSinceScaleChange++;
+	if(framesSinceScaleChange < SCALE_CHANGE_INTERVAL || gpuFrameTime <= 0.f)
+		return;
+
+	float newScale = scale;
+	if(gpuFrameTime > targetFrameTime)
+	{
+		//Shaded pixel amount is proportional to squared scale
+		float fittingScale = scale * sqrt(targetFrameTime / gpuFrameTime);
+		newScale = min(scale - SCALE_STEP, floor(fittingScale / SCALE_STEP) * SCALE_STEP);
+	}
+	else if(gpuFrameTime < targetFrameTime * UPSCALE_HEADROOM)
+	{
+		newScale = scale + SCALE_STEP;
+	}
+
+	newScale = clamp(round(newScale / SCALE_STEP) * SCALE_STEP, MIN_SCALE, MAX_SCALE);
+	if(fabs(newScale - scale) < SCALE_STEP * 0.5f)
+		return;
+
+	scale = newScale;
+	framesSinceScaleChange = 0;
+}
@@ -17,8 +17,11 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
+#include "graphics_lib/operations/counted_calls.h"
+
 using namespace std;
 using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
 using namespace renderer::graphics_lib::videocard_data;
 
 namespace
@@ -45,7 +48,7 @@ void EditorFrameRenderer::renderFrame()
 
 	if(objectRenderingData || areaMarkers)
 	{
-		glUseProgram(editorShaderId.id);
+		useProgram(editorShaderId.id);
 	}
 
 	if(objectRenderingData)
@@ -143,7 +146,7 @@ void EditorFrameRenderer::renderSelectedInstance()
 
 	/*
 	//OpenGL 3.3
-	glBindVertexArray(objectData.vaoId);
+	bindVertexArray(objectData.vaoId);
 
 	glEnableVertexAttribArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, objectData.vertexBufferId);
@@ -158,20 +161,20 @@ void EditorFrameRenderer::renderSelectedInstance()
 	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, (void*) nullptr);
 
 	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, objectData.textureId);
-	glUniform1i(editorShaderId.unifTextureId, 0);
+	bindTexture(GL_TEXTURE_2D, objectData.textureId);
+	uniform1i(editorShaderId.unifTextureId, 0);
 	*/
 
 	//OpenGL 4.5
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
 
 	//---
 
-	glUniformMatrix4fv(editorShaderId.unifModel, 1, GL_FALSE, &editorSelectedInstanceModel[0][0]);
-	glUniformMatrix3fv(editorShaderId.unifRotation, 1, GL_FALSE, &editorSelectedInstanceRotation[0][0]);
+	uniformMatrix4fv(editorShaderId.unifModel, 1, GL_FALSE, &editorSelectedInstanceModel[0][0]);
+	uniformMatrix3fv(editorShaderId.unifRotation, 1, GL_FALSE, &editorSelectedInstanceRotation[0][0]);
 
-	glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+	drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
 
 	/*
 	//OpenGL 3.3
@@ -187,7 +190,7 @@ void EditorFrameRenderer::renderMarkers()
 
 	//Appropriate for both versions 3.3 and 4.5
 
-	glBindVertexArray(objectData.vaoId);
+	bindVertexArray(objectData.vaoId);
 
 	glEnableVertexAttribArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, objectData.vertexBufferId);
@@ -202,18 +205,18 @@ void EditorFrameRenderer::renderMarkers()
 	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, (void*) nullptr);
 
 	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, objectData.textureId);
-	glUniform1i(editorShaderId.unifTextureId, 0);
+	bindTexture(GL_TEXTURE_2D, objectData.textureId);
+	uniform1i(editorShaderId.unifTextureId, 0);
 
 	for(int i = 0; i < markerAmount; i++)
 	{
 		glm::mat4 modelMatrix = glm::translate(glm::mat4(1.), glm::vec3(areaMarkers[i*3], areaMarkers[i*3+1], areaMarkers[i*3+2]));
-		glUniformMatrix4fv(editorShaderId.unifModel, 1, GL_FALSE, &modelMatrix[0][0]);
+		uniformMatrix4fv(editorShaderId.unifModel, 1, GL_FALSE, &modelMatrix[0][0]);
 
 		glm::mat3 unitMatrix(1.f);
-		glUniformMatrix3fv(editorShaderId.unifRotation, 1, GL_FALSE, &unitMatrix[0][0]);
+		uniformMatrix3fv(editorShaderId.unifRotation, 1, GL_FALSE, &unitMatrix[0][0]);
 
-		glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+		drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
 	}
 
 	glDisableVertexAttribArray(2);
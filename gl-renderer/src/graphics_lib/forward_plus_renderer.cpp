@@ -0,0 +1,93 @@
+/* forward_plus_renderer.cpp
+ * Forward+ renderer implementation: depth pre-pass, light clustering, forward shading with point lights from clusters
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "graphics_lib/forward_plus_renderer.h"
+
+#include <GL/glew.h>
+
+#include "graphics_lib/operations/counted_calls.h"
+
+using namespace std;
+using namespace renderer::data;
+using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
+using namespace renderer::graphics_lib::videocard_data;
+
+ForwardPlusRenderer::ForwardPlusRenderer(const vector<ShaderIds> &shaderIds, const ShaderIds &sky, const map<int, unsigned long long> &shaderFlags,
+	unique_ptr<LightClusters> clusters, const vector<PointLight> &sceneLights):
+	Base3DRenderer(shaderIds, sky, shaderFlags, true), lightClusters(move(clusters)), scenePointLights(sceneLights)
+{
+}
+
+ForwardPlusRenderer::~ForwardPlusRenderer()
+{
+}
+
+void ForwardPlusRenderer::render()
+{
+	triangleCount = 0;
+	drawCallCount = 0;
+	previousShader = -1; //Other classes may set their own shaders
+
+	prepareRenderQueue(); //Shared by depth pre-pass and shading pass
+
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	//Opaque meshes are shaded only where they are visible
+	beginGpuPass("Depth pre-pass");
+	renderDepthPrepass();
+	endGpuPass();
+
+	beginGpuPass("Light clustering");
+	lightClusters->update(viewMatrix);
+	lightClusters->bindBuffers();
+	endGpuPass();
+
+	if(depthPrepassShaders)
+	{
+		glDepthFunc(GL_EQUAL);
+		glDepthMask(GL_FALSE);
+	}
+
+	previousShader = -1; //After light clustering
+	beginGpuPass("Opaque");
+	beginShadedSampleQuery();
+	renderOpaqueMeshes();
+	endShadedSampleQuery();
+	endGpuPass();
+
+	glDepthFunc(GL_LEQUAL);
+
+	//Sky
+
+	beginGpuPass("Sky");
+	glDepthMask(GL_FALSE);
+	useProgram(skyShader.id);
+	uniformMatrix4fv(skyShader.unifView, 1, GL_FALSE, &viewMatrix[0][0]);
+
+	renderSky();
+
+	glDepthMask(GL_TRUE);
+	endGpuPass();
+
+	beginGpuPass("Transparency");
+	renderTransparency(); //Cluster buffers are still bound, so transparent meshes get point lights too
+	endGpuPass();
+}
+
+void ForwardPlusRenderer::setTargetFramebuffer()
+{
+}
+
+bool ForwardPlusRenderer::setPointLights(const vector<PointLight> &lights)
+{
+	vector<PointLight> clusteredLights(lights);
+	clusteredLights.insert(clusteredLights.end(), scenePointLights.begin(), scenePointLights.end());
+
+	lightClusters->setLights(clusteredLights);
+	return true;
+}
@@ -9,8 +9,11 @@
 
 #include <GL/glew.h>
 
+#include "graphics_lib/operations/counted_calls.h"
+
 using namespace std;
 using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
 using namespace renderer::graphics_lib::videocard_data;
 
 ForwardRenderer::ForwardRenderer(const vector<ShaderIds> &shaderIds, const ShaderIds &sky, const map<int, unsigned long long> &shaderFlags, bool isDirectional):
@@ -25,27 +28,46 @@ ForwardRenderer::~ForwardRenderer()
 void ForwardRenderer::render()
 {
 	triangleCount = 0;
+	drawCallCount = 0;
 	previousShader = -1; //Other classes may set their own shaders
 
+	prepareRenderQueue(); //Shared by depth pre-pass and shading pass
+
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); //this
 
+	if(depthPrepassShaders) //Expensive shaders run only for visible fragments
+	{
+		beginGpuPass("Depth pre-pass");
+		renderDepthPrepass();
+		endGpuPass();
+
+		glDepthFunc(GL_EQUAL);
+		glDepthMask(GL_FALSE);
+	}
+
+	beginGpuPass("Opaque");
+	beginShadedSampleQuery();
 	renderOpaqueMeshes();
+	endShadedSampleQuery();
+	endGpuPass();
+
+	glDepthFunc(GL_LEQUAL);
 
 	//Sky
 
+	beginGpuPass("Sky");
 	glDepthMask(GL_FALSE);
-	glUseProgram(skyShader.id);
-	glUniformMatrix4fv(skyShader.unifView, 1, GL_FALSE, &viewMatrix[0][0]);
+	useProgram(skyShader.id);
+	uniformMatrix4fv(skyShader.unifView, 1, GL_FALSE, &viewMatrix[0][0]);
 
 	renderSky();
 
 	glDepthMask(GL_TRUE);
+	endGpuPass();
 
-
-	previousShader = -1; //After sky
-	glEnable(GL_BLEND);
-	renderTransparentMeshes();
-	glDisable(GL_BLEND);
+	beginGpuPass("Transparency");
+	renderTransparency();
+	endGpuPass();
 }
 
 void ForwardRenderer::setTargetFramebuffer()
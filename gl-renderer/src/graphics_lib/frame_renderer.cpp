@@ -7,6 +7,7 @@
 
 #include "graphics_lib/frame_renderer.h"
 
+#include <cfloat>
 #include <cstring>
 
 #include <GL/glew.h>
@@ -14,22 +15,64 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
+#include "profiler.h"
+#include "graphics_lib/operations/memory_ledger.h"
+
 using namespace std;
 using namespace renderer::data;
 using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
 
 namespace
 {
 	const ImVec2 THIRDPARTY_FRAME_POSITION(20., 20.);
-	const ImVec2 THIRDPARTY_FRAME_SIZE(250., 70.);
 	const char *THIRDPARTY_FRAME_TITLE = "Statistics";
+
+	const char *GPU_PASS_TABLE_TITLE = "GPU passes";
+	const char *CPU_ZONE_TABLE_TITLE = "CPU zones";
+	const char *TIME_COLUMN_TITLE = "ms";
+	constexpr float TIME_COLUMN_WIDTH = 50.f;
+
+	const char *MEMORY_TABLE_TITLE = "GPU memory";
+	const char *MEMORY_COLUMN_TITLE = "MB";
+	const char *MEMORY_OWNERS_TITLE = "Largest owners";
+	constexpr int LARGEST_OWNER_AMOUNT = 8;
+	constexpr double BYTES_IN_MEGABYTE = 1024. * 1024.;
+
+	const ImVec2 FRAME_TIME_GRAPH_SIZE(300., 60.);
+
+
+
+	/*
+	@brief Draws two-column table of names and times
+	*/
+	void showTimeTable(const char *title, const vector<pair<const char*, float>> &rows);
+
+	/*
+	@brief Draws recent frame times with percentiles and hitch counts
+	*/
+	void showFrameTimeGraph(const renderer::FrameTimeHistory &history);
+
+	/*
+	@brief Draws memory ledger categories, owners are gathered only while their node is open
+	*/
+	void showMemoryTable();
 }
 
 FrameRenderer::FrameRenderer(Base3DRenderer *mainRend, PostprocessingRenderer *postprocessingRend, bool isDeferred):
-	mainRenderer(mainRend), postprocessingRenderer(postprocessingRend), isDeferredRenderer(isDeferred)
+	mainRenderer(mainRend), postprocessingRenderer(postprocessingRend), isDeferredRenderer(isDeferred), viewportWidth(0), viewportHeight(0),
+	gpuPassTimer(make_unique<GpuPassTimer>()), frameTimeHistory(nullptr)
 {
+	mainRenderer->setGpuPassTimer(gpuPassTimer.get());
+	if(postprocessingRenderer)
+		postprocessingRenderer->setGpuPassTimer(gpuPassTimer.get());
+
 	statisticsString[0] = '\0';
 	simulationString[0] = '\0';
+	uploadString[0] = '\0';
+	renderingString[0] = '\0';
+	resolutionString[0] = '\0';
+	postprocessingString[0] = '\0';
 }
 
 FrameRenderer::~FrameRenderer()
@@ -49,39 +92,99 @@ FrameRenderer::~FrameRenderer()
 
 void FrameRenderer::renderFrame()
 {
+	PROFILE_ZONE("FrameRenderer::renderFrame");
+
+	//Counters are taken at frame start, so calls issued after this method are attributed to the frame too
+	frameCallCounters = getCallCounters();
+	resetCallCounters();
+
+	gpuPassTimer->beginFrame();
+
+	if(dynamicResolution) //Scene target replaces postprocessing framebuffer
+	{
+		dynamicResolution->beginFrame();
+
+		int scaledWidth = dynamicResolution->getScaledWidth();
+		int scaledHeight = dynamicResolution->getScaledHeight();
+		if(scaledWidth != viewportWidth || scaledHeight != viewportHeight)
+		{
+			mainRenderer->setViewportSize(scaledWidth, scaledHeight);
+			viewportWidth = scaledWidth;
+			viewportHeight = scaledHeight;
+		}
+
+		if(dynamicResolution->isTemporalUpscaling())
+			mainRenderer->setProjection(dynamicResolution->getJitteredProjection());
+	}
+
 	mainRenderer->setTargetFramebuffer();
-	if(!isDeferredRenderer && postprocessingRenderer)
+	if(!isDeferredRenderer && postprocessingRenderer && !dynamicResolution)
 		postprocessingRenderer->setTargetFramebuffer();
 
 	mainRenderer->render();
 
+	if(dynamicResolution)
+	{
+		gpuPassTimer->beginPass("Upscaling");
+		dynamicResolution->upscale(postprocessingRenderer ? postprocessingRenderer->getFramebufferId() : 0);
+		gpuPassTimer->endPass();
+	}
+
 	if(postprocessingRenderer)
 		postprocessingRenderer->render();
 }
 
 void FrameRenderer::renderUi()
 {
+	PROFILE_ZONE("FrameRenderer::renderUi");
+
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 
 	ImGui::NewFrame();
 
 	ImGui::SetNextWindowPos(THIRDPARTY_FRAME_POSITION, ImGuiCond_Once);
-	ImGui::SetNextWindowSize(THIRDPARTY_FRAME_SIZE, ImGuiCond_Once);
-	ImGui::Begin(THIRDPARTY_FRAME_TITLE, nullptr, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoResize);
+	ImGui::Begin(THIRDPARTY_FRAME_TITLE, nullptr, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_AlwaysAutoResize); //Grows with pass tables
 
 	ImGui::Text(statisticsString);
+	if(frameTimeHistory)
+		showFrameTimeGraph(*frameTimeHistory);
 	ImGui::Text(simulationString);
+	ImGui::Text(uploadString);
+	ImGui::Text(renderingString);
+	if(dynamicResolution)
+		ImGui::Text(resolutionString);
+	if(postprocessingRenderer)
+		ImGui::Text(postprocessingString);
+
+	ImGui::Text("Draw calls: %d, instances: %d", frameCallCounters.drawCalls, frameCallCounters.instances);
+	ImGui::Text("Binds: %d programs, %d VAO, %d textures", frameCallCounters.programSwitches, frameCallCounters.vaoBinds, frameCallCounters.textureBinds);
+	ImGui::Text("Uniform uploads: %d", frameCallCounters.uniformUploads);
+
+	showMemoryTable();
+
+	gpuPassTimes.clear();
+	for(int i = 0; i < gpuPassTimer->getPassAmount(); i++)
+		gpuPassTimes.emplace_back(gpuPassTimer->getPassName(i), gpuPassTimer->getPassTime(i));
+
+	showTimeTable(GPU_PASS_TABLE_TITLE, gpuPassTimes);
+	showTimeTable(CPU_ZONE_TABLE_TITLE, cpuZoneTimes); //Empty without profiler zones
 
 	ImGui::End();
 
 	ImGui::Render();
+
+	gpuPassTimer->beginPass("ImGui");
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	gpuPassTimer->endPass();
 }
 
 void FrameRenderer::updateCamera(const glm::mat4 &newViewMatrix)
 {
 	mainRenderer->updateCamera(newViewMatrix);
+
+	if(dynamicResolution)
+		dynamicResolution->updateCamera(newViewMatrix);
 }
 
 void FrameRenderer::setLightDirection(const glm::vec3 &direction)
@@ -99,6 +202,16 @@ void FrameRenderer::setAmbientLightColour(const glm::vec3 &colour)
 	mainRenderer->setAmbientLightColour(colour);
 }
 
+bool FrameRenderer::setPointLights(const vector<PointLight> &lights)
+{
+	return mainRenderer->setPointLights(lights);
+}
+
+void FrameRenderer::setSceneTime(float seconds)
+{
+	mainRenderer->setSceneTime(seconds);
+}
+
 void FrameRenderer::setVisibilityFlags(vector<VisibilityFlags> *visibility)
 {
 	mainRenderer->setVisibilityFlags(visibility);
@@ -120,11 +233,46 @@ void FrameRenderer::setRendererLibraryProperties()
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
+void FrameRenderer::setDynamicResolution(unique_ptr<DynamicResolution> resolution)
+{
+	dynamicResolution = move(resolution);
+}
+
 int FrameRenderer::getDrawnTriangleCount() const
 {
 	return mainRenderer->getDrawnTriangleCount();
 }
 
+int FrameRenderer::getDrawCallCount() const
+{
+	return mainRenderer->getDrawCallCount();
+}
+
+const CallCounters& FrameRenderer::getFrameCallCounters() const
+{
+	return frameCallCounters;
+}
+
+unsigned int FrameRenderer::getShadedSampleCount() const
+{
+	return mainRenderer->getShadedSampleCount();
+}
+
+float FrameRenderer::getRenderQueueTime() const
+{
+	return mainRenderer->getRenderQueueTime();
+}
+
+const DynamicResolution* FrameRenderer::getDynamicResolution() const
+{
+	return dynamicResolution.get();
+}
+
+const PostprocessingRenderer* FrameRenderer::getPostprocessingRenderer() const
+{
+	return postprocessingRenderer;
+}
+
 void FrameRenderer::setStatisticsLine(const string &str)
 {
 	strncpy(statisticsString, str.c_str(), UI_STR_MAX_LENGTH - 1);
@@ -134,3 +282,106 @@ void FrameRenderer::setSimulationLine(const std::string &str)
 {
 	strncpy(simulationString, str.c_str(), UI_STR_MAX_LENGTH - 1);
 }
+
+void FrameRenderer::setUploadLine(const std::string &str)
+{
+	strncpy(uploadString, str.c_str(), UI_STR_MAX_LENGTH - 1);
+}
+
+void FrameRenderer::setRenderingLine(const string &str)
+{
+	strncpy(renderingString, str.c_str(), UI_STR_MAX_LENGTH - 1);
+}
+
+void FrameRenderer::setResolutionLine(const string &str)
+{
+	strncpy(resolutionString, str.c_str(), UI_STR_MAX_LENGTH - 1);
+}
+
+void FrameRenderer::setPostprocessingLine(const string &str)
+{
+	strncpy(postprocessingString, str.c_str(), UI_STR_MAX_LENGTH - 1);
+}
+
+void FrameRenderer::setCpuZoneTimes(const vector<pair<const char*, float>> &zoneTimes)
+{
+	cpuZoneTimes = zoneTimes;
+}
+
+void FrameRenderer::setFrameTimeHistory(const renderer::FrameTimeHistory *history)
+{
+	frameTimeHistory = history;
+}
+
+namespace
+{
+	void showTimeTable(const char *title, const vector<pair<const char*, float>> &rows)
+	{
+		if(rows.empty())
+			return;
+
+		if(!ImGui::BeginTable(title, 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+			return;
+
+		ImGui::TableSetupColumn(title);
+		ImGui::TableSetupColumn(TIME_COLUMN_TITLE, ImGuiTableColumnFlags_WidthFixed, TIME_COLUMN_WIDTH);
+		ImGui::TableHeadersRow();
+
+		for(auto &[name, time]: rows)
+		{
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted(name);
+			ImGui::TableNextColumn();
+			ImGui::Text("%.3f", time);
+		}
+
+		ImGui::EndTable();
+	}
+
+	void showFrameTimeGraph(const renderer::FrameTimeHistory &history)
+	{
+		//Zero lower bound, so spikes are seen in proportion to usual frames
+		ImGui::PlotLines("##FrameTimes", history.getRecentTimes(), history.getRecentAmount(), history.getRecentOffset(), "ms", 0.f, FLT_MAX, FRAME_TIME_GRAPH_SIZE);
+
+		ImGui::Text("p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms", history.getPercentile50(), history.getPercentile95(), history.getPercentile99(), history.getMaxTime());
+		ImGui::Text("Hitches: %d recent, %d in session", history.getHitchCount(), history.getSessionHitchCount());
+	}
+
+	void showMemoryTable()
+	{
+		if(ImGui::BeginTable(MEMORY_TABLE_TITLE, 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+		{
+			ImGui::TableSetupColumn(MEMORY_TABLE_TITLE);
+			ImGui::TableSetupColumn(MEMORY_COLUMN_TITLE, ImGuiTableColumnFlags_WidthFixed, TIME_COLUMN_WIDTH);
+			ImGui::TableHeadersRow();
+
+			for(int i = 0; i < MEMORY_CATEGORY_AMOUNT; i++)
+			{
+				const MemoryCategory category = static_cast<MemoryCategory>(i);
+
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::Text("%s (%d)", getMemoryCategoryName(category), getMemoryUsage(category).resourceAmount);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f", getMemoryUsage(category).bytes / BYTES_IN_MEGABYTE);
+			}
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextUnformatted("Total");
+			ImGui::TableNextColumn();
+			ImGui::Text("%.1f", getTotalMemoryUsage().bytes / BYTES_IN_MEGABYTE);
+
+			ImGui::EndTable();
+		}
+
+		if(!ImGui::TreeNode(MEMORY_OWNERS_TITLE))
+			return;
+
+		for(auto &[owner, bytes]: getLargestMemoryOwners(LARGEST_OWNER_AMOUNT))
+			ImGui::Text("%.1f MB  %s", bytes / BYTES_IN_MEGABYTE, owner.c_str());
+
+		ImGui::TreePop();
+	}
+}
@@ -0,0 +1,117 @@
+/* gpu_pass_timer.cpp
+ * Measures GPU time of frame passes with timestamp queries
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "graphics_lib/gpu_pass_timer.h"
+
+#include <cstring>
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+using namespace std;
+using namespace renderer::graphics_lib;
+
+namespace
+{
+	constexpr float PASS_TIME_SMOOTHING = 0.2f;
+	constexpr float NANOSECONDS_IN_MILLISECOND = 1000000.f;
+}
+
+GpuPassTimer::GpuPassTimer():
+	currentFrame(0), isPassStarted(false)
+{
+	glCreateQueries(GL_TIMESTAMP, QUERY_FRAMES * MAX_PASS_AMOUNT * 2, &queryIds[0][0]);
+
+	for(int i = 0; i < QUERY_FRAMES; i++)
+		framePassAmount[i] = 0;
+}
+
+GpuPassTimer::~GpuPassTimer()
+{
+	glDeleteQueries(QUERY_FRAMES * MAX_PASS_AMOUNT * 2, &queryIds[0][0]);
+}
+
+void GpuPassTimer::beginFrame()
+{
+	if(isPassStarted) //Pass wasn't finished in the previous frame
+		endPass();
+
+	currentFrame = (currentFrame + 1) % QUERY_FRAMES;
+
+	const int passAmount = framePassAmount[currentFrame];
+	framePassAmount[currentFrame] = 0;
+
+	if(passAmount == 0)
+		return;
+
+	//The last timestamp is written the latest, so the whole frame is ready when it is available
+	int isAvailable = 0;
+	glGetQueryObjectiv(queryIds[currentFrame][passAmount * 2 - 1], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+	if(!isAvailable)
+		return;
+
+	for(int i = 0; i < passAmount; i++)
+	{
+		GLuint64 beginTime = 0, endTime = 0;
+		glGetQueryObjectui64v(queryIds[currentFrame][i * 2], GL_QUERY_RESULT, &beginTime);
+		glGetQueryObjectui64v(queryIds[currentFrame][i * 2 + 1], GL_QUERY_RESULT, &endTime);
+
+		addPassTime(framePassNames[currentFrame][i], (endTime - beginTime) / NANOSECONDS_IN_MILLISECOND);
+	}
+}
+
+void GpuPassTimer::beginPass(const char *name)
+{
+	int &passAmount = framePassAmount[currentFrame];
+	if(isPassStarted || passAmount >= MAX_PASS_AMOUNT)
+		return;
+
+	glQueryCounter(queryIds[currentFrame][passAmount * 2], GL_TIMESTAMP);
+	framePassNames[currentFrame][passAmount] = name;
+	isPassStarted = true;
+}
+
+void GpuPassTimer::endPass()
+{
+	if(!isPassStarted)
+		return;
+
+	int &passAmount = framePassAmount[currentFrame];
+	glQueryCounter(queryIds[currentFrame][passAmount * 2 + 1], GL_TIMESTAMP);
+	passAmount++;
+	isPassStarted = false;
+}
+
+int GpuPassTimer::getPassAmount() const
+{
+	return passNames.size();
+}
+
+const char* GpuPassTimer::getPassName(int index) const
+{
+	return passNames[index];
+}
+
+float GpuPassTimer::getPassTime(int index) const
+{
+	return passTimes[index];
+}
+
+void GpuPassTimer::addPassTime(const char *name, float time)
+{
+	for(size_t i = 0; i < passNames.size(); i++)
+	{
+		if(strcmp(passNames[i], name) == 0)
+		{
+			passTimes[i] = glm::mix(passTimes[i], time, PASS_TIME_SMOOTHING);
+			return;
+		}
+	}
+
+	passNames.push_back(name);
+	passTimes.push_back(time);
+}
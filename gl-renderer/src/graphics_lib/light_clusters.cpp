@@ -0,0 +1,100 @@
+/* light_clusters.cpp
+ * Bins point lights into view frustum clusters with compute shader
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "graphics_lib/light_clusters.h"
+
+#include <GL/glew.h>
+
+#include "graphics_lib/operations/counted_calls.h"
+#include "graphics_lib/operations/memory_ledger.h"
+#include "utils/math_tools.h"
+
+using namespace std;
+using namespace renderer::data;
+using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
+using namespace renderer::graphics_lib::videocard_data;
+using namespace renderer::utils;
+
+namespace
+{
+	constexpr unsigned int LIGHT_BUFFER_BINDING = 0;
+	constexpr unsigned int LIGHT_COUNT_BUFFER_BINDING = 1;
+	constexpr unsigned int LIGHT_INDEX_BUFFER_BINDING = 2;
+
+	const char *MEMORY_OWNER = "Light clusters";
+
+	//std430 layout of light in shaders
+	struct GpuPointLight
+	{
+		glm::vec4 positionRadius;
+		glm::vec4 colourPower;
+	};
+}
+
+LightClusters::LightClusters(const ShaderIds &clustering):
+	clusteringShaderId(clustering), lightAmount(0)
+{
+	lightCountBufferId = createTrackedBuffer(CLUSTER_AMOUNT * sizeof(unsigned int), nullptr, 0, MemoryCategory::LIGHTS, MEMORY_OWNER);
+	lightIndexBufferId = createTrackedBuffer(CLUSTER_AMOUNT * CLUSTER_MAX_LIGHTS * sizeof(unsigned int), nullptr, 0, MemoryCategory::LIGHTS, MEMORY_OWNER);
+
+	setLights(vector<PointLight>());
+}
+
+LightClusters::~LightClusters()
+{
+	deleteTrackedBuffer(lightIndexBufferId);
+	deleteTrackedBuffer(lightCountBufferId);
+	deleteTrackedBuffer(lightBufferId);
+}
+
+void LightClusters::setLights(const vector<PointLight> &lights)
+{
+	vector<GpuPointLight> gpuLights(lights.size());
+	for(size_t i = 0; i < lights.size(); i++)
+	{
+		const PointLight &current = lights[i];
+
+		gpuLights[i].positionRadius = glm::vec4(current.x, current.y, current.z, computeBoundingSphereRadius(current.power));
+		gpuLights[i].colourPower = glm::vec4(current.red / 255.f, current.green / 255.f, current.blue / 255.f, current.power);
+	}
+
+	if(gpuLights.empty())
+		gpuLights.resize(1); //Buffer can't be empty
+
+	if(lightBufferId != -1u)
+		deleteTrackedBuffer(lightBufferId);
+
+	lightBufferId = createTrackedBuffer(gpuLights.size() * sizeof(GpuPointLight), gpuLights.data(), 0, MemoryCategory::LIGHTS, MEMORY_OWNER);
+
+	lightAmount = lights.size();
+}
+
+void LightClusters::update(const glm::mat4 &viewMatrix)
+{
+	useProgram(clusteringShaderId.id);
+
+	uniformMatrix4fv(clusteringShaderId.unifView, 1, GL_FALSE, &viewMatrix[0][0]);
+	uniform1ui(clusteringShaderId.unifLightAmount, lightAmount);
+
+	bindBuffers();
+
+	glDispatchCompute(CLUSTER_TILES_X, CLUSTER_TILES_Y, CLUSTER_DEPTH_SLICES); //Work group per cluster
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void LightClusters::bindBuffers()
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_BUFFER_BINDING, lightBufferId);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_COUNT_BUFFER_BINDING, lightCountBufferId);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_INDEX_BUFFER_BINDING, lightIndexBufferId);
+}
+
+int LightClusters::getLightAmount() const
+{
+	return lightAmount;
+}
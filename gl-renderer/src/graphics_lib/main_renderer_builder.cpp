@@ -1,5 +1,5 @@
 /* main_renderer_builder.cpp
- * Initializes all the shaders for ForardRenderer and DeferredRenderer classes
+ * Initializes all the shaders for ForardRenderer, ForwardPlusRenderer and DeferredRenderer classes
  * OpenGL 4.5
  *
  * Author: Artem Hiblov
@@ -12,8 +12,11 @@
 #include "common_constants.h"
 #include "log.h"
 #include "graphics_lib/deferred_renderer.h"
+#include "graphics_lib/forward_plus_renderer.h"
 #include "graphics_lib/forward_renderer.h"
+#include "graphics_lib/light_clusters.h"
 #include "graphics_lib/uniform_setters.h"
+#include "graphics_lib/weighted_blended_transparency.h"
 
 using namespace std;
 using namespace renderer;
@@ -29,6 +32,9 @@ namespace
 	const char *DEFERRED_FOG_LIGHT_PASS_DIRECTIONAL_SHADER_NAME = "directional-fog-light-pass";
 	const char *STENCIL_PASS_SHADER_NAME = "stencil";
 	const char *DEFERRED_LIGHT_PASS_POINT_SHADER_NAME = "point-light-pass";
+	const char *CLUSTERED_LIGHT_PASS_SHADER_NAME = "clustered-light-pass";
+	const char *LIGHT_CLUSTERING_SHADER_NAME = "light-clustering";
+	const char *WEIGHTED_BLENDED_COMPOSITE_SHADER_NAME = "weighted-blended-composite";
 
 	//Common part
 	const char *COLOUR_TEXTURE_UNIFORM_NAME = "colourTexture";
@@ -57,11 +63,21 @@ namespace
 	const char *FOG_COLOUR_UNIFORM_NAME = "fogColour";
 
 	//Deferred shaders
-	const char *POSITION_COMPONENT_UNIFORM_NAME = "positionComponent";
+	const char *DEPTH_COMPONENT_UNIFORM_NAME = "depthComponent";
 	const char *NORMAL_COMPONENT_UNIFORM_NAME = "normalComponent";
 	const char *DIFFUSE_COMPONENT_UNIFORM_NAME = "diffuseComponent";
 	const char *SCREEN_SIZE_UNIFORM_NAME = "screenSize";
 	const char *LIGHT_PARAMETERS_UNIFORM_NAME = "lightParameters";
+	const char *INVERSE_PROJECTION_UNIFORM_NAME = "inverseProjection";
+	const char *INVERSE_VIEW_UNIFORM_NAME = "inverseView";
+
+	//Clustered lights
+	const char *CLUSTER_DEPTH_RANGE_UNIFORM_NAME = "clusterDepthRange";
+	const char *LIGHT_AMOUNT_UNIFORM_NAME = "lightAmount";
+
+	//Weighted blended transparency
+	const char *ACCUMULATION_TEXTURE_UNIFORM_NAME = "accumulationTexture";
+	const char *REVEALAGE_TEXTURE_UNIFORM_NAME = "revealageTexture";
 
 	const char *OBJECT_LIGHT_SPHERE_NAME = "light-sphere";
 
@@ -69,6 +85,11 @@ namespace
 	constexpr float MATERIAL_ALPHA_Y = 0.1f;
 
 
+	/*
+	@brief Initializes uniforms of scene object, particle or terrain shader according to its flags
+	*/
+	void initSceneShader(ShaderIds &shaderId, unsigned long long flags, int screenWidth, int screenHeight, const Light &light, const Fog &fog);
+
 	void initDirectionalShaderUniforms(ShaderIds &shaderId);
 	void initPointShaderUniforms(ShaderIds &shaderId);
 	void initNormalmapShaderUniforms(ShaderIds &shaderId);
@@ -79,54 +100,48 @@ namespace
 	void initStencilPassShaderUniforms(ShaderIds &shaderId);
 	void initDeferredDirectionalLightPassShaderUniforms(ShaderIds &shaderId, bool useFog);
 	void initDeferredPointLightPassShaderUniforms(ShaderIds &shaderId, bool useFog);
+	void initLightClusteringShaderUniforms(ShaderIds &shaderId);
+	void initClusteredLightPassShaderUniforms(ShaderIds &shaderId);
+	void initClusteredShadingShaderUniforms(ShaderIds &shaderId);
+	void initWeightedBlendedCompositeShaderUniforms(ShaderIds &shaderId);
+
+	/*
+	@brief Creates light clusters with compute shader
+	@return nullptr if clustering shader can't be created
+	*/
+	unique_ptr<LightClusters> makeLightClusters(ShaderManager *shaderManager, int screenWidth, int screenHeight, const vector<PointLight> &pointLights);
+
+	/*
+	@brief Creates light clusters and clustered shading pass for additional point lights
+	*/
+	void initClusteredLights(DeferredRenderer *deferredRenderer, ShaderManager *shaderManager, int screenWidth, int screenHeight, const vector<PointLight> &pointLights);
+
+	/*
+	@brief Creates Forward+ renderer. Scene point light becomes one of clustered lights
+	*/
+	unique_ptr<Base3DRenderer> makeForwardPlusRenderer(ShaderManager *shaderManager, int screenWidth, int screenHeight, const Light &light, const vector<PointLight> &pointLights,
+		const map<int, unsigned long long> &shaderFlags, vector<ShaderIds> &shaderIds, const ShaderIds &skyShader);
+
+	/*
+	@brief Creates depth-only shaders and passes them to renderer
+	*/
+	void initDepthPrepass(Base3DRenderer *mainRenderer, ShaderManager *shaderManager, int screenWidth, int screenHeight, const Light &light, const Fog &fog,
+		const map<int, unsigned long long> &shaderFlags);
+
+	/*
+	@brief Creates accumulation targets and composite pass for transparent meshes
+	*/
+	void initWeightedBlendedTransparency(Base3DRenderer *mainRenderer, ShaderManager *shaderManager, int screenWidth, int screenHeight);
 }
 
 unique_ptr<Base3DRenderer> renderer::graphics_lib::buildMainRenderer(ObjectManager *objectManager, ShaderManager *shaderManager, int screenWidth, int screenHeight, const Light &light,
-	const Fog &fog, const map<int, unsigned long long> &shaderFlags, vector<ShaderIds> &shaderIds, bool isDirectional, bool isDeferred)
+	const vector<PointLight> &pointLights, const Fog &fog, const map<int, unsigned long long> &shaderFlags, vector<ShaderIds> &shaderIds, bool isDirectional, bool isDeferred,
+	bool isForwardPlus, bool useDepthPrepass, bool useWeightedBlendedTransparency)
 {
 	const float screenRatio = static_cast<float>(screenWidth) / screenHeight;
 
 	for(auto &[index, flags]: shaderFlags)
-	{
-		ShaderIds &current = shaderIds[index];
-		glUseProgram(current.id);
-
-		current.unifTextureId = glGetUniformLocation(current.id, COLOUR_TEXTURE_UNIFORM_NAME);
-
-		if(flags & ShaderFlags::FEATURE_DIRECTIONAL_LIGHT)
-		{
-			initDirectionalShaderUniforms(current);
-			setDirectionalShaderUniforms(current, screenRatio, light);
-		}
-
-		if(flags & ShaderFlags::FEATURE_POINT_LIGHT)
-		{
-			initPointShaderUniforms(current);
-			setPointShaderUniforms(current, screenRatio, light);
-		}
-
-		if(flags & ShaderFlags::FEATURE_NORMALMAP)
-		{
-			initNormalmapShaderUniforms(current);
-		}
-
-		if(flags & ShaderFlags::FEATURE_SMALL_WAVES)
-		{
-			initSmallWavesShaderUniforms(current);
-		}
-
-		if(flags & ShaderFlags::FEATURE_GLITTER)
-		{
-			initGlitterShaderUniforms(current);
-			setGlitterShaderUniforms(current, MATERIAL_ALPHA_X, MATERIAL_ALPHA_Y);
-		}
-
-		if(flags | ShaderFlags::FEATURE_FOG) //Can be combined with other
-		{
-			initFogShaderUniforms(current);
-			setFogShaderUniforms(current, fog);
-		}
-	}
+		initSceneShader(shaderIds[index], flags, screenWidth, screenHeight, light, fog);
 
 	ShaderIds skyShader;
 	shaderManager->getShaderId(SHADER_NAME_SKY, skyShader);
@@ -172,24 +187,100 @@ unique_ptr<Base3DRenderer> renderer::graphics_lib::buildMainRenderer(ObjectManag
 			setDeferredPointLightPassShaderUniforms(pointLightPassId, screenWidth, screenHeight, light);
 		}
 
-		mainRenderer = make_unique<DeferredRenderer>(shaderIds, skyShader, shaderFlags, lightSphere, isDirectional, isDeferredLightDirectional, fog.enable, directionalLightPassId, stencilPassId,
-			pointLightPassId, glm::vec3(light.x, light.y, light.z), screenWidth, screenHeight);
+		unique_ptr<DeferredRenderer> deferredRenderer = make_unique<DeferredRenderer>(shaderIds, skyShader, shaderFlags, lightSphere, isDirectional, isDeferredLightDirectional, fog.enable,
+			directionalLightPassId, stencilPassId, pointLightPassId, glm::vec3(light.x, light.y, light.z), screenWidth, screenHeight);
+
+		if(!pointLights.empty())
+			initClusteredLights(deferredRenderer.get(), shaderManager, screenWidth, screenHeight, pointLights);
+
+		mainRenderer = move(deferredRenderer);
 
 		if(!isDeferredLightDirectional) //Use only ambient component if point light is specified
 			mainRenderer->setDiffuseLightColour(LIGHT_DIFFUSE_NIGHT_COLOUR);
 	}
+	else if(isForwardPlus)
+	{
+		Log::getInstance().info("Initializing Forward+ renderer");
+
+		mainRenderer = makeForwardPlusRenderer(shaderManager, screenWidth, screenHeight, light, pointLights, shaderFlags, shaderIds, skyShader);
+		if(!mainRenderer)
+		{
+			Log::getInstance().error("Can't create Forward+ renderer, point lights are ignored");
+			mainRenderer = make_unique<ForwardRenderer>(shaderIds, skyShader, shaderFlags, isDirectional);
+		}
+
+		useDepthPrepass = true; //Always used by Forward+
+	}
 	else
 	{
 		Log::getInstance().info("Initializing forward renderer");
 
+		if(!pointLights.empty())
+			Log::getInstance().warning("Additional point lights are supported by deferred and Forward+ renderers only");
+
 		mainRenderer = make_unique<ForwardRenderer>(shaderIds, skyShader, shaderFlags, isDirectional);
 	}
 
+	if(useDepthPrepass)
+		initDepthPrepass(mainRenderer.get(), shaderManager, screenWidth, screenHeight, light, fog, shaderFlags);
+
+	if(useWeightedBlendedTransparency)
+		initWeightedBlendedTransparency(mainRenderer.get(), shaderManager, screenWidth, screenHeight);
+
 	return mainRenderer;
 }
 
 namespace
 {
+	void initSceneShader(ShaderIds &shaderId, unsigned long long flags, int screenWidth, int screenHeight, const Light &light, const Fog &fog)
+	{
+		const float screenRatio = static_cast<float>(screenWidth) / screenHeight;
+
+		glUseProgram(shaderId.id);
+
+		shaderId.unifTextureId = glGetUniformLocation(shaderId.id, COLOUR_TEXTURE_UNIFORM_NAME);
+
+		if(flags & ShaderFlags::FEATURE_DIRECTIONAL_LIGHT)
+		{
+			initDirectionalShaderUniforms(shaderId);
+			setDirectionalShaderUniforms(shaderId, screenRatio, light);
+		}
+
+		if(flags & ShaderFlags::FEATURE_POINT_LIGHT)
+		{
+			initPointShaderUniforms(shaderId);
+			setPointShaderUniforms(shaderId, screenRatio, light);
+		}
+
+		if(flags & ShaderFlags::FEATURE_NORMALMAP)
+		{
+			initNormalmapShaderUniforms(shaderId);
+		}
+
+		if(flags & ShaderFlags::FEATURE_SMALL_WAVES)
+		{
+			initSmallWavesShaderUniforms(shaderId);
+		}
+
+		if(flags & ShaderFlags::FEATURE_GLITTER)
+		{
+			initGlitterShaderUniforms(shaderId);
+			setGlitterShaderUniforms(shaderId, MATERIAL_ALPHA_X, MATERIAL_ALPHA_Y);
+		}
+
+		if(flags | ShaderFlags::FEATURE_FOG) //Can be combined with other
+		{
+			initFogShaderUniforms(shaderId);
+			setFogShaderUniforms(shaderId, fog);
+		}
+
+		if(flags & ShaderFlags::FEATURE_CLUSTERED_LIGHTS)
+		{
+			initClusteredShadingShaderUniforms(shaderId);
+			setLightClusteringShaderUniforms(shaderId, screenWidth, screenHeight);
+		}
+	}
+
 	void initDirectionalShaderUniforms(ShaderIds &shaderId)
 	{
 		shaderId.unifModel = glGetUniformLocation(shaderId.id, MODEL_UNIFORM_NAME);
@@ -257,12 +348,11 @@ namespace
 
 		if(useFog)
 		{
-			shaderId.unifView = glGetUniformLocation(shaderId.id, VIEW_UNIFORM_NAME);
-
 			shaderId.unifFogDensity = glGetUniformLocation(shaderId.id, FOG_DENSITY_UNIFORM_NAME);
 			shaderId.unifFogColour = glGetUniformLocation(shaderId.id, FOG_COLOUR_UNIFORM_NAME);
 
-			shaderId.unifPositionComponentId = glGetUniformLocation(shaderId.id, POSITION_COMPONENT_UNIFORM_NAME);
+			shaderId.unifDepthComponentId = glGetUniformLocation(shaderId.id, DEPTH_COMPONENT_UNIFORM_NAME);
+			shaderId.unifInverseProjection = glGetUniformLocation(shaderId.id, INVERSE_PROJECTION_UNIFORM_NAME);
 		}
 
 		shaderId.unifNormalComponentId = glGetUniformLocation(shaderId.id, NORMAL_COMPONENT_UNIFORM_NAME);
@@ -279,11 +369,140 @@ namespace
 		shaderId.unifDiffuseLightColour = glGetUniformLocation(shaderId.id, LIGHT_DIFFUSE_COLOUR_UNIFORM_NAME);
 		shaderId.unifAmbientLightColour = glGetUniformLocation(shaderId.id, LIGHT_AMBIENT_COLOUR_UNIFORM_NAME);
 
-		shaderId.unifPositionComponentId = glGetUniformLocation(shaderId.id, POSITION_COMPONENT_UNIFORM_NAME);
+		shaderId.unifDepthComponentId = glGetUniformLocation(shaderId.id, DEPTH_COMPONENT_UNIFORM_NAME);
 		shaderId.unifNormalComponentId = glGetUniformLocation(shaderId.id, NORMAL_COMPONENT_UNIFORM_NAME);
 		shaderId.unifDiffuseComponentId = glGetUniformLocation(shaderId.id, DIFFUSE_COMPONENT_UNIFORM_NAME);
 
 		shaderId.unifScreenSize = glGetUniformLocation(shaderId.id, SCREEN_SIZE_UNIFORM_NAME);
 		shaderId.unifLightParameters = glGetUniformLocation(shaderId.id, LIGHT_PARAMETERS_UNIFORM_NAME);
+		shaderId.unifInverseProjection = glGetUniformLocation(shaderId.id, INVERSE_PROJECTION_UNIFORM_NAME);
+		shaderId.unifInverseView = glGetUniformLocation(shaderId.id, INVERSE_VIEW_UNIFORM_NAME);
+	}
+	void initLightClusteringShaderUniforms(ShaderIds &shaderId)
+	{
+		shaderId.unifView = glGetUniformLocation(shaderId.id, VIEW_UNIFORM_NAME);
+		shaderId.unifInverseProjection = glGetUniformLocation(shaderId.id, INVERSE_PROJECTION_UNIFORM_NAME);
+		shaderId.unifClusterDepthRange = glGetUniformLocation(shaderId.id, CLUSTER_DEPTH_RANGE_UNIFORM_NAME);
+		shaderId.unifLightAmount = glGetUniformLocation(shaderId.id, LIGHT_AMOUNT_UNIFORM_NAME);
+	}
+
+	void initClusteredLightPassShaderUniforms(ShaderIds &shaderId)
+	{
+		shaderId.unifDepthComponentId = glGetUniformLocation(shaderId.id, DEPTH_COMPONENT_UNIFORM_NAME);
+		shaderId.unifNormalComponentId = glGetUniformLocation(shaderId.id, NORMAL_COMPONENT_UNIFORM_NAME);
+		shaderId.unifDiffuseComponentId = glGetUniformLocation(shaderId.id, DIFFUSE_COMPONENT_UNIFORM_NAME);
+
+		shaderId.unifInverseProjection = glGetUniformLocation(shaderId.id, INVERSE_PROJECTION_UNIFORM_NAME);
+		shaderId.unifInverseView = glGetUniformLocation(shaderId.id, INVERSE_VIEW_UNIFORM_NAME);
+		shaderId.unifClusterDepthRange = glGetUniformLocation(shaderId.id, CLUSTER_DEPTH_RANGE_UNIFORM_NAME);
+	}
+
+	void initClusteredShadingShaderUniforms(ShaderIds &shaderId)
+	{
+		shaderId.unifView = glGetUniformLocation(shaderId.id, VIEW_UNIFORM_NAME);
+		shaderId.unifScreenSize = glGetUniformLocation(shaderId.id, SCREEN_SIZE_UNIFORM_NAME);
+		shaderId.unifClusterDepthRange = glGetUniformLocation(shaderId.id, CLUSTER_DEPTH_RANGE_UNIFORM_NAME);
+	}
+
+	void initWeightedBlendedCompositeShaderUniforms(ShaderIds &shaderId)
+	{
+		shaderId.unifAccumulationId = glGetUniformLocation(shaderId.id, ACCUMULATION_TEXTURE_UNIFORM_NAME);
+		shaderId.unifRevealageId = glGetUniformLocation(shaderId.id, REVEALAGE_TEXTURE_UNIFORM_NAME);
+	}
+
+	unique_ptr<LightClusters> makeLightClusters(ShaderManager *shaderManager, int screenWidth, int screenHeight, const vector<PointLight> &pointLights)
+	{
+		Log::getInstance().info(string("Initializing clustered lighting for ") + to_string(pointLights.size()) + " point lights");
+
+		ShaderIds clusteringId;
+		if(!shaderManager->getComputeShaderId(LIGHT_CLUSTERING_SHADER_NAME, clusteringId))
+		{
+			Log::getInstance().error("Can't create light clustering shader");
+			return nullptr;
+		}
+
+		glUseProgram(clusteringId.id);
+		initLightClusteringShaderUniforms(clusteringId);
+		setLightClusteringShaderUniforms(clusteringId, screenWidth, screenHeight);
+
+		unique_ptr<LightClusters> lightClusters = make_unique<LightClusters>(clusteringId);
+		lightClusters->setLights(pointLights);
+
+		return lightClusters;
+	}
+
+	void initClusteredLights(DeferredRenderer *deferredRenderer, ShaderManager *shaderManager, int screenWidth, int screenHeight, const vector<PointLight> &pointLights)
+	{
+		unique_ptr<LightClusters> lightClusters = makeLightClusters(shaderManager, screenWidth, screenHeight, pointLights);
+		if(!lightClusters)
+		{
+			Log::getInstance().error("Additional point lights are ignored");
+			return;
+		}
+
+		ShaderIds clusteredLightPassId;
+		if(!shaderManager->getShaderId(CLUSTERED_LIGHT_PASS_SHADER_NAME, clusteredLightPassId))
+		{
+			Log::getInstance().error("Can't create clustered light pass shader, additional point lights are ignored");
+			return;
+		}
+
+		glUseProgram(clusteredLightPassId.id);
+		initClusteredLightPassShaderUniforms(clusteredLightPassId);
+		setLightClusteringShaderUniforms(clusteredLightPassId, screenWidth, screenHeight);
+
+		deferredRenderer->setLightClusters(move(lightClusters), clusteredLightPassId);
+	}
+
+	unique_ptr<Base3DRenderer> makeForwardPlusRenderer(ShaderManager *shaderManager, int screenWidth, int screenHeight, const Light &light, const vector<PointLight> &pointLights,
+		const map<int, unsigned long long> &shaderFlags, vector<ShaderIds> &shaderIds, const ShaderIds &skyShader)
+	{
+		bool isSceneLightDirectional = light.lightType == "directional";
+
+		vector<PointLight> sceneLights;
+		if(!isSceneLightDirectional)
+			sceneLights.emplace_back(light.x, light.y, light.z, POINT_LIGHT_POWER, 255, 255, 255);
+
+		vector<PointLight> clusteredLights(pointLights);
+		clusteredLights.insert(clusteredLights.end(), sceneLights.begin(), sceneLights.end());
+
+		unique_ptr<LightClusters> lightClusters = makeLightClusters(shaderManager, screenWidth, screenHeight, clusteredLights);
+		if(!lightClusters)
+			return nullptr;
+
+		unique_ptr<Base3DRenderer> forwardPlusRenderer = make_unique<ForwardPlusRenderer>(shaderIds, skyShader, shaderFlags, move(lightClusters), sceneLights);
+
+		if(!isSceneLightDirectional) //Use only ambient component if point light is specified
+			forwardPlusRenderer->setDiffuseLightColour(LIGHT_DIFFUSE_NIGHT_COLOUR);
+
+		return forwardPlusRenderer;
+	}
+	void initDepthPrepass(Base3DRenderer *mainRenderer, ShaderManager *shaderManager, int screenWidth, int screenHeight, const Light &light, const Fog &fog,
+		const map<int, unsigned long long> &shaderFlags)
+	{
+		Log::getInstance().info("Initializing depth pre-pass");
+
+		vector<ShaderIds> &depthPrepassShaderIds = shaderManager->createDepthPrepassShaders();
+		for(auto &[index, flags]: shaderFlags)
+			initSceneShader(depthPrepassShaderIds[index], flags, screenWidth, screenHeight, light, fog); //Only transformation uniforms are found
+
+		mainRenderer->setDepthPrepassShaders(depthPrepassShaderIds);
+	}
+
+	void initWeightedBlendedTransparency(Base3DRenderer *mainRenderer, ShaderManager *shaderManager, int screenWidth, int screenHeight)
+	{
+		Log::getInstance().info("Initializing weighted blended transparency");
+
+		ShaderIds compositeId;
+		if(!shaderManager->getShaderId(WEIGHTED_BLENDED_COMPOSITE_SHADER_NAME, compositeId))
+		{
+			Log::getInstance().error("Can't create weighted blended transparency composite shader");
+			return;
+		}
+
+		glUseProgram(compositeId.id);
+		initWeightedBlendedCompositeShaderUniforms(compositeId);
+
+		mainRenderer->setWeightedBlendedTransparency(make_unique<WeightedBlendedTransparency>(compositeId, screenWidth, screenHeight));
 	}
 }
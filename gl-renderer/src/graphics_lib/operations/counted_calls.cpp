@@ -0,0 +1,119 @@
+/* counted_calls.cpp
+ * Thin wrappers over OpenGL calls of per-frame rendering, counting them for statistics
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "graphics_lib/operations/counted_calls.h"
+
+#include <GL/glew.h>
+
+using namespace renderer::graphics_lib::operations;
+
+namespace
+{
+	CallCounters callCounters;
+}
+
+const CallCounters& renderer::graphics_lib::operations::getCallCounters()
+{
+	return callCounters;
+}
+
+void renderer::graphics_lib::operations::resetCallCounters()
+{
+	callCounters = CallCounters();
+}
+
+void renderer::graphics_lib::operations::useProgram(unsigned int programId)
+{
+	glUseProgram(programId);
+	callCounters.programSwitches++;
+}
+
+void renderer::graphics_lib::operations::bindVertexArray(unsigned int vaoId)
+{
+	glBindVertexArray(vaoId);
+	callCounters.vaoBinds++;
+}
+
+void renderer::graphics_lib::operations::bindTextureUnit(unsigned int unit, unsigned int textureId)
+{
+	glBindTextureUnit(unit, textureId);
+	callCounters.textureBinds++;
+}
+
+void renderer::graphics_lib::operations::bindTexture(unsigned int target, unsigned int textureId)
+{
+	glBindTexture(target, textureId);
+	callCounters.textureBinds++;
+}
+
+void renderer::graphics_lib::operations::drawArrays(unsigned int mode, int first, int vertexAmount)
+{
+	glDrawArrays(mode, first, vertexAmount);
+	callCounters.drawCalls++;
+	callCounters.instances++;
+}
+
+void renderer::graphics_lib::operations::drawArraysInstanced(unsigned int mode, int first, int vertexAmount, int instanceAmount)
+{
+	glDrawArraysInstanced(mode, first, vertexAmount, instanceAmount);
+	callCounters.drawCalls++;
+	callCounters.instances += instanceAmount;
+}
+
+void renderer::graphics_lib::operations::uniform1i(int location, int value)
+{
+	glUniform1i(location, value);
+	callCounters.uniformUploads++;
+}
+
+void renderer::graphics_lib::operations::uniform1ui(int location, unsigned int value)
+{
+	glUniform1ui(location, value);
+	callCounters.uniformUploads++;
+}
+
+void renderer::graphics_lib::operations::uniform1f(int location, float value)
+{
+	glUniform1f(location, value);
+	callCounters.uniformUploads++;
+}
+
+void renderer::graphics_lib::operations::uniform2f(int location, float value0, float value1)
+{
+	glUniform2f(location, value0, value1);
+	callCounters.uniformUploads++;
+}
+
+void renderer::graphics_lib::operations::uniform2fv(int location, int count, const float *value)
+{
+	glUniform2fv(location, count, value);
+	callCounters.uniformUploads++;
+}
+
+void renderer::graphics_lib::operations::uniform3fv(int location, int count, const float *value)
+{
+	glUniform3fv(location, count, value);
+	callCounters.uniformUploads++;
+}
+
+void renderer::graphics_lib::operations::uniform4fv(int location, int count, const float *value)
+{
+	glUniform4fv(location, count, value);
+	callCounters.uniformUploads++;
+}
+
+void renderer::graphics_lib::operations::uniformMatrix3fv(int location, int count, unsigned char transpose, const float *value)
+{
+	glUniformMatrix3fv(location, count, transpose, value);
+	callCounters.uniformUploads++;
+}
+
+void renderer::graphics_lib::operations::uniformMatrix4fv(int location, int count, unsigned char transpose, const float *value)
+{
+	glUniformMatrix4fv(location, count, transpose, value);
+	callCounters.uniformUploads++;
+}
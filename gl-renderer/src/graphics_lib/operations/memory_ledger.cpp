@@ -0,0 +1,171 @@
+/* memory_ledger.cpp
+ * Creates and deletes buffers and textures, keeping videocard memory they take per category and owner
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "graphics_lib/operations/memory_ledger.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <GL/glew.h>
+
+#include "log.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::graphics_lib::operations;
+
+namespace
+{
+	struct Allocation
+	{
+		int64_t bytes;
+		MemoryCategory category;
+		string owner;
+	};
+
+	const char *CATEGORY_NAMES[MEMORY_CATEGORY_AMOUNT] = {"Meshes", "Terrain", "Particles", "Textures", "Render targets", "Lights", "Staging"};
+
+	//Buffer and texture IDs are separate name spaces
+	unordered_map<unsigned int, Allocation> bufferAllocations;
+	unordered_map<unsigned int, Allocation> textureAllocations;
+
+	MemoryUsage categoryUsage[MEMORY_CATEGORY_AMOUNT];
+
+
+
+	/*
+	@brief Returns texel size the format takes in videocard memory
+	*/
+	int getBytesPerTexel(unsigned int format);
+
+	void addAllocation(unordered_map<unsigned int, Allocation> &allocations, unsigned int id, int64_t bytes, MemoryCategory category, const string &owner);
+	void removeAllocation(unordered_map<unsigned int, Allocation> &allocations, unsigned int id);
+}
+
+unsigned int renderer::graphics_lib::operations::createTrackedBuffer(int64_t size, const void *data, unsigned int flags, MemoryCategory category, const string &owner)
+{
+	unsigned int bufferId = -1u;
+
+	glCreateBuffers(1, &bufferId);
+	glNamedBufferStorage(bufferId, size, data, flags);
+
+	addAllocation(bufferAllocations, bufferId, size, category, owner);
+
+	return bufferId;
+}
+
+unsigned int renderer::graphics_lib::operations::createTrackedTexture(int levels, unsigned int format, int width, int height, MemoryCategory category, const string &owner)
+{
+	unsigned int textureId = -1u;
+
+	glCreateTextures(GL_TEXTURE_2D, 1, &textureId);
+	glTextureStorage2D(textureId, levels, format, width, height);
+
+	//Every level is allocated by storage call, even if mipmaps aren't generated
+	int64_t texelAmount = 0;
+	for(int i = 0; i < levels; i++)
+		texelAmount += static_cast<int64_t>(max<>(width >> i, 1)) * max<>(height >> i, 1);
+
+	addAllocation(textureAllocations, textureId, texelAmount * getBytesPerTexel(format), category, owner);
+
+	return textureId;
+}
+
+void renderer::graphics_lib::operations::deleteTrackedBuffer(unsigned int bufferId)
+{
+	glDeleteBuffers(1, &bufferId);
+	removeAllocation(bufferAllocations, bufferId);
+}
+
+void renderer::graphics_lib::operations::deleteTrackedTexture(unsigned int textureId)
+{
+	glDeleteTextures(1, &textureId);
+	removeAllocation(textureAllocations, textureId);
+}
+
+const MemoryUsage& renderer::graphics_lib::operations::getMemoryUsage(MemoryCategory category)
+{
+	return categoryUsage[static_cast<int>(category)];
+}
+
+MemoryUsage renderer::graphics_lib::operations::getTotalMemoryUsage()
+{
+	MemoryUsage total;
+	for(auto &current: categoryUsage)
+	{
+		total.bytes += current.bytes;
+		total.resourceAmount += current.resourceAmount;
+	}
+
+	return total;
+}
+
+const char* renderer::graphics_lib::operations::getMemoryCategoryName(MemoryCategory category)
+{
+	return CATEGORY_NAMES[static_cast<int>(category)];
+}
+
+vector<pair<string, int64_t>> renderer::graphics_lib::operations::getLargestMemoryOwners(int amount)
+{
+	unordered_map<string, int64_t> ownerBytes;
+	for(auto &[id, allocation]: bufferAllocations)
+		ownerBytes[allocation.owner] += allocation.bytes;
+	for(auto &[id, allocation]: textureAllocations)
+		ownerBytes[allocation.owner] += allocation.bytes;
+
+	vector<pair<string, int64_t>> owners(ownerBytes.begin(), ownerBytes.end());
+	const size_t ownerAmount = min<>(owners.size(), static_cast<size_t>(max<>(amount, 0)));
+
+	partial_sort(owners.begin(), owners.begin() + ownerAmount, owners.end(), [](const auto &first, const auto &second) { return first.second > second.second; });
+	owners.resize(ownerAmount);
+
+	return owners;
+}
+
+namespace
+{
+	int getBytesPerTexel(unsigned int format)
+	{
+		switch(format)
+		{
+		case GL_R8:
+			return 1;
+		case GL_RGB8: //Drivers pad 3-byte texels to 4 bytes
+		case GL_RGBA8:
+		case GL_RG16:
+		case GL_DEPTH24_STENCIL8:
+			return 4;
+		case GL_RGBA16F:
+			return 8;
+		default:
+			Log::getInstance().warning(string("Unknown texture format ") + to_string(format) + ", 4 bytes per texel are assumed");
+			return 4;
+		}
+	}
+
+	void addAllocation(unordered_map<unsigned int, Allocation> &allocations, unsigned int id, int64_t bytes, MemoryCategory category, const string &owner)
+	{
+		allocations[id] = {bytes, category, owner};
+
+		MemoryUsage &usage = categoryUsage[static_cast<int>(category)];
+		usage.bytes += bytes;
+		usage.resourceAmount++;
+	}
+
+	void removeAllocation(unordered_map<unsigned int, Allocation> &allocations, unsigned int id)
+	{
+		auto iter = allocations.find(id);
+		if(iter == allocations.end())
+			return;
+
+		MemoryUsage &usage = categoryUsage[static_cast<int>(iter->second.category)];
+		usage.bytes -= iter->second.bytes;
+		usage.resourceAmount--;
+
+		allocations.erase(iter);
+	}
+}
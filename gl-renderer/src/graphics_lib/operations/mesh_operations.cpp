@@ -12,6 +12,7 @@
 #include <GL/glew.h>
 
 #include "log.h"
+#include "graphics_lib/operations/memory_ledger.h"
 #include "graphics_lib/videocard_data/component_indices.h"
 
 using namespace std;
@@ -25,15 +26,33 @@ namespace
 {
 	constexpr int QUAD_MESH_ARRAY_SIZE = 6 * 3; //6 vertices, 3 components per vertex
 
+	const char *QUAD_MESH_OWNER = "Full-screen quad";
+
+
+
 	/*
 	@brief Makes VBO and transfers data to it
 	@param[in] data - data to transfer
+	@param[in] owner - mesh path for memory ledger
+	@return VBO ID
+	*/
+	unsigned int makeVBO(const std::vector<float> &data, const string &owner);
+
+	/*
+	@brief Makes VBO to be filled by copy from staging ring
 	@return VBO ID
 	*/
-	unsigned int makeVBO(const std::vector<float> &data);
+	unsigned int makeStagedVBO(const StagingAllocation &data, UploadService &uploadService, const string &owner);
+
+	/*
+	@brief Makes VAO for structure of arrays and fills mesh-related structure fields
+	@param[in] tangentVboId - -1u if there is no tangent basis. Bitangent VBO is used with it
+	*/
+	void makeVao(unsigned int vertexVboId, unsigned int uvVboId, unsigned int normalsVboId, unsigned int tangentVboId, unsigned int bitangentVboId, int floatsPerVertex,
+		ObjectRenderingData &meshIds);
 }
 
-bool renderer::graphics_lib::operations::makeMesh(const Mesh &meshData, ObjectRenderingData &meshIds)
+bool renderer::graphics_lib::operations::makeMesh(const Mesh &meshData, const string &owner, ObjectRenderingData &meshIds)
 {
 	if(!meshData.vertices.size() || !meshData.uvs.size())
 	{
@@ -46,68 +65,78 @@ bool renderer::graphics_lib::operations::makeMesh(const Mesh &meshData, ObjectRe
 
 	//Structure of arrays
 
-	unsigned int vertexVboId = makeVBO(meshData.vertices);
-	unsigned int uvVboId = makeVBO(meshData.uvs);
+	unsigned int vertexVboId = makeVBO(meshData.vertices, owner);
+	unsigned int uvVboId = makeVBO(meshData.uvs, owner);
 	unsigned int normalsVboId = -1u;
 	if(!meshData.normals.empty())
 	{
-		normalsVboId = makeVBO(meshData.normals);
+		normalsVboId = makeVBO(meshData.normals, owner);
 	}
 
-	unsigned int vaoId = -1u;
-	glCreateVertexArrays(1, &vaoId);
+	unsigned int tangentVboId = -1u;
+	unsigned int bitangentVboId = -1u;
+	if(is3DMesh && useTangentBasis)
+	{
+		tangentVboId = makeVBO(meshData.tangent, owner);
+		bitangentVboId = makeVBO(meshData.bitangent, owner);
+	}
 
-	glVertexArrayVertexBuffer(vaoId, COMPONENT_VERTEX, vertexVboId, 0, meshData.floatsPerVertex * sizeof(float));
-	glVertexArrayVertexBuffer(vaoId, 1, uvVboId, 0, 2 * sizeof(float));
-	if(is3DMesh)
-		glVertexArrayVertexBuffer(vaoId, 2, normalsVboId, 0, 3 * sizeof(float));
+	makeVao(vertexVboId, uvVboId, normalsVboId, tangentVboId, bitangentVboId, meshData.floatsPerVertex, meshIds);
 
-	glEnableVertexArrayAttrib(vaoId, COMPONENT_VERTEX);
-	glVertexArrayAttribFormat(vaoId, COMPONENT_VERTEX, meshData.floatsPerVertex, GL_FLOAT, GL_FALSE, 0);
-	glVertexArrayAttribBinding(vaoId, COMPONENT_VERTEX, COMPONENT_VERTEX);
-	glVertexArrayBindingDivisor(vaoId, COMPONENT_VERTEX, 0);
+	meshIds.vertexAmount = meshData.vertices.size() / meshData.floatsPerVertex;
 
-	glEnableVertexArrayAttrib(vaoId, COMPONENT_UV);
-	glVertexArrayAttribFormat(vaoId, COMPONENT_UV, 2, GL_FLOAT, GL_FALSE, 0);
-	glVertexArrayAttribBinding(vaoId, COMPONENT_UV, COMPONENT_UV);
+	return true;
+}
 
-	if(is3DMesh)
+bool renderer::graphics_lib::operations::makeMesh(const StagedMesh &meshData, UploadService &uploadService, const string &owner, ObjectRenderingData &meshIds)
+{
+	if(!meshData.vertices.size || !meshData.uvs.size)
 	{
-		glEnableVertexArrayAttrib(vaoId, COMPONENT_NORMAL);
-		glVertexArrayAttribFormat(vaoId, COMPONENT_NORMAL, 3, GL_FLOAT, GL_FALSE, 0);
-		glVertexArrayAttribBinding(vaoId, COMPONENT_NORMAL, COMPONENT_NORMAL);
-
-		if(useTangentBasis)
-		{
-			unsigned int tangentBufferId = makeVBO(meshData.tangent);
-			unsigned int bitangentBufferId = makeVBO(meshData.bitangent);
-
-			glVertexArrayVertexBuffer(vaoId, COMPONENT_TANGENT, tangentBufferId, 0, meshData.floatsPerVertex * sizeof(float));
-			glVertexArrayVertexBuffer(vaoId, COMPONENT_BITANGENT, bitangentBufferId, 0, meshData.floatsPerVertex * sizeof(float));
+		Log::getInstance().error("Not enough data to create mesh");
+		discardMesh(meshData, uploadService); //Ring is reclaimed in order, lost allocation would stop it
+		return false;
+	}
 
-			glEnableVertexArrayAttrib(vaoId, COMPONENT_TANGENT);
-			glVertexArrayAttribFormat(vaoId, COMPONENT_TANGENT, 3, GL_FLOAT, GL_FALSE, 0);
-			glVertexArrayAttribBinding(vaoId, COMPONENT_TANGENT, COMPONENT_TANGENT);
+	const bool is3DMesh = meshData.floatsPerVertex == 3;
+	const bool useTangentBasis = meshData.tangent.size && meshData.bitangent.size;
 
-			glEnableVertexArrayAttrib(vaoId, COMPONENT_BITANGENT);
-			glVertexArrayAttribFormat(vaoId, COMPONENT_BITANGENT, 3, GL_FLOAT, GL_FALSE, 0);
-			glVertexArrayAttribBinding(vaoId, COMPONENT_BITANGENT, COMPONENT_BITANGENT);
+	unsigned int vertexVboId = makeStagedVBO(meshData.vertices, uploadService, owner);
+	unsigned int uvVboId = makeStagedVBO(meshData.uvs, uploadService, owner);
+	unsigned int normalsVboId = -1u;
+	if(meshData.normals.size)
+	{
+		normalsVboId = makeStagedVBO(meshData.normals, uploadService, owner);
+	}
 
-			meshIds.tangentBufferId = tangentBufferId;
-			meshIds.bitangentBufferId = bitangentBufferId;
-		}
+	unsigned int tangentVboId = -1u;
+	unsigned int bitangentVboId = -1u;
+	if(is3DMesh && useTangentBasis)
+	{
+		tangentVboId = makeStagedVBO(meshData.tangent, uploadService, owner);
+		bitangentVboId = makeStagedVBO(meshData.bitangent, uploadService, owner);
+	}
+	else
+	{
+		uploadService.discard(meshData.tangent);
+		uploadService.discard(meshData.bitangent);
 	}
 
-	meshIds.vaoId = vaoId;
-	meshIds.vertexBufferId = vertexVboId;
-	meshIds.uvBufferId = uvVboId;
-	meshIds.normalBufferId = normalsVboId;
+	makeVao(vertexVboId, uvVboId, normalsVboId, tangentVboId, bitangentVboId, meshData.floatsPerVertex, meshIds);
 
-	meshIds.vertexAmount = meshData.vertices.size() / meshData.floatsPerVertex;
+	meshIds.vertexAmount = meshData.vertices.size / (meshData.floatsPerVertex * sizeof(float));
 
 	return true;
 }
 
+void renderer::graphics_lib::operations::discardMesh(const StagedMesh &meshData, UploadService &uploadService)
+{
+	uploadService.discard(meshData.vertices);
+	uploadService.discard(meshData.uvs);
+	uploadService.discard(meshData.normals);
+	uploadService.discard(meshData.tangent);
+	uploadService.discard(meshData.bitangent);
+}
+
 bool renderer::graphics_lib::operations::makeMeshWithClonedVbo(const ObjectRenderingData &data, ObjectRenderingData &meshIds)
 {
 	if(data.vertexBufferId == -1u || data.uvBufferId == -1u || data.normalBufferId == -1u)
@@ -148,7 +177,7 @@ bool renderer::graphics_lib::operations::makeMeshWithClonedVbo(const ObjectRende
 	return true;
 }
 
-void renderer::graphics_lib::operations::initializeQuadMesh(unsigned int &vaoId)
+void renderer::graphics_lib::operations::initializeQuadMesh(unsigned int &vaoId, unsigned int &vboId)
 {
 	float quadMesh[QUAD_MESH_ARRAY_SIZE] = {
 		-1.f, -1.f, 0.f,
@@ -159,9 +188,7 @@ void renderer::graphics_lib::operations::initializeQuadMesh(unsigned int &vaoId)
 		1.f, 1.f, 0.f
 	};
 
-	unsigned int vboId = -1u;
-	glCreateBuffers(1, &vboId);
-	glNamedBufferStorage(vboId, QUAD_MESH_ARRAY_SIZE * sizeof(float), quadMesh, 0);
+	vboId = createTrackedBuffer(QUAD_MESH_ARRAY_SIZE * sizeof(float), quadMesh, 0, MemoryCategory::MESHES, QUAD_MESH_OWNER);
 
 	glCreateVertexArrays(1, &vaoId);
 
@@ -174,7 +201,11 @@ void renderer::graphics_lib::operations::initializeQuadMesh(unsigned int &vaoId)
 
 void renderer::graphics_lib::operations::deleteMesh(const ObjectRenderingData &objectIds)
 {
-	glDeleteBuffers(1, &objectIds.vertexBufferId);
+	deleteTrackedBuffer(objectIds.vertexBufferId);
+	deleteTrackedBuffer(objectIds.uvBufferId);
+	deleteTrackedBuffer(objectIds.normalBufferId);
+	deleteTrackedBuffer(objectIds.tangentBufferId);
+	deleteTrackedBuffer(objectIds.bitangentBufferId);
 	glDeleteVertexArrays(1, &objectIds.vaoId);
 }
 
@@ -185,13 +216,68 @@ void renderer::graphics_lib::operations::deleteContainer(unsigned int id)
 
 namespace
 {
-	unsigned int makeVBO(const vector<float> &data)
+	unsigned int makeVBO(const vector<float> &data, const string &owner)
 	{
-		unsigned int vboId = -1u;
+		return createTrackedBuffer(data.size() * sizeof(float), data.data(), 0, MemoryCategory::MESHES, owner);
+	}
 
-		glCreateBuffers(1, &vboId);
-		glNamedBufferStorage(vboId, data.size() * sizeof(float), data.data(), 0);
+	unsigned int makeStagedVBO(const StagingAllocation &data, UploadService &uploadService, const string &owner)
+	{
+		unsigned int vboId = createTrackedBuffer(data.size, nullptr, 0, MemoryCategory::MESHES, owner);
+		uploadService.commitBufferCopy(data, vboId, 0);
 
 		return vboId;
 	}
+
+	void makeVao(unsigned int vertexVboId, unsigned int uvVboId, unsigned int normalsVboId, unsigned int tangentVboId, unsigned int bitangentVboId, int floatsPerVertex,
+		ObjectRenderingData &meshIds)
+	{
+		const bool is3DMesh = floatsPerVertex == 3;
+
+		unsigned int vaoId = -1u;
+		glCreateVertexArrays(1, &vaoId);
+
+		glVertexArrayVertexBuffer(vaoId, COMPONENT_VERTEX, vertexVboId, 0, floatsPerVertex * sizeof(float));
+		glVertexArrayVertexBuffer(vaoId, 1, uvVboId, 0, 2 * sizeof(float));
+		if(is3DMesh)
+			glVertexArrayVertexBuffer(vaoId, 2, normalsVboId, 0, 3 * sizeof(float));
+
+		glEnableVertexArrayAttrib(vaoId, COMPONENT_VERTEX);
+		glVertexArrayAttribFormat(vaoId, COMPONENT_VERTEX, floatsPerVertex, GL_FLOAT, GL_FALSE, 0);
+		glVertexArrayAttribBinding(vaoId, COMPONENT_VERTEX, COMPONENT_VERTEX);
+		glVertexArrayBindingDivisor(vaoId, COMPONENT_VERTEX, 0);
+
+		glEnableVertexArrayAttrib(vaoId, COMPONENT_UV);
+		glVertexArrayAttribFormat(vaoId, COMPONENT_UV, 2, GL_FLOAT, GL_FALSE, 0);
+		glVertexArrayAttribBinding(vaoId, COMPONENT_UV, COMPONENT_UV);
+
+		if(is3DMesh)
+		{
+			glEnableVertexArrayAttrib(vaoId, COMPONENT_NORMAL);
+			glVertexArrayAttribFormat(vaoId, COMPONENT_NORMAL, 3, GL_FLOAT, GL_FALSE, 0);
+			glVertexArrayAttribBinding(vaoId, COMPONENT_NORMAL, COMPONENT_NORMAL);
+
+			if(tangentVboId != -1u)
+			{
+				glVertexArrayVertexBuffer(vaoId, COMPONENT_TANGENT, tangentVboId, 0, floatsPerVertex * sizeof(float));
+				glVertexArrayVertexBuffer(vaoId, COMPONENT_BITANGENT, bitangentVboId, 0, floatsPerVertex * sizeof(float));
+
+				glEnableVertexArrayAttrib(vaoId, COMPONENT_TANGENT);
+				glVertexArrayAttribFormat(vaoId, COMPONENT_TANGENT, 3, GL_FLOAT, GL_FALSE, 0);
+				glVertexArrayAttribBinding(vaoId, COMPONENT_TANGENT, COMPONENT_TANGENT);
+
+				glEnableVertexArrayAttrib(vaoId, COMPONENT_BITANGENT);
+				glVertexArrayAttribFormat(vaoId, COMPONENT_BITANGENT, 3, GL_FLOAT, GL_FALSE, 0);
+				glVertexArrayAttribBinding(vaoId, COMPONENT_BITANGENT, COMPONENT_BITANGENT);
+
+				meshIds.tangentBufferId = tangentVboId;
+				meshIds.bitangentBufferId = bitangentVboId;
+			}
+		}
+
+		meshIds.vaoId = vaoId;
+		meshIds.vertexBufferId = vertexVboId;
+		meshIds.uvBufferId = uvVboId;
+		meshIds.normalBufferId = normalsVboId;
+	}
 }
@@ -10,9 +10,12 @@
 #include <GL/glew.h>
 
 #include "log.h"
+#include "graphics_lib/operations/memory_ledger.h"
 #include "graphics_lib/videocard_data/component_indices.h"
 
+using namespace std;
 using namespace glm;
+using namespace renderer::graphics_lib::operations;
 using namespace renderer::graphics_lib::videocard_data;
 
 namespace
@@ -21,13 +24,14 @@ namespace
 	@brief Makes VBO and transfers data to it
 	@param[in] data - data to transfer
 	@param[in] matrixAmount - number of matrices
+	@param[in] owner - particle group name for memory ledger
 	@return VBO ID
 	*/
-	unsigned int makeVBO(const glm::vec3 *data, int matrixAmount);
-	unsigned int makeVBO(const float *data, int amount);
+	unsigned int makeVBO(const glm::vec3 *data, int matrixAmount, const string &owner);
+	unsigned int makeVBO(const float *data, int amount, const string &owner);
 }
 
-bool renderer::graphics_lib::operations::makeParticleGroup(const glm::vec3 *arrangement, const float *rotation, int recordAmount, ParticleRenderingData &groupIds)
+bool renderer::graphics_lib::operations::makeParticleGroup(const glm::vec3 *arrangement, const float *rotation, int recordAmount, const string &owner, ParticleRenderingData &groupIds)
 {
     if(!arrangement || !rotation || !recordAmount)
     {
@@ -42,8 +46,8 @@ bool renderer::graphics_lib::operations::makeParticleGroup(const glm::vec3 *arra
 
     glBindVertexArray(groupIds.objectData.vaoId);
 
-    unsigned int arrangementVboId = makeVBO(arrangement, recordAmount);
-    unsigned int rotationVboId = makeVBO(rotation, recordAmount);
+    unsigned int arrangementVboId = makeVBO(arrangement, recordAmount, owner);
+    unsigned int rotationVboId = makeVBO(rotation, recordAmount, owner);
 
 	glVertexArrayVertexBuffer(groupIds.objectData.vaoId, COMPONENT_INSTANCE_OFFSET, arrangementVboId, 0, 3 * sizeof(float));
 	glVertexArrayVertexBuffer(groupIds.objectData.vaoId, COMPONENT_INSTANCE_ROTATION, rotationVboId, 0, sizeof(float));
@@ -68,29 +72,19 @@ bool renderer::graphics_lib::operations::makeParticleGroup(const glm::vec3 *arra
 
 void renderer::graphics_lib::operations::deleteParticleGroup(const ParticleRenderingData &groupIds)
 {
-	glDeleteBuffers(1, &groupIds.arrangementBufferId);
-	glDeleteBuffers(1, &groupIds.rotationBufferId);
+	deleteTrackedBuffer(groupIds.arrangementBufferId);
+	deleteTrackedBuffer(groupIds.rotationBufferId);
 }
 
 namespace
 {
-    unsigned int makeVBO(const glm::vec3 *data, int matrixAmount)
+    unsigned int makeVBO(const glm::vec3 *data, int matrixAmount, const string &owner)
     {
-        unsigned int vboId = -1u;
-
-        glCreateBuffers(1, &vboId);
-        glNamedBufferStorage(vboId, matrixAmount * sizeof(glm::vec3), data, 0);
-
-        return vboId;
+        return createTrackedBuffer(matrixAmount * sizeof(glm::vec3), data, 0, MemoryCategory::PARTICLES, owner);
     }
 
-	unsigned int makeVBO(const float *data, int amount)
+	unsigned int makeVBO(const float *data, int amount, const string &owner)
 	{
-	    unsigned int vboId = -1u;
-
-	    glCreateBuffers(1, &vboId);
-        glNamedBufferStorage(vboId, amount * sizeof(float), data, 0);
-
-        return vboId;
+        return createTrackedBuffer(amount * sizeof(float), data, 0, MemoryCategory::PARTICLES, owner);
 	}
 }
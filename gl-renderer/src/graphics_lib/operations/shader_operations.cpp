@@ -7,23 +7,30 @@
 
 #include "graphics_lib/operations/shader_operations.h"
 
+#include <chrono>
 #include <cstring>
+#include <initializer_list>
 #include <memory>
 
 #include <GL/glew.h>
 
 #include "log.h"
+#include "startup_timer.h"
 
 using namespace std;
+using namespace std::chrono;
 using namespace renderer;
 using namespace renderer::graphics_lib;
 
 namespace
 {
+	const char *SHADER_COMPILATION_GROUP = "Shader compilation"; //Startup time of each phase that compiles shaders
+
 	enum EShaderType
 	{
 		shader_vertex,
-		shader_fragment
+		shader_fragment,
+		shader_compute
 	};
 
 	/*
@@ -32,9 +39,11 @@ namespace
 	bool compileShader(const string &source, EShaderType type, unsigned int &id);
 
 	/*
-	@brief Links vertex and fragment shader
+	@brief Links compiled shaders into program
 	*/
-	bool linkShader(unsigned int vertexShaderId, unsigned int fragmentShaderId, unsigned int &linkedShaderId);
+	bool linkShader(initializer_list<unsigned int> shaderIds, unsigned int &linkedShaderId);
+
+	const char* getShaderTypeName(EShaderType type);
 }
 
 bool renderer::graphics_lib::operations::makeShader(const string &vertexShader, const string &fragmentShader, unsigned int &shaderId, unsigned int &vertexShaderId, unsigned int &fragmentShaderId)
@@ -45,6 +54,8 @@ bool renderer::graphics_lib::operations::makeShader(const string &vertexShader,
 		return false;
 	}
 
+	const steady_clock::time_point startTime = steady_clock::now();
+
 	unsigned int compiledVertexShader = -1u, compiledFragmentShader = -1u;
 
 	if(!compileShader(vertexShader, shader_vertex, compiledVertexShader))
@@ -59,7 +70,7 @@ bool renderer::graphics_lib::operations::makeShader(const string &vertexShader,
 	}
 
 	unsigned int newShaderId = -1u;
-	if(!linkShader(compiledVertexShader, compiledFragmentShader, newShaderId))
+	if(!linkShader({compiledVertexShader, compiledFragmentShader}, newShaderId))
 	{
 		Log::getInstance().error("Can't link shaders");
 		return false;
@@ -69,6 +80,41 @@ bool renderer::graphics_lib::operations::makeShader(const string &vertexShader,
 	vertexShaderId = compiledVertexShader;
 	fragmentShaderId = compiledFragmentShader;
 
+	StartupTimer::getInstance().addTime(SHADER_COMPILATION_GROUP, "", steady_clock::now() - startTime);
+
+	return true;
+}
+
+bool renderer::graphics_lib::operations::makeComputeShader(const string &computeShader, unsigned int &shaderId, unsigned int &computeShaderId)
+{
+	if(computeShader.empty())
+	{
+		Log::getInstance().error("Shader source code is not provided");
+		return false;
+	}
+
+	const steady_clock::time_point startTime = steady_clock::now();
+
+	unsigned int compiledComputeShader = -1u;
+
+	if(!compileShader(computeShader, shader_compute, compiledComputeShader))
+	{
+		Log::getInstance().error("Compute shader compiling error");
+		return false;
+	}
+
+	unsigned int newShaderId = -1u;
+	if(!linkShader({compiledComputeShader}, newShaderId))
+	{
+		Log::getInstance().error("Can't link shaders");
+		return false;
+	}
+
+	shaderId = newShaderId;
+	computeShaderId = compiledComputeShader;
+
+	StartupTimer::getInstance().addTime(SHADER_COMPILATION_GROUP, "", steady_clock::now() - startTime);
+
 	return true;
 }
 
@@ -84,7 +130,8 @@ namespace
 
 		unsigned int shaderId = -1u;
 
-		shaderId = glCreateShader(type == shader_vertex ? GL_VERTEX_SHADER: GL_FRAGMENT_SHADER);
+		const GLenum glType[] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_COMPUTE_SHADER}; //Order matches EShaderType
+		shaderId = glCreateShader(glType[type]);
 		const char *sourceCPtr = source.c_str();
 		glShaderSource(shaderId, 1, &sourceCPtr, nullptr);
 		glCompileShader(shaderId);
@@ -100,7 +147,7 @@ namespace
 			memset(errorMessage.get(), 0, messageLength + 1);
 
 			glGetShaderInfoLog(shaderId, messageLength, nullptr, errorMessage.get());
-			Log::getInstance().error(string((type == shader_vertex ? "Vertex": "Fragment")) + " shader compilation error: " + errorMessage.get());
+			Log::getInstance().error(string(getShaderTypeName(type)) + " shader compilation error: " + errorMessage.get());
 
 			return false;
 		}
@@ -109,11 +156,11 @@ namespace
 		return true;
 	}
 
-	bool linkShader(unsigned int vertexShaderId, unsigned int fragmentShaderId, unsigned int &linkedShaderId)
+	bool linkShader(initializer_list<unsigned int> shaderIds, unsigned int &linkedShaderId)
 	{
 		unsigned int programId = glCreateProgram();
-		glAttachShader(programId, vertexShaderId);
-		glAttachShader(programId, fragmentShaderId);
+		for(auto current: shaderIds)
+			glAttachShader(programId, current);
 		glLinkProgram(programId);
 
 		int linkStatus = GL_FALSE;
@@ -135,4 +182,17 @@ namespace
 		linkedShaderId = programId;
 		return true;
 	}
+
+	const char* getShaderTypeName(EShaderType type)
+	{
+		switch(type)
+		{
+		case shader_vertex:
+			return "Vertex";
+		case shader_fragment:
+			return "Fragment";
+		default:
+			return "Compute";
+		}
+	}
 }
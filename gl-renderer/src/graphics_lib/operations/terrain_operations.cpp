@@ -12,6 +12,7 @@
 #include <GL/glew.h>
 
 #include "log.h"
+#include "graphics_lib/operations/memory_ledger.h"
 
 using namespace std;
 using namespace renderer;
@@ -25,12 +26,13 @@ namespace
 	/*
 	@brief Makes VBO and transfers data to it
 	@param[in] data - data to transfer
+	@param[in] owner - chunk name for memory ledger
 	@return VBO ID
 	*/
-	unsigned int makeVBO(const std::vector<float> &data);
+	unsigned int makeVBO(const std::vector<float> &data, const string &owner);
 }
 
-bool renderer::graphics_lib::operations::makeTerrain(const Mesh &terrainData, ObjectRenderingData &terrainIds)
+bool renderer::graphics_lib::operations::makeTerrain(const Mesh &terrainData, const string &owner, ObjectRenderingData &terrainIds)
 {
 	if(!terrainData.vertices.size() || !terrainData.uvs.size())
 	{
@@ -56,7 +58,7 @@ bool renderer::graphics_lib::operations::makeTerrain(const Mesh &terrainData, Ob
 		mergedBuffer.push_back(terrainData.normals[i*3+2]);
 	}
 
-	unsigned int vboId = makeVBO(mergedBuffer);
+	unsigned int vboId = makeVBO(mergedBuffer, owner);
 
 	int unitSize = (3 + 2 + 3) * sizeof(float);
 
@@ -87,21 +89,16 @@ bool renderer::graphics_lib::operations::makeTerrain(const Mesh &terrainData, Ob
 
 void renderer::graphics_lib::operations::deleteTerrain(const ObjectRenderingData &objectIds)
 {
-	glDeleteBuffers(1, &objectIds.vertexBufferId);
-	glDeleteBuffers(1, &objectIds.uvBufferId);
-	glDeleteBuffers(1, &objectIds.normalBufferId);
+	deleteTrackedBuffer(objectIds.vertexBufferId);
+	deleteTrackedBuffer(objectIds.uvBufferId);
+	deleteTrackedBuffer(objectIds.normalBufferId);
 	glDeleteVertexArrays(1, &objectIds.vaoId);
 }
 
 namespace
 {
-	unsigned int makeVBO(const vector<float> &data)
+	unsigned int makeVBO(const vector<float> &data, const string &owner)
 	{
-		unsigned int vboId = -1u;
-
-		glCreateBuffers(1, &vboId);
-		glNamedBufferStorage(vboId, data.size() * sizeof(float), data.data(), 0);
-
-		return vboId;
+		return createTrackedBuffer(data.size() * sizeof(float), data.data(), 0, MemoryCategory::TERRAIN, owner);
 	}
 }
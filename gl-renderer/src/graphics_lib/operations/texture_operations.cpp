@@ -13,6 +13,7 @@
 #include <GL/glew.h>
 
 #include "log.h"
+#include "graphics_lib/operations/memory_ledger.h"
 
 using namespace std;
 using namespace renderer::data;
@@ -23,22 +24,20 @@ using namespace renderer::graphics_lib::videocard_data;
 namespace
 {
 	constexpr int TEXTURE_RGB = 3;
-}
 
-bool renderer::graphics_lib::operations::makeTexture(const Texture &texture, unsigned int &textureId)
-{
-	unsigned int newTextureId = -1u;
-	glCreateTextures(GL_TEXTURE_2D, 1, &newTextureId);
 
-	glTextureParameteri(newTextureId, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTextureParameteri(newTextureId, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTextureParameteri(newTextureId, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTextureParameteri(newTextureId, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 
-	int minDimension = min<>(texture.width, texture.height);
-	int levels = log2(minDimension);
+	/*
+	@brief Creates texture with storage for all mipmap levels and sets its sampling parameters
+	@return Texture ID
+	*/
+	unsigned int createTexture(int width, int height, int bytesPerPixel, const string &owner);
+}
+
+bool renderer::graphics_lib::operations::makeTexture(const Texture &texture, const string &owner, unsigned int &textureId)
+{
+	unsigned int newTextureId = createTexture(texture.width, texture.height, texture.bytesPerPixel, owner);
 
-	glTextureStorage2D(newTextureId, levels, (texture.bytesPerPixel == TEXTURE_RGB) ? GL_RGB8: GL_RGBA8, texture.width, texture.height);
 	glTextureSubImage2D(newTextureId, 0, 0, 0, texture.width, texture.height, (texture.bytesPerPixel == TEXTURE_RGB) ? GL_BGR: GL_BGRA, GL_UNSIGNED_BYTE, texture.data.get());
 
 	glGenerateTextureMipmap(newTextureId);
@@ -47,7 +46,35 @@ bool renderer::graphics_lib::operations::makeTexture(const Texture &texture, uns
 	return true;
 }
 
+bool renderer::graphics_lib::operations::makeTexture(const StagedTexture &texture, UploadService &uploadService, const string &owner, unsigned int &textureId)
+{
+	unsigned int newTextureId = createTexture(texture.width, texture.height, texture.bytesPerPixel, owner);
+
+	uploadService.commitTextureCopy(texture.pixels, newTextureId, texture.width, texture.height, texture.bytesPerPixel); //Mipmaps are generated after copy
+
+	textureId = newTextureId;
+	return true;
+}
+
 void renderer::graphics_lib::operations::deleteTexture(unsigned int textureId)
 {
-	glDeleteTextures(1, &textureId);
+	deleteTrackedTexture(textureId);
+}
+
+namespace
+{
+	unsigned int createTexture(int width, int height, int bytesPerPixel, const string &owner)
+	{
+		int minDimension = min<>(width, height);
+		int levels = log2(minDimension);
+
+		unsigned int textureId = createTrackedTexture(levels, (bytesPerPixel == TEXTURE_RGB) ? GL_RGB8: GL_RGBA8, width, height, MemoryCategory::TEXTURES, owner);
+
+		glTextureParameteri(textureId, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(textureId, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTextureParameteri(textureId, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(textureId, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+		return textureId;
+	}
 }
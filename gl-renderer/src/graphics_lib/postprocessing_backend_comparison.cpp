@@ -0,0 +1,92 @@
+/* postprocessing_backend_comparison.cpp
+ * Measures GPU time of postprocessing effect with fragment and compute shaders
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "graphics_lib/postprocessing_backend_comparison.h"
+
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+#include <GL/glew.h>
+
+#include "common_constants.h"
+#include "log.h"
+#include "graphics_lib/postprocessing_renderer_builder.h"
+#include "graphics_lib/operations/memory_ledger.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
+
+namespace
+{
+	constexpr int COMPARED_RESOLUTIONS[][2] = {{1280, 720}, {1920, 1080}, {2560, 1440}, {3840, 2160}};
+	constexpr int MEASURED_FRAMES = 64; //Pass time is smoothed, so the first frames don't matter
+
+	const char *MEMORY_OWNER = "Postprocessing comparison";
+
+
+
+	/*
+	@brief Runs effect on offscreen target for several frames
+	@param[out] passTime - smoothed GPU time of effect pass, milliseconds. Compute pass is timed without copy to output
+	*/
+	bool measureEffect(const string &effect, int width, int height, ShaderManager *shaderManager, float &passTime);
+}
+
+void renderer::graphics_lib::comparePostprocessingBackends(const string &effect, ShaderManager *shaderManager)
+{
+	Log::getInstance().info(string("Comparing fragment and compute shaders of ") + effect);
+
+	for(auto &[width, height]: COMPARED_RESOLUTIONS)
+	{
+		float fragmentTime = 0.f, computeTime = 0.f;
+		if(!measureEffect(effect, width, height, shaderManager, fragmentTime) || !measureEffect(effect + POSTPROCESSING_COMPUTE_SUFFIX, width, height, shaderManager, computeTime))
+		{
+			Log::getInstance().error("Postprocessing comparison is stopped");
+			return;
+		}
+
+		stringstream message;
+		message << width << "x" << height << ": fragment " << fixed << setprecision(3) << fragmentTime << " ms, compute " << computeTime << " ms";
+		Log::getInstance().info(message.str());
+	}
+}
+
+namespace
+{
+	bool measureEffect(const string &effect, int width, int height, ShaderManager *shaderManager, float &passTime)
+	{
+		unique_ptr<PostprocessingRenderer> postprocessingRenderer = buildPostprocessingRenderer(width, height, effect, shaderManager);
+		if(!postprocessingRenderer)
+			return false;
+
+		//Screen may be smaller than compared resolution
+		unsigned int framebufferId = -1u;
+		glCreateFramebuffers(1, &framebufferId);
+		unsigned int textureId = createTrackedTexture(1, GL_RGBA8, width, height, MemoryCategory::RENDER_TARGETS, MEMORY_OWNER);
+		glNamedFramebufferTexture(framebufferId, GL_COLOR_ATTACHMENT0, textureId, 0);
+
+		postprocessingRenderer->setOutputFramebuffer(framebufferId);
+
+		for(int i = 0; i < MEASURED_FRAMES; i++)
+		{
+			postprocessingRenderer->setTargetFramebuffer();
+			postprocessingRenderer->render();
+		}
+		glFinish();
+
+		passTime = postprocessingRenderer->getPassTime(0);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		deleteTrackedTexture(textureId);
+		glDeleteFramebuffers(1, &framebufferId);
+
+		return true;
+	}
+}
@@ -1,5 +1,5 @@
 /* postprocessing_renderer.cpp
- * Applies 2D fullscreen effects on framebuffer
+ * Applies chain of 2D fullscreen effects on framebuffer
  * OpenGL 4.5
  *
  * Author: Artem Hiblov
@@ -7,11 +7,17 @@
 
 #include "graphics_lib/postprocessing_renderer.h"
 
+#include <algorithm>
+
 #include <GL/glew.h>
+#include <glm/glm.hpp>
 
 #include "log.h"
+#include "graphics_lib/operations/counted_calls.h"
+#include "graphics_lib/operations/memory_ledger.h"
 #include "graphics_lib/operations/mesh_operations.h"
 
+using namespace std;
 using namespace renderer;
 using namespace renderer::graphics_lib;
 using namespace renderer::graphics_lib::operations;
@@ -21,44 +27,100 @@ namespace
 {
 	constexpr float colourClearValue[4] = {0., 0., 0., 1.};
 	constexpr float depthClearValue = 1.;
+
+	constexpr float PASS_TIME_SMOOTHING = 0.2f;
+	constexpr float NANOSECONDS_IN_MILLISECOND = 1000000.f;
+
+	const char *MEMORY_OWNER = "Postprocessing";
 }
 
-PostprocessingRenderer::PostprocessingRenderer(PostprocessingShaderIds &ids, int width, int height):
-	postprocessingIds(ids), framebufferWidth(width), framebufferHeight(height)
+PostprocessingRenderer::PostprocessingRenderer(const vector<PostprocessingShaderIds> &passes, const PostprocessingShaderIds &outputCopy, int width, int height):
+	passIds(passes), outputCopyId(outputCopy), outputFramebufferId(0), framebufferWidth(width), framebufferHeight(height), currentTimerFrame(0), passTimes(passes.size(), 0.f),
+	gpuPassTimer(nullptr)
 {
-	initializeFramebuffer();
-	initializeQuadMesh(quadVaoId);
+	for(int i = 0; i < TARGET_AMOUNT; i++)
+	{
+		framebufferIds[i] = -1u;
+		textureIds[i] = -1u;
+	}
+
+	initializeFramebuffers();
+	initializeQuadMesh(quadVaoId, quadVboId);
+
+	timerQueryIds.resize(TIMER_QUERY_FRAMES * passIds.size());
+	glCreateQueries(GL_TIME_ELAPSED, timerQueryIds.size(), timerQueryIds.data());
+	for(int i = 0; i < TIMER_QUERY_FRAMES; i++)
+		isTimerQueryUsed[i] = false;
 }
 
 PostprocessingRenderer::~PostprocessingRenderer()
 {
-	glDeleteTextures(1, &depthTextureId);
+	glDeleteQueries(timerQueryIds.size(), timerQueryIds.data());
+	deleteTrackedTexture(depthTextureId);
 	glDeleteVertexArrays(1, &quadVaoId);
-	glDeleteTextures(1, &textureId);
-	glDeleteFramebuffers(1, &framebufferId);
+	deleteTrackedBuffer(quadVboId);
+
+	for(int i = 0; i < TARGET_AMOUNT; i++)
+	{
+		if(textureIds[i] != -1u)
+			deleteTrackedTexture(textureIds[i]);
+		if(framebufferIds[i] != -1u)
+			glDeleteFramebuffers(1, &framebufferIds[i]);
+	}
 }
 
 void PostprocessingRenderer::render()
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	readTimerQueries();
+
+	const int passAmount = passIds.size();
+	unsigned int *frameQueryIds = timerQueryIds.data() + currentTimerFrame * passAmount;
+
+	if(gpuPassTimer)
+		gpuPassTimer->beginPass("Postprocessing");
+
+	glDisable(GL_DEPTH_TEST); //Scene target keeps scene depth when it is written by a pass
+
+	bindVertexArray(quadVaoId);
 	glViewport(0, 0, framebufferWidth, framebufferHeight);
 
-	glClearBufferfv(GL_COLOR, 0, colourClearValue);
-	glClearBufferfv(GL_DEPTH, 0, &depthClearValue);
+	int source = 0;
+	for(int i = 0; i < passAmount; i++)
+	{
+		glBeginQuery(GL_TIME_ELAPSED, frameQueryIds[i]);
+
+		bool isLastPass = (i == passAmount - 1);
+		if(isLastPass)
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, outputFramebufferId);
+
+			glClearBufferfv(GL_COLOR, 0, colourClearValue);
+			glClearBufferfv(GL_DEPTH, 0, &depthClearValue);
+		}
 
-	glUseProgram(postprocessingIds.quadShaderId);
+		renderPass(i, source, isLastPass);
 
-	glBindVertexArray(quadVaoId);
-	glBindTextureUnit(0, textureId);
+		glEndQuery(GL_TIME_ELAPSED);
 
-	glUniform1i(postprocessingIds.unifTextureId, 0);
+		//Copy isn't timed, so fragment and compute variants of effect are compared by the effect itself
+		if(isLastPass && passIds[i].isCompute)
+			copyToOutput(1 - source);
 
-	glDrawArrays(GL_TRIANGLES, 0, 6); //6 vertices -> 2 triangles
+		source = 1 - source;
+	}
+
+	glEnable(GL_DEPTH_TEST);
+
+	if(gpuPassTimer)
+		gpuPassTimer->endPass();
+
+	isTimerQueryUsed[currentTimerFrame] = true;
+	currentTimerFrame = (currentTimerFrame + 1) % TIMER_QUERY_FRAMES;
 }
 
 void PostprocessingRenderer::setTargetFramebuffer()
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+	glBindFramebuffer(GL_FRAMEBUFFER, framebufferIds[0]);
 	glViewport(0, 0, framebufferWidth, framebufferHeight);
 
 	glClearBufferfv(GL_COLOR, 0, colourClearValue);
@@ -67,27 +129,115 @@ void PostprocessingRenderer::setTargetFramebuffer()
 
 unsigned int PostprocessingRenderer::getFramebufferId() const
 {
-	return framebufferId;
+	return framebufferIds[0];
+}
+
+void PostprocessingRenderer::setOutputFramebuffer(unsigned int id)
+{
+	outputFramebufferId = id;
+}
+
+int PostprocessingRenderer::getPassAmount() const
+{
+	return passIds.size();
+}
+
+float PostprocessingRenderer::getPassTime(int index) const
+{
+	return passTimes[index];
+}
+
+void PostprocessingRenderer::setGpuPassTimer(GpuPassTimer *timer)
+{
+	gpuPassTimer = timer;
+}
+
+void PostprocessingRenderer::initializeFramebuffers()
+{
+	//Ping-pong target is needed for chains and compute passes
+	bool hasComputePass = any_of(passIds.begin(), passIds.end(), [](const PostprocessingShaderIds &current)
+		{
+			return current.isCompute;
+		});
+	const int targetAmount = (passIds.size() > 1 || hasComputePass) ? TARGET_AMOUNT : 1;
+
+	glCreateFramebuffers(targetAmount, framebufferIds);
+
+	for(int i = 0; i < targetAmount; i++)
+	{
+		textureIds[i] = createTrackedTexture(1, GL_RGBA8, framebufferWidth, framebufferHeight, MemoryCategory::RENDER_TARGETS, MEMORY_OWNER); //Compute passes write it as image, RGB8 can't be used there
+		glTextureParameteri(textureIds[i], GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(textureIds[i], GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(textureIds[i], GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(textureIds[i], GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		glNamedFramebufferTexture(framebufferIds[i], GL_COLOR_ATTACHMENT0, textureIds[i], 0);
+
+		GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
+		glNamedFramebufferDrawBuffers(framebufferIds[i], 1, drawBuffers);
+	}
+
+	//Only scene is drawn with depth test
+	depthTextureId = createTrackedTexture(1, GL_DEPTH24_STENCIL8, framebufferWidth, framebufferHeight, MemoryCategory::RENDER_TARGETS, MEMORY_OWNER);
+
+	glNamedFramebufferTexture(framebufferIds[0], GL_DEPTH_STENCIL_ATTACHMENT, depthTextureId, 0);
 }
 
-void PostprocessingRenderer::initializeFramebuffer()
+void PostprocessingRenderer::renderPass(int index, int source, bool isLastPass)
 {
-	glCreateFramebuffers(1, &framebufferId);
+	const PostprocessingShaderIds &passId = passIds[index];
+
+	useProgram(passId.quadShaderId);
 
-	glCreateTextures(GL_TEXTURE_2D, 1, &textureId);
-	glTextureStorage2D(textureId, 1, GL_RGB8, framebufferWidth, framebufferHeight);
-	glTextureParameteri(textureId, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTextureParameteri(textureId, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTextureParameteri(textureId, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTextureParameteri(textureId, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	bindTextureUnit(0, textureIds[source]);
+	uniform1i(passId.unifTextureId, 0);
 
-	glNamedFramebufferTexture(framebufferId, GL_COLOR_ATTACHMENT0, textureId, 0);
+	if(!passId.isCompute)
+	{
+		if(!isLastPass)
+			glBindFramebuffer(GL_FRAMEBUFFER, framebufferIds[1 - source]); //The whole target is overwritten, no need to clear
 
-	glCreateTextures(GL_TEXTURE_2D, 1, &depthTextureId);
-	glTextureStorage2D(depthTextureId, 1, GL_DEPTH24_STENCIL8, framebufferWidth, framebufferHeight);
+		drawArrays(GL_TRIANGLES, 0, 6); //6 vertices -> 2 triangles
+		return;
+	}
 
-	glNamedFramebufferTexture(framebufferId, GL_DEPTH_STENCIL_ATTACHMENT, depthTextureId, 0);
+	glBindImageTexture(0, textureIds[1 - source], 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+	uniform1i(passId.unifResultImageId, 0);
 
-	GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
-	glNamedFramebufferDrawBuffers(framebufferId, 1, drawBuffers);
+	glDispatchCompute((framebufferWidth + COMPUTE_TILE_SIDE - 1) / COMPUTE_TILE_SIDE, (framebufferHeight + COMPUTE_TILE_SIDE - 1) / COMPUTE_TILE_SIDE, 1);
+	glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT); //Result is sampled by the next pass or output copy
+}
+
+void PostprocessingRenderer::copyToOutput(int source)
+{
+	useProgram(outputCopyId.quadShaderId);
+
+	bindTextureUnit(0, textureIds[source]);
+	uniform1i(outputCopyId.unifTextureId, 0);
+
+	drawArrays(GL_TRIANGLES, 0, 6);
+}
+
+void PostprocessingRenderer::readTimerQueries()
+{
+	if(!isTimerQueryUsed[currentTimerFrame])
+		return;
+
+	const int passAmount = passIds.size();
+	unsigned int *frameQueryIds = timerQueryIds.data() + currentTimerFrame * passAmount;
+
+	//The last pass finishes the latest, so the whole frame is ready when its result is available
+	int isAvailable = 0;
+	glGetQueryObjectiv(frameQueryIds[passAmount - 1], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+	if(!isAvailable)
+		return;
+
+	for(int i = 0; i < passAmount; i++)
+	{
+		GLuint64 elapsedTime = 0;
+		glGetQueryObjectui64v(frameQueryIds[i], GL_QUERY_RESULT, &elapsedTime);
+
+		float passTime = elapsedTime / NANOSECONDS_IN_MILLISECOND;
+		passTimes[i] = (passTimes[i] == 0.f) ? passTime : glm::mix(passTimes[i], passTime, PASS_TIME_SMOOTHING);
+	}
 }
@@ -1,5 +1,5 @@
 /* postprocessing_renderer_builder.cpp
- * Initializes all the shaders for PostprocessingRenderer class
+ * Initializes all the shaders for PostprocessingRenderer and DynamicResolution classes
  * OpenGL 4.5
  *
  * Author: Artem Hiblov
@@ -7,12 +7,20 @@
 
 #include "graphics_lib/postprocessing_renderer_builder.h"
 
+#include <cstring>
+#include <sstream>
+#include <vector>
+
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
+#include "common_constants.h"
+#include "log.h"
 #include "graphics_lib/videocard_data/postprocessing_shader_ids.h"
+#include "graphics_lib/videocard_data/shader_ids.h"
 
 using namespace std;
+using namespace renderer;
 using namespace renderer::data;
 using namespace renderer::graphics_lib;
 using namespace renderer::graphics_lib::videocard_data;
@@ -22,35 +30,238 @@ namespace
 	const char *RENDERED_TEXTURE_UNIFORM_NAME = "renderedTexture";
 	const char *POSTPROCESSING_SCREEN_RATIO_UNIFORM_NAME = "screenRatio";
 	const char *POSTPROCESSING_SCREEN_WIDTH_HEIGHT_UNIFORM_NAME = "screenWidthHeight"; //x = width, y = height
+	const char *RESULT_IMAGE_UNIFORM_NAME = "resultImage";
+
+	const char *UPSCALE_SHADER_NAME = "upscale-sharpen";
+	const char *SCENE_TEXTURE_UNIFORM_NAME = "sceneTexture";
+	const char *RENDER_SCALE_UNIFORM_NAME = "renderScale";
+	const char *SHARPNESS_UNIFORM_NAME = "sharpness";
+
+	const char *TEMPORAL_RESOLVE_SHADER_NAME = "temporal-resolve";
+	const char *DEPTH_COMPONENT_UNIFORM_NAME = "depthComponent";
+	const char *HISTORY_TEXTURE_UNIFORM_NAME = "historyTexture";
+	const char *JITTER_UNIFORM_NAME = "jitter";
+	const char *REPROJECTION_UNIFORM_NAME = "reprojection";
+	const char *HISTORY_WEIGHT_UNIFORM_NAME = "historyWeight";
+
+	constexpr char EFFECT_CHAIN_SEPARATOR = ',';
+
+
+
+	/*
+	@brief Splits effect chain from scene file into effects in applying order
+	*/
+	void splitEffectChain(const string &chain, vector<string> &effects);
+
+	/*
+	@brief Removes compute shader suffix from effect name
+	@return true if compute shader is requested
+	*/
+	bool removeComputeSuffix(string &effect);
+
+	/*
+	@brief Gets uniform locations of a pass and sets values which don't change
+	@param[in] flags - all the effects applied by the pass
+	*/
+	void initializePassUniforms(PostprocessingShaderIds &id, unsigned long long flags, float screenWidth, float screenHeight);
 }
 
 unique_ptr<PostprocessingRenderer> renderer::graphics_lib::buildPostprocessingRenderer(float screenWidth, float screenHeight, const string &postprocessingEffect, ShaderManager *shaderManager)
 {
-	PostprocessingShaderIds *postprocessingId = nullptr;
-	bool status = shaderManager->getPostprocessingShaderId(postprocessingEffect, &postprocessingId);
-	if(!status)
-		return nullptr;
+	vector<string> effects;
+	splitEffectChain(postprocessingEffect, effects);
+
+	for(auto &current: effects)
+	{
+		string effect = current;
+		if(removeComputeSuffix(effect) && (shaderManager->getPostprocessingShaderFlags(effect) & PostprocessingFlags::PER_PIXEL_EFFECTS))
+		{
+			Log::getInstance().warning(effect + " reads only its own pixel, it is fused into fragment shader instead of compute one");
+			current = effect;
+		}
+	}
+
+	vector<PostprocessingShaderIds> passes;
+	stringstream message;
+	message << "Postprocessing passes:";
+
+	size_t effectIndex = 0;
+	while(effectIndex < effects.size())
+	{
+		string effect = effects[effectIndex];
+		bool useCompute = removeComputeSuffix(effect);
+
+		unsigned long long flags = shaderManager->getPostprocessingShaderFlags(effect);
+		if(!flags)
+		{
+			Log::getInstance().error(string("Unknown postprocessing effect \"") + effects[effectIndex] + "\"");
+			return nullptr;
+		}
+
+		PostprocessingShaderIds *postprocessingId = nullptr;
+		bool status = false;
+		unsigned long long passFlags = 0;
+		string passEffects;
+
+		if(flags & PostprocessingFlags::PER_PIXEL_EFFECTS)
+		{
+			//Consecutive per-pixel effects share a pass
+			vector<string> fusedEffects;
+			for(; effectIndex < effects.size(); effectIndex++)
+			{
+				unsigned long long currentFlags = shaderManager->getPostprocessingShaderFlags(effects[effectIndex]);
+				if(!(currentFlags & PostprocessingFlags::PER_PIXEL_EFFECTS))
+					break;
 
-	glUseProgram(postprocessingId->quadShaderId);
+				fusedEffects.push_back(effects[effectIndex]);
+				passFlags |= currentFlags;
+				passEffects += (passEffects.empty() ? "" : "+") + effects[effectIndex];
+			}
 
-	postprocessingId->unifTextureId = glGetUniformLocation(postprocessingId->quadShaderId, RENDERED_TEXTURE_UNIFORM_NAME);
+			status = shaderManager->getFusedPostprocessingShaderId(fusedEffects, &postprocessingId);
+		}
+		else
+		{
+			passFlags = flags;
+			passEffects = effects[effectIndex];
+			if(useCompute)
+				status = shaderManager->getComputePostprocessingShaderId(effect, &postprocessingId);
+			else status = shaderManager->getPostprocessingShaderId(effect, &postprocessingId);
+			effectIndex++;
+		}
+
+		if(!status)
+			return nullptr;
+
+		initializePassUniforms(*postprocessingId, passFlags, screenWidth, screenHeight);
+		passes.push_back(*postprocessingId);
+
+		message << (passes.size() == 1 ? " " : ", ") << passEffects;
+	}
 
-	unsigned long long flags = shaderManager->getPostprocessingShaderFlags(postprocessingEffect);
-	if((flags & PostprocessingFlags::POSTPROCESSING_VIGNETTE) || (flags & PostprocessingFlags::POSTPROCESSING_DROPS_ON_LENS))
+	if(passes.empty())
 	{
-		postprocessingId->unifScreenRatio = glGetUniformLocation(postprocessingId->quadShaderId, POSTPROCESSING_SCREEN_RATIO_UNIFORM_NAME);
-		float screenRatio = static_cast<float>(screenWidth) / screenHeight;
-		glUniform1f(postprocessingId->unifScreenRatio, screenRatio);
+		Log::getInstance().error("No postprocessing effects are specified");
+		return nullptr;
 	}
 
-	if(flags & PostprocessingFlags::POSTPROCESSING_EMBOSS)
+	//Fused shader without effects copies compute result to the screen, which may be multisampled
+	PostprocessingShaderIds outputCopyId;
+	if(passes.back().isCompute)
 	{
-		postprocessingId->unifScreenWidthHeight = glGetUniformLocation(postprocessingId->quadShaderId, POSTPROCESSING_SCREEN_WIDTH_HEIGHT_UNIFORM_NAME);
-		glm::vec2 dimensions(screenWidth, screenHeight);
-		glUniform2fv(postprocessingId->unifScreenWidthHeight, 1, &dimensions[0]);
+		PostprocessingShaderIds *copyId = nullptr;
+		if(!shaderManager->getFusedPostprocessingShaderId(vector<string>(), &copyId))
+			return nullptr;
+
+		initializePassUniforms(*copyId, 0, screenWidth, screenHeight);
+		outputCopyId = *copyId;
 	}
 
-	unique_ptr<PostprocessingRenderer> postprocessingRenderer = make_unique<PostprocessingRenderer>(*postprocessingId, screenWidth, screenHeight);
+	Log::getInstance().info(message.str());
+
+	unique_ptr<PostprocessingRenderer> postprocessingRenderer = make_unique<PostprocessingRenderer>(passes, outputCopyId, screenWidth, screenHeight);
 
 	return postprocessingRenderer;
 }
+
+unique_ptr<DynamicResolution> renderer::graphics_lib::buildDynamicResolution(int screenWidth, int screenHeight, float initialScale, float targetFrameTime, bool useTemporalUpscaling,
+	ShaderManager *shaderManager)
+{
+	stringstream message;
+	message << "Initializing dynamic resolution, scale is " << initialScale;
+	if(targetFrameTime > 0.f)
+		message << ", target GPU frame time is " << targetFrameTime << " ms";
+	if(useTemporalUpscaling)
+		message << ", temporal upscaling";
+	Log::getInstance().info(message.str());
+
+	ShaderIds upscaleId;
+	if(!shaderManager->getShaderId(UPSCALE_SHADER_NAME, upscaleId))
+	{
+		Log::getInstance().error("Can't create dynamic resolution upscaling shader");
+		return nullptr;
+	}
+
+	glUseProgram(upscaleId.id);
+
+	upscaleId.unifSceneTextureId = glGetUniformLocation(upscaleId.id, SCENE_TEXTURE_UNIFORM_NAME);
+	upscaleId.unifRenderScale = glGetUniformLocation(upscaleId.id, RENDER_SCALE_UNIFORM_NAME);
+	upscaleId.unifSharpness = glGetUniformLocation(upscaleId.id, SHARPNESS_UNIFORM_NAME);
+
+	unique_ptr<DynamicResolution> dynamicResolution = make_unique<DynamicResolution>(upscaleId, screenWidth, screenHeight, initialScale, targetFrameTime);
+
+	if(useTemporalUpscaling)
+	{
+		ShaderIds resolveId;
+		if(!shaderManager->getShaderId(TEMPORAL_RESOLVE_SHADER_NAME, resolveId))
+		{
+			Log::getInstance().error("Can't create temporal resolve shader, plain upscaling is used");
+			return dynamicResolution;
+		}
+
+		glUseProgram(resolveId.id);
+
+		resolveId.unifSceneTextureId = glGetUniformLocation(resolveId.id, SCENE_TEXTURE_UNIFORM_NAME);
+		resolveId.unifDepthComponentId = glGetUniformLocation(resolveId.id, DEPTH_COMPONENT_UNIFORM_NAME);
+		resolveId.unifHistoryTextureId = glGetUniformLocation(resolveId.id, HISTORY_TEXTURE_UNIFORM_NAME);
+		resolveId.unifRenderScale = glGetUniformLocation(resolveId.id, RENDER_SCALE_UNIFORM_NAME);
+		resolveId.unifJitter = glGetUniformLocation(resolveId.id, JITTER_UNIFORM_NAME);
+		resolveId.unifReprojection = glGetUniformLocation(resolveId.id, REPROJECTION_UNIFORM_NAME);
+		resolveId.unifHistoryWeight = glGetUniformLocation(resolveId.id, HISTORY_WEIGHT_UNIFORM_NAME);
+
+		dynamicResolution->setTemporalUpscaler(make_unique<TemporalUpscaler>(resolveId, screenWidth, screenHeight));
+	}
+
+	return dynamicResolution;
+}
+
+namespace
+{
+	void splitEffectChain(const string &chain, vector<string> &effects)
+	{
+		istringstream iss(chain);
+		string current;
+		while(getline(iss, current, EFFECT_CHAIN_SEPARATOR))
+		{
+			if(!current.empty())
+				effects.push_back(current);
+		}
+	}
+
+	bool removeComputeSuffix(string &effect)
+	{
+		const size_t suffixLength = strlen(POSTPROCESSING_COMPUTE_SUFFIX);
+		if(effect.size() <= suffixLength || effect.compare(effect.size() - suffixLength, suffixLength, POSTPROCESSING_COMPUTE_SUFFIX) != 0)
+			return false;
+
+		effect.erase(effect.size() - suffixLength);
+		return true;
+	}
+
+	void initializePassUniforms(PostprocessingShaderIds &id, unsigned long long flags, float screenWidth, float screenHeight)
+	{
+		glUseProgram(id.quadShaderId);
+
+		id.unifTextureId = glGetUniformLocation(id.quadShaderId, RENDERED_TEXTURE_UNIFORM_NAME);
+
+		if(id.isCompute) //Neighbours are read by texel positions, screen size isn't needed
+		{
+			id.unifResultImageId = glGetUniformLocation(id.quadShaderId, RESULT_IMAGE_UNIFORM_NAME);
+			return;
+		}
+
+		if((flags & PostprocessingFlags::POSTPROCESSING_VIGNETTE) || (flags & PostprocessingFlags::POSTPROCESSING_DROPS_ON_LENS))
+		{
+			id.unifScreenRatio = glGetUniformLocation(id.quadShaderId, POSTPROCESSING_SCREEN_RATIO_UNIFORM_NAME);
+			float screenRatio = static_cast<float>(screenWidth) / screenHeight;
+			glUniform1f(id.unifScreenRatio, screenRatio);
+		}
+
+		if(flags & PostprocessingFlags::POSTPROCESSING_EMBOSS)
+		{
+			id.unifScreenWidthHeight = glGetUniformLocation(id.quadShaderId, POSTPROCESSING_SCREEN_WIDTH_HEIGHT_UNIFORM_NAME);
+			glm::vec2 dimensions(screenWidth, screenHeight);
+			glUniform2fv(id.unifScreenWidthHeight, 1, &dimensions[0]);
+		}
+	}
+}
@@ -0,0 +1,135 @@
+/* render_queue.cpp
+ * Per-frame list of visible meshes ordered by 64-bit sort keys
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "graphics_lib/render_queue.h"
+
+#include <algorithm>
+
+#include "common_constants.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::graphics_lib;
+
+namespace
+{
+	constexpr int PASS_SHIFT = 60;
+	constexpr uint64_t PASS_OPAQUE = 0;
+	constexpr uint64_t PASS_TRANSPARENT = 1;
+
+	constexpr uint64_t SHADER_MASK = 0xFFF;
+	constexpr uint64_t TEXTURE_MASK = 0xFFFFFF;
+	constexpr uint64_t DEPTH_MASK = 0xFFFFFF;
+
+	/*
+	@brief Converts view space distance to integer. Objects behind camera get 0
+	*/
+	uint64_t quantizeDepth(float depth);
+}
+
+RenderQueue::RenderQueue():
+	opaqueAmount(0)
+{
+}
+
+RenderQueue::~RenderQueue()
+{
+}
+
+void RenderQueue::clear()
+{
+	items.clear();
+	keys.clear();
+	order.clear();
+	opaqueAmount = 0;
+}
+
+void RenderQueue::addOpaque(const Item &item, unsigned int textureId, float depth)
+{
+	uint64_t key = (PASS_OPAQUE << PASS_SHIFT) | ((item.shaderIndex & SHADER_MASK) << 48) | ((textureId & TEXTURE_MASK) << 24) | quantizeDepth(depth);
+
+	items.push_back(item);
+	keys.push_back(key);
+	opaqueAmount++;
+}
+
+void RenderQueue::addTransparent(const Item &item, unsigned int textureId, float depth)
+{
+	uint64_t key = (PASS_TRANSPARENT << PASS_SHIFT) | ((DEPTH_MASK - quantizeDepth(depth)) << 36) | ((item.shaderIndex & SHADER_MASK) << 24) | (textureId & TEXTURE_MASK);
+
+	items.push_back(item);
+	keys.push_back(key);
+}
+
+void RenderQueue::sort()
+{
+	const size_t amount = keys.size();
+
+	sortedKeys = keys;
+	order.resize(amount);
+	for(size_t i = 0; i < amount; i++)
+		order[i] = i;
+
+	if(amount < 2)
+		return;
+
+	scratchKeys.resize(amount);
+	scratchOrder.resize(amount);
+
+	for(int shift = 0; shift < 64; shift += RADIX_BITS)
+	{
+		size_t digitCount[RADIX_SIZE] = {};
+		for(size_t i = 0; i < amount; i++)
+			digitCount[(sortedKeys[i] >> shift) & (RADIX_SIZE - 1)]++;
+
+		//Most digits are equal for all keys, e.g. pass and high depth bits
+		if(digitCount[(sortedKeys[0] >> shift) & (RADIX_SIZE - 1)] == amount)
+			continue;
+
+		size_t offset = 0;
+		for(int digit = 0; digit < RADIX_SIZE; digit++)
+		{
+			size_t count = digitCount[digit];
+			digitCount[digit] = offset;
+			offset += count;
+		}
+
+		for(size_t i = 0; i < amount; i++) //Stable, so lower digits keep their order
+		{
+			size_t destination = digitCount[(sortedKeys[i] >> shift) & (RADIX_SIZE - 1)]++;
+			scratchKeys[destination] = sortedKeys[i];
+			scratchOrder[destination] = order[i];
+		}
+
+		sortedKeys.swap(scratchKeys);
+		order.swap(scratchOrder);
+	}
+}
+
+int RenderQueue::getItemAmount() const
+{
+	return items.size();
+}
+
+int RenderQueue::getTransparentStart() const
+{
+	return opaqueAmount;
+}
+
+const RenderQueue::Item& RenderQueue::getItem(int position) const
+{
+	return items[order[position]];
+}
+
+namespace
+{
+	uint64_t quantizeDepth(float depth)
+	{
+		float normalized = clamp(depth / PROJECTION_FAR_CLIPPING, 0.f, 1.f);
+		return static_cast<uint64_t>(normalized * DEPTH_MASK);
+	}
+}
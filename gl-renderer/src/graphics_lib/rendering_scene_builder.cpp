@@ -8,18 +8,25 @@
 #include "graphics_lib/rendering_scene_builder.h"
 
 #include <algorithm>
+#include <chrono>
 #include <vector>
 
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "log.h"
+#include "common_constants.h"
+#include "profiler.h"
+#include "startup_timer.h"
+#include "utils/chunk_tools.h"
 
 using namespace std;
+using namespace std::chrono;
 using namespace renderer;
 using namespace renderer::data;
 using namespace renderer::graphics_lib;
 using namespace renderer::graphics_lib::videocard_data;
 using namespace renderer::managers;
+using namespace renderer::utils;
 
 namespace
 {
@@ -41,11 +48,6 @@ namespace
 		RenderingScene *renderingScene);
 	void createSky(const Scene &scene, ObjectManager *objectManager, RenderingScene *renderingScene);
 
-	/*
-	@brief Returns quad index for given coordinates
-	*/
-	int findQuad(const ChunkMargins &margins, float x, float z);
-
 	void groupObjectsByShader(vector<ObjectQuadSubdivision::ObjectNode*> *objectsSorted, QuadObjects &quadObjects);
 	void copyObjectsToRenderingScene(vector<ObjectQuadSubdivision::ObjectNode*> *objectsSorted, QuadObjects &quadObjects, int chunkIndex, RenderingObjects *renderingObjects);
 }
@@ -55,6 +57,8 @@ namespace
 RenderingScene* renderer::graphics_lib::makeRenderingScene(const Scene &scene, bool isDeferredRendering, TerrainManager *terrainManager, ObjectManager *objectManager, ParticleManager *particleManager,
 	const map<int, ChunkMargins> &chunkMargins, ShaderManager *shaderManager)
 {
+	PROFILE_ZONE("graphics_lib::makeRenderingScene");
+
 	RenderingScene *renderingScene = new RenderingScene();
 
 	renderingScene->chunkAmount = scene.chunks.size();
@@ -102,7 +106,7 @@ namespace
 			terrainManager->getRenderingData(currentPatch.name, data);
 
 			int shaderIndex = 0;
-			bool status = shaderManager->getShaderIndexByProperty(scene.terrainTexturing, scene.fog.enable, isDeferredRendering, shaderIndex);
+			bool status = shaderManager->getShaderIndexByProperty(scene.terrainTexturing, scene.fog.enable, isDeferredRendering, false, shaderIndex);
 			if(!status)
 			{
 				Log::getInstance().error("Can't require shader for terrain");
@@ -134,19 +138,8 @@ namespace
 				vector<glm::mat4> arrangement[4];
 				vector<glm::mat3> rotation[4];
 
-				int quadIndex = 0;
-				const int positionArraySize = static_cast<int>(currentInstance.positions.size());
-				for(int j = 0; j < positionArraySize; j += 4)
-				{
-					glm::mat4 translationMatrix = glm::translate(glm::mat4(1.), glm::vec3(currentInstance.positions[j], currentInstance.positions[j+1], currentInstance.positions[j+2]));
-					glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.), glm::radians(currentInstance.positions[j+3]), glm::vec3(0, 1, 0));
-
-					const auto iter = chunkMargins.find(chunkIndex);
-					quadIndex = findQuad(iter->second, currentInstance.positions[j], currentInstance.positions[j+2]);
-
-					arrangement[quadIndex].push_back(translationMatrix * rotationMatrix);
-					rotation[quadIndex].push_back(rotationMatrix);
-				}
+				const auto iter = chunkMargins.find(chunkIndex);
+				arrangeInstances(currentInstance.positions, iter->second, arrangement, rotation);
 
 				ObjectRenderingData data;
 				bool status = objectManager->getRenderingData(currentInstance.name, data);
@@ -162,7 +155,7 @@ namespace
 					useDeferredRenderingShader = !hasTransparentTexture;
 
 				int shaderIndex = 0;
-				status = shaderManager->getShaderIndexByProperty(currentInstance.shaderFeature, scene.fog.enable, useDeferredRenderingShader, shaderIndex);
+				status = shaderManager->getShaderIndexByProperty(currentInstance.shaderFeature, scene.fog.enable, useDeferredRenderingShader, hasTransparentTexture, shaderIndex);
 				if(!status)
 				{
 					Log::getInstance().error(string("Can't find shader with property \"") + currentInstance.shaderFeature + "\" for object");
@@ -240,13 +233,15 @@ namespace
 				const int quadIndex = findQuad(iter->second, currentGroup.x, currentGroup.z);
 
 				ParticleRenderingData data;
+				const steady_clock::time_point transferStart = steady_clock::now();
 				objectManager->getRenderingDataWithClonedVbo(currentGroup.name, data.objectData);
+				StartupTimer::getInstance().addTime(STARTUP_GROUP_PARTICLES, STARTUP_STEP_TRANSFER, steady_clock::now() - transferStart);
 				particleManager->getRenderingData(currentGroup, scene.chunks[chunkIndex], data); //TODO out arg for 4 quads for per-instance classification
 
 				glm::mat4 arrangement = glm::translate(glm::mat4(1.f), glm::vec3(currentGroup.x, 0, currentGroup.z));
 
 				int shaderIndex = 0;
-				bool status = shaderManager->getShaderIndexByProperty(currentGroup.shaderFeature, scene.fog.enable, isDeferredRendering, shaderIndex);
+				bool status = shaderManager->getShaderIndexByProperty(currentGroup.shaderFeature, scene.fog.enable, isDeferredRendering, false, shaderIndex);
 				if(!status)
 				{
 					Log::getInstance().error(string("Can't find shader with property \"") + currentGroup.shaderFeature + "\" for particle group");
@@ -280,37 +275,6 @@ namespace
 		renderingScene->sky = data;
 	}
 
-	int findQuad(const ChunkMargins &margins, float x, float z)
-	{
-		if((x >= margins.leftX) && (x <= margins.centerX))
-		{
-			if((z <= margins.nearZ) && (z >= margins.centerZ))
-				return 0;
-			else if((z <= margins.centerZ) && (z >= margins.farZ))
-				return 2;
-			else
-			{
-				Log::getInstance().error("Quad not found");
-				return 0;
-			}
-		}
-		if((x >= margins.centerX) && (x <= margins.rightX))
-		{
-			if((z <= margins.nearZ) && (z >= margins.centerZ))
-				return 1;
-			else if((z <= margins.centerZ) && (z >= margins.farZ))
-				return 3;
-			else
-			{
-				Log::getInstance().error("Quad not found");
-				return 0;
-			}
-		}
-
-		Log::getInstance().error("Quad not found");
-		return 0;
-	}
-
 	void groupObjectsByShader(vector<ObjectQuadSubdivision::ObjectNode*> *objectsSorted, QuadObjects &quadObjects)
 	{
 		for(int quadIndex = 0; quadIndex < 4; quadIndex++)
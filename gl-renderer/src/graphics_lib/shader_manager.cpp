@@ -17,6 +17,7 @@
 #include <GL/glew.h>
 
 #include "log.h"
+#include "graphics_lib/light_clusters.h"
 #include "graphics_lib/operations/shader_operations.h"
 #include "loaders/shader_loader.h"
 
@@ -40,6 +41,8 @@ namespace
 	const char *FEATURE_TEXTURE_BOMBING_AND_TRIPLANAR_MAPPING_STRING = "texture-bombing-and-triplanar-mapping";
 	const char *FEATURE_SMALL_WAVES_STRING = "small-waves";
 	const char *FEATURE_GLITTER = "glitter";
+	const char *FEATURE_CLUSTERED_LIGHTS_STRING = "clustered-lights";
+	const char *FEATURE_WEIGHTED_BLENDED_OIT_STRING = "weighted-blended-oit";
 
 	//Deferred shading properties
 	const char *FEATURE_DEFERRED_GEOMETRY_STRING = "deferred-geometry";
@@ -56,6 +59,35 @@ namespace
 	const char *POSTPROCESSING_VIGNETTE_STRING = "postprocessing:vignette";
 	const char *POSTPROCESSING_DROPS_ON_LENS_STRING = "postprocessing:drops-on-lens";
 	const char *POSTPROCESSING_EMBOSS_STRING = "postprocessing:emboss";
+	const char *POSTPROCESSING_COMPUTE_STRING = "postprocessing:compute";
+
+	//Fused per-pixel postprocessing effects. Fragment shader keeps effect functions, main() is generated
+	const char *FULLSCREEN_VERTEX_SHADER_PATH = "shaders/fullscreen-vert.glsl";
+	const char *PER_PIXEL_EFFECTS_FRAGMENT_SHADER_PATH = "shaders/postprocessing/per-pixel-effects-frag.glsl";
+	const char *FUSED_POSTPROCESSING_SHADER_NAME_PREFIX = "fused:";
+
+	//Compute shader variants of neighbourhood postprocessing effects. Description keeps effect source path instead of vertex shader path
+	const char *TILE_FILTER_COMPUTE_SHADER_PATH = "shaders/postprocessing/tile-filter-comp.glsl";
+
+	//Uber-shader for regular objects
+	const char *UBER_VERTEX_SHADER_PATH = "shaders/uber/object-vert.glsl";
+	const char *UBER_FRAGMENT_SHADER_PATH = "shaders/uber/object-frag.glsl";
+	const char *UBER_SHADER_NAME_PREFIX = "uber:";
+
+	//Shared fragment shader code of define-enabled features. Appended to shader declaring prototypes of its functions
+	const char *CLUSTERED_LIGHTS_SHADER_PATH = "shaders/common/clustered-lights.glsl";
+	const char *WEIGHTED_BLENDED_OIT_SHADER_PATH = "shaders/common/weighted-blended-oit.glsl";
+
+	constexpr unsigned long long UBER_SHADER_FEATURES = ShaderFlags::FEATURE_DIRECTIONAL_LIGHT | ShaderFlags::FEATURE_POINT_LIGHT |
+		ShaderFlags::FEATURE_DEFERRED_GEOMETRY | ShaderFlags::FEATURE_SPECULAR | ShaderFlags::FEATURE_NORMALMAP |
+		ShaderFlags::FEATURE_INSTANCING | ShaderFlags::FEATURE_FOG | ShaderFlags::FEATURE_CLUSTERED_LIGHTS | ShaderFlags::FEATURE_WEIGHTED_BLENDED_OIT;
+
+	//Features enabled by defines in shaders from description file
+	constexpr unsigned long long DEFINE_ONLY_FEATURES = ShaderFlags::FEATURE_CLUSTERED_LIGHTS | ShaderFlags::FEATURE_WEIGHTED_BLENDED_OIT;
+
+	//Depth pre-pass. Vertex shader is the same as in shading pass
+	const char *DEPTH_PREPASS_FRAGMENT_SHADER_PATH = "shaders/depth-prepass-frag.glsl";
+	const char *DEPTH_PREPASS_SHADER_NAME_PREFIX = "depth-prepass:";
 
 
 
@@ -71,16 +103,37 @@ namespace
 	*/
 	bool stringPropertyToFlag(const string &name, unsigned long long &flag);
 
+	/*
+	@brief Makes uber-shader macro names for enabled features
+	*/
+	void makeFeatureDefines(unsigned long long flags, vector<string> &defines);
+
+	/*
+	@brief Makes defines with light cluster grid dimensions, so shaders match LightClusters
+	*/
+	void makeClusterGridDefines(vector<string> &defines);
+
+	/*
+	@brief Appends shared code of enabled features to fragment shader
+	*/
+	bool appendFeatureSources(unsigned long long flags, string &fragmentShader);
+
 	/*
 	@brief Matches property name and its postprocessing code
 	@param[in] name - one of POSTPROCESSING_*_STRING
 	@param[out] flag - corresponding flag
 	*/
 	bool stringPropertyToPostprocessingFlag(const string &name, unsigned long long &flag);
+
+	/*
+	@brief Makes main() calling effect functions of per-pixel effects library in the given order
+	@param[in] flags - postprocessing flags of the effects
+	*/
+	bool makeFusedPostprocessingMain(const vector<unsigned long long> &flags, string &code);
 }
 
 ShaderManager::ShaderManager(const string &descriptionPath):
-	directionalLight(false)
+	directionalLight(false), clusteredLights(false), weightedBlendedTransparency(false)
 {
 	initShaderDescriptions(descriptionPath);
 
@@ -100,6 +153,16 @@ void ShaderManager::setLightType(bool directional)
 	directionalLight = directional;
 }
 
+void ShaderManager::setClusteredLights(bool enable)
+{
+	clusteredLights = enable;
+}
+
+void ShaderManager::setWeightedBlendedTransparency(bool enable)
+{
+	weightedBlendedTransparency = enable;
+}
+
 bool ShaderManager::getShaderId(const string &shaderName, ShaderIds &id)
 {
 	if(shaderName.empty())
@@ -144,7 +207,54 @@ bool ShaderManager::getShaderId(const string &shaderName, ShaderIds &id)
 	return true;
 }
 
-bool ShaderManager::getShaderIndexByProperty(const string &property, bool enableFog, bool isDeferredRenderer, int &shaderIndex)
+bool ShaderManager::getComputeShaderId(const string &shaderName, ShaderIds &id)
+{
+	if(shaderName.empty())
+	{
+		Log::getInstance().error("No shader name is provided");
+		return false;
+	}
+
+	auto iter = ids.find(shaderName);
+	if(iter != ids.end())
+	{
+		id = iter->second;
+		return true;
+	}
+
+	Log::getInstance().info(string("Creating compute shader \"") + shaderName + "\"");
+
+	ShaderProperties properties = getProperties(shaderName);
+
+	vector<string> defines;
+	makeClusterGridDefines(defines); //For light clustering shader
+
+	string computeShader;
+	if(properties.vertexShaderPath.empty() || !loadShaderWithDefines(properties.vertexShaderPath, defines, computeShader))
+	{
+		Log::getInstance().error(string("Can't load compute shader ") + shaderName);
+		return false;
+	}
+
+	ShaderIds shaderId;
+	unsigned int computeShaderObject = -1u;
+	bool status = makeComputeShader(computeShader, shaderId.id, computeShaderObject);
+	if(!status)
+	{
+		Log::getInstance().error("Can't compile compute shader");
+		return false;
+	}
+
+	//Keep shader object ID for deletion
+	shaderObjects.push_back(computeShaderObject);
+
+	ids[shaderName] = shaderId;
+	id = ids[shaderName];
+
+	return true;
+}
+
+bool ShaderManager::getShaderIndexByProperty(const string &property, bool enableFog, bool isDeferredRenderer, bool isTransparent, int &shaderIndex)
 {
 	unsigned long long flags = 0;
 	if(!stringPropertyToFlag(property, flags))
@@ -156,59 +266,29 @@ bool ShaderManager::getShaderIndexByProperty(const string &property, bool enable
 	if(isDeferredRenderer)
 		flags |= ShaderFlags::FEATURE_DEFERRED_GEOMETRY;
 
-	if(directionalLight)
-	{
-		unsigned long long flagsWithLight = flags | ShaderFlags::FEATURE_DIRECTIONAL_LIGHT;
-		unsigned long long flagsWithFog = flagsWithLight | ShaderFlags::FEATURE_FOG;
+	flags |= directionalLight ? ShaderFlags::FEATURE_DIRECTIONAL_LIGHT: ShaderFlags::FEATURE_POINT_LIGHT;
 
-		auto iter = find_if(neededShaders.begin(), neededShaders.end(), [flagsWithLight](const pair<int, unsigned long long> &current)
-		{
-			return current.second == flagsWithLight;
-		});
+	if(enableFog && !isDeferredRenderer)
+		flags |= ShaderFlags::FEATURE_FOG;
 
-		if(enableFog && !isDeferredRenderer)
-		{
-			iter = find_if(neededShaders.begin(), neededShaders.end(), [flagsWithFog](const pair<int, unsigned long long> &current)
-			{
-				return current.second == flagsWithFog;
-			});
-		}
+	if(clusteredLights && !isDeferredRenderer)
+		flags |= ShaderFlags::FEATURE_CLUSTERED_LIGHTS;
 
-		if(iter == neededShaders.end())
-		{
-			int index = neededShaders.size();
-			neededShaders[index] = enableFog && !isDeferredRenderer ? flagsWithFog: flagsWithLight;
-			shaderIndex = index;
-		}
-		else shaderIndex = iter->first;
-	}
-	else
-	{
-		unsigned long long flagsWithLight = flags | ShaderFlags::FEATURE_POINT_LIGHT;
-		unsigned long long flagsWithFog = flagsWithLight | ShaderFlags::FEATURE_FOG;
-
-		auto iter = find_if(neededShaders.begin(), neededShaders.end(), [flagsWithLight](const pair<int, unsigned long long> &current)
-		{
-			return current.second == flagsWithLight;
-		});
-
-		if(enableFog && !isDeferredRenderer)
-		{
-			iter = find_if(neededShaders.begin(), neededShaders.end(), [flagsWithFog](const pair<int, unsigned long long> &current)
-			{
-				return current.second == flagsWithFog;
-			});
-		}
+	if(weightedBlendedTransparency && isTransparent)
+		flags |= ShaderFlags::FEATURE_WEIGHTED_BLENDED_OIT;
 
-		if(iter == neededShaders.end())
-		{
-			int index = neededShaders.size();
-			neededShaders[index] = enableFog && !isDeferredRenderer ? flagsWithFog: flagsWithLight;
-			shaderIndex = index;
-		}
-		else shaderIndex = iter->first;
+	auto iter = neededShaderIndices.find(flags);
+	if(iter != neededShaderIndices.end())
+	{
+		shaderIndex = iter->second;
+		return true;
 	}
 
+	int index = neededShaders.size();
+	neededShaders[index] = flags;
+	neededShaderIndices[flags] = index;
+	shaderIndex = index;
+
 	return true;
 }
 
@@ -218,37 +298,28 @@ vector<ShaderIds>& ShaderManager::createNeededShaders(map<int, unsigned long lon
 
 	for(auto &[index, flags]: neededShaders)
 	{
-		auto iter = find_if(description.begin(), description.end(), [flags](const pair<string, ShaderProperties> &current)
-		{
-			return current.second.propertyFlags == flags;
-		});
+		ShaderIds id;
 
-		if(iter == description.end()) //Fallback in case shader with fog is not found
+		if(isUberShaderPermutation(flags))
 		{
-			unsigned long long flagsWithoutFog = flags & ~ShaderFlags::FEATURE_FOG;
-
-			stringstream ss;
-			ss << flags;
-			Log::getInstance().warning(string("Fog shader is not found for flags ") + ss.str() + ". Trying fallback");
-
-			iter = find_if(description.begin(), description.end(), [flagsWithoutFog](const pair<string, ShaderProperties> &current)
+			if(!getPermutationShaderId(flags, id))
 			{
-				return current.second.propertyFlags == flagsWithoutFog;
-			});
-		}
+				stringstream ss;
+				ss << flags;
+				Log::getInstance().error(string("Cannot create uber-shader permutation for flags ") + ss.str());
+				continue;
+			}
 
-		if(iter == description.end())
-		{
-			stringstream ss;
-			ss << flags;
-			Log::getInstance().error(string("Can't find shader for flags ") + ss.str());
+			orderedShaderIds[index] = id;
 			continue;
 		}
 
-		string shaderName = iter->first;
+		string shaderName;
+		if(!findDescriptionShaderName(flags, shaderName))
+			continue;
 
-		ShaderIds id;
-		if(!getShaderId(shaderName, id))
+		bool status = (flags & DEFINE_ONLY_FEATURES) ? getShaderIdWithDefines(shaderName, flags & DEFINE_ONLY_FEATURES, id): getShaderId(shaderName, id);
+		if(!status)
 		{
 			Log::getInstance().error(string("Cannot create shader \"") + shaderName + "\"");
 			continue;
@@ -261,6 +332,27 @@ vector<ShaderIds>& ShaderManager::createNeededShaders(map<int, unsigned long lon
 	return orderedShaderIds;
 }
 
+vector<ShaderIds>& ShaderManager::createDepthPrepassShaders()
+{
+	depthPrepassShaderIds.resize(neededShaders.size());
+
+	for(auto &[index, flags]: neededShaders)
+	{
+		ShaderIds id;
+		if(!getDepthPrepassShaderId(flags, id))
+		{
+			stringstream ss;
+			ss << flags;
+			Log::getInstance().error(string("Cannot create depth pre-pass shader for flags ") + ss.str());
+			continue;
+		}
+
+		depthPrepassShaderIds[index] = id;
+	}
+
+	return depthPrepassShaderIds;
+}
+
 bool ShaderManager::getPostprocessingShaderId(const string &property, PostprocessingShaderIds **id)
 {
 	unsigned long long flags = 0;
@@ -318,6 +410,125 @@ bool ShaderManager::getPostprocessingShaderId(const string &property, Postproces
 	return true;
 }
 
+bool ShaderManager::getFusedPostprocessingShaderId(const vector<string> &properties, PostprocessingShaderIds **id)
+{
+	string shaderName(FUSED_POSTPROCESSING_SHADER_NAME_PREFIX);
+	vector<unsigned long long> flags;
+	for(auto &current: properties)
+	{
+		unsigned long long currentFlag = 0;
+		if(!stringPropertyToPostprocessingFlag(current, currentFlag) || !(currentFlag & PostprocessingFlags::PER_PIXEL_EFFECTS))
+		{
+			Log::getInstance().error(string("Postprocessing effect \"") + current + "\" can't be fused");
+			return false;
+		}
+
+		if(!flags.empty())
+			shaderName += ",";
+		shaderName += current;
+		flags.push_back(currentFlag);
+	}
+
+	auto shaderIter = postprocessingIds.find(shaderName);
+	if(shaderIter != postprocessingIds.end())
+	{
+		*id = &(shaderIter->second);
+		return true;
+	}
+
+	Log::getInstance().info(string("Creating postprocessing shader \"") + shaderName + "\"");
+
+	string vertexShader, fragmentShader, mainFunction;
+	if(!loadShader(FULLSCREEN_VERTEX_SHADER_PATH, vertexShader) || !loadShader(PER_PIXEL_EFFECTS_FRAGMENT_SHADER_PATH, fragmentShader) ||
+		!makeFusedPostprocessingMain(flags, mainFunction))
+	{
+		Log::getInstance().error("Can't load fused postprocessing shader");
+		return false;
+	}
+	fragmentShader += mainFunction;
+
+	ShaderIds quadShaderId; //Only id field is used
+	unsigned int vertexShaderObject = -1u, fragmentShaderObject = -1u;
+	bool status = makeShader(vertexShader, fragmentShader, quadShaderId.id, vertexShaderObject, fragmentShaderObject);
+	if(!status)
+	{
+		Log::getInstance().error("Can't compile fused postprocessing shader");
+		return false;
+	}
+
+	//Keep shader object ID for deletion
+	shaderObjects.push_back(vertexShaderObject);
+	shaderObjects.push_back(fragmentShaderObject);
+
+	PostprocessingShaderIds postprocessingShaderId;
+	postprocessingShaderId.quadShaderId = quadShaderId.id;
+	postprocessingIds[shaderName] = postprocessingShaderId;
+	*id = &postprocessingIds[shaderName];
+
+	return true;
+}
+
+bool ShaderManager::getComputePostprocessingShaderId(const string &property, PostprocessingShaderIds **id)
+{
+	unsigned long long flags = 0;
+	if(!stringPropertyToPostprocessingFlag(property, flags))
+	{
+		Log::getInstance().error("Can't determine postprocessing shader property");
+		return false;
+	}
+
+	flags |= PostprocessingFlags::POSTPROCESSING_COMPUTE;
+
+	auto descriptionIter = find_if(description.begin(), description.end(), [flags](const pair<string, ShaderProperties> &current)
+		{
+			return current.second.postprocessingFlags == flags;
+		});
+	if(descriptionIter == description.end())
+	{
+		Log::getInstance().error(string("There is no compute shader for postprocessing effect ") + property);
+		return false;
+	}
+
+	string shaderName(descriptionIter->first);
+
+	auto shaderIter = postprocessingIds.find(shaderName);
+	if(shaderIter != postprocessingIds.end())
+	{
+		*id = &(shaderIter->second);
+		return true;
+	}
+
+	Log::getInstance().info(string("Creating postprocessing compute shader \"") + shaderName + "\"");
+
+	string computeShader, effectSource;
+	if(!loadShader(TILE_FILTER_COMPUTE_SHADER_PATH, computeShader) || !loadShader(descriptionIter->second.vertexShaderPath, effectSource))
+	{
+		Log::getInstance().error("Can't load postprocessing compute shader");
+		return false;
+	}
+	computeShader += "\n" + effectSource;
+
+	ShaderIds shaderId; //Only id field is used
+	unsigned int computeShaderObject = -1u;
+	bool status = makeComputeShader(computeShader, shaderId.id, computeShaderObject);
+	if(!status)
+	{
+		Log::getInstance().error("Can't compile postprocessing compute shader");
+		return false;
+	}
+
+	//Keep shader object ID for deletion
+	shaderObjects.push_back(computeShaderObject);
+
+	PostprocessingShaderIds postprocessingShaderId;
+	postprocessingShaderId.quadShaderId = shaderId.id;
+	postprocessingShaderId.isCompute = true;
+	postprocessingIds[shaderName] = postprocessingShaderId;
+	*id = &postprocessingIds[shaderName];
+
+	return true;
+}
+
 unsigned long long ShaderManager::getPostprocessingShaderFlags(const std::string &property) const
 {
 	unsigned long long flags = 0;
@@ -334,14 +545,9 @@ void ShaderManager::getEditorShaderId(renderer::graphics_lib::videocard_data::Sh
 	unsigned long long neededFlags = ShaderFlags::FEATURE_DIRECTIONAL_LIGHT;
 
 	int neededIndex = 0;
-	for(auto &[index, flags]: neededShaders)
-	{
-		if(neededFlags == flags)
-		{
-			neededIndex = index;
-			break;
-		}
-	}
+	auto iter = neededShaderIndices.find(neededFlags);
+	if(iter != neededShaderIndices.end())
+		neededIndex = iter->second;
 
 	id = orderedShaderIds[neededIndex];
 }
@@ -356,6 +562,11 @@ vector<ShaderIds>& ShaderManager::getOrderedShaderIds()
 	return orderedShaderIds;
 }
 
+vector<ShaderIds>& ShaderManager::getDepthPrepassShaderIds()
+{
+	return depthPrepassShaderIds;
+}
+
 ShaderProperties ShaderManager::getProperties(const string &shaderName)
 {
 	auto iter = description.find(shaderName);
@@ -395,6 +606,9 @@ void ShaderManager::initShaderDescriptions(const string &descriptionPath)
 		parseFeatures(featuresString, featureFlags, postprocessingFlags);
 
 		description[shaderName] = ShaderProperties(vertexShaderPath, fragmentShaderPath, featureFlags, postprocessingFlags);
+
+		if(featureFlags != 0)
+			descriptionByFlags.emplace(featureFlags, shaderName);
 	}
 }
 
@@ -416,7 +630,11 @@ bool ShaderManager::readShaders(const string &shaderName, string &vertexShader,
 		Log::getInstance().error(string("Can't load shader from ") + properties.vertexShaderPath);
 		return false;
 	}
-	status = loadShader(properties.fragmentShaderPath, fragmentShader);
+
+	vector<string> defines;
+	makeClusterGridDefines(defines); //For clustered light pass shader
+
+	status = loadShaderWithDefines(properties.fragmentShaderPath, defines, fragmentShader);
 	if(!status)
 	{
 		Log::getInstance().error(string("Can't load shader from ") + properties.fragmentShaderPath);
@@ -426,6 +644,197 @@ bool ShaderManager::readShaders(const string &shaderName, string &vertexShader,
 	return true;
 }
 
+bool ShaderManager::isUberShaderPermutation(unsigned long long flags) const
+{
+	if((flags & ~UBER_SHADER_FEATURES) != 0)
+		return false;
+
+	//Both use vertex attributes 3 and 4
+	if((flags & ShaderFlags::FEATURE_NORMALMAP) && (flags & ShaderFlags::FEATURE_INSTANCING))
+		return false;
+
+	return (flags & (ShaderFlags::FEATURE_DIRECTIONAL_LIGHT | ShaderFlags::FEATURE_POINT_LIGHT)) != 0;
+}
+
+bool ShaderManager::getPermutationShaderId(unsigned long long flags, ShaderIds &id)
+{
+	stringstream ss;
+	ss << UBER_SHADER_NAME_PREFIX << flags;
+	string shaderName = ss.str();
+
+	auto iter = ids.find(shaderName);
+	if(iter != ids.end())
+	{
+		id = iter->second;
+		return true;
+	}
+
+	Log::getInstance().info(string("Creating shader \"") + shaderName + "\"");
+
+	vector<string> defines;
+	makeFeatureDefines(flags, defines);
+
+	string vertexShader, fragmentShader;
+	if(!loadShaderWithDefines(UBER_VERTEX_SHADER_PATH, defines, vertexShader) || !loadShaderWithDefines(UBER_FRAGMENT_SHADER_PATH, defines, fragmentShader) ||
+		!appendFeatureSources(flags, fragmentShader))
+	{
+		Log::getInstance().error("Can't load uber-shader");
+		return false;
+	}
+
+	ShaderIds shaderId;
+	unsigned int vertexShaderObject = -1u, fragmentShaderObject = -1u;
+	bool status = makeShader(vertexShader, fragmentShader, shaderId.id, vertexShaderObject, fragmentShaderObject);
+	if(!status)
+	{
+		Log::getInstance().error("Can't compile uber-shader");
+		return false;
+	}
+
+	//Keep shader object ID for deletion
+	shaderObjects.push_back(vertexShaderObject);
+	shaderObjects.push_back(fragmentShaderObject);
+
+	ids[shaderName] = shaderId;
+	id = shaderId;
+
+	return true;
+}
+
+bool ShaderManager::findDescriptionShaderName(unsigned long long flags, string &shaderName)
+{
+	unsigned long long descriptionFlags = flags & ~DEFINE_ONLY_FEATURES;
+
+	auto iter = descriptionByFlags.find(descriptionFlags);
+	if(iter == descriptionByFlags.end()) //Fallback in case shader with fog is not found
+	{
+		unsigned long long flagsWithoutFog = descriptionFlags & ~ShaderFlags::FEATURE_FOG;
+
+		stringstream ss;
+		ss << flags;
+		Log::getInstance().warning(string("Fog shader is not found for flags ") + ss.str() + ". Trying fallback");
+
+		iter = descriptionByFlags.find(flagsWithoutFog);
+	}
+
+	if(iter == descriptionByFlags.end())
+	{
+		stringstream ss;
+		ss << flags;
+		Log::getInstance().error(string("Can't find shader for flags ") + ss.str());
+		return false;
+	}
+
+	shaderName = iter->second;
+	return true;
+}
+
+bool ShaderManager::getShaderIdWithDefines(const string &shaderName, unsigned long long defineFlags, ShaderIds &id)
+{
+	stringstream ss;
+	ss << shaderName << ':' << defineFlags;
+	string permutationName = ss.str();
+
+	auto iter = ids.find(permutationName);
+	if(iter != ids.end())
+	{
+		id = iter->second;
+		return true;
+	}
+
+	Log::getInstance().info(string("Creating shader \"") + permutationName + "\"");
+
+	ShaderProperties properties = getProperties(shaderName);
+
+	vector<string> defines;
+	makeFeatureDefines(defineFlags, defines);
+
+	string vertexShader, fragmentShader;
+	if(!loadShaderWithDefines(properties.vertexShaderPath, defines, vertexShader) || !loadShaderWithDefines(properties.fragmentShaderPath, defines, fragmentShader) ||
+		!appendFeatureSources(defineFlags, fragmentShader))
+	{
+		Log::getInstance().error(string("Can't load shader ") + shaderName);
+		return false;
+	}
+
+	ShaderIds shaderId;
+	unsigned int vertexShaderObject = -1u, fragmentShaderObject = -1u;
+	bool status = makeShader(vertexShader, fragmentShader, shaderId.id, vertexShaderObject, fragmentShaderObject);
+	if(!status)
+	{
+		Log::getInstance().error("Can't compile shader");
+		return false;
+	}
+
+	//Keep shader object ID for deletion
+	shaderObjects.push_back(vertexShaderObject);
+	shaderObjects.push_back(fragmentShaderObject);
+
+	ids[permutationName] = shaderId;
+	id = shaderId;
+
+	return true;
+}
+
+bool ShaderManager::getDepthPrepassShaderId(unsigned long long flags, ShaderIds &id)
+{
+	stringstream ss;
+	ss << DEPTH_PREPASS_SHADER_NAME_PREFIX << flags;
+	string shaderName = ss.str();
+
+	auto iter = ids.find(shaderName);
+	if(iter != ids.end())
+	{
+		id = iter->second;
+		return true;
+	}
+
+	//Vertex shader must match the shading pass one, otherwise depth values may differ
+	string vertexShaderPath;
+	vector<string> defines;
+	if(isUberShaderPermutation(flags))
+	{
+		vertexShaderPath = UBER_VERTEX_SHADER_PATH;
+		makeFeatureDefines(flags, defines);
+	}
+	else
+	{
+		string descriptionShaderName;
+		if(!findDescriptionShaderName(flags, descriptionShaderName))
+			return false;
+
+		vertexShaderPath = getProperties(descriptionShaderName).vertexShaderPath;
+		makeFeatureDefines(flags & DEFINE_ONLY_FEATURES, defines);
+	}
+
+	Log::getInstance().info(string("Creating shader \"") + shaderName + "\"");
+
+	string vertexShader, fragmentShader;
+	if(!loadShaderWithDefines(vertexShaderPath, defines, vertexShader) || !loadShader(DEPTH_PREPASS_FRAGMENT_SHADER_PATH, fragmentShader))
+	{
+		Log::getInstance().error("Can't load depth pre-pass shader");
+		return false;
+	}
+
+	ShaderIds shaderId;
+	unsigned int vertexShaderObject = -1u, fragmentShaderObject = -1u;
+	bool status = makeShader(vertexShader, fragmentShader, shaderId.id, vertexShaderObject, fragmentShaderObject);
+	if(!status)
+	{
+		Log::getInstance().error("Can't compile depth pre-pass shader");
+		return false;
+	}
+
+	//Keep shader object ID for deletion
+	shaderObjects.push_back(vertexShaderObject);
+	shaderObjects.push_back(fragmentShaderObject);
+
+	ids[shaderName] = shaderId;
+	id = shaderId;
+
+	return true;
+}
+
 namespace
 {
 	void parseFeatures(const string &features, unsigned long long &flags, unsigned long long &postprocessingFlags)
@@ -469,6 +878,8 @@ namespace
 			{FEATURE_TEXTURE_BOMBING_AND_TRIPLANAR_MAPPING_STRING, ShaderFlags::FEATURE_TEXTURE_BOMBING_AND_TRIPLANAR_MAPPING},
 			{FEATURE_SMALL_WAVES_STRING, ShaderFlags::FEATURE_SMALL_WAVES},
 			{FEATURE_GLITTER, ShaderFlags::FEATURE_GLITTER},
+			{FEATURE_CLUSTERED_LIGHTS_STRING, ShaderFlags::FEATURE_CLUSTERED_LIGHTS},
+			{FEATURE_WEIGHTED_BLENDED_OIT_STRING, ShaderFlags::FEATURE_WEIGHTED_BLENDED_OIT},
 			{FEATURE_SKY_STRING, ShaderFlags::FEATURE_SKY},
 			{FEATURE_2D_STRING, ShaderFlags::FEATURE_2D},
 			{FEATURE_BASIC_STRING, 0} //No additional effects
@@ -483,13 +894,68 @@ namespace
 		return true;
 	}
 
+	void makeFeatureDefines(unsigned long long flags, vector<string> &defines)
+	{
+		static const pair<unsigned long long, const char*> flagToDefine[] = {
+			{ShaderFlags::FEATURE_DIRECTIONAL_LIGHT, "FEATURE_DIRECTIONAL_LIGHT"},
+			{ShaderFlags::FEATURE_POINT_LIGHT, "FEATURE_POINT_LIGHT"},
+			{ShaderFlags::FEATURE_DEFERRED_GEOMETRY, "FEATURE_DEFERRED_GEOMETRY"},
+			{ShaderFlags::FEATURE_SPECULAR, "FEATURE_SPECULAR"},
+			{ShaderFlags::FEATURE_NORMALMAP, "FEATURE_NORMALMAP"},
+			{ShaderFlags::FEATURE_INSTANCING, "FEATURE_INSTANCING"},
+			{ShaderFlags::FEATURE_FOG, "FEATURE_FOG"},
+			{ShaderFlags::FEATURE_CLUSTERED_LIGHTS, "FEATURE_CLUSTERED_LIGHTS"},
+			{ShaderFlags::FEATURE_WEIGHTED_BLENDED_OIT, "FEATURE_WEIGHTED_BLENDED_OIT"}
+		};
+
+		for(auto &[flag, define]: flagToDefine)
+		{
+			if(flags & flag)
+				defines.push_back(define);
+		}
+
+		if(flags & ShaderFlags::FEATURE_CLUSTERED_LIGHTS)
+			makeClusterGridDefines(defines);
+	}
+
+	void makeClusterGridDefines(vector<string> &defines)
+	{
+		defines.push_back(string("CLUSTER_TILES_X ") + to_string(LightClusters::CLUSTER_TILES_X));
+		defines.push_back(string("CLUSTER_TILES_Y ") + to_string(LightClusters::CLUSTER_TILES_Y));
+		defines.push_back(string("CLUSTER_DEPTH_SLICES ") + to_string(LightClusters::CLUSTER_DEPTH_SLICES));
+		defines.push_back(string("CLUSTER_MAX_LIGHTS ") + to_string(LightClusters::CLUSTER_MAX_LIGHTS));
+	}
+
+	bool appendFeatureSources(unsigned long long flags, string &fragmentShader)
+	{
+		static const pair<unsigned long long, const char*> flagToPath[] = {
+			{ShaderFlags::FEATURE_CLUSTERED_LIGHTS, CLUSTERED_LIGHTS_SHADER_PATH},
+			{ShaderFlags::FEATURE_WEIGHTED_BLENDED_OIT, WEIGHTED_BLENDED_OIT_SHADER_PATH}
+		};
+
+		for(auto &[flag, path]: flagToPath)
+		{
+			if(!(flags & flag))
+				continue;
+
+			string featureSource;
+			if(!loadShader(path, featureSource))
+				return false;
+
+			fragmentShader += "\n" + featureSource;
+		}
+
+		return true;
+	}
+
 	bool stringPropertyToPostprocessingFlag(const string &name, unsigned long long &flag)
 	{
 		static const unordered_map<string, int> stringToFlag = {
 			{POSTPROCESSING_GRAYSCALE_STRING, PostprocessingFlags::POSTPROCESSING_GRAYSCALE},
 			{POSTPROCESSING_VIGNETTE_STRING, PostprocessingFlags::POSTPROCESSING_VIGNETTE},
 			{POSTPROCESSING_DROPS_ON_LENS_STRING, PostprocessingFlags::POSTPROCESSING_DROPS_ON_LENS},
-			{POSTPROCESSING_EMBOSS_STRING, PostprocessingFlags::POSTPROCESSING_EMBOSS}
+			{POSTPROCESSING_EMBOSS_STRING, PostprocessingFlags::POSTPROCESSING_EMBOSS},
+			{POSTPROCESSING_COMPUTE_STRING, PostprocessingFlags::POSTPROCESSING_COMPUTE}
 		};
 
 		auto iter = stringToFlag.find(name);
@@ -500,4 +966,25 @@ namespace
 
 		return true;
 	}
+
+	bool makeFusedPostprocessingMain(const vector<unsigned long long> &flags, string &code)
+	{
+		static const unordered_map<unsigned long long, const char*> flagToFunction = {
+			{PostprocessingFlags::POSTPROCESSING_GRAYSCALE, "applyGrayscale"},
+			{PostprocessingFlags::POSTPROCESSING_VIGNETTE, "applyVignette"}
+		};
+
+		code = "\n\nvoid main()\n{\n\tvec3 fragmentColour = texture(renderedTexture, passUv).rgb;\n";
+		for(auto current: flags)
+		{
+			auto iter = flagToFunction.find(current);
+			if(iter == flagToFunction.end())
+				return false;
+
+			code += string("\tfragmentColour = ") + iter->second + "(fragmentColour);\n";
+		}
+		code += "\tcolour = fragmentColour;\n}\n";
+
+		return true;
+	}
 }
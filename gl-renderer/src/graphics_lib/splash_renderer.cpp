@@ -7,11 +7,29 @@
 
 #include "graphics_lib/splash_renderer.h"
 
+#include <algorithm>
+
 #include <GL/glew.h>
 
+#include "graphics_lib/operations/counted_calls.h"
+
 using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
 using namespace renderer::graphics_lib::videocard_data;
 
+namespace
+{
+	//Parts of screen size
+	constexpr float PROGRESS_BAR_WIDTH = 0.5f;
+	constexpr float PROGRESS_BAR_HEIGHT = 0.01f;
+	constexpr float PROGRESS_BAR_BOTTOM_OFFSET = 0.1f;
+
+	/*
+	@brief Draws progress bar with scissored clears, no shader is needed
+	*/
+	void renderProgressBar(float progress);
+}
+
 SplashRenderer::SplashRenderer(const ObjectRenderingData &data, const ShaderIds &id):
 	objectData(data), shaderId(id)
 {
@@ -21,17 +39,45 @@ SplashRenderer::~SplashRenderer()
 {
 }
 
-void SplashRenderer::render()
+void SplashRenderer::render(float progress)
 {
-	glUseProgram(shaderId.id);
+	useProgram(shaderId.id);
 
 	glClearColor(0.09, 0.09, 0.09, 0);
 	glClear(GL_COLOR_BUFFER_BIT);
 
-	glBindVertexArray(objectData.vaoId);
-	glBindTextureUnit(0, objectData.textureId);
+	bindVertexArray(objectData.vaoId);
+	bindTextureUnit(0, objectData.textureId);
+
+	uniform1i(shaderId.unifTextureId, 0);
+
+	drawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+
+	renderProgressBar(progress);
+}
+
+namespace
+{
+	void renderProgressBar(float progress)
+	{
+		int viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+
+		const int width = viewport[2] * PROGRESS_BAR_WIDTH;
+		const int height = std::max(1, static_cast<int>(viewport[3] * PROGRESS_BAR_HEIGHT));
+		const int x = (viewport[2] - width) / 2;
+		const int y = viewport[3] * PROGRESS_BAR_BOTTOM_OFFSET;
+
+		glEnable(GL_SCISSOR_TEST);
+
+		glScissor(x, y, width, height);
+		glClearColor(0.2, 0.2, 0.2, 0);
+		glClear(GL_COLOR_BUFFER_BIT);
 
-	glUniform1i(shaderId.unifTextureId, 0);
+		glScissor(x, y, width * std::clamp(progress, 0.f, 1.f), height);
+		glClearColor(0.85, 0.85, 0.85, 0);
+		glClear(GL_COLOR_BUFFER_BIT);
 
-	glDrawArrays(GL_TRIANGLES, 0, objectData.vertexAmount);
+		glDisable(GL_SCISSOR_TEST);
+	}
 }
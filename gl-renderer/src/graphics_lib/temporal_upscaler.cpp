@@ -0,0 +1,130 @@
+/* temporal_upscaler.cpp
+ * Accumulates jittered frames of reduced resolution into full resolution history
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "graphics_lib/temporal_upscaler.h"
+
+#include <GL/glew.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "graphics_lib/uniform_setters.h"
+#include "graphics_lib/operations/counted_calls.h"
+#include "graphics_lib/operations/memory_ledger.h"
+#include "graphics_lib/operations/mesh_operations.h"
+#include "utils/math_tools.h"
+
+using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
+using namespace renderer::graphics_lib::videocard_data;
+using namespace renderer::utils;
+
+namespace
+{
+	constexpr float HISTORY_WEIGHT = 0.9f; //About ten frames contribute to a pixel
+
+	constexpr int JITTER_BASE_X = 2;
+	constexpr int JITTER_BASE_Y = 3;
+
+	const char *MEMORY_OWNER = "Temporal upscaling history";
+}
+
+TemporalUpscaler::TemporalUpscaler(const ShaderIds &resolve, int width, int height):
+	framebufferWidth(width), framebufferHeight(height), currentHistory(0), isHistoryValid(false), resolveShaderId(resolve), jitter(0.f, 0.f), jitterIndex(0), viewMatrix(1.f),
+	previousViewProjection(1.f)
+{
+	initializeBuffers();
+	initializeQuadMesh(quadVaoId, quadVboId);
+
+	projection = makeProjectionMatrix(static_cast<float>(width) / height);
+	jitteredProjection = projection;
+}
+
+TemporalUpscaler::~TemporalUpscaler()
+{
+	glDeleteVertexArrays(1, &quadVaoId);
+	deleteTrackedBuffer(quadVboId);
+	for(int i = 0; i < HISTORY_AMOUNT; i++)
+		deleteTrackedTexture(textureIds[i]);
+	glDeleteFramebuffers(HISTORY_AMOUNT, framebufferIds);
+}
+
+void TemporalUpscaler::beginFrame(int scaledWidth, int scaledHeight)
+{
+	jitterIndex = jitterIndex % JITTER_SEQUENCE_LENGTH + 1; //Halton sequence starts from 1
+	jitter = glm::vec2(computeHaltonValue(jitterIndex, JITTER_BASE_X), computeHaltonValue(jitterIndex, JITTER_BASE_Y)) - 0.5f;
+
+	//Offset in pixels of the scaled viewport is converted to clip space
+	const glm::vec3 clipOffset(2.f * jitter.x / scaledWidth, 2.f * jitter.y / scaledHeight, 0.f);
+	jitteredProjection = glm::translate(glm::mat4(1.f), clipOffset) * projection;
+}
+
+void TemporalUpscaler::resolve(unsigned int sceneTextureId, unsigned int sceneDepthTextureId, const glm::vec2 &renderScale)
+{
+	const glm::mat4 viewProjection = projection * viewMatrix;
+	const glm::mat4 reprojection = previousViewProjection * glm::inverse(viewProjection);
+
+	int previousHistory = (currentHistory + 1) % HISTORY_AMOUNT;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebufferIds[currentHistory]);
+	glViewport(0, 0, framebufferWidth, framebufferHeight);
+
+	useProgram(resolveShaderId.id);
+
+	bindVertexArray(quadVaoId);
+
+	bindTextureUnit(0, sceneTextureId);
+	uniform1i(resolveShaderId.unifSceneTextureId, 0);
+
+	bindTextureUnit(1, sceneDepthTextureId);
+	uniform1i(resolveShaderId.unifDepthComponentId, 1);
+
+	bindTextureUnit(2, textureIds[previousHistory]);
+	uniform1i(resolveShaderId.unifHistoryTextureId, 2);
+
+	uniform2fv(resolveShaderId.unifRenderScale, 1, &renderScale[0]);
+	uniform2fv(resolveShaderId.unifJitter, 1, &jitter[0]);
+	uniformMatrix4fv(resolveShaderId.unifReprojection, 1, GL_FALSE, &reprojection[0][0]);
+	uniform1f(resolveShaderId.unifHistoryWeight, isHistoryValid ? HISTORY_WEIGHT : 0.f);
+
+	drawArrays(GL_TRIANGLES, 0, 6);
+
+	previousViewProjection = viewProjection;
+	isHistoryValid = true;
+
+	currentHistory = previousHistory;
+}
+
+void TemporalUpscaler::updateCamera(const glm::mat4 &newViewMatrix)
+{
+	viewMatrix = newViewMatrix;
+}
+
+const glm::mat4& TemporalUpscaler::getJitteredProjection() const
+{
+	return jitteredProjection;
+}
+
+unsigned int TemporalUpscaler::getResolvedTextureId() const
+{
+	return textureIds[(currentHistory + 1) % HISTORY_AMOUNT]; //Index is already moved to the next frame
+}
+
+void TemporalUpscaler::initializeBuffers()
+{
+	glCreateFramebuffers(HISTORY_AMOUNT, framebufferIds);
+
+	for(int i = 0; i < HISTORY_AMOUNT; i++)
+	{
+		textureIds[i] = createTrackedTexture(1, GL_RGBA16F, framebufferWidth, framebufferHeight, MemoryCategory::RENDER_TARGETS, MEMORY_OWNER); //8 bits are not enough for repeated blending
+		glTextureParameteri(textureIds[i], GL_TEXTURE_MIN_FILTER, GL_LINEAR); //Reprojected position is between pixels
+		glTextureParameteri(textureIds[i], GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(textureIds[i], GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(textureIds[i], GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		glNamedFramebufferTexture(framebufferIds[i], GL_COLOR_ATTACHMENT0, textureIds[i], 0);
+		glNamedFramebufferDrawBuffer(framebufferIds[i], GL_COLOR_ATTACHMENT0);
+	}
+}
@@ -22,7 +22,6 @@ namespace
 {
 	constexpr float PROJECTION_FOV = 45.f;
 	constexpr float PROJECTION_NEAR_CLIPPING = 0.5f;
-	constexpr float PROJECTION_FAR_CLIPPING = 125.f;
 
 	constexpr float FOG_DENSITY = 0.04f;
 
@@ -30,6 +29,11 @@ namespace
 	const glm::vec3 LIGHT_AMBIENT_COLOUR_DEFAULT = glm::vec3(1.f, 1.f, 1.f);
 }
 
+glm::mat4 renderer::graphics_lib::makeProjectionMatrix(float screenRatio)
+{
+	return glm::perspective(PROJECTION_FOV, screenRatio, PROJECTION_NEAR_CLIPPING, PROJECTION_FAR_CLIPPING);
+}
+
 void renderer::graphics_lib::setDirectionalShaderUniforms(ShaderIds &shaderId, float screenRatio, const Light &light)
 {
 	const glm::mat4 projection = glm::perspective(PROJECTION_FOV, screenRatio, PROJECTION_NEAR_CLIPPING, PROJECTION_FAR_CLIPPING);
@@ -80,8 +84,13 @@ void renderer::graphics_lib::setStencilPassShaderUniforms(ShaderIds &shaderId, f
 void renderer::graphics_lib::setDeferredDirectionalLightPassShaderUniforms(ShaderIds &shaderId, float screenWidth, float screenHeight, const Light &light, const Fog &fog)
 {
 	if(fog.enable)
+	{
 		setFogShaderUniforms(shaderId, fog);
 
+		const glm::mat4 inverseProjection = glm::inverse(glm::perspective(PROJECTION_FOV, screenWidth / screenHeight, PROJECTION_NEAR_CLIPPING, PROJECTION_FAR_CLIPPING));
+		glUniformMatrix4fv(shaderId.unifInverseProjection, 1, GL_FALSE, &inverseProjection[0][0]);
+	}
+
 	const glm::vec3 lightCoordinates(light.x, light.y, light.z);
 	glUniform3fv(shaderId.unifLightDirection, 1, &lightCoordinates[0]);
 	glUniform3fv(shaderId.unifDiffuseLightColour, 1, &LIGHT_DIFFUSE_COLOUR_DEFAULT[0]);
@@ -95,6 +104,9 @@ void renderer::graphics_lib::setDeferredPointLightPassShaderUniforms(ShaderIds &
 	const glm::mat4 projection = glm::perspective(PROJECTION_FOV, screenWidth / screenHeight, PROJECTION_NEAR_CLIPPING, PROJECTION_FAR_CLIPPING);
 	glUniformMatrix4fv(shaderId.unifProjection, 1, GL_FALSE, &projection[0][0]);
 
+	const glm::mat4 inverseProjection = glm::inverse(projection);
+	glUniformMatrix4fv(shaderId.unifInverseProjection, 1, GL_FALSE, &inverseProjection[0][0]);
+
 	glm::vec2 screenSize(screenWidth, screenHeight);
 	glUniform2fv(shaderId.unifScreenSize, 1, &screenSize[0]);
 
@@ -109,3 +121,15 @@ void renderer::graphics_lib::setDeferredPointLightPassShaderUniforms(ShaderIds &
 
 	shaderId.isDirectionalLight = false;
 }
+
+void renderer::graphics_lib::setLightClusteringShaderUniforms(ShaderIds &shaderId, float screenWidth, float screenHeight)
+{
+	const glm::mat4 inverseProjection = glm::inverse(glm::perspective(PROJECTION_FOV, screenWidth / screenHeight, PROJECTION_NEAR_CLIPPING, PROJECTION_FAR_CLIPPING));
+	glUniformMatrix4fv(shaderId.unifInverseProjection, 1, GL_FALSE, &inverseProjection[0][0]);
+
+	const glm::vec2 depthRange(PROJECTION_NEAR_CLIPPING, PROJECTION_FAR_CLIPPING);
+	glUniform2fv(shaderId.unifClusterDepthRange, 1, &depthRange[0]);
+
+	const glm::vec2 screenSize(screenWidth, screenHeight); //Forward shading finds cluster by fragment coordinates
+	glUniform2fv(shaderId.unifScreenSize, 1, &screenSize[0]);
+}
@@ -0,0 +1,283 @@
+/* upload_service.cpp
+ * Streams data to videocard through persistently mapped staging ring
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "graphics_lib/upload_service.h"
+
+#include <GL/glew.h>
+
+#include "log.h"
+#include "profiler.h"
+#include "graphics_lib/operations/memory_ledger.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
+
+namespace
+{
+	constexpr size_t STAGING_ALIGNMENT = 256; //Satisfies every copy and unpack alignment requirement
+
+	constexpr int TEXTURE_RGB = 3;
+
+	const char *MEMORY_OWNER = "Staging ring";
+
+	size_t alignSize(size_t size);
+}
+
+UploadService::UploadService(size_t ringSize, size_t bytesPerFrame):
+	bufferId(-1u), mappedData(nullptr), ringSize(alignSize(ringSize)), head(0), tail(0), usedBytes(0), nextSequence(1), currentFrame(1), completedFrame(0),
+	bytesPerFrameLimit(bytesPerFrame), queuedBytes(0), bytesLastFrame(0), totalBytes(0)
+{
+}
+
+UploadService::~UploadService()
+{
+	for(auto &current: fences)
+		glDeleteSync(static_cast<GLsync>(current.sync));
+
+	if(bufferId != -1u)
+	{
+		glUnmapNamedBuffer(bufferId);
+		deleteTrackedBuffer(bufferId);
+	}
+}
+
+bool UploadService::init()
+{
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	bufferId = createTrackedBuffer(ringSize, nullptr, flags, MemoryCategory::STAGING, MEMORY_OWNER);
+
+	mappedData = static_cast<char*>(glMapNamedBufferRange(bufferId, 0, ringSize, flags));
+	if(!mappedData)
+	{
+		Log::getInstance().error("Can't map staging buffer");
+		deleteTrackedBuffer(bufferId);
+		bufferId = -1u;
+		return false;
+	}
+
+	Log::getInstance().info(string("Staging ring: ") + to_string(ringSize / 1024) + " KB, " + to_string(bytesPerFrameLimit / 1024) + " KB per frame");
+
+	return true;
+}
+
+bool UploadService::reserve(size_t size, StagingAllocation &allocation)
+{
+	size_t alignedSize = alignSize(size);
+	if(!mappedData || alignedSize == 0 || alignedSize > ringSize)
+		return false;
+
+	lock_guard<mutex> lockGuard(accessLock);
+
+	if(usedBytes == 0)
+		head = tail = 0;
+
+	size_t offset = 0;
+	size_t padding = 0;
+	if(head >= tail && usedBytes < ringSize)
+	{
+		if(ringSize - head >= alignedSize)
+			offset = head;
+		else if(tail >= alignedSize) //Skip the ring end
+		{
+			padding = ringSize - head;
+			offset = 0;
+		}
+		else return false;
+	}
+	else if(head < tail && tail - head >= alignedSize)
+		offset = head;
+	else return false;
+
+	head = offset + alignedSize;
+	usedBytes += padding + alignedSize;
+
+	allocation.data = mappedData + offset;
+	allocation.offset = offset;
+	allocation.size = size;
+	allocation.sequence = nextSequence++;
+
+	reservations.push_back({allocation.sequence, head, padding + alignedSize, 0, false});
+
+	return true;
+}
+
+void UploadService::commitBufferCopy(const StagingAllocation &allocation, unsigned int bufferId, size_t targetOffset)
+{
+	lock_guard<mutex> lockGuard(accessLock);
+
+	copyQueue.push_back({allocation, CopyType::BUFFER, bufferId, targetOffset, 0, 0, 0});
+	queuedBytes += allocation.size;
+}
+
+void UploadService::commitTextureCopy(const StagingAllocation &allocation, unsigned int textureId, int width, int height, int bytesPerPixel)
+{
+	lock_guard<mutex> lockGuard(accessLock);
+
+	copyQueue.push_back({allocation, CopyType::TEXTURE, textureId, 0, width, height, bytesPerPixel});
+	queuedBytes += allocation.size;
+}
+
+void UploadService::discard(const StagingAllocation &allocation)
+{
+	lock_guard<mutex> lockGuard(accessLock);
+
+	markSubmitted(allocation.sequence, 0); //Frame 0 is always completed
+}
+
+void UploadService::processUploads()
+{
+	PROFILE_ZONE("UploadService::processUploads");
+
+	reclaim();
+	issueCopies(bytesPerFrameLimit);
+}
+
+void UploadService::flush()
+{
+	reclaim();
+	issueCopies(SIZE_MAX);
+}
+
+void UploadService::setBytesPerFrameLimit(size_t bytesPerFrame)
+{
+	bytesPerFrameLimit = bytesPerFrame;
+}
+
+size_t UploadService::getBytesPerFrameLimit() const
+{
+	return bytesPerFrameLimit;
+}
+
+int UploadService::getQueueDepth()
+{
+	lock_guard<mutex> lockGuard(accessLock);
+	return copyQueue.size();
+}
+
+size_t UploadService::getQueuedBytes()
+{
+	lock_guard<mutex> lockGuard(accessLock);
+	return queuedBytes;
+}
+
+size_t UploadService::getUsedRingBytes()
+{
+	lock_guard<mutex> lockGuard(accessLock);
+	return usedBytes;
+}
+
+size_t UploadService::getBytesLastFrame() const
+{
+	return bytesLastFrame;
+}
+
+uint64_t UploadService::getTotalBytes() const
+{
+	return totalBytes;
+}
+
+void UploadService::issueCopies(size_t byteLimit)
+{
+	bytesLastFrame = 0;
+
+	//Copy commands are issued outside of the lock, loaders aren't blocked by driver calls
+	deque<CopyRequest> batch;
+	{
+		lock_guard<mutex> lockGuard(accessLock);
+
+		while(!copyQueue.empty() && (batch.empty() || bytesLastFrame + copyQueue.front().allocation.size <= byteLimit))
+		{
+			bytesLastFrame += copyQueue.front().allocation.size;
+			batch.push_back(copyQueue.front());
+			copyQueue.pop_front();
+		}
+
+		queuedBytes -= bytesLastFrame;
+	}
+
+	if(batch.empty())
+		return;
+
+	for(auto &current: batch)
+	{
+		if(current.type == CopyType::BUFFER)
+		{
+			glCopyNamedBufferSubData(bufferId, current.targetId, current.allocation.offset, current.targetOffset, current.allocation.size);
+		}
+		else
+		{
+			const GLenum format = (current.bytesPerPixel == TEXTURE_RGB) ? GL_BGR: GL_BGRA;
+
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, bufferId);
+			glTextureSubImage2D(current.targetId, 0, 0, 0, current.width, current.height, format, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(current.allocation.offset));
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+			glGenerateTextureMipmap(current.targetId);
+		}
+	}
+
+	GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	lock_guard<mutex> lockGuard(accessLock);
+
+	for(auto &current: batch)
+		markSubmitted(current.allocation.sequence, currentFrame);
+
+	fences.push_back({sync, currentFrame});
+	currentFrame++;
+
+	totalBytes += bytesLastFrame;
+}
+
+void UploadService::reclaim()
+{
+	lock_guard<mutex> lockGuard(accessLock);
+
+	while(!fences.empty())
+	{
+		GLsync sync = static_cast<GLsync>(fences.front().sync);
+		GLenum status = glClientWaitSync(sync, 0, 0);
+		if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			break;
+
+		completedFrame = fences.front().frame;
+		glDeleteSync(sync);
+		fences.pop_front();
+	}
+
+	while(!reservations.empty() && reservations.front().isSubmitted && reservations.front().submitFrame <= completedFrame)
+	{
+		tail = reservations.front().end;
+		usedBytes -= reservations.front().consumedBytes;
+		reservations.pop_front();
+	}
+}
+
+void UploadService::markSubmitted(uint64_t sequence, uint64_t frame)
+{
+	//Reservations are sorted by sequence
+	if(reservations.empty())
+		return;
+
+	size_t index = sequence - reservations.front().sequence;
+	if(index >= reservations.size())
+		return;
+
+	reservations[index].submitFrame = frame;
+	reservations[index].isSubmitted = true;
+}
+
+namespace
+{
+	size_t alignSize(size_t size)
+	{
+		return (size + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+	}
+}
@@ -0,0 +1,151 @@
+/* weighted_blended_transparency.cpp
+ * Order-independent transparency: accumulation and revealage targets with composite pass
+ * OpenGL 4.5
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "graphics_lib/weighted_blended_transparency.h"
+
+#include <string>
+
+#include <GL/glew.h>
+
+#include "log.h"
+#include "graphics_lib/operations/counted_calls.h"
+#include "graphics_lib/operations/memory_ledger.h"
+#include "graphics_lib/operations/mesh_operations.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
+using namespace renderer::graphics_lib::videocard_data;
+
+namespace
+{
+	constexpr float accumulationClearValue[4] = {0., 0., 0., 0.};
+	constexpr float revealageClearValue[4] = {1., 1., 1., 1.}; //Nothing covers the scene
+	constexpr float depthClearValue = 1.f;
+
+	constexpr int TARGET_DEPTH_BITS = 24;
+	constexpr int TARGET_STENCIL_BITS = 8;
+
+	const char *MEMORY_OWNER = "Weighted blended transparency";
+}
+
+WeightedBlendedTransparency::WeightedBlendedTransparency(const ShaderIds &composite, int width, int height):
+	framebufferWidth(width), framebufferHeight(height), targetFramebufferId(0), checkedFramebufferId(-1), canBlitDepth(false),
+	compositeShaderId(composite)
+{
+	initializeBuffer();
+	initializeQuadMesh(quadVaoId, quadVboId);
+}
+
+WeightedBlendedTransparency::~WeightedBlendedTransparency()
+{
+	glDeleteVertexArrays(1, &quadVaoId);
+	deleteTrackedBuffer(quadVboId);
+	deleteTrackedTexture(depthTextureId);
+	for(int i = 0; i < TOTAL_TEXTURES; i++)
+		deleteTrackedTexture(textureIds[i]);
+	glDeleteFramebuffers(1, &framebufferId);
+}
+
+void WeightedBlendedTransparency::beginAccumulation()
+{
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &targetFramebufferId);
+
+	if(targetFramebufferId != checkedFramebufferId)
+	{
+		checkedFramebufferId = targetFramebufferId;
+		canBlitDepth = isTargetDepthCompatible();
+	}
+
+	//Blit requires equal depth formats. Multisampled screen depth is resolved to one sample per pixel
+	if(canBlitDepth)
+		glBlitNamedFramebuffer(targetFramebufferId, framebufferId, 0, 0, framebufferWidth, framebufferHeight, 0, 0, framebufferWidth, framebufferHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	else glClearNamedFramebufferfv(framebufferId, GL_DEPTH, 0, &depthClearValue);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+	glClearNamedFramebufferfv(framebufferId, GL_COLOR, TEXTURE_INDEX_ACCUMULATION, accumulationClearValue);
+	glClearNamedFramebufferfv(framebufferId, GL_COLOR, TEXTURE_INDEX_REVEALAGE, revealageClearValue);
+
+	glEnable(GL_DEPTH_TEST);
+	glDepthMask(GL_FALSE);
+
+	glEnable(GL_BLEND);
+	glBlendEquation(GL_FUNC_ADD);
+	glBlendFunci(TEXTURE_INDEX_ACCUMULATION, GL_ONE, GL_ONE);
+	glBlendFunci(TEXTURE_INDEX_REVEALAGE, GL_ZERO, GL_ONE_MINUS_SRC_COLOR);
+}
+
+void WeightedBlendedTransparency::composite()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, targetFramebufferId);
+
+	glDisable(GL_DEPTH_TEST);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	useProgram(compositeShaderId.id);
+
+	bindVertexArray(quadVaoId);
+
+	bindTextureUnit(0, textureIds[TEXTURE_INDEX_ACCUMULATION]);
+	uniform1i(compositeShaderId.unifAccumulationId, 0);
+
+	bindTextureUnit(1, textureIds[TEXTURE_INDEX_REVEALAGE]);
+	uniform1i(compositeShaderId.unifRevealageId, 1);
+
+	drawArrays(GL_TRIANGLES, 0, 6);
+
+	glDisable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+	glDepthMask(GL_TRUE);
+}
+
+void WeightedBlendedTransparency::initializeBuffer()
+{
+	glCreateFramebuffers(1, &framebufferId);
+
+	static const GLenum textureFormats[TOTAL_TEXTURES] = {GL_RGBA16F, GL_R8};
+
+	for(int i = 0; i < TOTAL_TEXTURES; i++)
+	{
+		textureIds[i] = createTrackedTexture(1, textureFormats[i], framebufferWidth, framebufferHeight, MemoryCategory::RENDER_TARGETS, MEMORY_OWNER);
+		glTextureParameteri(textureIds[i], GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(textureIds[i], GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTextureParameteri(textureIds[i], GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(textureIds[i], GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		glNamedFramebufferTexture(framebufferId, GL_COLOR_ATTACHMENT0 + i, textureIds[i], 0);
+	}
+
+	depthTextureId = createTrackedTexture(1, GL_DEPTH24_STENCIL8, framebufferWidth, framebufferHeight, MemoryCategory::RENDER_TARGETS, MEMORY_OWNER);
+
+	glNamedFramebufferTexture(framebufferId, GL_DEPTH_STENCIL_ATTACHMENT, depthTextureId, 0);
+
+	GLenum drawBuffers[TOTAL_TEXTURES] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+	glNamedFramebufferDrawBuffers(framebufferId, TOTAL_TEXTURES, drawBuffers);
+}
+
+bool WeightedBlendedTransparency::isTargetDepthCompatible() const
+{
+	//Default framebuffer names its buffers instead of attachments
+	const GLenum depthAttachment = (targetFramebufferId == 0) ? GL_DEPTH : GL_DEPTH_ATTACHMENT;
+	const GLenum stencilAttachment = (targetFramebufferId == 0) ? GL_STENCIL : GL_STENCIL_ATTACHMENT;
+
+	int depthBits = 0;
+	int stencilBits = 0;
+	glGetNamedFramebufferAttachmentParameteriv(targetFramebufferId, depthAttachment, GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE, &depthBits);
+	glGetNamedFramebufferAttachmentParameteriv(targetFramebufferId, stencilAttachment, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE, &stencilBits);
+
+	if(depthBits != TARGET_DEPTH_BITS || stencilBits != TARGET_STENCIL_BITS)
+	{
+		Log::getInstance().warning(string("Framebuffer has ") + to_string(depthBits) + "-bit depth and " + to_string(stencilBits) +
+			"-bit stencil, opaque depth isn't copied for transparency");
+		return false;
+	}
+
+	return true;
+}
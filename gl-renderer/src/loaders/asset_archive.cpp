@@ -0,0 +1,285 @@
+/* asset_archive.cpp
+ * Packed archive with meshes, textures and terrain chunks. Read through memory mapping
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "loaders/asset_archive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "log.h"
+#include "utils/hash_tools.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::loaders;
+using namespace renderer::utils;
+
+namespace
+{
+	const char ARCHIVE_SIGNATURE[8] = {'g', 'l', 'r', 'a', 'r', 'c', 'h', '\0'};
+	constexpr uint32_t ARCHIVE_VERSION = 1;
+
+	constexpr uint64_t ARCHIVE_BLOB_ALIGNMENT = 16;
+
+
+
+	uint64_t alignOffset(uint64_t offset);
+
+	/*
+	@brief Checks that range lies inside file. Compared without sums, so damaged offsets and sizes can't wrap around
+	*/
+	bool isInsideFile(uint64_t offset, uint64_t size, uint64_t fileSize);
+}
+
+AssetArchive::AssetArchive():
+	index(nullptr), names(nullptr), entryAmount(0)
+{
+}
+
+AssetArchive::~AssetArchive()
+{
+}
+
+bool AssetArchive::open(const string &path)
+{
+	if(!mapping.open(path))
+		return false;
+
+	const char *data = mapping.getData();
+	size_t size = mapping.getSize();
+
+	if(size < sizeof(ArchiveHeader))
+	{
+		Log::getInstance().error(string("Archive ") + path + " is too small");
+		mapping.close();
+		return false;
+	}
+
+	const ArchiveHeader *header = reinterpret_cast<const ArchiveHeader*>(data);
+	if(memcmp(header->signature, ARCHIVE_SIGNATURE, sizeof(ARCHIVE_SIGNATURE)) != 0 || header->version != ARCHIVE_VERSION)
+	{
+		Log::getInstance().error(string("Invalid signature or version for archive ") + path);
+		mapping.close();
+		return false;
+	}
+
+	uint64_t indexSize = static_cast<uint64_t>(header->entryAmount) * sizeof(ArchiveIndexEntry);
+	if(!isInsideFile(header->indexOffset, indexSize, size) || header->namesOffset > size)
+	{
+		Log::getInstance().error(string("Archive ") + path + " index is damaged");
+		mapping.close();
+		return false;
+	}
+
+	index = reinterpret_cast<const ArchiveIndexEntry*>(data + header->indexOffset);
+	names = data + header->namesOffset;
+	entryAmount = header->entryAmount;
+
+	for(int i = 0; i < entryAmount; i++)
+	{
+		if(!isInsideFile(index[i].dataOffset, index[i].dataSize, size) || !isInsideFile(index[i].nameOffset, index[i].nameLength, size - header->namesOffset))
+		{
+			Log::getInstance().error(string("Archive ") + path + " entries are damaged");
+			mapping.close();
+			index = nullptr;
+			names = nullptr;
+			entryAmount = 0;
+			return false;
+		}
+
+		//getEntry() uses binary search, unsorted index would silently miss entries
+		if(i > 0 && index[i].nameHash < index[i - 1].nameHash)
+		{
+			Log::getInstance().error(string("Archive ") + path + " index isn't sorted by name hash");
+			mapping.close();
+			index = nullptr;
+			names = nullptr;
+			entryAmount = 0;
+			return false;
+		}
+	}
+
+	Log::getInstance().info(string("Archive ") + path + " is mapped, " + to_string(entryAmount) + " entries");
+
+	return true;
+}
+
+bool AssetArchive::getEntry(const string &name, const char **data, size_t &size) const
+{
+	if(!index || !data)
+		return false;
+
+	uint64_t hash = hashString(name.c_str(), name.size());
+
+	const ArchiveIndexEntry *indexEnd = index + entryAmount;
+	const ArchiveIndexEntry *iter = lower_bound(index, indexEnd, hash, [](const ArchiveIndexEntry &entry, uint64_t value)
+	{
+		return entry.nameHash < value;
+	});
+
+	//Several names may share the same hash
+	for(; iter != indexEnd && iter->nameHash == hash; iter++)
+	{
+		if(iter->nameLength == name.size() && memcmp(names + iter->nameOffset, name.c_str(), name.size()) == 0)
+		{
+			*data = mapping.getData() + iter->dataOffset;
+			size = iter->dataSize;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int AssetArchive::getEntryAmount() const
+{
+	return entryAmount;
+}
+
+MemoryStreamBuffer::MemoryStreamBuffer(const char *data, size_t size)
+{
+	char *begin = const_cast<char*>(data); //Buffer is never written
+	setg(begin, begin, begin + size);
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekoff(off_type offset, ios_base::seekdir direction, ios_base::openmode which)
+{
+	if(!(which & ios_base::in))
+		return pos_type(off_type(-1));
+
+	char *position = nullptr;
+	if(direction == ios_base::beg)
+		position = eback() + offset;
+	else if(direction == ios_base::cur)
+		position = gptr() + offset;
+	else position = egptr() + offset;
+
+	if(position < eback() || position > egptr())
+		return pos_type(off_type(-1));
+
+	setg(eback(), position, egptr());
+
+	return pos_type(position - eback());
+}
+
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekpos(pos_type position, ios_base::openmode which)
+{
+	return seekoff(off_type(position), ios_base::beg, which);
+}
+
+bool renderer::loaders::writeAssetArchive(const string &path, const vector<string> &files)
+{
+	if(files.empty())
+	{
+		Log::getInstance().error("No files to pack");
+		return false;
+	}
+
+	//Build index
+
+	vector<ArchiveIndexEntry> entries(files.size());
+	vector<int> fileIndices(files.size()); //Entry order to files order
+
+	string namesBlock;
+	for(size_t i = 0; i < files.size(); i++)
+	{
+		ifstream file(files[i], ios::in | ios::binary | ios::ate);
+		if(!file.is_open())
+		{
+			Log::getInstance().error(files[i] + " can't be opened");
+			return false;
+		}
+
+		entries[i].nameHash = hashString(files[i].c_str(), files[i].size());
+		entries[i].dataSize = static_cast<uint64_t>(file.tellg());
+		entries[i].nameOffset = namesBlock.size();
+		entries[i].nameLength = files[i].size();
+
+		namesBlock += files[i];
+		fileIndices[i] = i;
+	}
+
+	sort(fileIndices.begin(), fileIndices.end(), [&entries](int first, int second)
+	{
+		return entries[first].nameHash < entries[second].nameHash;
+	});
+
+	vector<ArchiveIndexEntry> sortedEntries;
+	sortedEntries.reserve(entries.size());
+	for(auto current: fileIndices)
+		sortedEntries.push_back(entries[current]);
+
+	ArchiveHeader header;
+	memcpy(header.signature, ARCHIVE_SIGNATURE, sizeof(ARCHIVE_SIGNATURE));
+	header.version = ARCHIVE_VERSION;
+	header.entryAmount = sortedEntries.size();
+	header.indexOffset = sizeof(ArchiveHeader);
+	header.namesOffset = header.indexOffset + sortedEntries.size() * sizeof(ArchiveIndexEntry);
+
+	uint64_t dataOffset = alignOffset(header.namesOffset + namesBlock.size());
+	for(auto &current: sortedEntries)
+	{
+		current.dataOffset = dataOffset;
+		dataOffset = alignOffset(dataOffset + current.dataSize);
+	}
+
+	//Write archive
+
+	ofstream archive(path, ios::out | ios::binary | ios::trunc);
+	if(!archive.is_open())
+	{
+		Log::getInstance().error(path + " can't be created");
+		return false;
+	}
+
+	archive.write(reinterpret_cast<const char*>(&header), sizeof(ArchiveHeader));
+	archive.write(reinterpret_cast<const char*>(sortedEntries.data()), sortedEntries.size() * sizeof(ArchiveIndexEntry));
+	archive.write(namesBlock.data(), namesBlock.size());
+
+	vector<char> buffer;
+	for(size_t i = 0; i < sortedEntries.size(); i++)
+	{
+		const string &filePath = files[fileIndices[i]];
+
+		vector<char> padding(sortedEntries[i].dataOffset - static_cast<uint64_t>(archive.tellp()), 0);
+		archive.write(padding.data(), padding.size());
+
+		ifstream file(filePath, ios::in | ios::binary);
+		buffer.resize(sortedEntries[i].dataSize);
+		file.read(buffer.data(), buffer.size());
+		if(!file)
+		{
+			Log::getInstance().error(string("Can't read ") + filePath);
+			return false;
+		}
+
+		archive.write(buffer.data(), buffer.size());
+	}
+
+	if(!archive)
+	{
+		Log::getInstance().error(string("Can't write ") + path);
+		return false;
+	}
+
+	Log::getInstance().info(string("Packed ") + to_string(sortedEntries.size()) + " files into " + path);
+
+	return true;
+}
+
+namespace
+{
+	uint64_t alignOffset(uint64_t offset)
+	{
+		return (offset + ARCHIVE_BLOB_ALIGNMENT - 1) & ~(ARCHIVE_BLOB_ALIGNMENT - 1);
+	}
+
+	bool isInsideFile(uint64_t offset, uint64_t size, uint64_t fileSize)
+	{
+		return offset <= fileSize && size <= fileSize - offset;
+	}
+}
@@ -0,0 +1,137 @@
+/* background_loader.cpp
+ * Runs file reading on worker threads and videocard transfers in time slices on the calling thread
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "loaders/background_loader.h"
+
+#include "log.h"
+#include "profiler.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace renderer;
+using namespace renderer::loaders;
+
+BackgroundLoader::BackgroundLoader():
+	nextTaskIndex(0), loadedAmount(0), submittedAmount(0), failedAmount(0), needTerminate(false)
+{
+}
+
+BackgroundLoader::~BackgroundLoader()
+{
+	stopWorkers();
+}
+
+void BackgroundLoader::addTask(function<bool()> load, function<bool()> submit)
+{
+	tasks.push_back({move(load), move(submit)});
+}
+
+void BackgroundLoader::start(int threadAmount)
+{
+	if(threadAmount < 1)
+		threadAmount = 1;
+
+	Log::getInstance().info(string("Loading ") + to_string(tasks.size()) + " resources on " + to_string(threadAmount) + " threads");
+
+	for(int i = 0; i < threadAmount; i++)
+		workers.emplace_back(&BackgroundLoader::runWorker, this);
+}
+
+void BackgroundLoader::processLoaded(microseconds budget)
+{
+	const steady_clock::time_point deadline = steady_clock::now() + budget;
+
+	while(!isFinished())
+	{
+		int taskIndex = -1;
+		{
+			unique_lock<mutex> lock(accessLock);
+
+			bool isReady = loadedCondition.wait_until(lock, deadline, [this]() { return !loadedTasks.empty(); });
+			if(!isReady)
+				return;
+
+			taskIndex = loadedTasks.front();
+			loadedTasks.pop_front();
+		}
+
+		if(taskIndex >= 0)
+		{
+			PROFILE_ZONE("Submit resource");
+
+			bool status = tasks[taskIndex].submit();
+			if(!status)
+				failedAmount++;
+		}
+
+		submittedAmount++;
+
+		if(steady_clock::now() >= deadline)
+			return;
+	}
+}
+
+bool BackgroundLoader::isFinished() const
+{
+	return submittedAmount == static_cast<int>(tasks.size());
+}
+
+float BackgroundLoader::getProgress() const
+{
+	if(tasks.empty())
+		return 1.f;
+
+	return static_cast<float>(loadedAmount + submittedAmount) / (2.f * tasks.size());
+}
+
+int BackgroundLoader::getFailedAmount() const
+{
+	return failedAmount;
+}
+
+void BackgroundLoader::runWorker()
+{
+	PROFILE_THREAD_NAME("Loader");
+
+	const int taskAmount = tasks.size();
+
+	while(!needTerminate)
+	{
+		int taskIndex = nextTaskIndex++;
+		if(taskIndex >= taskAmount)
+			return;
+
+		bool status = false;
+		{
+			PROFILE_ZONE("Load resource");
+			status = tasks[taskIndex].load();
+		}
+
+		if(!status)
+			failedAmount++;
+
+		{
+			lock_guard<mutex> lockGuard(accessLock);
+			loadedTasks.push_back(status ? taskIndex: -1); //Failed tasks are only counted
+		}
+
+		loadedAmount++;
+		loadedCondition.notify_one();
+	}
+}
+
+void BackgroundLoader::stopWorkers()
+{
+	needTerminate = true;
+
+	for(auto &current: workers)
+	{
+		if(current.joinable())
+			current.join();
+	}
+
+	workers.clear();
+}
@@ -0,0 +1,109 @@
+/* camera_path_loader.cpp
+ * Loads and saves camera path for replays and benchmarks
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "loaders/camera_path_loader.h"
+
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+#include "log.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::data;
+using namespace renderer::loaders;
+
+namespace
+{
+	const string STR_CAMERA_PATH_SIGNATURE = "camera-path";
+
+	constexpr float MATH_PI_RADIANS = 3.14159f;
+}
+
+bool renderer::loaders::loadCameraPath(const string &path, CameraPath &cameraPath)
+{
+	/*
+	camera-path  keyframeAmount
+	time  x y z  horizontalRotationDegrees verticalRotationDegrees
+	...
+	*/
+
+	ifstream data(path);
+	if(!data.is_open())
+	{
+		Log::getInstance().error(string("Can't open camera path ") + path);
+		return false;
+	}
+
+	string signature;
+	int keyframeAmount = 0;
+	data >> signature >> keyframeAmount;
+	if(signature != STR_CAMERA_PATH_SIGNATURE || keyframeAmount <= 0)
+	{
+		Log::getInstance().error(path + " is not a camera path");
+		return false;
+	}
+
+	cameraPath.keyframes.resize(keyframeAmount);
+	for(int i = 0; i < keyframeAmount; i++)
+	{
+		CameraKeyframe &current = cameraPath.keyframes[i];
+		float horizontalRotationDegrees = 0.f, verticalRotationDegrees = 0.f;
+
+		data >> current.time >> current.position.x >> current.position.y >> current.position.z >> horizontalRotationDegrees >> verticalRotationDegrees;
+		if(!data)
+		{
+			Log::getInstance().error(string("Camera path ") + path + " is incomplete");
+			return false;
+		}
+
+		if(i > 0 && current.time < cameraPath.keyframes[i - 1].time)
+		{
+			Log::getInstance().error(string("Keyframes of camera path ") + path + " aren't sorted by time");
+			return false;
+		}
+
+		current.horizontalRotationRadians = (horizontalRotationDegrees * MATH_PI_RADIANS) / 180.f;
+		current.verticalRotationRadians = (verticalRotationDegrees * MATH_PI_RADIANS) / 180.f;
+	}
+
+	Log::getInstance().info(string("Camera path ") + path + " is loaded, " + to_string(keyframeAmount) + " keyframes");
+
+	return true;
+}
+
+bool renderer::loaders::saveCameraPath(const string &path, const CameraPath &cameraPath)
+{
+	ofstream data(path);
+	if(!data.is_open())
+	{
+		Log::getInstance().error(string("Can't open camera path ") + path + " for writing");
+		return false;
+	}
+
+	data << setprecision(numeric_limits<float>::max_digits10); //Enough digits to read the same floats back
+
+	data << STR_CAMERA_PATH_SIGNATURE << ' ' << cameraPath.keyframes.size() << '\n';
+	for(auto &current: cameraPath.keyframes)
+	{
+		const float horizontalRotationDegrees = (current.horizontalRotationRadians * 180.f) / MATH_PI_RADIANS;
+		const float verticalRotationDegrees = (current.verticalRotationRadians * 180.f) / MATH_PI_RADIANS;
+
+		data << current.time << ' ' << current.position.x << ' ' << current.position.y << ' ' << current.position.z << ' ' << horizontalRotationDegrees << ' ' <<
+			verticalRotationDegrees << '\n';
+	}
+
+	if(!data)
+	{
+		Log::getInstance().error(string("Can't write camera path ") + path);
+		return false;
+	}
+
+	Log::getInstance().info(string("Camera path ") + path + " is saved, " + to_string(cameraPath.keyframes.size()) + " keyframes");
+
+	return true;
+}
@@ -0,0 +1,83 @@
+/* file_mapping.cpp
+ * Maps file into memory for reading. POSIX implementation
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "loaders/file_mapping.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "log.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::loaders;
+
+FileMapping::FileMapping():
+	data(nullptr), size(0)
+{
+}
+
+FileMapping::~FileMapping()
+{
+	close();
+}
+
+bool FileMapping::open(const string &path)
+{
+	close();
+
+	int fileDescriptor = ::open(path.c_str(), O_RDONLY);
+	if(fileDescriptor == -1)
+	{
+		Log::getInstance().error(path + " can't be opened");
+		return false;
+	}
+
+	struct stat fileStatus;
+	if(fstat(fileDescriptor, &fileStatus) == -1 || fileStatus.st_size == 0)
+	{
+		Log::getInstance().error(string("Can't get size of ") + path);
+		::close(fileDescriptor);
+		return false;
+	}
+
+	void *mappedData = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	::close(fileDescriptor); //Mapping stays valid after the descriptor is closed
+
+	if(mappedData == MAP_FAILED)
+	{
+		Log::getInstance().error(string("Can't map ") + path + " into memory");
+		return false;
+	}
+
+	data = static_cast<const char*>(mappedData);
+	size = fileStatus.st_size;
+
+	return true;
+}
+
+void FileMapping::close()
+{
+	if(!data)
+		return;
+
+	munmap(const_cast<char*>(data), size);
+
+	data = nullptr;
+	size = 0;
+}
+
+const char* FileMapping::getData() const
+{
+	return data;
+}
+
+size_t FileMapping::getSize() const
+{
+	return size;
+}
@@ -0,0 +1,89 @@
+/* file_mapping_win.cpp
+ * Maps file into memory for reading. Windows implementation
+ *
+ * Author: Artem Hiblov
+ */
+
+//Include this file only in Windows version of the project
+
+#include "loaders/file_mapping.h"
+
+#include <windows.h>
+
+#include "log.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::loaders;
+
+FileMapping::FileMapping():
+	data(nullptr), size(0)
+{
+}
+
+FileMapping::~FileMapping()
+{
+	close();
+}
+
+bool FileMapping::open(const string &path)
+{
+	close();
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if(file == INVALID_HANDLE_VALUE)
+	{
+		Log::getInstance().error(path + " can't be opened");
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Log::getInstance().error(string("Can't get size of ") + path);
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if(!mapping)
+	{
+		Log::getInstance().error(string("Can't map ") + path + " into memory");
+		return false;
+	}
+
+	void *mappedData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping); //View keeps the mapping alive
+	if(!mappedData)
+	{
+		Log::getInstance().error(string("Can't map ") + path + " into memory");
+		return false;
+	}
+
+	data = static_cast<const char*>(mappedData);
+	size = static_cast<size_t>(fileSize.QuadPart);
+
+	return true;
+}
+
+void FileMapping::close()
+{
+	if(!data)
+		return;
+
+	UnmapViewOfFile(data);
+
+	data = nullptr;
+	size = 0;
+}
+
+const char* FileMapping::getData() const
+{
+	return data;
+}
+
+size_t FileMapping::getSize() const
+{
+	return size;
+}
@@ -0,0 +1,57 @@
+/* load_timing.cpp
+ * Maps whole files into memory and keeps time the calling thread spent on file reading and decoding
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "loaders/load_timing.h"
+
+#include "loaders/file_mapping.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace renderer;
+using namespace renderer::loaders;
+
+namespace
+{
+	thread_local LoadTimes threadLoadTimes; //Loader threads don't share times
+	thread_local FileMapping threadFileMapping; //Unmapped by the next call or when loader thread finishes
+
+	constexpr size_t MEMORY_PAGE_SIZE = 4096; //The smallest page size of supported platforms
+}
+
+LoadTimes renderer::loaders::getLoadTimes()
+{
+	return threadLoadTimes;
+}
+
+void renderer::loaders::resetLoadTimes()
+{
+	threadLoadTimes = LoadTimes();
+}
+
+void renderer::loaders::addDecodeTime(steady_clock::duration time)
+{
+	threadLoadTimes.decodeTime += time;
+}
+
+bool renderer::loaders::readWholeFile(const string &path, const char **data, size_t &size)
+{
+	const steady_clock::time_point startTime = steady_clock::now();
+
+	if(!threadFileMapping.open(path))
+		return false;
+
+	*data = threadFileMapping.getData();
+	size = threadFileMapping.getSize();
+
+	//Page faults happen here instead of decoding
+	volatile char pageSum = 0;
+	for(size_t i = 0; i < size; i += MEMORY_PAGE_SIZE)
+		pageSum += (*data)[i];
+
+	threadLoadTimes.readTime += steady_clock::now() - startTime;
+
+	return true;
+}
@@ -4,13 +4,20 @@
  * Author: Artem Hiblov
  */
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <fstream>
+#include <vector>
 
 #include "log.h"
+#include "loaders/load_timing.h"
 #include "loaders/mesh_loader.h"
+#include "profiler.h"
 
 using namespace std;
+using namespace std::chrono;
+using namespace renderer;
 using namespace renderer::data;
 using namespace renderer::loaders;
 
@@ -22,70 +29,57 @@ namespace
 	constexpr int TANGENT_BASIS_FLAG = 2;
 
 	const char *MESH_FILE_SIGNATURE = "mesh";
-}
 
-bool renderer::loaders::loadMesh(const string &path, Mesh &mesh)
-{
-	if(path.empty())
-	{
-		Log::getInstance().error("Path for mesh is not provided");
-		return false;
-	}
 
-	ifstream data(path, ios::in | ios::binary);
-	if(!data.is_open())
-	{
-		Log::getInstance().error(path + " can't be opened");
-		return false;
-	}
 
-	char signature[MESH_FILE_SIGNATURE_LENGTH+1] = {'\0'}; //1 is for \0 cheracter
-	data.read(signature, MESH_FILE_SIGNATURE_LENGTH);
-	signature[MESH_FILE_SIGNATURE_LENGTH] = '\0';
-	if(strcmp(signature, MESH_FILE_SIGNATURE) != 0)
-	{
-		Log::getInstance().error(string("Invalid signature for file ") + path);
-		return false;
-	}
+	/*
+	@brief Parses mesh file header and finds arrays after it
+	@param[in] path - for log messages only
+	*/
+	bool readMesh(const char *data, size_t size, const string &path, MeshFileArrays &arrays);
 
-	int formatType = 0;
-	int vertexAmount = 0;
+	void copyFloats(const char *data, size_t size, vector<float> &destination);
+}
 
-	data.read(reinterpret_cast<char*>(&formatType), sizeof(int));
-	data.read(reinterpret_cast<char*>(&vertexAmount), sizeof(int));
+bool renderer::loaders::loadMesh(const string &path, const AssetArchive *archive, Mesh &mesh)
+{
+	PROFILE_ZONE("loaders::loadMesh");
 
-	int floatsPerVertex = 3;
-	if((formatType & TWO_FLOATS_PER_COORD_FLAG) == 1) //Floats per position: 0 = 3 floats, 1 = 2 floats
-		floatsPerVertex = 2;
-	bool hasTangent = formatType & TANGENT_BASIS_FLAG;
+	MeshFileArrays arrays;
+	if(!mapMesh(path, archive, arrays))
+		return false;
 
-	mesh.floatsPerVertex = floatsPerVertex;
+	const steady_clock::time_point decodeStart = steady_clock::now();
 
-	int vertexArraySize = vertexAmount * floatsPerVertex;
-	mesh.vertices.resize(vertexArraySize);
-	data.read(reinterpret_cast<char*>(mesh.vertices.data()), vertexArraySize * sizeof(float));
+	mesh.floatsPerVertex = arrays.floatsPerVertex;
+	copyFloats(arrays.vertices, arrays.vertexSize, mesh.vertices);
+	copyFloats(arrays.uvs, arrays.uvSize, mesh.uvs);
+	copyFloats(arrays.normals, arrays.normalSize, mesh.normals);
+	copyFloats(arrays.tangent, arrays.tangentSize, mesh.tangent);
+	copyFloats(arrays.bitangent, arrays.tangentSize, mesh.bitangent);
 
-	int uvArraySize = vertexAmount * 2; //Always 2 floats per vertex
-	mesh.uvs.resize(uvArraySize);
-	data.read(reinterpret_cast<char*>(mesh.uvs.data()), uvArraySize * sizeof(float));
+	addDecodeTime(steady_clock::now() - decodeStart);
 
-	if(floatsPerVertex == 3) //2D meshes don't have normals
+	return true;
+}
+
+bool renderer::loaders::mapMesh(const string &path, const AssetArchive *archive, MeshFileArrays &arrays)
+{
+	if(path.empty())
 	{
-		int normalsArraySize = vertexAmount * 3; //Always 3 floats per vertex
-		mesh.normals.resize(normalsArraySize);
-		data.read(reinterpret_cast<char*>(mesh.normals.data()), normalsArraySize * sizeof(float));
+		Log::getInstance().error("Path for mesh is not provided");
+		return false;
 	}
 
-	if(hasTangent)
+	const char *entryData = nullptr;
+	size_t entrySize = 0;
+	if(!archive || !archive->getEntry(path, &entryData, entrySize))
 	{
-		mesh.tangent.resize(vertexArraySize);
-		data.read(reinterpret_cast<char*>(mesh.tangent.data()), vertexArraySize * sizeof(float));
-		mesh.bitangent.resize(vertexArraySize);
-		data.read(reinterpret_cast<char*>(mesh.bitangent.data()), vertexArraySize * sizeof(float));
+		if(!readWholeFile(path, &entryData, entrySize))
+			return false;
 	}
 
-	data.close();
-	return true;
+	return readMesh(entryData, entrySize, path, arrays);
 }
 
 bool renderer::loaders::loadObjectDescription(const string &path, map<string, ObjectFilePaths> &description)
@@ -112,3 +106,57 @@ bool renderer::loaders::loadObjectDescription(const string &path, map<string, Ob
 
 	return true;
 }
+
+namespace
+{
+	bool readMesh(const char *data, size_t size, const string &path, MeshFileArrays &arrays)
+	{
+		const size_t headerSize = MESH_FILE_SIGNATURE_LENGTH + 2 * sizeof(int);
+		if(size < headerSize || strncmp(data, MESH_FILE_SIGNATURE, MESH_FILE_SIGNATURE_LENGTH) != 0)
+		{
+			Log::getInstance().error(string("Invalid signature for file ") + path);
+			return false;
+		}
+
+		int formatType = 0;
+		int vertexAmount = 0;
+
+		memcpy(&formatType, data + MESH_FILE_SIGNATURE_LENGTH, sizeof(int));
+		memcpy(&vertexAmount, data + MESH_FILE_SIGNATURE_LENGTH + sizeof(int), sizeof(int));
+
+		int floatsPerVertex = 3;
+		if((formatType & TWO_FLOATS_PER_COORD_FLAG) == 1) //Floats per position: 0 = 3 floats, 1 = 2 floats
+			floatsPerVertex = 2;
+		bool hasTangent = formatType & TANGENT_BASIS_FLAG;
+
+		const size_t vertexAmountSize = static_cast<size_t>(max<>(vertexAmount, 0));
+
+		arrays.floatsPerVertex = floatsPerVertex;
+		arrays.vertexSize = vertexAmountSize * floatsPerVertex * sizeof(float);
+		arrays.uvSize = vertexAmountSize * 2 * sizeof(float); //Always 2 floats per vertex
+		arrays.normalSize = (floatsPerVertex == 3) ? vertexAmountSize * 3 * sizeof(float): 0; //2D meshes don't have normals
+		arrays.tangentSize = hasTangent ? arrays.vertexSize: 0;
+
+		if(size - headerSize < arrays.vertexSize + arrays.uvSize + arrays.normalSize + 2 * arrays.tangentSize)
+		{
+			Log::getInstance().error(string("Mesh file ") + path + " is truncated");
+			return false;
+		}
+
+		//Arrays follow each other in file
+		arrays.vertices = data + headerSize;
+		arrays.uvs = arrays.vertices + arrays.vertexSize;
+		arrays.normals = arrays.uvs + arrays.uvSize;
+		arrays.tangent = arrays.normals + arrays.normalSize;
+		arrays.bitangent = arrays.tangent + arrays.tangentSize;
+
+		return true;
+	}
+
+	void copyFloats(const char *data, size_t size, vector<float> &destination)
+	{
+		destination.resize(size / sizeof(float));
+		if(size)
+			memcpy(destination.data(), data, size);
+	}
+}
@@ -9,6 +9,7 @@
 #include <fstream>
 
 #include "log.h"
+#include "profiler.h"
 
 using namespace std;
 using namespace renderer::data;
@@ -18,6 +19,10 @@ namespace
 {
 	const string STR_YES = "yes";
 	const string STR_SCENE_SIGNATURE = "scene";
+	const string STR_POINT_LIGHTS_SIGNATURE = "point-lights";
+	const string STR_DEPTH_PREPASS_PROPERTY = "depth-prepass:";
+	const string STR_TRANSPARENCY_PROPERTY = "transparency:";
+	const string STR_WEIGHTED_BLENDED_TRANSPARENCY = "weighted-blended";
 
 	/*
 	@brief Loads camera data
@@ -25,7 +30,7 @@ namespace
 	void readCamera(ifstream &data, Scene &scene);
 
 	/*
-	@brief Loads renderer type (forward/deferred)
+	@brief Loads renderer type (forward/deferred/forward-plus) and optional depth pre-pass and transparency properties
 	*/
 	void readRendererType(ifstream &data, Scene &scene);
 
@@ -41,6 +46,11 @@ namespace
 	*/
 	void readLight(ifstream &data, Scene &scene);
 
+	/*
+	@brief Loads additional point lights. Section name is already read
+	*/
+	void readPointLights(ifstream &data, Scene &scene);
+
 	/*
 	@brief Loads single terrain chunk
 	@param[in] data - open file
@@ -73,6 +83,8 @@ namespace
 
 bool renderer::loaders::loadScene(const string &path, Scene &scene)
 {
+	PROFILE_ZONE("loaders::loadScene");
+
 	if(path.empty())
 	{
 		Log::getInstance().error("Path for scene file is not provided");
@@ -103,13 +115,21 @@ bool renderer::loaders::loadScene(const string &path, Scene &scene)
 	readLight(data, scene);
 
 	/*
+	[point-lights 2 ...]  optional section
 	chunks 1  chunkSignature, chunkNumber
 	terrain-texturing: texture-bombing-and-triplanar-mapping  terrainTexturingSignature, terrainTexturing
 	*/
 	string chunkSignature;
 	int chunkNumber = 0;
 
-	data >> chunkSignature >> chunkNumber;
+	data >> chunkSignature;
+	if(chunkSignature == STR_POINT_LIGHTS_SIGNATURE)
+	{
+		readPointLights(data, scene);
+		data >> chunkSignature;
+	}
+
+	data >> chunkNumber;
 	scene.instances.resize(chunkNumber);
 	scene.particles.resize(chunkNumber);
 
@@ -153,10 +173,35 @@ namespace
 	{
 		/*
 		renderer-type: forward  rendererType
+		[depth-prepass: yes]  optional property, enable
+		[transparency: weighted-blended]  optional property, sorted or weighted-blended
 		*/
 
 		string propertyName;
 		data >> propertyName >> scene.rendererType;
+
+		while(true)
+		{
+			streampos position = data.tellg();
+			data >> propertyName;
+			if(propertyName == STR_DEPTH_PREPASS_PROPERTY)
+			{
+				string enable;
+				data >> enable;
+				scene.depthPrepass = (enable == STR_YES);
+			}
+			else if(propertyName == STR_TRANSPARENCY_PROPERTY)
+			{
+				string mode;
+				data >> mode;
+				scene.weightedBlendedTransparency = (mode == STR_WEIGHTED_BLENDED_TRANSPARENCY);
+			}
+			else
+			{
+				data.seekg(position); //No more optional properties
+				break;
+			}
+		}
 	}
 
 	void readFogData(ifstream &data, Scene &scene)
@@ -176,6 +221,7 @@ namespace
 	{
 		/*
 		post-effect: --  postprocessingEffect
+		Effect chain is comma-separated without spaces: postprocessing:grayscale,postprocessing:vignette
 		*/
 
 		string propertyName;
@@ -197,6 +243,27 @@ namespace
 		scene.light = Light(lightType, x, y, z);
 	}
 
+	void readPointLights(ifstream &data, Scene &scene)
+	{
+		/*
+		point-lights 2  sectionName, lightAmount
+		1.5 2 -3 5 255 180 90  x, y, z, power, red, green, blue
+		*/
+
+		int lightAmount = 0;
+		data >> lightAmount;
+
+		scene.pointLights.reserve(lightAmount);
+		for(int i = 0; i < lightAmount; i++)
+		{
+			float x = 0, y = 0, z = 0, power = 0;
+			int red = 0, green = 0, blue = 0;
+			data >> x >> y >> z >> power >> red >> green >> blue;
+
+			scene.pointLights.push_back(PointLight(x, y, z, power, red, green, blue));
+		}
+	}
+
 	void readChunk(ifstream &data, int index, Scene &scene)
 	{
 		/*
@@ -35,3 +35,26 @@ bool renderer::loaders::loadShader(const string &path, string &code)
 	data.close();
 	return true;
 }
+
+bool renderer::loaders::loadShaderWithDefines(const string &path, const vector<string> &defines, string &code)
+{
+	string source;
+	if(!loadShader(path, source))
+		return false;
+
+	string defineLines;
+	for(auto &current: defines)
+		defineLines += string("#define ") + current + "\n";
+
+	//"#version" must be the first directive, so defines go after its line
+	size_t insertPosition = 0;
+	size_t versionPosition = source.find("#version");
+	if(versionPosition != string::npos)
+	{
+		size_t lineEnd = source.find('\n', versionPosition);
+		insertPosition = (lineEnd == string::npos) ? source.size(): lineEnd + 1;
+	}
+
+	code = source.substr(0, insertPosition) + defineLines + source.substr(insertPosition);
+	return true;
+}
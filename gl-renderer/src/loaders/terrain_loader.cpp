@@ -6,12 +6,17 @@
 
 #include "loaders/terrain_loader.h"
 
+#include <chrono>
 #include <cstring>
 #include <fstream>
 
 #include "log.h"
+#include "loaders/load_timing.h"
+#include "profiler.h"
 
 using namespace std;
+using namespace std::chrono;
+using namespace renderer;
 using namespace renderer::data;
 using namespace renderer::loaders;
 
@@ -20,68 +25,48 @@ namespace
 	constexpr int TERRAIN_FILE_SIGNATURE_LENGTH = 7;
 
 	const char *TERRAIN_FILE_SIGNATURE = "terrain";
+
+
+
+	/*
+	@brief Parses terrain file contents
+	@param[in] path - for log messages only
+	*/
+	bool readTerrain(istream &data, const string &path, Mesh &chunk, Heightmap &heightmap, float &sideLength);
+
+	/*
+	@brief Reads only chunk side length from terrain file contents
+	*/
+	float readSideLength(istream &data, const string &path);
 }
 
-bool renderer::loaders::loadTerrain(const string &path, Mesh &chunk, Heightmap &heightmap, float &sideLength)
+bool renderer::loaders::loadTerrain(const string &path, const AssetArchive *archive, Mesh &chunk, Heightmap &heightmap, float &sideLength)
 {
+	PROFILE_ZONE("loaders::loadTerrain");
+
 	if(path.empty())
 	{
 		Log::getInstance().error("Path for terrain mesh is not provided");
 		return false;
 	}
 
-	ifstream data(path, ios::in | ios::binary);
-	if(!data.is_open())
-	{
-		Log::getInstance().error(path + " can't be opened");
-		return false;
-	}
-
-	char signature[TERRAIN_FILE_SIGNATURE_LENGTH+1] = {'\0'};
-	data.read(signature, TERRAIN_FILE_SIGNATURE_LENGTH);
-	signature[TERRAIN_FILE_SIGNATURE_LENGTH] = '\0';
-	if(strcmp(signature, TERRAIN_FILE_SIGNATURE) != 0)
+	const char *entryData = nullptr;
+	size_t entrySize = 0;
+	if(!archive || !archive->getEntry(path, &entryData, entrySize))
 	{
-		Log::getInstance().error(string("Invalid signature for file ") + path);
-		return false;
+		if(!readWholeFile(path, &entryData, entrySize))
+			return false;
 	}
 
-	data.read(reinterpret_cast<char*>(&sideLength), sizeof(float));
-
-	chunk.floatsPerVertex = 0;
+	const steady_clock::time_point decodeStart = steady_clock::now();
 
-	int vertexAmount = 0;
-	data.read(reinterpret_cast<char*>(&vertexAmount), sizeof(int));
+	MemoryStreamBuffer buffer(entryData, entrySize);
+	istream data(&buffer);
+	bool status = readTerrain(data, path, chunk, heightmap, sideLength);
 
-	int vertexArraySize = vertexAmount * 3; //3 coordinates per vertex and normal
-	chunk.vertices.resize(vertexArraySize);
-	data.read(reinterpret_cast<char*>(chunk.vertices.data()), vertexArraySize * sizeof(float));
+	addDecodeTime(steady_clock::now() - decodeStart);
 
-	int uvArraySize = vertexAmount * 2; //2 coordinates for texture
-	chunk.uvs.resize(uvArraySize);
-	data.read(reinterpret_cast<char*>(chunk.uvs.data()), uvArraySize * sizeof(float));
-
-	chunk.normals.resize(vertexArraySize);
-	data.read(reinterpret_cast<char*>(chunk.normals.data()), vertexArraySize * sizeof(float));
-
-	//Heightmap
-
-	data.read(reinterpret_cast<char*>(&heightmap.verticesInSide), sizeof(int));
-	data.read(reinterpret_cast<char*>(&heightmap.gridStep), sizeof(float));
-	for(int i = 0; i < heightmap.verticesInSide; i++)
-	{
-		vector<float> row(heightmap.verticesInSide);
-		for(int j = 0; j < heightmap.verticesInSide; j++)
-		{
-			data.read(reinterpret_cast<char*>(&row[j]), sizeof(float));
-		}
-
-		heightmap.heights.emplace_back(row);
-	}
-
-	data.close();
-
-	return true;
+	return status;
 }
 
 bool renderer::loaders::loadTerrainDescription(const string &path, map<string, TerrainFilePaths> &description)
@@ -109,7 +94,29 @@ bool renderer::loaders::loadTerrainDescription(const string &path, map<string, T
 	return true;
 }
 
-float renderer::loaders::readChunkDimensions(const std::string &path)
+bool renderer::loaders::saveTerrainDescription(const string &path, const map<string, TerrainFilePaths> &description)
+{
+	ofstream data(path);
+	if(!data.is_open())
+	{
+		Log::getInstance().error(string("\"") + path + "\" can't be opened for writing");
+		return false;
+	}
+
+	data << description.size() << '\n';
+	for(auto &[chunkName, paths]: description)
+		data << chunkName << ' ' << paths.meshPath << ' ' << paths.texturePath << '\n';
+
+	if(!data)
+	{
+		Log::getInstance().error(string("Can't write ") + path);
+		return false;
+	}
+
+	return true;
+}
+
+float renderer::loaders::readChunkDimensions(const std::string &path, const AssetArchive *archive)
 {
 	if(path.empty())
 	{
@@ -117,6 +124,16 @@ float renderer::loaders::readChunkDimensions(const std::string &path)
 		return false;
 	}
 
+	const char *entryData = nullptr;
+	size_t entrySize = 0;
+	if(archive && archive->getEntry(path, &entryData, entrySize))
+	{
+		MemoryStreamBuffer buffer(entryData, entrySize);
+		istream data(&buffer);
+
+		return readSideLength(data, path);
+	}
+
 	ifstream data(path, ios::in | ios::binary);
 	if(!data.is_open())
 	{
@@ -124,16 +141,71 @@ float renderer::loaders::readChunkDimensions(const std::string &path)
 		return false;
 	}
 
-	char signature[TERRAIN_FILE_SIGNATURE_LENGTH+1] = {'\0'};
-	data.read(signature, TERRAIN_FILE_SIGNATURE_LENGTH);
-	if(strcmp(signature, TERRAIN_FILE_SIGNATURE) != 0)
+	return readSideLength(data, path);
+}
+
+namespace
+{
+	bool readTerrain(istream &data, const string &path, Mesh &chunk, Heightmap &heightmap, float &sideLength)
 	{
-		Log::getInstance().error(string("Invalid signature for file ") + path);
-		return false;
+		char signature[TERRAIN_FILE_SIGNATURE_LENGTH+1] = {'\0'};
+		data.read(signature, TERRAIN_FILE_SIGNATURE_LENGTH);
+		signature[TERRAIN_FILE_SIGNATURE_LENGTH] = '\0';
+		if(strcmp(signature, TERRAIN_FILE_SIGNATURE) != 0)
+		{
+			Log::getInstance().error(string("Invalid signature for file ") + path);
+			return false;
+		}
+
+		data.read(reinterpret_cast<char*>(&sideLength), sizeof(float));
+
+		chunk.floatsPerVertex = 0;
+
+		int vertexAmount = 0;
+		data.read(reinterpret_cast<char*>(&vertexAmount), sizeof(int));
+
+		int vertexArraySize = vertexAmount * 3; //3 coordinates per vertex and normal
+		chunk.vertices.resize(vertexArraySize);
+		data.read(reinterpret_cast<char*>(chunk.vertices.data()), vertexArraySize * sizeof(float));
+
+		int uvArraySize = vertexAmount * 2; //2 coordinates for texture
+		chunk.uvs.resize(uvArraySize);
+		data.read(reinterpret_cast<char*>(chunk.uvs.data()), uvArraySize * sizeof(float));
+
+		chunk.normals.resize(vertexArraySize);
+		data.read(reinterpret_cast<char*>(chunk.normals.data()), vertexArraySize * sizeof(float));
+
+		//Heightmap
+
+		data.read(reinterpret_cast<char*>(&heightmap.verticesInSide), sizeof(int));
+		data.read(reinterpret_cast<char*>(&heightmap.gridStep), sizeof(float));
+		for(int i = 0; i < heightmap.verticesInSide; i++)
+		{
+			vector<float> row(heightmap.verticesInSide);
+			for(int j = 0; j < heightmap.verticesInSide; j++)
+			{
+				data.read(reinterpret_cast<char*>(&row[j]), sizeof(float));
+			}
+
+			heightmap.heights.emplace_back(row);
+		}
+
+		return true;
 	}
 
-	float sideLength = 0;
-	data.read(reinterpret_cast<char*>(&sideLength), sizeof(float));
+	float readSideLength(istream &data, const string &path)
+	{
+		char signature[TERRAIN_FILE_SIGNATURE_LENGTH+1] = {'\0'};
+		data.read(signature, TERRAIN_FILE_SIGNATURE_LENGTH);
+		if(strcmp(signature, TERRAIN_FILE_SIGNATURE) != 0)
+		{
+			Log::getInstance().error(string("Invalid signature for file ") + path);
+			return false;
+		}
+
+		float sideLength = 0;
+		data.read(reinterpret_cast<char*>(&sideLength), sizeof(float));
 
-	return sideLength;
-}
+		return sideLength;
+	}
+}
\ No newline at end of file
@@ -6,12 +6,17 @@
 
 #include "loaders/texture_loader.h"
 
-#include <fstream>
+#include <chrono>
+#include <cstring>
 #include <memory>
 
 #include "log.h"
+#include "loaders/load_timing.h"
+#include "profiler.h"
 
 using namespace std;
+using namespace std::chrono;
+using namespace renderer;
 using namespace renderer::data;
 using namespace renderer::loaders;
 
@@ -23,9 +28,40 @@ namespace
 	constexpr int BMP_IMAGE_HEIGHT_OFFSET = 22;
 	constexpr int BMP_IMAGE_BITS_PER_PIXEL_OFFSET = 28;
 	constexpr int BMP_IMAGE_SIZE_OFFSET = 34;
+
+
+
+	/*
+	@brief Parses BMP header and finds pixels after it
+	@param[in] path - for log messages only
+	*/
+	bool readTexture(const char *data, size_t size, const string &path, TextureFilePixels &pixels);
+}
+
+bool renderer::loaders::loadTexture(const string &path, const AssetArchive *archive, Texture &texture)
+{
+	PROFILE_ZONE("loaders::loadTexture");
+
+	TextureFilePixels pixels;
+	if(!mapTexture(path, archive, pixels))
+		return false;
+
+	const steady_clock::time_point decodeStart = steady_clock::now();
+
+	shared_ptr<unsigned char[]> image = shared_ptr<unsigned char[]>(new unsigned char [pixels.size]);
+	memcpy(image.get(), pixels.data, pixels.size);
+
+	texture.data = move(image);
+	texture.width = pixels.width;
+	texture.height = pixels.height;
+	texture.bytesPerPixel = pixels.bytesPerPixel;
+
+	addDecodeTime(steady_clock::now() - decodeStart);
+
+	return true;
 }
 
-bool renderer::loaders::loadTexture(const string &path, Texture &texture)
+bool renderer::loaders::mapTexture(const string &path, const AssetArchive *archive, TextureFilePixels &pixels)
 {
 	if(path.empty())
 	{
@@ -33,38 +69,50 @@ bool renderer::loaders::loadTexture(const string &path, Texture &texture)
 		return false;
 	}
 
-	ifstream data(path, ios::in | ios::binary);
-	if(!data.is_open())
+	const char *entryData = nullptr;
+	size_t entrySize = 0;
+	if(!archive || !archive->getEntry(path, &entryData, entrySize))
 	{
-		Log::getInstance().error(string("Can't open ") + path);
-		return false;
+		if(!readWholeFile(path, &entryData, entrySize))
+			return false;
 	}
 
-	unsigned char header[BMP_HEADER_SIZE] = {0};
+	return readTexture(entryData, entrySize, path, pixels);
+}
 
-	data.read(reinterpret_cast<char*>(header), BMP_HEADER_SIZE);
-	if(header[0] != 'B' || header[1] != 'M')
+namespace
+{
+	bool readTexture(const char *data, size_t size, const string &path, TextureFilePixels &pixels)
 	{
-		Log::getInstance().error(string("Signature for ") + path + " is invalid.");
-		return false;
-	}
+		if(size < BMP_HEADER_SIZE || data[0] != 'B' || data[1] != 'M')
+		{
+			Log::getInstance().error(string("Signature for ") + path + " is invalid.");
+			return false;
+		}
 
-	int dataOffset = *(reinterpret_cast<int*>(&header[BMP_DATA_OFFSET]));
-	texture.width = *(reinterpret_cast<int*>(&header[BMP_IMAGE_WIDTH_OFFSET]));
-	texture.height = *(reinterpret_cast<int*>(&header[BMP_IMAGE_HEIGHT_OFFSET]));
-	short bitsPerPixel = *(reinterpret_cast<short*>(&header[BMP_IMAGE_BITS_PER_PIXEL_OFFSET]));
-	texture.bytesPerPixel = bitsPerPixel / 8;
+		int dataOffset = 0;
+		short bitsPerPixel = 0;
+		int textureSize = 0;
 
-	int textureSize = *(reinterpret_cast<int*>(&header[BMP_IMAGE_SIZE_OFFSET]));
-	if(textureSize == 0)
-		textureSize = texture.width * texture.height * texture.bytesPerPixel;
+		memcpy(&dataOffset, data + BMP_DATA_OFFSET, sizeof(int));
+		memcpy(&pixels.width, data + BMP_IMAGE_WIDTH_OFFSET, sizeof(int));
+		memcpy(&pixels.height, data + BMP_IMAGE_HEIGHT_OFFSET, sizeof(int));
+		memcpy(&bitsPerPixel, data + BMP_IMAGE_BITS_PER_PIXEL_OFFSET, sizeof(short));
+		memcpy(&textureSize, data + BMP_IMAGE_SIZE_OFFSET, sizeof(int));
+		pixels.bytesPerPixel = bitsPerPixel / 8;
 
-	shared_ptr<unsigned char[]> image = shared_ptr<unsigned char[]>(new unsigned char [textureSize]);
-	data.seekg(dataOffset);
-	data.read(reinterpret_cast<char*>(image.get()), textureSize);
+		if(textureSize == 0)
+			textureSize = pixels.width * pixels.height * pixels.bytesPerPixel;
 
-	texture.data = move(image);
+		if(dataOffset < 0 || textureSize < 0 || static_cast<size_t>(dataOffset) > size || size - dataOffset < static_cast<size_t>(textureSize))
+		{
+			Log::getInstance().error(string("Texture file ") + path + " is truncated");
+			return false;
+		}
 
-	data.close();
-	return true;
-}
+		pixels.data = data + dataOffset;
+		pixels.size = textureSize;
+
+		return true;
+	}
+}
\ No newline at end of file
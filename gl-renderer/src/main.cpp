@@ -6,6 +6,7 @@
 
 #include "log.h"
 #include "main_component.h"
+#include "startup_timer.h"
 #include "graphics_lib/backend_teller.h"
 #include "utils/commandline_parser.h"
 
@@ -14,8 +15,15 @@ using namespace renderer;
 using namespace renderer::graphics_lib;
 using namespace renderer::utils;
 
+namespace
+{
+	const char *STARTUP_TIMES_PATH = "startup-times.jsonl"; //One line per run
+}
+
 int main(int argc, const char **argv)
 {
+	StartupTimer::getInstance().beginPhase("Startup");
+
 	AppParameters appParameters;
 
 	bool status = parseCommandline(argc, argv, appParameters);
@@ -39,6 +47,8 @@ int main(int argc, const char **argv)
 		if(!status)
 			return 1;
 
+		StartupTimer::getInstance().finish(STARTUP_TIMES_PATH, appParameters.scenePath);
+
 		mainComponent.run();
 	}
 
@@ -8,27 +8,42 @@
 
 #include "main_component.h"
 
+#include <chrono>
+#include <functional>
 #include <iomanip>
+#include <set>
 #include <sstream>
 #include <string>
+#include <thread>
 
 #include "log.h"
+#include "common_constants.h"
 #include "graphics_lib/deferred_renderer.h"
 #include "graphics_lib/editor_frame_renderer.h"
 #include "graphics_lib/main_renderer_builder.h"
 #include "graphics_lib/message_callback.h"
+#include "graphics_lib/operations/memory_ledger.h"
+#include "graphics_lib/postprocessing_backend_comparison.h"
 #include "graphics_lib/postprocessing_renderer_builder.h"
 #include "graphics_lib/rendering_scene_builder.h"
 #include "graphics_lib/splash_renderer_builder.h"
 #include "graphics_lib/videocard_data/rendering_scene.h"
+#include "loaders/background_loader.h"
+#include "loaders/camera_path_loader.h"
+#include "loaders/load_timing.h"
+#include "profiler.h"
+#include "startup_timer.h"
 #include "thirdparty/imgui_tools.h"
 #include "visibility/camera_controller.h"
 
 using namespace std;
+using namespace std::chrono;
 using namespace renderer;
 using namespace renderer::data;
 using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
 using namespace renderer::graphics_lib::videocard_data;
+using namespace renderer::loaders;
 using namespace renderer::managers;
 using namespace renderer::thirdparty;
 using namespace renderer::visibility;
@@ -42,8 +57,35 @@ namespace
 	const char *LIGHT_TYPE_DIRECTIONAL = "directional";
 
 	const char *SCENE_STATISTICS_PATH = "statistics";
+	const char *PROFILER_TRACE_PATH = "trace.json";
+
+	constexpr size_t UPLOAD_RING_SIZE = 64 * 1024 * 1024;
+	constexpr double BYTES_IN_MEGABYTE = 1024. * 1024.;
+
+	//Loading screen
+	constexpr microseconds LOADING_TRANSFER_BUDGET(8000); //Transfers to videocard between event pumps
+	constexpr milliseconds SPLASH_FRAME_INTERVAL(50);
+
+	//Startup timer groups and steps of resource loading
+	const char *STARTUP_GROUP_TERRAIN = "Terrain";
+	const char *STARTUP_GROUP_OBJECTS = "Objects";
+	const char *STARTUP_STEP_READING = "File reading";
+	const char *STARTUP_STEP_DECODING = "Decoding";
+
+
 
 	void writeContextInfoLogMessages();
+
+	/*
+	@brief Runs preloading in loader thread and adds its file reading and decoding time to startup timer
+	@param[in] group - resource type
+	*/
+	bool preloadWithTiming(const char *group, const function<bool()> &preload);
+
+	/*
+	@brief Runs transfer to videocard and adds its time to startup timer
+	*/
+	bool transferWithTiming(const char *group, const function<bool()> &transfer);
 }
 
 MainComponent::MainComponent(const AppParameters &parameters):
@@ -61,21 +103,51 @@ MainComponent::~MainComponent()
 
 bool MainComponent::initBase()
 {
+	PROFILE_THREAD_NAME("Main");
+
+	StartupTimer &startupTimer = StartupTimer::getInstance();
+
 	//Initialize thirdparty libraries
 
+	startupTimer.beginPhase("GLFW initialization");
 	bool status = initGlfw(appParameters, &window);
+	startupTimer.endPhase();
 	if(!status)
 		return false;
 
+	startupTimer.beginPhase("GLEW initialization");
 	status = initGlew();
+	startupTimer.endPhase();
 	if(!status)
 		return false;
 
 	writeContextInfoLogMessages();
 
 	//Initialize components needed for both splash and main renderer
-	objectManager = make_unique<ObjectManager>(OBJECT_DESCRIPTION_PATH);
+
+	startupTimer.beginPhase("Archive and staging ring");
+	if(!appParameters.archivePath.empty())
+	{
+		assetArchive = make_unique<AssetArchive>();
+		if(!assetArchive->open(appParameters.archivePath))
+		{
+			Log::getInstance().warning("Can't open asset archive. Separate files are used");
+			assetArchive.reset();
+		}
+	}
+
+	uploadService = make_unique<UploadService>(UPLOAD_RING_SIZE, static_cast<size_t>(appParameters.uploadKilobytesPerFrame) * 1024);
+	if(!uploadService->init())
+	{
+		Log::getInstance().warning("Can't create staging ring. Data is transfered directly");
+		uploadService.reset();
+	}
+	startupTimer.endPhase();
+
+	startupTimer.beginPhase("Description loading");
+	objectManager = make_unique<ObjectManager>(OBJECT_DESCRIPTION_PATH, assetArchive.get(), uploadService.get());
 	shaderManager = make_unique<ShaderManager>(SHADER_DESCRIPTION_PATH);
+	startupTimer.endPhase();
 
 	//OpenGL 4.3+
 	if(appParameters.enableDebug)
@@ -90,8 +162,14 @@ bool MainComponent::initBase()
 
 void MainComponent::showSplash()
 {
+	StartupPhase phase("Splash");
+
 	splashRenderer = move(buildSplashRenderer(objectManager.get(), shaderManager.get(), static_cast<float>(appParameters.screenWidth) / appParameters.screenHeight));
-	splashRenderer->render();
+
+	if(uploadService)
+		uploadService->flush(); //Splash must be complete in its only frame
+
+	splashRenderer->render(0.f);
 
 	glfwSwapBuffers(window);
 }
@@ -104,24 +182,50 @@ bool MainComponent::initAll()
 		return false;
 	}
 
+	StartupTimer &startupTimer = StartupTimer::getInstance();
+
+	startupTimer.beginPhase("ImGui initialization");
 	initImgui(window);
+	startupTimer.endPhase();
+
+	if(appParameters.isBenchmarkMode && !loadCameraPath(appParameters.cameraPathPath, cameraPath))
+	{
+		Log::getInstance().error("Can't load camera path for benchmark");
+		return false;
+	}
 
 	//Initialize scene
 
 	Log::getInstance().info(string("Initializing scene \"") + appParameters.scenePath + "\"");
 
+	startupTimer.beginPhase("Scene parsing");
 	sceneManager = make_unique<SceneManager>(appParameters.scenePath);
-	terrainManager = make_unique<TerrainManager>(TERRAIN_DESCRIPTION_PATH);
+	startupTimer.endPhase();
+
+	startupTimer.beginPhase("Description loading");
+	terrainManager = make_unique<TerrainManager>(TERRAIN_DESCRIPTION_PATH, assetArchive.get());
 	particleManager = make_unique<ParticleManager>(terrainManager.get());
+	startupTimer.endPhase();
 
+	startupTimer.beginPhase("Chunk dimensions"); //Read from chunk files
 	sceneManager->computeChunkMargins(terrainManager.get());
 	sceneManager->appendChunkDimensions(terrainManager.get());
+	startupTimer.endPhase();
+
+	loadSceneResources();
+
+	startupTimer.beginPhase("Rendering scene build");
+	if(appParameters.isLightSweep) //Renderer is built for the largest amount, sweep replaces lights
+		sceneManager->generatePointLights(BenchmarkCore::LIGHT_SWEEP_MAX_AMOUNT, terrainManager.get());
+	else if(appParameters.pointLightAmount > 0)
+		sceneManager->generatePointLights(appParameters.pointLightAmount, terrainManager.get());
 
 	bool isDeferredRendering = sceneManager->isDeferredRendering();
+	bool isForwardPlusRendering = sceneManager->isForwardPlusRendering();
 
 	const Scene &scene = sceneManager->getScene();
 	bool isDirectional = false;
-	if(isDeferredRendering)
+	if(isDeferredRendering || isForwardPlusRendering)
 	{
 		isDirectional = true; //Directional light is used as ambient component for point light
 	}
@@ -132,15 +236,29 @@ bool MainComponent::initAll()
 	}
 
 	shaderManager->setLightType(isDirectional);
+	shaderManager->setClusteredLights(isForwardPlusRendering);
+	shaderManager->setWeightedBlendedTransparency(sceneManager->isWeightedBlendedTransparency());
 	RenderingScene *renderingScene = makeRenderingScene(scene, isDeferredRendering, terrainManager.get(), objectManager.get(), particleManager.get(), sceneManager->getChunkMargins(),
 		shaderManager.get());
+	startupTimer.endPhase();
 
 	//Create and initialize shaders
+	startupTimer.beginPhase("Scene shaders");
 	std::map<int, unsigned long long> shaderFlags;
 	vector<ShaderIds> &sceneShaders = shaderManager->createNeededShaders(shaderFlags);
+	startupTimer.endPhase();
+
+	if(!appParameters.comparedPostprocessingEffect.empty()) //Own phase, so renderer build time doesn't include the whole comparison
+	{
+		startupTimer.beginPhase("Postprocessing backend comparison");
+		comparePostprocessingBackends(appParameters.comparedPostprocessingEffect, shaderManager.get());
+		startupTimer.endPhase();
+	}
 
+	startupTimer.beginPhase("Renderer build");
 	unique_ptr<Base3DRenderer> mainRenderer = buildMainRenderer(objectManager.get(), shaderManager.get(), appParameters.screenWidth, appParameters.screenHeight,
-		sceneManager->getScene().light, sceneManager->getScene().fog, shaderFlags, sceneShaders, isDirectional, isDeferredRendering);
+		sceneManager->getScene().light, sceneManager->getScene().pointLights, sceneManager->getScene().fog, shaderFlags, sceneShaders, isDirectional, isDeferredRendering,
+		isForwardPlusRendering, sceneManager->isDepthPrepassEnabled(), sceneManager->isWeightedBlendedTransparency());
 	mainRenderer->setRenderingScene(renderingScene);
 
 	unique_ptr<PostprocessingRenderer> postprocessingRenderer;
@@ -154,10 +272,24 @@ bool MainComponent::initAll()
 		}
 	}
 
+	unique_ptr<DynamicResolution> dynamicResolution;
+	if(appParameters.targetFrameTime > 0.f || appParameters.renderScale < 1.f || appParameters.useTemporalUpscaling)
+	{
+		dynamicResolution = buildDynamicResolution(appParameters.screenWidth, appParameters.screenHeight, appParameters.renderScale, appParameters.targetFrameTime,
+			appParameters.useTemporalUpscaling, shaderManager.get());
+
+		if(dynamicResolution && isDeferredRendering) //Light passes write to scaled scene target, it is upscaled to postprocessing framebuffer
+		{
+			static_cast<DeferredRenderer*>(mainRenderer.get())->setWriteFramebufferId(dynamicResolution->getFramebufferId());
+		}
+	}
+
 	//Create core and renderer stuff
 
 	EditorFrameRenderer *frameRenderer = new EditorFrameRenderer(mainRenderer.release(), postprocessingRenderer.release(), sceneManager->isDeferredRendering(), shaderManager.get());
 	frameRenderer->setRendererLibraryProperties();
+	if(dynamicResolution)
+		frameRenderer->setDynamicResolution(move(dynamicResolution));
 
 	//FlyingCamera
 	TCameraController cameraController(sceneManager->getCameraData().xPos, sceneManager->getCameraData().yPos, sceneManager->getCameraData().zPos,
@@ -173,14 +305,31 @@ bool MainComponent::initAll()
 		frameRenderer->initEditorShader();
 		core = make_unique<EditorCore>(frameRenderer, window, cameraController, *sceneManager, terrainManager.get(), objectManager.get(), particleManager.get(), shaderManager.get());
 	}
+	else if(appParameters.isBenchmarkMode)
+	{
+		Log::getInstance().info("Starting in benchmark mode");
+		core = make_unique<BenchmarkCore>(window, frameRenderer, cameraController, *sceneManager, *shaderManager, cameraPath, appParameters);
+	}
 	else core = make_unique<Core>(window, frameRenderer, cameraController, *sceneManager, *shaderManager);
+	startupTimer.endPhase();
 
-	stringstream memoryMessage;
-	float bytesUsed = static_cast<float>(terrainManager->getTransferedBytesAmount()) + static_cast<float>(objectManager->getTransferedBytesAmount()) +
-        static_cast<float>(particleManager->getTransferedBytesAmount());
+	//Scene data is transfered before the first frame, objects added later are streamed within per-frame limit
+	if(uploadService)
+	{
+		startupTimer.beginPhase("Staging flush");
+		uploadService->flush();
+		startupTimer.endPhase();
+
+		core->setUploadService(uploadService.get());
+	}
 
-	memoryMessage << std::fixed << setprecision(1) << (bytesUsed / 1024.f) / 1024.f;
-	memoryMessage << " MB of data transfered to videocard";
+	stringstream memoryMessage;
+	memoryMessage << std::fixed << setprecision(1) << getTotalMemoryUsage().bytes / BYTES_IN_MEGABYTE << " MB of videocard memory is used:";
+	for(int i = 0; i < MEMORY_CATEGORY_AMOUNT; i++)
+	{
+		const MemoryCategory category = static_cast<MemoryCategory>(i);
+		memoryMessage << (i == 0 ? " " : ", ") << getMemoryCategoryName(category) << " " << getMemoryUsage(category).bytes / BYTES_IN_MEGABYTE;
+	}
 	Log::getInstance().info(memoryMessage.str());
 
 	return true;
@@ -200,11 +349,91 @@ void MainComponent::run()
 
 	core->mainLoop();
 
+#ifdef RENDERER_PROFILING
+	Profiler::getInstance().exportChromeTrace(PROFILER_TRACE_PATH);
+#endif
+
 	const time_t sceneEndTime = time(nullptr);
 	statistics.addTime(appParameters.scenePath, sceneEndTime - sceneStartTime);
 	statistics.save();
 }
 
+void MainComponent::loadSceneResources()
+{
+	PROFILE_ZONE("MainComponent::loadSceneResources");
+
+	StartupPhase phase("Resource loading");
+
+	const Scene &scene = sceneManager->getScene();
+
+	set<string> chunkNames, objectNames, particleNames;
+	for(auto &current: scene.chunks)
+		chunkNames.insert(current.name);
+
+	for(auto &chunkInstances: scene.instances)
+	{
+		for(auto &current: chunkInstances)
+			objectNames.insert(current.name);
+	}
+
+	for(auto &chunkParticles: scene.particles)
+	{
+		for(auto &current: chunkParticles)
+		{
+			if(objectNames.find(current.name) == objectNames.end())
+				particleNames.insert(current.name);
+		}
+	}
+
+	BackgroundLoader loader;
+
+	for(auto &name: chunkNames)
+	{
+		loader.addTask([this, name]() { return preloadWithTiming(STARTUP_GROUP_TERRAIN, [this, &name]() { return terrainManager->preloadChunk(name); }); },
+			[this, name]() { return transferWithTiming(STARTUP_GROUP_TERRAIN, [this, &name]() { ObjectRenderingData data; return terrainManager->getRenderingData(name, data); }); });
+	}
+
+	for(auto &name: objectNames)
+	{
+		loader.addTask([this, name]() { return preloadWithTiming(STARTUP_GROUP_OBJECTS, [this, &name]() { return objectManager->preloadObjectData(name); }); },
+			[this, name]() { return transferWithTiming(STARTUP_GROUP_OBJECTS, [this, &name]() { ObjectRenderingData data; return objectManager->getRenderingData(name, data); }); });
+	}
+
+	//Particle objects are transfered later, they get cloned VAOs
+	for(auto &name: particleNames)
+	{
+		loader.addTask([this, name]() { return preloadWithTiming(STARTUP_GROUP_PARTICLES, [this, &name]() { return objectManager->preloadObjectData(name); }); },
+			[]() { return true; });
+	}
+
+	loader.start(static_cast<int>(thread::hardware_concurrency()) - 1); //Main thread does transfers
+
+	steady_clock::time_point lastSplashTime = steady_clock::now();
+	while(!loader.isFinished())
+	{
+		loader.processLoaded(LOADING_TRANSFER_BUDGET);
+		if(uploadService)
+		{
+			const steady_clock::time_point flushStart = steady_clock::now();
+			uploadService->flush();
+			StartupTimer::getInstance().addTime("Staging flush", "", steady_clock::now() - flushStart);
+		}
+
+		glfwPollEvents(); //Window must stay responsive
+
+		if(splashRenderer && steady_clock::now() - lastSplashTime >= SPLASH_FRAME_INTERVAL)
+		{
+			splashRenderer->render(loader.getProgress());
+			glfwSwapBuffers(window);
+
+			lastSplashTime = steady_clock::now();
+		}
+	}
+
+	if(loader.getFailedAmount() > 0)
+		Log::getInstance().warning(to_string(loader.getFailedAmount()) + " resources failed to load");
+}
+
 namespace
 {
 	void writeContextInfoLogMessages()
@@ -218,4 +447,28 @@ namespace
 		const unsigned char *renderer = glGetString(GL_RENDERER);
 		Log::getInstance().info(string("OpenGL renderer string: ") + reinterpret_cast<const char*>(renderer));
 	}
+
+	bool preloadWithTiming(const char *group, const function<bool()> &preload)
+	{
+		resetLoadTimes();
+
+		bool status = preload();
+
+		const LoadTimes times = getLoadTimes();
+		StartupTimer::getInstance().addTime(group, STARTUP_STEP_READING, times.readTime);
+		StartupTimer::getInstance().addTime(group, STARTUP_STEP_DECODING, times.decodeTime);
+
+		return status;
+	}
+
+	bool transferWithTiming(const char *group, const function<bool()> &transfer)
+	{
+		const steady_clock::time_point startTime = steady_clock::now();
+
+		bool status = transfer();
+
+		StartupTimer::getInstance().addTime(group, STARTUP_STEP_TRANSFER, steady_clock::now() - startTime);
+
+		return status;
+	}
 }
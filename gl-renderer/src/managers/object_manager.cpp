@@ -10,16 +10,11 @@
 #include <fstream>
 
 #include "log.h"
-#include "data/mesh.h"
-#include "data/texture.h"
 #include "graphics_lib/operations/mesh_operations.h"
-#include "graphics_lib/operations/texture_operations.h"
 #include "loaders/mesh_loader.h"
-#include "loaders/texture_loader.h"
 
 using namespace std;
 using namespace renderer;
-using namespace renderer::data;
 using namespace renderer::loaders;
 using namespace renderer::managers;
 using namespace renderer::graphics_lib;
@@ -36,8 +31,8 @@ namespace
 	const char *PATH_LIBRARIES = "objects/libraries";
 }
 
-ObjectManager::ObjectManager(const string &descriptionPath):
-	transferedBytes(0)
+ObjectManager::ObjectManager(const string &descriptionPath, const AssetArchive *archive, UploadService *uploadService):
+	resourceCache(archive, uploadService)
 {
 	bool status = initDescription(descriptionPath);
 	if(!status)
@@ -53,11 +48,11 @@ ObjectManager::~ObjectManager()
 
 	for(auto &current: meshIds)
 	{
-		deleteMesh(current.second);
-		deleteTexture(current.second.textureId);
+		resourceCache.releaseMesh(current.second.vaoId);
+		resourceCache.releaseTexture(current.second.textureId);
 
 		if(current.second.normalTextureId != -1u)
-			deleteTexture(current.second.normalTextureId);
+			resourceCache.releaseTexture(current.second.normalTextureId);
 	}
 }
 
@@ -111,9 +106,22 @@ bool ObjectManager::getRenderingDataWithClonedVbo(const string &name, ObjectRend
 	return true;
 }
 
-int ObjectManager::getTransferedBytesAmount()
+bool ObjectManager::preloadObjectData(const string &name)
 {
-	return transferedBytes;
+	auto iter = description.find(name);
+	if(iter == description.end())
+	{
+		Log::getInstance().error(string("Can't find description of \"") + name + "\" object");
+		return false;
+	}
+
+	bool status = resourceCache.preloadMesh(iter->second.meshPath);
+	status = resourceCache.preloadTexture(iter->second.texturePath) && status;
+
+	if(iter->second.normalmapPath != ABSENT_NORMALMAP_STRING)
+		status = resourceCache.preloadTexture(iter->second.normalmapPath) && status;
+
+	return status;
 }
 
 bool ObjectManager::isTextureTransparent(const std::string &name)
@@ -187,78 +195,45 @@ bool ObjectManager::initObjectData(const std::string &name)
 		return false;
 	}
 
-	//Load data
+	//Load data and submit to video card. Resources already used by other objects are shared
 
-	Mesh mesh;
-	bool status = loaders::loadMesh(iter->second.meshPath, mesh);
+	ObjectRenderingData objectIds;
+	bool status = resourceCache.acquireMesh(iter->second.meshPath, objectIds);
 	if(!status)
 	{
-		Log::getInstance().error("Can't load object mesh");
+		Log::getInstance().error("Can't get object mesh");
 		return false;
 	}
 
-	Texture texture;
-	status = loaders::loadTexture(iter->second.texturePath, texture);
+	int bytesPerPixel = 0;
+	status = resourceCache.acquireTexture(iter->second.texturePath, objectIds.textureId, bytesPerPixel);
 	if(!status)
 	{
-		Log::getInstance().error("Can't load object texture");
+		Log::getInstance().error("Can't get object texture");
+		resourceCache.releaseMesh(objectIds.vaoId);
 		return false;
 	}
 
-	if(texture.bytesPerPixel == 4)
+	if(bytesPerPixel == 4)
 		textureFlags[name] |= TEXTURE_ATTRIBUTE_TRANSPARENCY;
 
 	//Normalmap
-	Texture normalTexture;
 	if(iter->second.normalmapPath != ABSENT_NORMALMAP_STRING)
 	{
-		status = loaders::loadTexture(iter->second.normalmapPath, normalTexture);
+		int normalmapBytesPerPixel = 0;
+		status = resourceCache.acquireTexture(iter->second.normalmapPath, objectIds.normalTextureId, normalmapBytesPerPixel);
 		if(!status)
 		{
-			Log::getInstance().error("Can't load object normalmap texture");
+			Log::getInstance().error("Can't get object normalmap texture");
+			resourceCache.releaseMesh(objectIds.vaoId);
+			resourceCache.releaseTexture(objectIds.textureId);
 			return false;
 		}
 
 		textureFlags[name] |= TEXTURE_ATTRIBUTE_NORMALMAP;
 	}
 
-	//Submit to video card
-
-	ObjectRenderingData objectIds;
-	status = graphics_lib::operations::makeMesh(mesh, objectIds);
-	if(!status)
-	{
-		Log::getInstance().error("Can't create object mesh");
-		return false;
-	}
-
-	status = graphics_lib::operations::makeTexture(texture, objectIds.textureId);
-	if(!status)
-	{
-		Log::getInstance().error("Can't create object texture");
-		return false;
-	}
-
-	//Normalmap
-	if(textureFlags[name] & TEXTURE_ATTRIBUTE_NORMALMAP)
-	{
-		status = graphics_lib::operations::makeTexture(normalTexture, objectIds.normalTextureId);
-		if(!status)
-		{
-			Log::getInstance().error("Can't create object normalmap texture");
-			return false;
-		}
-	}
-
 	meshIds[name] = objectIds;
 
-	transferedBytes += mesh.vertices.size() * sizeof(float) + mesh.uvs.size() * sizeof(float) + mesh.normals.size() * sizeof(float);
-	transferedBytes += texture.width * texture.height * texture.bytesPerPixel;
-	if(textureFlags[name] & TEXTURE_ATTRIBUTE_NORMALMAP)
-	{
-		transferedBytes += mesh.tangent.size() * sizeof(float) + mesh.bitangent.size() * sizeof(float);
-		transferedBytes += normalTexture.width * normalTexture.height * normalTexture.bytesPerPixel;
-	}
-
 	return true;
 }
@@ -6,11 +6,16 @@
 
 #include "managers/particle_manager.h"
 
+#include <chrono>
+
 #include "log.h"
+#include "common_constants.h"
 #include "graphics_lib/operations/particle_operations.h"
+#include "startup_timer.h"
 #include "utils/instance_group_tools.h"
 
 using namespace std;
+using namespace std::chrono;
 using namespace renderer;
 using namespace renderer::data;
 using namespace renderer::graphics_lib::videocard_data;
@@ -23,7 +28,7 @@ namespace
 }
 
 ParticleManager::ParticleManager(TerrainManager *terrainMgr):
-	terrainManager(terrainMgr), transferedBytes(0)
+	terrainManager(terrainMgr)
 {
 
 }
@@ -44,11 +49,6 @@ bool ParticleManager::getRenderingData(const ParticleSet &particleSet, const Chu
 	return true;
 }
 
-int ParticleManager::getTransferedBytesAmount()
-{
-    return transferedBytes;
-}
-
 bool ParticleManager::initParticleData(const ParticleSet &particleSet, const ChunkData &chunk, ParticleRenderingData &data)
 {
     //Generate data
@@ -74,7 +74,9 @@ bool ParticleManager::initParticleData(const ParticleSet &particleSet, const Chu
     }
 
     //Submit to videocard
-    bool status = graphics_lib::operations::makeParticleGroup(arrangement, rotation, instanceAmount, data);
+    const steady_clock::time_point transferStart = steady_clock::now();
+    bool status = graphics_lib::operations::makeParticleGroup(arrangement, rotation, instanceAmount, particleSet.name, data);
+    StartupTimer::getInstance().addTime(STARTUP_GROUP_PARTICLES, STARTUP_STEP_TRANSFER, steady_clock::now() - transferStart);
     if(!status)
     {
         Log::getInstance().error("Can't create particle group");
@@ -86,7 +88,5 @@ bool ParticleManager::initParticleData(const ParticleSet &particleSet, const Chu
 
     groupIds.push_back(data);
 
-    transferedBytes += instanceAmount * sizeof(glm::vec3) + instanceAmount * sizeof(float);
-
     return true;
 }
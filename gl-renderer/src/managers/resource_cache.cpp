@@ -0,0 +1,520 @@
+/* resource_cache.cpp
+ * Shares meshes and textures between objects. Resources are found by file path or content hash and counted by references
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "managers/resource_cache.h"
+
+#include <chrono>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "log.h"
+#include "graphics_lib/operations/mesh_operations.h"
+#include "graphics_lib/operations/texture_operations.h"
+#include "loaders/load_timing.h"
+#include "loaders/mesh_loader.h"
+#include "loaders/texture_loader.h"
+#include "utils/hash_tools.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace renderer;
+using namespace renderer::data;
+using namespace renderer::loaders;
+using namespace renderer::managers;
+using namespace renderer::graphics_lib;
+using namespace renderer::graphics_lib::operations;
+using namespace renderer::graphics_lib::videocard_data;
+using namespace renderer::utils;
+
+namespace
+{
+	/*
+	@brief Hashes all mesh arrays
+	*/
+	uint64_t hashMesh(const MeshFileArrays &arrays);
+
+	/*
+	@brief Hashes texture dimensions and pixels
+	*/
+	uint64_t hashTexture(const TextureFilePixels &pixels);
+
+	/*
+	@brief Reserves staging ring regions for all arrays and copies them there
+	@return false if ring has no space now, nothing stays reserved then
+	*/
+	bool stageMesh(const MeshFileArrays &arrays, UploadService &uploadService, StagedMesh &mesh);
+
+	/*
+	@brief Reserves staging ring region and copies pixels there
+	@return false if ring has no space now
+	*/
+	bool stageTexture(const TextureFilePixels &pixels, UploadService &uploadService, StagedTexture &texture);
+
+	bool stageArray(const char *data, size_t size, UploadService &uploadService, StagingAllocation &allocation);
+
+	bool isSameMesh(const Mesh &first, const MeshFileArrays &second);
+	bool isSameTexture(const Texture &first, const TextureFilePixels &second);
+
+	bool isSameFloats(const vector<float> &first, const char *second, size_t secondSize);
+}
+
+ResourceCache::ResourceCache(const AssetArchive *archive, UploadService *uploader):
+	assetArchive(archive), uploadService(uploader)
+{
+}
+
+ResourceCache::~ResourceCache()
+{
+	//Ring is reclaimed in reservation order, regions of resources which were never acquired must be returned
+	for(auto &[path, loaded]: preloadedMeshes)
+	{
+		if(loaded.isStaged)
+			discardMesh(loaded.stagedMesh, *uploadService);
+	}
+
+	for(auto &[path, loaded]: preloadedTextures)
+	{
+		if(loaded.isStaged)
+			uploadService->discard(loaded.stagedTexture.pixels);
+	}
+
+	for(auto &[key, mesh]: meshes)
+		deleteMesh(mesh.meshIds);
+
+	for(auto &[key, texture]: textures)
+		deleteTexture(texture.textureId);
+}
+
+bool ResourceCache::preloadMesh(const string &path)
+{
+	{
+		lock_guard<mutex> lockGuard(preloadLock);
+		if(!requestedMeshPaths.insert(path).second)
+			return true;
+
+		pendingPaths.insert(path);
+	}
+
+	LoadedMesh loaded;
+	bool status = decodeMesh(path, loaded);
+	if(!status)
+		Log::getInstance().error(string("Can't preload mesh ") + path);
+
+	{
+		lock_guard<mutex> lockGuard(preloadLock);
+		if(status)
+			preloadedMeshes[path] = move(loaded);
+
+		pendingPaths.erase(path);
+	}
+	preloadCondition.notify_all();
+
+	return status;
+}
+
+bool ResourceCache::preloadTexture(const string &path)
+{
+	{
+		lock_guard<mutex> lockGuard(preloadLock);
+		if(!requestedTexturePaths.insert(path).second)
+			return true;
+
+		pendingPaths.insert(path);
+	}
+
+	LoadedTexture loaded;
+	bool status = decodeTexture(path, loaded);
+	if(!status)
+		Log::getInstance().error(string("Can't preload texture ") + path);
+
+	{
+		lock_guard<mutex> lockGuard(preloadLock);
+		if(status)
+			preloadedTextures[path] = move(loaded);
+
+		pendingPaths.erase(path);
+	}
+	preloadCondition.notify_all();
+
+	return status;
+}
+
+bool ResourceCache::acquireMesh(const string &path, ObjectRenderingData &meshIds)
+{
+	//Same file
+	auto pathIter = meshKeyByPath.find(path);
+	if(pathIter != meshKeyByPath.end())
+	{
+		CachedMesh &cached = meshes[pathIter->second];
+		cached.references++;
+		meshIds = cached.meshIds;
+		return true;
+	}
+
+	LoadedMesh loaded;
+	bool status = true;
+	if(!takePreloadedMesh(path, loaded))
+		status = decodeMesh(path, loaded);
+
+	if(!status)
+	{
+		Log::getInstance().error(string("Can't load mesh ") + path);
+		return false;
+	}
+
+	//Same content in another file
+	bool isCached = false;
+	uint64_t key = findMeshKey(loaded.hash, path, isCached);
+	if(isCached)
+	{
+		if(loaded.isStaged)
+			discardMesh(loaded.stagedMesh, *uploadService);
+
+		CachedMesh &cached = meshes[key];
+		meshKeyByPath[path] = key;
+		cached.references++;
+		meshIds = cached.meshIds;
+		return true;
+	}
+
+	CachedMesh cached;
+	if(loaded.isStaged)
+		status = makeMesh(loaded.stagedMesh, *uploadService, path, cached.meshIds);
+	else status = makeMesh(loaded.mesh, path, cached.meshIds);
+
+	if(!status)
+	{
+		Log::getInstance().error(string("Can't create mesh ") + path);
+		return false;
+	}
+
+	cached.references = 1;
+	cached.path = path;
+
+	meshes[key] = cached;
+	meshKeyByPath[path] = key;
+	meshKeyByVao[cached.meshIds.vaoId] = key;
+
+	meshIds = cached.meshIds;
+
+	return true;
+}
+
+bool ResourceCache::acquireTexture(const string &path, unsigned int &textureId, int &bytesPerPixel)
+{
+	//Same file
+	auto pathIter = textureKeyByPath.find(path);
+	if(pathIter != textureKeyByPath.end())
+	{
+		CachedTexture &cached = textures[pathIter->second];
+		cached.references++;
+		textureId = cached.textureId;
+		bytesPerPixel = cached.bytesPerPixel;
+		return true;
+	}
+
+	LoadedTexture loaded;
+	bool status = true;
+	if(!takePreloadedTexture(path, loaded))
+		status = decodeTexture(path, loaded);
+
+	if(!status)
+	{
+		Log::getInstance().error(string("Can't load texture ") + path);
+		return false;
+	}
+
+	//Same content in another file
+	bool isCached = false;
+	uint64_t key = findTextureKey(loaded.hash, path, isCached);
+	if(isCached)
+	{
+		if(loaded.isStaged)
+			uploadService->discard(loaded.stagedTexture.pixels);
+
+		CachedTexture &cached = textures[key];
+		textureKeyByPath[path] = key;
+		cached.references++;
+		textureId = cached.textureId;
+		bytesPerPixel = cached.bytesPerPixel;
+		return true;
+	}
+
+	CachedTexture cached;
+	if(loaded.isStaged)
+		status = makeTexture(loaded.stagedTexture, *uploadService, path, cached.textureId);
+	else status = makeTexture(loaded.texture, path, cached.textureId);
+
+	if(!status)
+	{
+		Log::getInstance().error(string("Can't create texture ") + path);
+		return false;
+	}
+
+	cached.bytesPerPixel = loaded.isStaged ? loaded.stagedTexture.bytesPerPixel: loaded.texture.bytesPerPixel;
+	cached.references = 1;
+	cached.path = path;
+
+	textures[key] = cached;
+	textureKeyByPath[path] = key;
+	textureKeyById[cached.textureId] = key;
+
+	textureId = cached.textureId;
+	bytesPerPixel = cached.bytesPerPixel;
+
+	return true;
+}
+
+void ResourceCache::releaseMesh(unsigned int vaoId)
+{
+	auto keyIter = meshKeyByVao.find(vaoId);
+	if(keyIter == meshKeyByVao.end())
+		return;
+
+	uint64_t key = keyIter->second;
+	auto iter = meshes.find(key);
+	if(--iter->second.references > 0)
+		return;
+
+	deleteMesh(iter->second.meshIds);
+
+	meshes.erase(iter);
+	meshKeyByVao.erase(keyIter);
+
+	for(auto pathIter = meshKeyByPath.begin(); pathIter != meshKeyByPath.end();)
+	{
+		if(pathIter->second == key)
+			pathIter = meshKeyByPath.erase(pathIter);
+		else pathIter++;
+	}
+}
+
+void ResourceCache::releaseTexture(unsigned int textureId)
+{
+	auto keyIter = textureKeyById.find(textureId);
+	if(keyIter == textureKeyById.end())
+		return;
+
+	uint64_t key = keyIter->second;
+	auto iter = textures.find(key);
+	if(--iter->second.references > 0)
+		return;
+
+	deleteTexture(iter->second.textureId);
+
+	textures.erase(iter);
+	textureKeyById.erase(keyIter);
+
+	for(auto pathIter = textureKeyByPath.begin(); pathIter != textureKeyByPath.end();)
+	{
+		if(pathIter->second == key)
+			pathIter = textureKeyByPath.erase(pathIter);
+		else pathIter++;
+	}
+}
+
+bool ResourceCache::decodeMesh(const string &path, LoadedMesh &loaded)
+{
+	MeshFileArrays arrays;
+	if(!loaders::mapMesh(path, assetArchive, arrays))
+		return false;
+
+	loaded.hash = hashMesh(arrays);
+
+	//Arrays are copied from file straight into staging ring, rendering thread only issues copy commands
+	const steady_clock::time_point decodeStart = steady_clock::now();
+	loaded.isStaged = uploadService && stageMesh(arrays, *uploadService, loaded.stagedMesh);
+	addDecodeTime(steady_clock::now() - decodeStart);
+
+	if(loaded.isStaged)
+		return true;
+
+	return loaders::loadMesh(path, assetArchive, loaded.mesh);
+}
+
+bool ResourceCache::decodeTexture(const string &path, LoadedTexture &loaded)
+{
+	TextureFilePixels pixels;
+	if(!loaders::mapTexture(path, assetArchive, pixels))
+		return false;
+
+	loaded.hash = hashTexture(pixels);
+
+	const steady_clock::time_point decodeStart = steady_clock::now();
+	loaded.isStaged = uploadService && stageTexture(pixels, *uploadService, loaded.stagedTexture);
+	addDecodeTime(steady_clock::now() - decodeStart);
+
+	if(loaded.isStaged)
+		return true;
+
+	return loaders::loadTexture(path, assetArchive, loaded.texture);
+}
+
+bool ResourceCache::takePreloadedMesh(const string &path, LoadedMesh &loaded)
+{
+	unique_lock<mutex> lock(preloadLock);
+	preloadCondition.wait(lock, [this, &path]() { return pendingPaths.find(path) == pendingPaths.end(); });
+
+	auto iter = preloadedMeshes.find(path);
+	if(iter == preloadedMeshes.end())
+		return false;
+
+	loaded = move(iter->second);
+	preloadedMeshes.erase(iter);
+
+	return true;
+}
+
+bool ResourceCache::takePreloadedTexture(const string &path, LoadedTexture &loaded)
+{
+	unique_lock<mutex> lock(preloadLock);
+	preloadCondition.wait(lock, [this, &path]() { return pendingPaths.find(path) == pendingPaths.end(); });
+
+	auto iter = preloadedTextures.find(path);
+	if(iter == preloadedTextures.end())
+		return false;
+
+	loaded = move(iter->second);
+	preloadedTextures.erase(iter);
+
+	return true;
+}
+
+uint64_t ResourceCache::findMeshKey(uint64_t hash, const string &path, bool &isCached)
+{
+	//Cached data isn't kept in memory, the first file is read again. Hash match means the same file content almost always
+	uint64_t key = hash;
+	for(auto iter = meshes.find(key); iter != meshes.end(); iter = meshes.find(++key))
+	{
+		//Cached mesh is copied before the new one is mapped, the next file reading replaces mapping of this thread
+		Mesh cachedMesh;
+		MeshFileArrays arrays;
+		if(loaders::loadMesh(iter->second.path, assetArchive, cachedMesh) && loaders::mapMesh(path, assetArchive, arrays) && isSameMesh(cachedMesh, arrays))
+		{
+			isCached = true;
+			return key;
+		}
+
+		Log::getInstance().warning(string("Mesh ") + iter->second.path + " has the same hash, but different content");
+	}
+
+	isCached = false;
+	return key;
+}
+
+uint64_t ResourceCache::findTextureKey(uint64_t hash, const string &path, bool &isCached)
+{
+	uint64_t key = hash;
+	for(auto iter = textures.find(key); iter != textures.end(); iter = textures.find(++key))
+	{
+		Texture cachedTexture;
+		TextureFilePixels pixels;
+		if(loaders::loadTexture(iter->second.path, assetArchive, cachedTexture) && loaders::mapTexture(path, assetArchive, pixels) && isSameTexture(cachedTexture, pixels))
+		{
+			isCached = true;
+			return key;
+		}
+
+		Log::getInstance().warning(string("Texture ") + iter->second.path + " has the same hash, but different content");
+	}
+
+	isCached = false;
+	return key;
+}
+
+namespace
+{
+	uint64_t hashMesh(const MeshFileArrays &arrays)
+	{
+		//Sizes are mixed in by hashData, so arrays don't merge into each other
+		uint64_t hash = hashData(&arrays.floatsPerVertex, sizeof(arrays.floatsPerVertex), 0);
+		hash = hashData(arrays.vertices, arrays.vertexSize, hash);
+		hash = hashData(arrays.uvs, arrays.uvSize, hash);
+		hash = hashData(arrays.normals, arrays.normalSize, hash);
+		hash = hashData(arrays.tangent, arrays.tangentSize, hash);
+		hash = hashData(arrays.bitangent, arrays.tangentSize, hash);
+
+		return hash;
+	}
+
+	uint64_t hashTexture(const TextureFilePixels &pixels)
+	{
+		const size_t size = static_cast<size_t>(pixels.width) * pixels.height * pixels.bytesPerPixel;
+
+		int dimensions[3] = {pixels.width, pixels.height, pixels.bytesPerPixel};
+		uint64_t hash = hashData(dimensions, sizeof(dimensions), 0);
+
+		return hashData(pixels.data, size, hash);
+	}
+
+	bool stageMesh(const MeshFileArrays &arrays, UploadService &uploadService, StagedMesh &mesh)
+	{
+		bool status = stageArray(arrays.vertices, arrays.vertexSize, uploadService, mesh.vertices);
+		status = status && stageArray(arrays.uvs, arrays.uvSize, uploadService, mesh.uvs);
+		status = status && stageArray(arrays.normals, arrays.normalSize, uploadService, mesh.normals);
+		status = status && stageArray(arrays.tangent, arrays.tangentSize, uploadService, mesh.tangent);
+		status = status && stageArray(arrays.bitangent, arrays.tangentSize, uploadService, mesh.bitangent);
+
+		if(!status)
+		{
+			discardMesh(mesh, uploadService);
+			mesh = StagedMesh();
+			return false;
+		}
+
+		mesh.floatsPerVertex = arrays.floatsPerVertex;
+
+		return true;
+	}
+
+	bool stageTexture(const TextureFilePixels &pixels, UploadService &uploadService, StagedTexture &texture)
+	{
+		if(!stageArray(pixels.data, pixels.size, uploadService, texture.pixels))
+			return false;
+
+		texture.width = pixels.width;
+		texture.height = pixels.height;
+		texture.bytesPerPixel = pixels.bytesPerPixel;
+
+		return true;
+	}
+
+	bool stageArray(const char *data, size_t size, UploadService &uploadService, StagingAllocation &allocation)
+	{
+		if(size == 0) //Absent array
+			return true;
+
+		if(!uploadService.reserve(size, allocation))
+			return false;
+
+		memcpy(allocation.data, data, size);
+
+		return true;
+	}
+
+	bool isSameMesh(const Mesh &first, const MeshFileArrays &second)
+	{
+		return first.floatsPerVertex == second.floatsPerVertex && isSameFloats(first.vertices, second.vertices, second.vertexSize) &&
+			isSameFloats(first.uvs, second.uvs, second.uvSize) && isSameFloats(first.normals, second.normals, second.normalSize) &&
+			isSameFloats(first.tangent, second.tangent, second.tangentSize) && isSameFloats(first.bitangent, second.bitangent, second.tangentSize);
+	}
+
+	bool isSameTexture(const Texture &first, const TextureFilePixels &second)
+	{
+		if(first.width != second.width || first.height != second.height || first.bytesPerPixel != second.bytesPerPixel)
+			return false;
+
+		const size_t size = static_cast<size_t>(first.width) * first.height * first.bytesPerPixel;
+		return memcmp(first.data.get(), second.data, size) == 0;
+	}
+
+	bool isSameFloats(const vector<float> &first, const char *second, size_t secondSize)
+	{
+		//Bytes are compared as they are hashed
+		return first.size() * sizeof(float) == secondSize && (secondSize == 0 || memcmp(first.data(), second, secondSize) == 0);
+	}
+}
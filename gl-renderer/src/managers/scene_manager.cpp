@@ -6,6 +6,8 @@
 
 #include "managers/scene_manager.h"
 
+#include <random>
+
 #include "log.h"
 #include "loaders/scene_loader.h"
 
@@ -18,7 +20,28 @@ using namespace renderer::loaders;
 namespace
 {
 	const char *DEFERRED_RENDERER_STRING = "deferred";
+	const char *FORWARD_PLUS_RENDERER_STRING = "forward-plus";
 	const char *NO_EFFECT_STRING = "--";
+
+	//Generated point lights
+	constexpr unsigned int GENERATED_LIGHTS_SEED = 1234;
+	constexpr float GENERATED_LIGHT_HEIGHT = 1.5f; //Above terrain
+	constexpr float GENERATED_LIGHT_POWER = 0.5f;
+	constexpr int GENERATED_LIGHT_MIN_COLOUR = 96;
+	constexpr int GENERATED_LIGHT_COLOUR_RANGE = 256 - GENERATED_LIGHT_MIN_COLOUR;
+
+	constexpr int RANDOM_SHIFT = 8; //32-bit generator output to 24 bits
+	constexpr float RANDOM_RANGE = 16777216.f; //2^24
+
+	/*
+	@brief Returns value in [0; 1). Distributions of <random> differ between standard libraries, raw output of mt19937 doesn't
+	*/
+	float getRandomUnit(mt19937 &generator);
+
+	/*
+	@brief Returns colour component in [GENERATED_LIGHT_MIN_COLOUR; 255]
+	*/
+	int getRandomColour(mt19937 &generator);
 }
 
 SceneManager::SceneManager(const string &scenePath)
@@ -109,6 +132,21 @@ bool SceneManager::isDeferredRendering() const
 	return scene.rendererType == DEFERRED_RENDERER_STRING;
 }
 
+bool SceneManager::isForwardPlusRendering() const
+{
+	return scene.rendererType == FORWARD_PLUS_RENDERER_STRING;
+}
+
+bool SceneManager::isDepthPrepassEnabled() const
+{
+	return scene.depthPrepass;
+}
+
+bool SceneManager::isWeightedBlendedTransparency() const
+{
+	return scene.weightedBlendedTransparency;
+}
+
 void SceneManager::appendChunkDimensions(TerrainManager *terrainManager)
 {
 	if(!terrainManager)
@@ -121,6 +159,35 @@ void SceneManager::appendChunkDimensions(TerrainManager *terrainManager)
 	}
 }
 
+void SceneManager::generatePointLights(int amount, TerrainManager *terrainManager)
+{
+	if(!terrainManager || scene.chunks.empty())
+		return;
+
+	scene.pointLights.clear();
+	scene.pointLights.reserve(amount);
+
+	mt19937 generator(GENERATED_LIGHTS_SEED);
+
+	const int chunkAmount = scene.chunks.size();
+	for(int i = 0; i < amount; i++)
+	{
+		const ChunkData &chunk = scene.chunks[i % chunkAmount];
+
+		float x = chunk.x + getRandomUnit(generator) * chunk.size;
+		float z = chunk.z - getRandomUnit(generator) * chunk.size; //Chunk spreads to negative Z
+		float y = terrainManager->getHeight(chunk.x, chunk.z, chunk.name, x, z) + GENERATED_LIGHT_HEIGHT;
+
+		int red = getRandomColour(generator);
+		int green = getRandomColour(generator);
+		int blue = getRandomColour(generator);
+
+		scene.pointLights.push_back(PointLight(x, y, z, GENERATED_LIGHT_POWER, red, green, blue));
+	}
+
+	Log::getInstance().info(to_string(amount) + " point lights are generated");
+}
+
 void SceneManager::initialize(const string &scenePath)
 {
 	bool status = loadScene(scenePath, scene);
@@ -129,3 +196,17 @@ void SceneManager::initialize(const string &scenePath)
 		Log::getInstance().error(string("Error initializing scene \"") + scenePath + "\"");
 	}
 }
+
+namespace
+{
+	float getRandomUnit(mt19937 &generator)
+	{
+		return (generator() >> RANDOM_SHIFT) / RANDOM_RANGE; //24 bits fit float mantissa exactly
+	}
+
+	int getRandomColour(mt19937 &generator)
+	{
+		//Scaled unit keeps components evenly distributed, modulo of generator output would favour lower values
+		return GENERATED_LIGHT_MIN_COLOUR + static_cast<int>(getRandomUnit(generator) * GENERATED_LIGHT_COLOUR_RANGE);
+	}
+}
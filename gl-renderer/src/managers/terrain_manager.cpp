@@ -58,8 +58,8 @@ namespace
 
 
 
-TerrainManager::TerrainManager(const string &descriptionPath):
-	transferedBytes(0)
+TerrainManager::TerrainManager(const string &descriptionPath, const AssetArchive *archive):
+	assetArchive(archive)
 {
 	initDescription(descriptionPath);
 }
@@ -79,12 +79,67 @@ float TerrainManager::getChunkDimensions(const string &chunkName)
 
 	auto descriptionIter = description.find(chunkName);
 
-	float width = readChunkDimensions(descriptionIter->second.meshPath);
+	float width = readChunkDimensions(descriptionIter->second.meshPath, assetArchive);
 	dimensions[chunkName] = width;
 
 	return width;
 }
 
+bool TerrainManager::preloadChunk(const string &name)
+{
+	auto iter = description.find(name);
+	if(iter == description.end())
+	{
+		Log::getInstance().error(string("Can't find description of \"") + name + "\" chunk");
+		return false;
+	}
+
+	PreloadedChunk chunk;
+	bool status = loadTerrain(iter->second.meshPath, assetArchive, chunk.mesh, chunk.heightmap, chunk.sideLength);
+	if(!status)
+	{
+		Log::getInstance().error("Can't preload terrain mesh");
+		return false;
+	}
+
+	status = loaders::loadTexture(iter->second.texturePath, assetArchive, chunk.texture);
+	if(!status)
+	{
+		Log::getInstance().error("Can't preload terrain texture");
+		return false;
+	}
+
+	lock_guard<mutex> lockGuard(preloadLock);
+	preloadedChunks[name] = move(chunk);
+
+	return true;
+}
+
+bool TerrainManager::loadHeightmap(const string &name)
+{
+	auto iter = description.find(name);
+	if(iter == description.end())
+	{
+		Log::getInstance().error(string("Can't find description of \"") + name + "\" chunk");
+		return false;
+	}
+
+	Mesh mesh;
+	Heightmap chunkHeightmap;
+	float sideLength = 0.f;
+	bool status = loadTerrain(iter->second.meshPath, assetArchive, mesh, chunkHeightmap, sideLength);
+	if(!status)
+	{
+		Log::getInstance().error("Can't load terrain mesh");
+		return false;
+	}
+
+	heightmap[name] = move(chunkHeightmap);
+	dimensions[name] = sideLength;
+
+	return true;
+}
+
 bool TerrainManager::getRenderingData(const string &name, ObjectRenderingData &data)
 {
 	auto iter = chunkIds.find(name);
@@ -196,11 +251,6 @@ float TerrainManager::getHeight(float xOffset, float zOffset, const string &chun
 	return targetHeight;
 }
 
-int TerrainManager::getTransferedBytesAmount() const
-{
-	return transferedBytes;
-}
-
 void TerrainManager::initDescription(const string &descriptionPath)
 {
 	loadTerrainDescription(descriptionPath, description);
@@ -215,24 +265,44 @@ bool TerrainManager::initTerrainData(const string &chunkName)
 		return false;
 	}
 
-	//Load data
+	//Load data or take preloaded one
 
 	Mesh chunk;
 	Heightmap currentHeightmap;
-	float sideLength = 0;
-	bool status = loadTerrain(iter->second.meshPath, chunk, currentHeightmap, sideLength);
-	if(!status)
+	Texture texture;
+	bool isPreloaded = false;
 	{
-		Log::getInstance().error("Can't load terrain mesh");
-		return false;
+		lock_guard<mutex> lockGuard(preloadLock);
+
+		auto preloadedIter = preloadedChunks.find(chunkName);
+		if(preloadedIter != preloadedChunks.end())
+		{
+			chunk = move(preloadedIter->second.mesh);
+			currentHeightmap = move(preloadedIter->second.heightmap);
+			texture = preloadedIter->second.texture;
+			preloadedChunks.erase(preloadedIter);
+
+			isPreloaded = true;
+		}
 	}
 
-	Texture texture;
-	status = loaders::loadTexture(iter->second.texturePath, texture);
-	if(!status)
+	bool status = true;
+	if(!isPreloaded)
 	{
-		Log::getInstance().error("Can't load terrain texture");
-		return false;
+		float sideLength = 0;
+		status = loadTerrain(iter->second.meshPath, assetArchive, chunk, currentHeightmap, sideLength);
+		if(!status)
+		{
+			Log::getInstance().error("Can't load terrain mesh");
+			return false;
+		}
+
+		status = loaders::loadTexture(iter->second.texturePath, assetArchive, texture);
+		if(!status)
+		{
+			Log::getInstance().error("Can't load terrain texture");
+			return false;
+		}
 	}
 
 	heightmap[chunkName] = move(currentHeightmap);
@@ -240,14 +310,14 @@ bool TerrainManager::initTerrainData(const string &chunkName)
 	//Pass to video card
 
 	ObjectRenderingData terrainIds;
-	status = graphics_lib::operations::makeTerrain(chunk, terrainIds);
+	status = graphics_lib::operations::makeTerrain(chunk, chunkName, terrainIds);
 	if(!status)
 	{
 		Log::getInstance().error("Can't create terrain mesh");
 		return false;
 	}
 
-	status = graphics_lib::operations::makeTexture(texture, terrainIds.textureId);
+	status = graphics_lib::operations::makeTexture(texture, iter->second.texturePath, terrainIds.textureId);
 	if(!status)
 	{
 		Log::getInstance().error("Can't create terrain texture");
@@ -255,9 +325,6 @@ bool TerrainManager::initTerrainData(const string &chunkName)
 	}
 	chunkIds[chunkName] = terrainIds;
 
-	transferedBytes += chunk.vertices.size() * sizeof(float) + chunk.uvs.size() * sizeof(float) + chunk.normals.size() * sizeof(float);
-	transferedBytes += texture.width * texture.height * texture.bytesPerPixel;
-
 	return true;
 }
 
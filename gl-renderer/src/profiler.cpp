@@ -0,0 +1,196 @@
+/* profiler.cpp
+ * CPU profiler with scoped zones, implemented as Singleton. Capture is exported as Chrome trace
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+#include "log.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace renderer;
+
+namespace
+{
+	constexpr double NANOSECONDS_IN_MICROSECOND = 1000.;
+	constexpr float NANOSECONDS_IN_MILLISECOND = 1000000.f;
+
+	thread_local void *currentThreadEvents = nullptr; //Profiler::ThreadEvents of the calling thread
+}
+
+Profiler& Profiler::getInstance()
+{
+	static Profiler instance; //Constructed on the first call
+
+	return instance;
+}
+
+uint64_t Profiler::getTime() const
+{
+	return duration_cast<nanoseconds>(steady_clock::now() - creationTime).count();
+}
+
+void Profiler::addEvent(const char *name, uint64_t startTime, uint64_t endTime)
+{
+	ThreadEvents *events = getThreadEvents();
+
+	//Flag is set before pause is checked and export sets pause before it checks flags, so one of them always sees the other
+	events->isWriting.store(true);
+	if(isPaused.load())
+	{
+		events->isWriting.store(false, memory_order_release);
+		return;
+	}
+
+	uint64_t index = events->writtenAmount.load(memory_order_relaxed);
+	events->events[index % THREAD_EVENT_CAPACITY] = {name, startTime, endTime - startTime};
+
+	events->writtenAmount.store(index + 1, memory_order_release); //Event is complete before export can see it
+	events->isWriting.store(false, memory_order_release);
+}
+
+void Profiler::getThreadZoneTimes(uint64_t sinceTime, vector<pair<const char*, float>> &zoneTimes) const
+{
+	zoneTimes.clear();
+
+	if(!currentThreadEvents) //Nothing is recorded, e.g. zones are compiled out
+		return;
+
+	const ThreadEvents *events = static_cast<const ThreadEvents*>(currentThreadEvents);
+
+	uint64_t end = events->writtenAmount.load(memory_order_relaxed);
+	uint64_t begin = (end > THREAD_EVENT_CAPACITY) ? end - THREAD_EVENT_CAPACITY : 0;
+
+	for(uint64_t i = begin; i < end; i++)
+	{
+		const ProfilerEvent &event = events->events[i % THREAD_EVENT_CAPACITY];
+		if(event.startTime < sinceTime)
+			continue;
+
+		auto iter = find_if(zoneTimes.begin(), zoneTimes.end(), [&event](const pair<const char*, float> &zone) { return strcmp(zone.first, event.name) == 0; });
+		if(iter == zoneTimes.end())
+			zoneTimes.emplace_back(event.name, event.duration / NANOSECONDS_IN_MILLISECOND);
+		else iter->second += event.duration / NANOSECONDS_IN_MILLISECOND;
+	}
+}
+
+void Profiler::setThreadName(const char *name)
+{
+	getThreadEvents()->threadName.store(name, memory_order_release);
+}
+
+bool Profiler::exportChromeTrace(const string &path)
+{
+	ofstream data(path);
+	if(!data.is_open())
+	{
+		Log::getInstance().error(string("Can't open ") + path + " for writing");
+		return false;
+	}
+
+	lock_guard<mutex> lockGuard(registrationLock);
+
+	//Rings aren't overwritten while they are read
+	isPaused.store(true);
+	for(auto &current: threadEvents)
+	{
+		while(current->isWriting.load(memory_order_acquire))
+			this_thread::yield();
+	}
+
+	uint64_t eventAmount = 0;
+
+	data << fixed << setprecision(3);
+	data << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+
+	bool isFirst = true;
+	for(auto &current: threadEvents)
+	{
+		const char *threadName = current->threadName.load(memory_order_acquire);
+		if(threadName)
+		{
+			data << (isFirst ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << current->threadIndex << ", \"args\": {\"name\": \"" <<
+				threadName << "\"}}";
+			isFirst = false;
+		}
+
+		uint64_t end = current->writtenAmount.load(memory_order_acquire);
+		uint64_t begin = (end > THREAD_EVENT_CAPACITY) ? end - THREAD_EVENT_CAPACITY : 0;
+
+		for(uint64_t i = begin; i < end; i++)
+		{
+			const ProfilerEvent &event = current->events[i % THREAD_EVENT_CAPACITY];
+
+			data << (isFirst ? "" : ",\n") << "{\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << current->threadIndex << ", \"ts\": " <<
+				event.startTime / NANOSECONDS_IN_MICROSECOND << ", \"dur\": " << event.duration / NANOSECONDS_IN_MICROSECOND << "}";
+			isFirst = false;
+		}
+
+		eventAmount += end - begin;
+	}
+
+	data << "\n]}\n";
+
+	isPaused.store(false);
+
+	if(!data)
+	{
+		Log::getInstance().error(string("Can't write ") + path);
+		return false;
+	}
+
+	if(eventAmount == 0)
+		Log::getInstance().warning("Profiler has no events, zones are compiled with RENDERER_PROFILING only");
+
+	Log::getInstance().info(string("Profiler capture is written to ") + path + ", " + to_string(eventAmount) + " events");
+
+	return true;
+}
+
+Profiler::Profiler():
+	creationTime(steady_clock::now()), isPaused(false)
+{
+}
+
+Profiler::~Profiler()
+{
+}
+
+Profiler::ThreadEvents* Profiler::getThreadEvents()
+{
+	if(currentThreadEvents)
+		return static_cast<ThreadEvents*>(currentThreadEvents);
+
+	unique_ptr<ThreadEvents> events = make_unique<ThreadEvents>();
+	events->threadName = nullptr;
+	events->events = make_unique<ProfilerEvent[]>(THREAD_EVENT_CAPACITY);
+	events->writtenAmount = 0;
+	events->isWriting = false;
+
+	lock_guard<mutex> lockGuard(registrationLock);
+
+	events->threadIndex = threadEvents.size();
+	currentThreadEvents = events.get();
+	threadEvents.push_back(move(events));
+
+	return static_cast<ThreadEvents*>(currentThreadEvents);
+}
+
+ProfilerZone::ProfilerZone(const char *zoneName):
+	name(zoneName), startTime(Profiler::getInstance().getTime())
+{
+}
+
+ProfilerZone::~ProfilerZone()
+{
+	Profiler& profiler = Profiler::getInstance();
+	profiler.addEvent(name, startTime, profiler.getTime());
+}
@@ -7,8 +7,11 @@
 #include "simulation/simulation_thread.h"
 
 #include <chrono>
+#include <cmath>
 #include <unistd.h>
 
+#include "profiler.h"
+
 using namespace std;
 using namespace std::chrono;
 using namespace renderer::simulation;
@@ -38,81 +41,81 @@ namespace
 
 void renderer::simulation::performSimulation(SimulationModel &model, bool &needTerminate)
 {
+	PROFILE_THREAD_NAME("Simulation");
+
 	steady_clock::time_point startTime = steady_clock::now();
 
 	while(true)
 	{
+		steady_clock::time_point iterationStartTime = steady_clock::now();
+
+		if(needTerminate)
+			break;
+
+		simulateAtTime(model, duration_cast<milliseconds>(iterationStartTime - startTime).count() / TIME_MILLISECONDS_IN_SECOND);
+
 		steady_clock::time_point currentTime = steady_clock::now();
-		steady_clock::time_point iterationStartTime = currentTime;
+		usleep((duration_cast<milliseconds>(currentTime - iterationStartTime).count() + SIMULATION_MILLISECONDS_PER_UPDATE) * TIME_MICROSECONDS_IN_MILLISECOND);
+	}
 
-		double currentT = (duration_cast<milliseconds>(currentTime - startTime).count() / TIME_MILLISECONDS_IN_SECOND) / SIMULATION_DAY_AND_NIGHT_PERIOD;
+}
 
-		if(currentT >= 1.f)
-		{
-			startTime = steady_clock::now();
-			currentT = 0;
-		}
+void renderer::simulation::simulateAtTime(SimulationModel &model, double seconds)
+{
+	PROFILE_ZONE("simulation::simulateAtTime");
 
-		if(needTerminate)
-			break;
+	double currentT = fmod(seconds / SIMULATION_DAY_AND_NIGHT_PERIOD, 1.);
 
-		bool isDay = false;
-		float sunRaysInterpoation = 0;
+	bool isDay = false;
+	float sunRaysInterpoation = 0;
 
-		bool isMorningGoldenHour = false, isEveningGoldenHour = false;
-		float goldenHourInterpolation = 0;
+	bool isMorningGoldenHour = false, isEveningGoldenHour = false;
+	float goldenHourInterpolation = 0;
 
-		bool isDawnTwilight = false, isDuskTwilight = false;
-		float twilightInterpolation = 0;
+	bool isDawnTwilight = false, isDuskTwilight = false;
+	float twilightInterpolation = 0;
 
-		if((SIMULATION_SUNRISE_TIME < currentT) && (currentT <= SIMULATION_SUNSET_TIME)) //Day
-		{
-			isDay = true;
-			sunRaysInterpoation = (currentT - SIMULATION_SUNRISE_TIME) / SIMULATION_DAY_PERIOD;
-
-			if((SIMULATION_SUNRISE_TIME < currentT) && (currentT <= SIMULATION_MORNING_GOLDEN_HOUR_TIME)) //Morning golden hour
-			{
-				isMorningGoldenHour = true;
-				goldenHourInterpolation = (currentT - SIMULATION_SUNRISE_TIME) / SIMULATION_GOLDEN_HOUR_PERIOD;
-			}
-			else if((SIMULATION_EVENING_GOLDEN_HOUR_TIME < currentT) && (currentT <= SIMULATION_SUNSET_TIME)) //Evening golden hour
-			{
-				isEveningGoldenHour = true;
-				goldenHourInterpolation = (currentT - SIMULATION_EVENING_GOLDEN_HOUR_TIME) / SIMULATION_GOLDEN_HOUR_PERIOD;
-			}
-		}
+	if((SIMULATION_SUNRISE_TIME < currentT) && (currentT <= SIMULATION_SUNSET_TIME)) //Day
+	{
+		isDay = true;
+		sunRaysInterpoation = (currentT - SIMULATION_SUNRISE_TIME) / SIMULATION_DAY_PERIOD;
 
-		if((SIMULATION_DAWN_TWILIGHT_TIME < currentT) && (currentT <= SIMULATION_SUNRISE_TIME)) //Morning twilight
+		if((SIMULATION_SUNRISE_TIME < currentT) && (currentT <= SIMULATION_MORNING_GOLDEN_HOUR_TIME)) //Morning golden hour
 		{
-			isDawnTwilight = true;
-			twilightInterpolation = (currentT - SIMULATION_DAWN_TWILIGHT_TIME) / SIMULATION_TWILIGHT_PERIOD;
+			isMorningGoldenHour = true;
+			goldenHourInterpolation = (currentT - SIMULATION_SUNRISE_TIME) / SIMULATION_GOLDEN_HOUR_PERIOD;
 		}
-		if((SIMULATION_SUNSET_TIME < currentT) && (currentT <= SIMULATION_DUSK_TWILIGHT_TIME)) //Evening twilight
+		else if((SIMULATION_EVENING_GOLDEN_HOUR_TIME < currentT) && (currentT <= SIMULATION_SUNSET_TIME)) //Evening golden hour
 		{
-			isDuskTwilight = true;
-			twilightInterpolation = (currentT - SIMULATION_SUNSET_TIME) / SIMULATION_TWILIGHT_PERIOD;
+			isEveningGoldenHour = true;
+			goldenHourInterpolation = (currentT - SIMULATION_EVENING_GOLDEN_HOUR_TIME) / SIMULATION_GOLDEN_HOUR_PERIOD;
 		}
+	}
 
-		{
-			lock_guard<mutex> lockGuard(model.accessLock);
-
-			model.time = currentT;
-			model.isDay = isDay;
-			model.sunRaysInterpolation = sunRaysInterpoation;
+	if((SIMULATION_DAWN_TWILIGHT_TIME < currentT) && (currentT <= SIMULATION_SUNRISE_TIME)) //Morning twilight
+	{
+		isDawnTwilight = true;
+		twilightInterpolation = (currentT - SIMULATION_DAWN_TWILIGHT_TIME) / SIMULATION_TWILIGHT_PERIOD;
+	}
+	if((SIMULATION_SUNSET_TIME < currentT) && (currentT <= SIMULATION_DUSK_TWILIGHT_TIME)) //Evening twilight
+	{
+		isDuskTwilight = true;
+		twilightInterpolation = (currentT - SIMULATION_SUNSET_TIME) / SIMULATION_TWILIGHT_PERIOD;
+	}
 
-			model.isMorningGoldenHour = isMorningGoldenHour;
-			model.isEveningGoldenHour = isEveningGoldenHour;
-			model.goldenHourInterpolation = goldenHourInterpolation;
+	lock_guard<mutex> lockGuard(model.accessLock);
 
-			model.isDawnTwilight = isDawnTwilight;
-			model.isDuskTwilight = isDuskTwilight;
-			model.twilightInterpolation = twilightInterpolation;
+	model.time = currentT;
+	model.isDay = isDay;
+	model.sunRaysInterpolation = sunRaysInterpoation;
 
-			model.wasUpdated = true;
-		}
+	model.isMorningGoldenHour = isMorningGoldenHour;
+	model.isEveningGoldenHour = isEveningGoldenHour;
+	model.goldenHourInterpolation = goldenHourInterpolation;
 
-		currentTime = steady_clock::now();
-		usleep((duration_cast<milliseconds>(currentTime - iterationStartTime).count() + SIMULATION_MILLISECONDS_PER_UPDATE) * TIME_MICROSECONDS_IN_MILLISECOND);
-	}
+	model.isDawnTwilight = isDawnTwilight;
+	model.isDuskTwilight = isDuskTwilight;
+	model.twilightInterpolation = twilightInterpolation;
 
+	model.wasUpdated = true;
 }
@@ -0,0 +1,206 @@
+/* startup_timer.cpp
+ * Startup phase timing, implemented as Singleton. Phases are logged as a tree and appended to report file
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "startup_timer.h"
+
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+
+#include "log.h"
+#include "utils/json_tools.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace renderer;
+using namespace renderer::utils;
+
+namespace
+{
+	constexpr int LOG_INDENT = 2;
+
+
+
+	double toMilliseconds(steady_clock::duration time);
+}
+
+StartupTimer& StartupTimer::getInstance()
+{
+	static StartupTimer instance; //Constructed on the first call
+
+	return instance;
+}
+
+StartupTimer::StartupTimer():
+	isFinished(false)
+{
+}
+
+void StartupTimer::beginPhase(const string &name)
+{
+	lock_guard<mutex> lockGuard(phaseLock);
+	if(isFinished)
+		return;
+
+	int index = findOrAddChild(activePhases.empty() ? -1 : activePhases.back(), name, false);
+	phases[index].start = steady_clock::now();
+
+	activePhases.push_back(index);
+}
+
+void StartupTimer::endPhase()
+{
+	lock_guard<mutex> lockGuard(phaseLock);
+	if(isFinished)
+		return;
+
+	endActivePhase();
+}
+
+void StartupTimer::addTime(const string &group, const string &name, steady_clock::duration time)
+{
+	lock_guard<mutex> lockGuard(phaseLock);
+	if(isFinished || activePhases.empty())
+		return;
+
+	//Group keeps the sum of its children, calls are counted by children
+	int groupIndex = findOrAddChild(activePhases.back(), group, true);
+	phases[groupIndex].time += time;
+
+	int index = name.empty() ? groupIndex : findOrAddChild(groupIndex, name, true);
+	if(index != groupIndex)
+		phases[index].time += time;
+	phases[index].callAmount++;
+}
+
+void StartupTimer::finish(const string &reportPath, const string &scenePath)
+{
+	{
+		lock_guard<mutex> lockGuard(phaseLock);
+		if(isFinished)
+			return;
+
+		while(!activePhases.empty())
+			endActivePhase();
+
+		isFinished = true; //Phases aren't changed anymore, no lock is needed below
+	}
+
+	Log::getInstance().info("Startup phases, ms (* - sum of separate measurements, loader threads included):");
+
+	const int phaseAmount = phases.size();
+	for(int i = 0; i < phaseAmount; i++)
+	{
+		if(phases[i].parent == -1)
+			logPhase(i, 0);
+	}
+
+	ofstream data(reportPath, ios::out | ios::app);
+	if(!data.is_open())
+	{
+		Log::getInstance().error(string("Can't open ") + reportPath);
+		return;
+	}
+
+	time_t now = time(nullptr);
+
+	data << fixed << setprecision(3);
+	data << "{\"date\": \"" << put_time(localtime(&now), "%Y-%m-%dT%H:%M:%S") << "\", \"scene\": \"" << escapeJsonString(scenePath) << "\", \"phases\": [";
+
+	bool isFirst = true;
+	for(int i = 0; i < phaseAmount; i++)
+	{
+		if(phases[i].parent == -1)
+			writePhase(data, i, "", isFirst);
+	}
+
+	data << "]}\n";
+
+	if(!data)
+		Log::getInstance().error(string("Can't write ") + reportPath);
+}
+
+int StartupTimer::findOrAddChild(int parent, const string &name, bool isSummed)
+{
+	const int phaseAmount = phases.size();
+	for(int i = 0; i < phaseAmount; i++)
+	{
+		if(phases[i].parent == parent && phases[i].name == name)
+			return i;
+	}
+
+	phases.push_back({name, parent, steady_clock::time_point(), steady_clock::duration::zero(), 0, isSummed});
+
+	return phaseAmount;
+}
+
+void StartupTimer::endActivePhase()
+{
+	if(activePhases.empty())
+		return;
+
+	Phase &phase = phases[activePhases.back()];
+	phase.time += steady_clock::now() - phase.start;
+	phase.callAmount++; //The same phase may be entered several times, e.g. description loading
+
+	activePhases.pop_back();
+}
+
+void StartupTimer::logPhase(int index, int depth) const
+{
+	const Phase &phase = phases[index];
+
+	stringstream message;
+	message << string(depth * LOG_INDENT, ' ') << phase.name << (phase.isSummed ? "*" : "") << ": " << fixed << setprecision(1) << toMilliseconds(phase.time);
+	if(phase.callAmount > 1)
+		message << " (" << phase.callAmount << " calls)";
+	Log::getInstance().info(message.str());
+
+	const int phaseAmount = phases.size();
+	for(int i = index + 1; i < phaseAmount; i++) //Children are always added after parent
+	{
+		if(phases[i].parent == index)
+			logPhase(i, depth + 1);
+	}
+}
+
+void StartupTimer::writePhase(ofstream &data, int index, const string &path, bool &isFirst) const
+{
+	const Phase &phase = phases[index];
+	const string phasePath = path.empty() ? phase.name : path + '/' + phase.name;
+
+	if(!isFirst)
+		data << ", ";
+	isFirst = false;
+
+	data << "{\"path\": \"" << escapeJsonString(phasePath) << "\", \"ms\": " << toMilliseconds(phase.time) << ", \"calls\": " << phase.callAmount
+		<< ", \"summed\": " << (phase.isSummed ? "true" : "false") << "}";
+
+	const int phaseAmount = phases.size();
+	for(int i = index + 1; i < phaseAmount; i++)
+	{
+		if(phases[i].parent == index)
+			writePhase(data, i, phasePath, isFirst);
+	}
+}
+
+StartupPhase::StartupPhase(const string &name)
+{
+	StartupTimer::getInstance().beginPhase(name);
+}
+
+StartupPhase::~StartupPhase()
+{
+	StartupTimer::getInstance().endPhase();
+}
+
+namespace
+{
+	double toMilliseconds(steady_clock::duration time)
+	{
+		return duration<double, milli>(time).count();
+	}
+}
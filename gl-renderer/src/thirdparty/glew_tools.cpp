@@ -13,7 +13,18 @@ using namespace renderer::thirdparty;
 
 bool renderer::thirdparty::initGlew()
 {
-	if(glewInit() != GLEW_OK)
+	GLenum status = glewInit();
+
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	//Headless contexts have no GLX display, but core entry points are loaded anyway
+	if(status == GLEW_ERROR_NO_GLX_DISPLAY)
+	{
+		Log::getInstance().warning("GLEW found no GLX display, context is headless");
+		status = GLEW_OK;
+	}
+#endif
+
+	if(status != GLEW_OK)
 	{
 		Log::getInstance().error("Can't initialize GLEW");
 		return false;
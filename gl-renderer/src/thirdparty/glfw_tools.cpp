@@ -14,6 +14,8 @@ using namespace renderer::thirdparty;
 namespace
 {
 	constexpr int CONTEXT_GLFW_SAMPLES_AMOUNT = 4;
+	constexpr int CONTEXT_GLFW_DEPTH_BITS = 24; //Renderer targets are GL_DEPTH24_STENCIL8, depth is blitted between them and screen
+	constexpr int CONTEXT_GLFW_STENCIL_BITS = 8;
 	constexpr int CONTEXT_GLFW_OGL_MAJOR_VERSION = 4;
 	constexpr int CONTEXT_GLFW_OGL_MINOR_VERSION = 5;
 
@@ -30,6 +32,11 @@ bool renderer::thirdparty::initGlfw(const AppParameters &appParameters, GLFWwind
 		return false;
 	}
 
+#ifdef GLFW_PLATFORM_NULL //GLFW 3.4+
+	if(appParameters.isBenchmarkMode)
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL); //No display server is needed
+#endif
+
 	if(!glfwInit())
 	{
 		Log::getInstance().error("Can't initialize GLFW");
@@ -39,12 +46,33 @@ bool renderer::thirdparty::initGlfw(const AppParameters &appParameters, GLFWwind
 	if(appParameters.useSmoothing)
 		glfwWindowHint(GLFW_SAMPLES, CONTEXT_GLFW_SAMPLES_AMOUNT);
 
+	glfwWindowHint(GLFW_DEPTH_BITS, CONTEXT_GLFW_DEPTH_BITS);
+	glfwWindowHint(GLFW_STENCIL_BITS, CONTEXT_GLFW_STENCIL_BITS);
+
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, CONTEXT_GLFW_OGL_MAJOR_VERSION);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, CONTEXT_GLFW_OGL_MINOR_VERSION);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-	localWindow = glfwCreateWindow(appParameters.screenWidth, appParameters.screenHeight, CONTEXT_GLFW_WINDOW_TITLE,
-		appParameters.isFullScreen ? glfwGetPrimaryMonitor(): nullptr, nullptr);
+	if(appParameters.isBenchmarkMode)
+	{
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+
+		localWindow = glfwCreateWindow(appParameters.screenWidth, appParameters.screenHeight, CONTEXT_GLFW_WINDOW_TITLE, nullptr, nullptr);
+		if(!localWindow)
+		{
+			Log::getInstance().warning("Can't create OSMesa context, trying EGL");
+
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+			localWindow = glfwCreateWindow(appParameters.screenWidth, appParameters.screenHeight, CONTEXT_GLFW_WINDOW_TITLE, nullptr, nullptr);
+		}
+	}
+	else
+	{
+		localWindow = glfwCreateWindow(appParameters.screenWidth, appParameters.screenHeight, CONTEXT_GLFW_WINDOW_TITLE,
+			appParameters.isFullScreen ? glfwGetPrimaryMonitor(): nullptr, nullptr);
+	}
+
 	if(!localWindow)
 	{
 		Log::getInstance().error("Can't create window");
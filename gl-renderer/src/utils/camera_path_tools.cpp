@@ -0,0 +1,108 @@
+/* camera_path_tools.cpp
+ * Camera pose computation along a path
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "utils/camera_path_tools.h"
+
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+using namespace std;
+using namespace renderer::data;
+using namespace renderer::utils;
+
+namespace
+{
+	/*
+	@brief Computes velocity of position and rotations at keyframe from its neighbours, per second. Path ends use one-sided differences
+	*/
+	void computeTangents(const vector<CameraKeyframe> &keyframes, size_t index, glm::vec3 &positionTangent, glm::vec2 &rotationTangent);
+
+	/*
+	@brief Cubic Hermite interpolation
+	@param[in] duration - segment length, seconds. Tangents are per second
+	@param[in] t - position in segment, [0; 1]
+	*/
+	template<typename T>
+	T interpolateHermite(const T &start, const T &startTangent, const T &end, const T &endTangent, float duration, float t);
+}
+
+void renderer::utils::sampleCameraPath(const CameraPath &cameraPath, float time, CameraKeyframe &pose)
+{
+	const vector<CameraKeyframe> &keyframes = cameraPath.keyframes;
+	if(keyframes.empty())
+		return;
+
+	auto next = upper_bound(keyframes.begin(), keyframes.end(), time, [](float value, const CameraKeyframe &keyframe)
+	{
+		return value < keyframe.time;
+	});
+
+	if(next == keyframes.begin())
+	{
+		pose = keyframes.front();
+		return;
+	}
+	if(next == keyframes.end())
+	{
+		pose = keyframes.back();
+		return;
+	}
+
+	size_t nextIndex = next - keyframes.begin();
+	const CameraKeyframe &previous = keyframes[nextIndex - 1];
+
+	float duration = next->time - previous.time; //Keyframes with the same time are skipped by upper_bound
+	float t = (time - previous.time) / duration;
+
+	glm::vec3 previousPositionTangent, nextPositionTangent;
+	glm::vec2 previousRotationTangent, nextRotationTangent;
+	computeTangents(keyframes, nextIndex - 1, previousPositionTangent, previousRotationTangent);
+	computeTangents(keyframes, nextIndex, nextPositionTangent, nextRotationTangent);
+
+	glm::vec2 rotation = interpolateHermite(glm::vec2(previous.horizontalRotationRadians, previous.verticalRotationRadians), previousRotationTangent,
+		glm::vec2(next->horizontalRotationRadians, next->verticalRotationRadians), nextRotationTangent, duration, t);
+
+	pose.time = time;
+	pose.position = interpolateHermite(previous.position, previousPositionTangent, next->position, nextPositionTangent, duration, t);
+	pose.horizontalRotationRadians = rotation.x;
+	pose.verticalRotationRadians = rotation.y;
+}
+
+float renderer::utils::getCameraPathDuration(const CameraPath &cameraPath)
+{
+	return cameraPath.keyframes.empty() ? 0.f : cameraPath.keyframes.back().time;
+}
+
+namespace
+{
+	void computeTangents(const vector<CameraKeyframe> &keyframes, size_t index, glm::vec3 &positionTangent, glm::vec2 &rotationTangent)
+	{
+		//Catmull-Rom: tangent is parallel to the chord between neighbours
+		const CameraKeyframe &previous = keyframes[index > 0 ? index - 1 : index];
+		const CameraKeyframe &next = keyframes[min(index + 1, keyframes.size() - 1)];
+
+		float duration = next.time - previous.time;
+		if(duration <= 0.f)
+		{
+			positionTangent = glm::vec3(0.f);
+			rotationTangent = glm::vec2(0.f);
+			return;
+		}
+
+		positionTangent = (next.position - previous.position) / duration;
+		rotationTangent = glm::vec2(next.horizontalRotationRadians - previous.horizontalRotationRadians, next.verticalRotationRadians - previous.verticalRotationRadians) / duration;
+	}
+
+	template<typename T>
+	T interpolateHermite(const T &start, const T &startTangent, const T &end, const T &endTangent, float duration, float t)
+	{
+		float t2 = t * t;
+		float t3 = t2 * t;
+
+		return (2.f * t3 - 3.f * t2 + 1.f) * start + (t3 - 2.f * t2 + t) * duration * startTangent + (-2.f * t3 + 3.f * t2) * end + (t3 - t2) * duration * endTangent;
+	}
+}
@@ -6,7 +6,12 @@
 
 #include "utils/chunk_tools.h"
 
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "log.h"
+
 using namespace std;
+using namespace renderer;
 using namespace renderer::data;
 using namespace renderer::utils;
 
@@ -26,3 +31,49 @@ void renderer::utils::findChunk(vector<ChunkData> &chunks, float x, float z, int
 
 	chunkIndex = -1;
 }
+
+int renderer::utils::findQuad(const ChunkMargins &margins, float x, float z)
+{
+	if((x >= margins.leftX) && (x <= margins.centerX))
+	{
+		if((z <= margins.nearZ) && (z >= margins.centerZ))
+			return 0;
+		else if((z <= margins.centerZ) && (z >= margins.farZ))
+			return 2;
+		else
+		{
+			Log::getInstance().error("Quad not found");
+			return 0;
+		}
+	}
+	if((x >= margins.centerX) && (x <= margins.rightX))
+	{
+		if((z <= margins.nearZ) && (z >= margins.centerZ))
+			return 1;
+		else if((z <= margins.centerZ) && (z >= margins.farZ))
+			return 3;
+		else
+		{
+			Log::getInstance().error("Quad not found");
+			return 0;
+		}
+	}
+
+	Log::getInstance().error("Quad not found");
+	return 0;
+}
+
+void renderer::utils::arrangeInstances(const vector<float> &positions, const ChunkMargins &margins, vector<glm::mat4> *arrangement, vector<glm::mat3> *rotation)
+{
+	const int positionArraySize = static_cast<int>(positions.size());
+	for(int j = 0; j < positionArraySize; j += 4)
+	{
+		glm::mat4 translationMatrix = glm::translate(glm::mat4(1.), glm::vec3(positions[j], positions[j+1], positions[j+2]));
+		glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.), glm::radians(positions[j+3]), glm::vec3(0, 1, 0));
+
+		int quadIndex = findQuad(margins, positions[j], positions[j+2]);
+
+		arrangement[quadIndex].push_back(translationMatrix * rotationMatrix);
+		rotation[quadIndex].push_back(rotationMatrix);
+	}
+}
@@ -22,6 +22,18 @@ namespace
 	const char *ARGUMENT_SMOOTH = "smooth";
 	const char *ARGUMENT_DEBUG = "debug";
 	const char *ARGUMENT_EDITOR = "editor";
+	const char *ARGUMENT_ARCHIVE = "archive";
+	const char *ARGUMENT_UPLOAD_LIMIT = "upload-limit";
+	const char *ARGUMENT_LIGHT_COUNT = "light-count";
+	const char *ARGUMENT_DYNAMIC_RESOLUTION = "dynamic-resolution";
+	const char *ARGUMENT_RENDER_SCALE = "render-scale";
+	const char *ARGUMENT_TEMPORAL_UPSCALING = "temporal-upscaling";
+	const char *ARGUMENT_COMPARE_POSTPROCESSING = "compare-postprocessing";
+	const char *ARGUMENT_BENCHMARK = "benchmark";
+	const char *ARGUMENT_BENCHMARK_OUTPUT = "benchmark-output";
+	const char *ARGUMENT_LIGHT_SWEEP = "light-sweep";
+
+	constexpr float PERCENTS = 100.f;
 }
 
 bool renderer::utils::parseCommandline(int argc, const char **argv, AppParameters &parameters)
@@ -81,8 +93,126 @@ bool renderer::utils::parseCommandline(int argc, const char **argv, AppParameter
 		{
 			parameters.isEditorMode = true;
 		}
+		else if(strcmp(argv[i], ARGUMENT_ARCHIVE) == 0)
+		{
+			if(i + 1 >= argc)
+			{
+				Log::getInstance().error("No archive path parameter is provided");
+				return false;
+			}
+
+			parameters.archivePath = argv[i+1];
+
+			i += 1; //i++ will move index to the next argument
+		}
+		else if(strcmp(argv[i], ARGUMENT_UPLOAD_LIMIT) == 0)
+		{
+			if(i + 1 >= argc)
+			{
+				Log::getInstance().error("No upload limit parameter is provided");
+				return false;
+			}
+
+			parameters.uploadKilobytesPerFrame = atoi(argv[i+1]);
+
+			i += 1; //i++ will move index to the next argument
+		}
+		else if(strcmp(argv[i], ARGUMENT_LIGHT_COUNT) == 0)
+		{
+			if(i + 1 >= argc)
+			{
+				Log::getInstance().error("No light count parameter is provided");
+				return false;
+			}
+
+			parameters.pointLightAmount = atoi(argv[i+1]);
+
+			i += 1; //i++ will move index to the next argument
+		}
+		else if(strcmp(argv[i], ARGUMENT_DYNAMIC_RESOLUTION) == 0)
+		{
+			if(i + 1 >= argc)
+			{
+				Log::getInstance().error("No target frame time parameter is provided");
+				return false;
+			}
+
+			parameters.targetFrameTime = atof(argv[i+1]);
+
+			i += 1; //i++ will move index to the next argument
+		}
+		else if(strcmp(argv[i], ARGUMENT_RENDER_SCALE) == 0)
+		{
+			if(i + 1 >= argc)
+			{
+				Log::getInstance().error("No render scale parameter is provided");
+				return false;
+			}
+
+			parameters.renderScale = atof(argv[i+1]) / PERCENTS;
+
+			i += 1; //i++ will move index to the next argument
+		}
+		else if(strcmp(argv[i], ARGUMENT_TEMPORAL_UPSCALING) == 0)
+		{
+			parameters.useTemporalUpscaling = true;
+		}
+		else if(strcmp(argv[i], ARGUMENT_COMPARE_POSTPROCESSING) == 0)
+		{
+			if(i + 1 >= argc)
+			{
+				Log::getInstance().error("No postprocessing effect parameter is provided");
+				return false;
+			}
+
+			parameters.comparedPostprocessingEffect = argv[i+1];
+
+			i += 1; //i++ will move index to the next argument
+		}
+		else if(strcmp(argv[i], ARGUMENT_BENCHMARK) == 0)
+		{
+			if(i + 2 >= argc)
+			{
+				Log::getInstance().error("Camera path and frame amount parameters are not provided");
+				return false;
+			}
+
+			parameters.isBenchmarkMode = true;
+			parameters.cameraPathPath = argv[i+1];
+			parameters.benchmarkFrameAmount = atoi(argv[i+2]);
+
+			if(parameters.benchmarkFrameAmount <= 0)
+			{
+				Log::getInstance().error("Benchmark frame amount must be positive");
+				return false;
+			}
+
+			i += 2; //not += 3, because i++ will move index to the next argument
+		}
+		else if(strcmp(argv[i], ARGUMENT_BENCHMARK_OUTPUT) == 0)
+		{
+			if(i + 1 >= argc)
+			{
+				Log::getInstance().error("No benchmark output path parameter is provided");
+				return false;
+			}
+
+			parameters.benchmarkOutputPath = argv[i+1];
+
+			i += 1; //i++ will move index to the next argument
+		}
+		else if(strcmp(argv[i], ARGUMENT_LIGHT_SWEEP) == 0)
+		{
+			parameters.isLightSweep = true;
+		}
 		else Log::getInstance().warning(std::string("Unknown parameter \"") + argv[i] + "\", ignored");
 	}
 
+	if(parameters.isLightSweep && !parameters.isBenchmarkMode)
+	{
+		Log::getInstance().warning("Light sweep is run in benchmark mode only, ignored");
+		parameters.isLightSweep = false;
+	}
+
 	return true;
 }
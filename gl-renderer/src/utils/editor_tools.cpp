@@ -69,12 +69,25 @@ void renderer::utils::saveScene(const string &fileName, Scene &scene)
 	data << "camera\n" << scene.camera.xPos << ' '<< scene.camera.yPos << ' ' << scene.camera.zPos << '\n' << horizontalRotationDegrees << ' ' << verticalRotationDegrees << "\n\n";
 
 	data << "renderer-type: " << scene.rendererType << "\n";
+	if(scene.depthPrepass)
+		data << "depth-prepass: yes\n";
+	if(scene.weightedBlendedTransparency)
+		data << "transparency: weighted-blended\n";
 	data << "fog: " << (scene.fog.enable ? "yes": "no") << "\n";
 	data << "fog-colour: " << scene.fog.red << ' ' << scene.fog.green << ' ' << scene.fog.blue << "\n";
 	data << "post-effect: " << scene.postprocessingEffect << "\n\n";
 
 	data << "light\n" << scene.light.lightType << '\n' << scene.light.x << ' ' << scene.light.y << ' ' << scene.light.z << "\n\n";
 
+	if(!scene.pointLights.empty())
+	{
+		data << "point-lights " << scene.pointLights.size() << '\n';
+		for(auto &current: scene.pointLights)
+			data << current.x << ' ' << current.y << ' ' << current.z << ' ' << current.power << ' ' << current.red << ' ' << current.green << ' ' << current.blue << '\n';
+
+		data << '\n';
+	}
+
 	data << "chunks " << scene.chunks.size() << "\n";
 	data << "terrain-texturing: " << scene.terrainTexturing << "\n";
 
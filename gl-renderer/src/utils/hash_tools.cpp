@@ -0,0 +1,62 @@
+/* hash_tools.cpp
+ * Non-cryptographic hashes for names and data blocks
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "utils/hash_tools.h"
+
+#include <cstring>
+
+using namespace renderer::utils;
+
+namespace
+{
+	constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+	constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+	//Mixing constants from MurmurHash3 finalizer
+	constexpr uint64_t MIX_MULTIPLIER1 = 0xff51afd7ed558ccdull;
+	constexpr uint64_t MIX_MULTIPLIER2 = 0xc4ceb9fe1a85ec53ull;
+}
+
+uint64_t renderer::utils::hashString(const char *data, size_t length)
+{
+	uint64_t hash = FNV_OFFSET_BASIS;
+	for(size_t i = 0; i < length; i++)
+	{
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= FNV_PRIME;
+	}
+
+	return hash;
+}
+
+uint64_t renderer::utils::hashData(const void *data, size_t size, uint64_t seed)
+{
+	const unsigned char *bytes = static_cast<const unsigned char*>(data);
+	uint64_t hash = seed ^ (size * FNV_PRIME);
+
+	size_t wordAmount = size / sizeof(uint64_t);
+	for(size_t i = 0; i < wordAmount; i++)
+	{
+		uint64_t word = 0;
+		memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t)); //Data may be unaligned
+
+		hash = (hash ^ word) * MIX_MULTIPLIER1;
+		hash ^= hash >> 29;
+	}
+
+	for(size_t i = wordAmount * sizeof(uint64_t); i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+
+	//Finalization
+	hash ^= hash >> 33;
+	hash *= MIX_MULTIPLIER2;
+	hash ^= hash >> 33;
+
+	return hash;
+}
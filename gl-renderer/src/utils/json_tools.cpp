@@ -0,0 +1,56 @@
+/* json_tools.cpp
+ * Helpers for JSON reports
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "utils/json_tools.h"
+
+#include <cstdio>
+
+using namespace std;
+using namespace renderer::utils;
+
+namespace
+{
+	constexpr unsigned char FIRST_PRINTABLE_CHARACTER = 0x20;
+	constexpr int UNICODE_ESCAPE_LENGTH = 6; //\u00XX
+}
+
+string renderer::utils::escapeJsonString(const string &str)
+{
+	string result;
+	result.reserve(str.size());
+
+	for(auto current: str)
+	{
+		switch(current)
+		{
+		case '"':
+			result += "\\\"";
+			break;
+		case '\\':
+			result += "\\\\";
+			break;
+		case '\n':
+			result += "\\n";
+			break;
+		case '\r':
+			result += "\\r";
+			break;
+		case '\t':
+			result += "\\t";
+			break;
+		default:
+			if(static_cast<unsigned char>(current) < FIRST_PRINTABLE_CHARACTER)
+			{
+				char escaped[UNICODE_ESCAPE_LENGTH + 1] = {'\0'}; //1 is for \0 character
+				snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(current));
+				result += escaped;
+			}
+			else result += current;
+		}
+	}
+
+	return result;
+}
@@ -6,10 +6,12 @@
 
 #include "utils/math_tools.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include <glm/glm.hpp>
 
+using namespace std;
 using namespace renderer::utils;
 
 glm::vec3 renderer::utils::slerp(const glm::vec3 &vector1, const glm::vec3 &vector2, float t)
@@ -30,3 +32,26 @@ float renderer::utils::computeBoundingSphereRadius(float lightPower)
 
 	return radius;
 }
+
+float renderer::utils::computeHaltonValue(int index, int base)
+{
+	float value = 0.f;
+	float fraction = 1.f;
+
+	while(index > 0)
+	{
+		fraction /= base;
+		value += fraction * (index % base);
+		index /= base;
+	}
+
+	return value;
+}
+
+float renderer::utils::computePercentile(const vector<float> &sortedValues, float percentile)
+{
+	int rank = static_cast<int>(ceil(percentile / 100.f * sortedValues.size()));
+	rank = clamp(rank, 1, static_cast<int>(sortedValues.size()));
+
+	return sortedValues[rank - 1];
+}
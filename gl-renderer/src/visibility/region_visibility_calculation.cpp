@@ -6,6 +6,8 @@
 
 #include "visibility/region_visibility_calculation.h"
 
+#include "profiler.h"
+
 using namespace std;
 using namespace renderer::data;
 using namespace renderer::visibility;
@@ -18,6 +20,8 @@ namespace
 
 void renderer::visibility::recalculateVisibility(map<int, ChunkMargins> *margins, float x, float z, vector<VisibilityFlags> &visibilityFlags)
 {
+	PROFILE_ZONE("visibility::recalculateVisibility");
+
 	const int amount = margins->size();
 	for(int i = 0; i < amount; i++)
 	{
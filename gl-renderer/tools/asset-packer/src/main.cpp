@@ -0,0 +1,114 @@
+/* main.cpp
+ * Asset packer entry point. Packs all meshes, textures and terrain chunks referenced by description files into one archive
+ * Must be started from the renderer working directory, so paths in descriptions are resolved the same way
+ *
+ * Author: Artem Hiblov
+ */
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "log.h"
+#include "data/object_file_paths.h"
+#include "data/terrain_file_paths.h"
+#include "loaders/asset_archive.h"
+#include "loaders/mesh_loader.h"
+#include "loaders/terrain_loader.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::data;
+using namespace renderer::loaders;
+
+namespace
+{
+	const char *OBJECT_DESCRIPTION_PATH = "objects/object-description";
+	const char *LIBRARIES_PATH = "objects/libraries";
+	const char *TERRAIN_DESCRIPTION_PATH = "terrain/terrain-description";
+
+	const char *ABSENT_NORMALMAP_STRING = "--";
+
+
+
+	/*
+	@brief Collects object file paths from object description and all libraries
+	*/
+	void collectObjectFiles(set<string> &files);
+
+	/*
+	@brief Collects chunk file paths from terrain description
+	*/
+	void collectTerrainFiles(set<string> &files);
+}
+
+int main(int argc, const char **argv)
+{
+	if(argc < 2)
+	{
+		Log::getInstance().error("Usage: asset-packer <archive path>");
+		return 1;
+	}
+
+	set<string> files; //Sorted and without duplicates
+	collectObjectFiles(files);
+	collectTerrainFiles(files);
+
+	Log::getInstance().info(to_string(files.size()) + " files to pack");
+
+	bool status = writeAssetArchive(argv[1], vector<string>(files.begin(), files.end()));
+	if(!status)
+	{
+		Log::getInstance().error("Can't create archive");
+		return 1;
+	}
+
+	return 0;
+}
+
+namespace
+{
+	void collectObjectFiles(set<string> &files)
+	{
+		map<string, ObjectFilePaths> description;
+		loadObjectDescription(OBJECT_DESCRIPTION_PATH, description);
+
+		ifstream data(LIBRARIES_PATH);
+		if(data.is_open())
+		{
+			int libraryAmount = 0;
+			data >> libraryAmount;
+
+			for(int i = 0; i < libraryAmount; i++)
+			{
+				string libraryPath;
+				data >> libraryPath;
+				loadObjectDescription(libraryPath, description);
+			}
+		}
+		else Log::getInstance().warning("Can't read list of libraries");
+
+		for(auto &[name, paths]: description)
+		{
+			files.insert(paths.meshPath);
+			files.insert(paths.texturePath);
+
+			if(paths.normalmapPath != ABSENT_NORMALMAP_STRING)
+				files.insert(paths.normalmapPath);
+		}
+	}
+
+	void collectTerrainFiles(set<string> &files)
+	{
+		map<string, TerrainFilePaths> description;
+		loadTerrainDescription(TERRAIN_DESCRIPTION_PATH, description);
+
+		for(auto &[name, paths]: description)
+		{
+			files.insert(paths.meshPath);
+			files.insert(paths.texturePath);
+		}
+	}
+}
@@ -0,0 +1,279 @@
+/* data_generator.cpp
+ * Writes synthetic asset files and scenes for micro-benchmarks, so they don't depend on renderer working directory
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "data_generator.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace std;
+using namespace renderer::benchmarks;
+using namespace renderer::data;
+
+namespace
+{
+	const char *MESH_FILE_SIGNATURE = "mesh";
+	const char *TERRAIN_FILE_SIGNATURE = "terrain";
+	constexpr int TANGENT_BASIS_FLAG = 2;
+
+	constexpr int BMP_HEADER_SIZE = 54;
+	constexpr int BMP_INFO_HEADER_SIZE = 40;
+	constexpr int BMP_FILE_SIZE_OFFSET = 2;
+	constexpr int BMP_DATA_OFFSET = 10;
+	constexpr int BMP_INFO_HEADER_SIZE_OFFSET = 14;
+	constexpr int BMP_IMAGE_WIDTH_OFFSET = 18;
+	constexpr int BMP_IMAGE_HEIGHT_OFFSET = 22;
+	constexpr int BMP_PLANES_OFFSET = 26;
+	constexpr int BMP_IMAGE_BITS_PER_PIXEL_OFFSET = 28;
+	constexpr int BMP_IMAGE_SIZE_OFFSET = 34;
+	constexpr int BMP_BYTES_PER_PIXEL = 3;
+
+	constexpr int VERTICES_PER_CELL = 6; //Two triangles
+	constexpr float HILL_HEIGHT = 4.f;
+	constexpr float HILL_FREQUENCY_X = 0.11f;
+	constexpr float HILL_FREQUENCY_Z = 0.07f;
+
+	constexpr int OBJECT_KINDS = 8; //Instance groups per chunk
+	constexpr int PARTICLE_SETS_PER_CHUNK = 2;
+	constexpr float MAX_ROTATION = 360.f; //Degrees
+	constexpr float PARTICLE_MIN_RADIUS = 2.f;
+	constexpr float PARTICLE_MAX_RADIUS = 6.f;
+	constexpr float PARTICLE_DENSITY = 0.5f;
+
+	const char *FEATURE_BASIC = "--";
+	const char *FEATURE_INSTANCING = "instancing";
+
+
+
+	/*
+	@brief Writes floats in [from; to)
+	*/
+	void writeRandomFloats(ofstream &data, int amount, float from, float to, mt19937 &generator);
+
+	float computeHillHeight(float x, float z);
+
+	void writeInt(unsigned char *header, int offset, int32_t value);
+}
+
+bool renderer::benchmarks::writeMeshFile(const string &path, int vertexAmount, mt19937 &generator)
+{
+	ofstream data(path, ios::out | ios::binary | ios::trunc);
+	if(!data.is_open())
+		return false;
+
+	int formatType = TANGENT_BASIS_FLAG;
+
+	data.write(MESH_FILE_SIGNATURE, strlen(MESH_FILE_SIGNATURE));
+	data.write(reinterpret_cast<const char*>(&formatType), sizeof(int));
+	data.write(reinterpret_cast<const char*>(&vertexAmount), sizeof(int));
+
+	writeRandomFloats(data, vertexAmount * 3, -1.f, 1.f, generator); //Vertices
+	writeRandomFloats(data, vertexAmount * 2, 0.f, 1.f, generator); //UVs
+	writeRandomFloats(data, vertexAmount * 3, -1.f, 1.f, generator); //Normals
+	writeRandomFloats(data, vertexAmount * 3, -1.f, 1.f, generator); //Tangents
+	writeRandomFloats(data, vertexAmount * 3, -1.f, 1.f, generator); //Bitangents
+
+	return static_cast<bool>(data);
+}
+
+bool renderer::benchmarks::writeTextureFile(const string &path, int width, int height, mt19937 &generator)
+{
+	ofstream data(path, ios::out | ios::binary | ios::trunc);
+	if(!data.is_open())
+		return false;
+
+	const int imageSize = width * height * BMP_BYTES_PER_PIXEL; //Width is expected to be multiple of 4, so rows have no padding
+
+	unsigned char header[BMP_HEADER_SIZE] = {0};
+	header[0] = 'B';
+	header[1] = 'M';
+	writeInt(header, BMP_FILE_SIZE_OFFSET, BMP_HEADER_SIZE + imageSize);
+	writeInt(header, BMP_DATA_OFFSET, BMP_HEADER_SIZE);
+	writeInt(header, BMP_INFO_HEADER_SIZE_OFFSET, BMP_INFO_HEADER_SIZE);
+	writeInt(header, BMP_IMAGE_WIDTH_OFFSET, width);
+	writeInt(header, BMP_IMAGE_HEIGHT_OFFSET, height);
+	header[BMP_PLANES_OFFSET] = 1;
+	header[BMP_IMAGE_BITS_PER_PIXEL_OFFSET] = BMP_BYTES_PER_PIXEL * 8;
+	writeInt(header, BMP_IMAGE_SIZE_OFFSET, imageSize);
+
+	data.write(reinterpret_cast<const char*>(header), BMP_HEADER_SIZE);
+
+	vector<char> image(imageSize);
+	for(auto &current: image)
+		current = static_cast<char>(generator());
+
+	data.write(image.data(), image.size());
+
+	return static_cast<bool>(data);
+}
+
+bool renderer::benchmarks::writeTerrainFile(const string &path, int verticesInSide, float gridStep)
+{
+	ofstream data(path, ios::out | ios::binary | ios::trunc);
+	if(!data.is_open())
+		return false;
+
+	const int cellsInSide = verticesInSide - 1;
+	float sideLength = cellsInSide * gridStep;
+	int vertexAmount = cellsInSide * cellsInSide * VERTICES_PER_CELL;
+
+	vector<float> vertices, uvs, normals;
+	vertices.reserve(vertexAmount * 3);
+	uvs.reserve(vertexAmount * 2);
+	normals.reserve(vertexAmount * 3);
+
+	//Two triangles per cell, chunk spreads to negative Z
+	const int cornerRows[VERTICES_PER_CELL] = {0, 0, 1, 1, 0, 1};
+	const int cornerColumns[VERTICES_PER_CELL] = {0, 1, 0, 0, 1, 1};
+	for(int row = 0; row < cellsInSide; row++)
+	{
+		for(int column = 0; column < cellsInSide; column++)
+		{
+			for(int i = 0; i < VERTICES_PER_CELL; i++)
+			{
+				float x = (column + cornerColumns[i]) * gridStep;
+				float z = (row + cornerRows[i]) * gridStep;
+
+				vertices.push_back(x);
+				vertices.push_back(computeHillHeight(x, z));
+				vertices.push_back(-z);
+
+				uvs.push_back(x / sideLength);
+				uvs.push_back(z / sideLength);
+
+				normals.push_back(0.f);
+				normals.push_back(1.f);
+				normals.push_back(0.f);
+			}
+		}
+	}
+
+	data.write(TERRAIN_FILE_SIGNATURE, strlen(TERRAIN_FILE_SIGNATURE));
+	data.write(reinterpret_cast<const char*>(&sideLength), sizeof(float));
+	data.write(reinterpret_cast<const char*>(&vertexAmount), sizeof(int));
+	data.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(float));
+	data.write(reinterpret_cast<const char*>(uvs.data()), uvs.size() * sizeof(float));
+	data.write(reinterpret_cast<const char*>(normals.data()), normals.size() * sizeof(float));
+
+	//Heightmap
+
+	data.write(reinterpret_cast<const char*>(&verticesInSide), sizeof(int));
+	data.write(reinterpret_cast<const char*>(&gridStep), sizeof(float));
+	for(int row = 0; row < verticesInSide; row++)
+	{
+		for(int column = 0; column < verticesInSide; column++)
+		{
+			float height = computeHillHeight(column * gridStep, row * gridStep);
+			data.write(reinterpret_cast<const char*>(&height), sizeof(float));
+		}
+	}
+
+	return static_cast<bool>(data);
+}
+
+void renderer::benchmarks::generateScene(const string &chunkName, int chunksPerSide, float sideLength, int instancesPerChunk, mt19937 &generator, Scene &scene)
+{
+	const int chunkAmount = chunksPerSide * chunksPerSide;
+
+	scene.rendererType = "forward";
+	scene.postprocessingEffect = FEATURE_BASIC;
+	scene.terrainTexturing = FEATURE_BASIC;
+	scene.light = Light("directional", -0.5f, -1.f, -0.3f);
+	scene.chunks.clear();
+	scene.instances.assign(chunkAmount, vector<InstanceArray>());
+	scene.particles.assign(chunkAmount, vector<ParticleSet>());
+
+	for(int row = 0; row < chunksPerSide; row++)
+	{
+		for(int column = 0; column < chunksPerSide; column++)
+		{
+			const int index = row * chunksPerSide + column;
+
+			ChunkData chunk(chunkName, column * sideLength, -row * sideLength);
+			chunk.size = sideLength;
+
+			vector<vector<float>> positions(OBJECT_KINDS);
+			for(int i = 0; i < instancesPerChunk; i++)
+			{
+				vector<float> &groupPositions = positions[generator() % OBJECT_KINDS];
+
+				float x = getRandomValue(generator, 0.f, sideLength);
+				float z = getRandomValue(generator, 0.f, sideLength);
+
+				groupPositions.push_back(chunk.x + x);
+				groupPositions.push_back(computeHillHeight(x, z));
+				groupPositions.push_back(chunk.z - z);
+				groupPositions.push_back(getRandomValue(generator, 0.f, MAX_ROTATION));
+			}
+
+			for(int i = 0; i < OBJECT_KINDS; i++)
+			{
+				if(!positions[i].empty())
+					scene.instances[index].emplace_back(string("object-") + to_string(i), FEATURE_INSTANCING, move(positions[i]));
+			}
+
+			for(int i = 0; i < PARTICLE_SETS_PER_CHUNK; i++)
+			{
+				float radius = getRandomValue(generator, PARTICLE_MIN_RADIUS, PARTICLE_MAX_RADIUS);
+				float x = chunk.x + getRandomValue(generator, radius, sideLength - radius);
+				float z = chunk.z - getRandomValue(generator, radius, sideLength - radius);
+
+				scene.particles[index].emplace_back("grass", FEATURE_BASIC, x, z, radius, PARTICLE_DENSITY);
+			}
+
+			scene.chunks.push_back(chunk);
+		}
+	}
+}
+
+void renderer::benchmarks::computeChunkMargins(const Scene &scene, float sideLength, map<int, ChunkMargins> &chunkMargins)
+{
+	const int chunkAmount = scene.chunks.size();
+	for(int i = 0; i < chunkAmount; i++)
+	{
+		const ChunkData &currentChunk = scene.chunks[i];
+
+		ChunkMargins currentMargins;
+		currentMargins.leftX = currentChunk.x;
+		currentMargins.rightX = currentChunk.x + sideLength;
+		currentMargins.nearZ = currentChunk.z;
+		currentMargins.farZ = currentChunk.z - sideLength;
+		currentMargins.centerX = (currentMargins.leftX + currentMargins.rightX) / 2.f;
+		currentMargins.centerZ = (currentMargins.nearZ + currentMargins.farZ) / 2.f;
+
+		chunkMargins[i] = currentMargins;
+	}
+}
+
+float renderer::benchmarks::getRandomValue(mt19937 &generator, float from, float to)
+{
+	return from + (to - from) * static_cast<float>(generator() / (static_cast<double>(mt19937::max()) + 1.));
+}
+
+namespace
+{
+	void writeRandomFloats(ofstream &data, int amount, float from, float to, mt19937 &generator)
+	{
+		vector<float> values(amount);
+		for(auto &current: values)
+			current = getRandomValue(generator, from, to);
+
+		data.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+	}
+
+	float computeHillHeight(float x, float z)
+	{
+		return HILL_HEIGHT * (sin(x * HILL_FREQUENCY_X) * cos(z * HILL_FREQUENCY_Z) + 1.f);
+	}
+
+	void writeInt(unsigned char *header, int offset, int32_t value)
+	{
+		memcpy(header + offset, &value, sizeof(int32_t));
+	}
+}
@@ -0,0 +1,51 @@
+/* data_generator.h
+ * Writes synthetic asset files and scenes for micro-benchmarks, so they don't depend on renderer working directory
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <map>
+#include <random>
+#include <string>
+
+#include "data/chunk_margins.h"
+#include "data/scene.h"
+
+namespace renderer::benchmarks
+{
+
+/*
+@brief Writes mesh file with normals and tangent basis
+*/
+bool writeMeshFile(const std::string &path, int vertexAmount, std::mt19937 &generator);
+
+/*
+@brief Writes 24-bit BMP file
+*/
+bool writeTextureFile(const std::string &path, int width, int height, std::mt19937 &generator);
+
+/*
+@brief Writes terrain chunk file. Chunk is a grid of two triangles per cell with smooth hills
+@param[in] verticesInSide - heightmap vertices along one side
+*/
+bool writeTerrainFile(const std::string &path, int verticesInSide, float gridStep);
+
+/*
+@brief Fills scene with square grid of chunks, each one with instance groups of several objects and particle sets
+@param[in] chunkName - terrain chunk used by all chunks
+*/
+void generateScene(const std::string &chunkName, int chunksPerSide, float sideLength, int instancesPerChunk, std::mt19937 &generator, renderer::data::Scene &scene);
+
+/*
+@brief Computes chunk margins the same way SceneManager does
+*/
+void computeChunkMargins(const renderer::data::Scene &scene, float sideLength, std::map<int, renderer::data::ChunkMargins> &chunkMargins);
+
+/*
+@brief Returns value in [from; to)
+*/
+float getRandomValue(std::mt19937 &generator, float from, float to);
+
+}
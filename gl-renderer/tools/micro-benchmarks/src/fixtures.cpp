@@ -0,0 +1,172 @@
+/* fixtures.cpp
+ * Generated data shared by micro-benchmarks. Files are written to temporary directory and removed after benchmark
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "fixtures.h"
+
+#include <filesystem>
+#include <random>
+#include <system_error>
+
+#include "log.h"
+#include "data/terrain_file_paths.h"
+#include "data_generator.h"
+#include "loaders/terrain_loader.h"
+#include "utils/editor_tools.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::benchmarks;
+using namespace renderer::data;
+using namespace renderer::loaders;
+using namespace renderer::managers;
+using namespace renderer::utils;
+
+namespace
+{
+	const char *DATA_DIRECTORY = "gl-renderer-micro-benchmarks";
+	const char *CHUNK_NAME = "benchmark-chunk";
+
+	constexpr float TERRAIN_GRID_STEP = 0.5f;
+	constexpr uint32_t SEED = 1; //The same data for every run
+
+
+
+	/*
+	@brief Returns path of file in temporary data directory, creates the directory if needed
+	*/
+	string getDataPath(const string &fileName);
+
+	void removeFile(const string &path);
+}
+
+bool AssetFilesFixture::setUp()
+{
+	mt19937 generator(SEED);
+
+	meshPath = getDataPath("mesh");
+	texturePath = getDataPath("texture.bmp");
+	terrainPath = getDataPath("terrain");
+
+	if(!writeMeshFile(meshPath, MESH_VERTEX_AMOUNT, generator) || !writeTextureFile(texturePath, TEXTURE_SIDE, TEXTURE_SIDE, generator) ||
+		!writeTerrainFile(terrainPath, TERRAIN_VERTICES_IN_SIDE, TERRAIN_GRID_STEP))
+	{
+		Log::getInstance().error("Can't write asset files");
+		return false;
+	}
+
+	return true;
+}
+
+void AssetFilesFixture::tearDown()
+{
+	removeFile(meshPath);
+	removeFile(texturePath);
+	removeFile(terrainPath);
+}
+
+bool TerrainFixture::setUp()
+{
+	const string terrainPath = getDataPath("heightmap-terrain");
+	const string descriptionPath = getDataPath("terrain-description");
+
+	if(!writeTerrainFile(terrainPath, AssetFilesFixture::TERRAIN_VERTICES_IN_SIDE, TERRAIN_GRID_STEP))
+	{
+		Log::getInstance().error("Can't write terrain file");
+		return false;
+	}
+
+	map<string, TerrainFilePaths> description;
+	description[CHUNK_NAME] = TerrainFilePaths(terrainPath, getDataPath("texture.bmp")); //Texture isn't read
+	if(!saveTerrainDescription(descriptionPath, description))
+		return false;
+
+	terrainManager = make_unique<TerrainManager>(descriptionPath, nullptr);
+	if(!terrainManager->loadHeightmap(CHUNK_NAME))
+		return false;
+
+	chunk = ChunkData(CHUNK_NAME, 0.f, 0.f);
+	chunk.size = terrainManager->getChunkDimensions(CHUNK_NAME);
+
+	mt19937 generator(SEED);
+	queryPoints.resize(QUERY_AMOUNT);
+	for(auto &current: queryPoints)
+		current = glm::vec2(getRandomValue(generator, 0.f, chunk.size), -getRandomValue(generator, 0.f, chunk.size)); //Chunk spreads to negative Z
+
+	removeFile(terrainPath);
+	removeFile(descriptionPath);
+
+	return true;
+}
+
+void TerrainFixture::tearDown()
+{
+	terrainManager.reset();
+	queryPoints.clear();
+}
+
+bool SceneFixture::setUp()
+{
+	const float sideLength = (AssetFilesFixture::TERRAIN_VERTICES_IN_SIDE - 1) * TERRAIN_GRID_STEP;
+
+	mt19937 generator(SEED);
+	generateScene(CHUNK_NAME, CHUNKS_PER_SIDE, sideLength, INSTANCES_PER_CHUNK, generator, scene);
+
+	chunkMargins.clear();
+	computeChunkMargins(scene, sideLength, chunkMargins);
+
+	//Camera walks over the whole scene and a bit outside
+	const float sceneSide = CHUNKS_PER_SIDE * sideLength;
+	queryPoints.resize(QUERY_AMOUNT);
+	for(auto &current: queryPoints)
+	{
+		current = glm::vec3(getRandomValue(generator, -sideLength, sceneSide + sideLength), getRandomValue(generator, 0.f, sideLength),
+			-getRandomValue(generator, -sideLength, sceneSide + sideLength));
+	}
+
+	scenePath = getDataPath("scene");
+	saveScene(scenePath, scene);
+
+	return true;
+}
+
+void SceneFixture::tearDown()
+{
+	removeFile(scenePath);
+
+	scene = Scene();
+	chunkMargins.clear();
+	queryPoints.clear();
+}
+
+int SceneFixture::getInstanceAmount() const
+{
+	int amount = 0;
+	for(auto &chunkInstances: scene.instances)
+	{
+		for(auto &current: chunkInstances)
+			amount += current.positions.size() / 4; //3 position coordinates + rotation
+	}
+
+	return amount;
+}
+
+namespace
+{
+	string getDataPath(const string &fileName)
+	{
+		error_code errorCode;
+		filesystem::path directory = filesystem::temp_directory_path(errorCode) / DATA_DIRECTORY;
+		filesystem::create_directories(directory, errorCode);
+
+		return (directory / fileName).string();
+	}
+
+	void removeFile(const string &path)
+	{
+		error_code errorCode;
+		filesystem::remove(path, errorCode);
+	}
+}
@@ -0,0 +1,82 @@
+/* fixtures.h
+ * Generated data shared by micro-benchmarks. Files are written to temporary directory and removed after benchmark
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "data/chunk_margins.h"
+#include "data/scene.h"
+#include "managers/terrain_manager.h"
+#include "micro_benchmark.h"
+
+namespace renderer::benchmarks
+{
+
+/*
+Mesh, texture and terrain chunk files of typical sizes for loader benchmarks
+*/
+class AssetFilesFixture: public Fixture
+{
+public:
+	static constexpr int MESH_VERTEX_AMOUNT = 30000;
+	static constexpr int TEXTURE_SIDE = 1024;
+	static constexpr int TERRAIN_VERTICES_IN_SIDE = 129;
+
+	bool setUp() override;
+	void tearDown() override;
+
+	std::string meshPath;
+	std::string texturePath;
+	std::string terrainPath;
+};
+
+/*
+Terrain manager with one chunk heightmap and query points on it
+*/
+class TerrainFixture: public Fixture
+{
+public:
+	static constexpr int QUERY_AMOUNT = 1024;
+
+	bool setUp() override;
+	void tearDown() override;
+
+	std::unique_ptr<renderer::managers::TerrainManager> terrainManager;
+	renderer::data::ChunkData chunk;
+	std::vector<glm::vec2> queryPoints; //X and Z
+};
+
+/*
+Scene with square grid of chunks, its file, margins and camera positions over it
+*/
+class SceneFixture: public Fixture
+{
+public:
+	static constexpr int CHUNKS_PER_SIDE = 16;
+	static constexpr int INSTANCES_PER_CHUNK = 100;
+	static constexpr int QUERY_AMOUNT = 1024;
+
+	bool setUp() override;
+	void tearDown() override;
+
+	/*
+	@brief Returns instance amount in all chunks
+	*/
+	int getInstanceAmount() const;
+
+	std::string scenePath;
+	renderer::data::Scene scene;
+	std::map<int, renderer::data::ChunkMargins> chunkMargins;
+	std::vector<glm::vec3> queryPoints; //Camera positions
+};
+
+}
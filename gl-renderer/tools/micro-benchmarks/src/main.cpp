@@ -0,0 +1,278 @@
+/* main.cpp
+ * Micro-benchmarks entry point. Measures CPU hot paths of loading and scene processing on generated data, no videocard is needed
+ *
+ * Author: Artem Hiblov
+ */
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "log.h"
+#include "data/chunk_margins.h"
+#include "data/heightmap.h"
+#include "data/mesh.h"
+#include "data/scene.h"
+#include "data/texture.h"
+#include "data/visibility_flags.h"
+#include "fixtures.h"
+#include "loaders/mesh_loader.h"
+#include "loaders/scene_loader.h"
+#include "loaders/terrain_loader.h"
+#include "loaders/texture_loader.h"
+#include "micro_benchmark.h"
+#include "utils/chunk_tools.h"
+#include "utils/editor_tools.h"
+#include "utils/instance_group_tools.h"
+#include "visibility/region_visibility_calculation.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::benchmarks;
+using namespace renderer::data;
+using namespace renderer::loaders;
+using namespace renderer::utils;
+using namespace renderer::visibility;
+
+namespace
+{
+	const char *ARGUMENT_FILTER = "filter";
+	const char *ARGUMENT_OUTPUT = "output";
+	const char *DEFAULT_REPORT_PATH = "micro-benchmarks.json";
+
+	constexpr int TWO_PI_INTEGER = 62831; //The same distribution as particle manager uses
+	constexpr float PARTICLE_DENSITY = 0.5f;
+	constexpr float PARTICLE_RADIUS = 10.f;
+
+	struct BenchmarkParameters
+	{
+		string filter; //Substring of benchmark name. Empty for all benchmarks
+		string reportPath = DEFAULT_REPORT_PATH;
+	};
+
+	AssetFilesFixture assetFiles;
+	TerrainFixture terrain;
+	SceneFixture sceneData;
+
+
+
+	/*
+	@brief Reads name-value pairs
+	*/
+	bool parseArguments(int argc, const char **argv, BenchmarkParameters &parameters);
+
+	void registerLoaderBenchmarks();
+	void registerTerrainBenchmarks();
+	void registerSceneBenchmarks();
+}
+
+int main(int argc, const char **argv)
+{
+	BenchmarkParameters parameters;
+	if(!parseArguments(argc, argv, parameters))
+	{
+		Log::getInstance().error("Usage: micro-benchmarks [filter <name part>] [output <report path>]");
+		return 1;
+	}
+
+	registerLoaderBenchmarks();
+	registerTerrainBenchmarks();
+	registerSceneBenchmarks();
+
+	if(!runBenchmarks(parameters.filter, parameters.reportPath, argv[0]))
+		return 1;
+
+	return 0;
+}
+
+namespace
+{
+	bool parseArguments(int argc, const char **argv, BenchmarkParameters &parameters)
+	{
+		for(int i = 1; i < argc; i++)
+		{
+			if(i + 1 >= argc)
+			{
+				Log::getInstance().error(string("No value is provided for \"") + argv[i] + "\"");
+				return false;
+			}
+
+			if(strcmp(argv[i], ARGUMENT_FILTER) == 0)
+				parameters.filter = argv[++i];
+			else if(strcmp(argv[i], ARGUMENT_OUTPUT) == 0)
+				parameters.reportPath = argv[++i];
+			else
+			{
+				Log::getInstance().error(string("Unknown argument \"") + argv[i] + "\"");
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void registerLoaderBenchmarks()
+	{
+		registerBenchmark("loadMesh", &assetFiles, [](BenchmarkState &state)
+		{
+			while(state.keepRunning())
+			{
+				Mesh mesh;
+				loadMesh(assetFiles.meshPath, nullptr, mesh);
+				doNotOptimize(mesh.vertices.data());
+			}
+
+			state.setItemsProcessed(state.getIterations() * AssetFilesFixture::MESH_VERTEX_AMOUNT);
+		});
+
+		registerBenchmark("loadTexture", &assetFiles, [](BenchmarkState &state)
+		{
+			while(state.keepRunning())
+			{
+				Texture texture;
+				loadTexture(assetFiles.texturePath, nullptr, texture);
+				doNotOptimize(texture.data.get());
+			}
+
+			state.setItemsProcessed(state.getIterations() * AssetFilesFixture::TEXTURE_SIDE * AssetFilesFixture::TEXTURE_SIDE); //Pixels
+		});
+
+		registerBenchmark("loadTerrain", &assetFiles, [](BenchmarkState &state)
+		{
+			while(state.keepRunning())
+			{
+				Mesh chunk;
+				Heightmap heightmap;
+				float sideLength = 0.f;
+				loadTerrain(assetFiles.terrainPath, nullptr, chunk, heightmap, sideLength);
+				doNotOptimize(heightmap.heights.data());
+			}
+
+			state.setItemsProcessed(state.getIterations() * AssetFilesFixture::TERRAIN_VERTICES_IN_SIDE * AssetFilesFixture::TERRAIN_VERTICES_IN_SIDE); //Heightmap vertices
+		});
+
+		registerBenchmark("loadScene", &sceneData, [](BenchmarkState &state)
+		{
+			while(state.keepRunning())
+			{
+				Scene scene;
+				loadScene(sceneData.scenePath, scene);
+				doNotOptimize(scene.instances.data());
+			}
+
+			state.setItemsProcessed(state.getIterations() * sceneData.getInstanceAmount());
+		});
+	}
+
+	void registerTerrainBenchmarks()
+	{
+		registerBenchmark("TerrainManager::getHeight", &terrain, [](BenchmarkState &state)
+		{
+			while(state.keepRunning())
+			{
+				float heightSum = 0.f;
+				for(auto &current: terrain.queryPoints)
+					heightSum += terrain.terrainManager->getHeight(terrain.chunk.x, terrain.chunk.z, terrain.chunk.name, current.x, current.y);
+				doNotOptimize(heightSum);
+			}
+
+			state.setItemsProcessed(state.getIterations() * TerrainFixture::QUERY_AMOUNT);
+		});
+
+		registerBenchmark("generateInstanceRelativePositions", &terrain, [](BenchmarkState &state)
+		{
+			const glm::vec3 center(terrain.chunk.x + terrain.chunk.size / 2.f, 0.f, terrain.chunk.z - terrain.chunk.size / 2.f);
+
+			mt19937 generator(1);
+			uniform_int_distribution<> positionDistribution(0, TWO_PI_INTEGER);
+
+			int64_t positionAmount = 0;
+			while(state.keepRunning())
+			{
+				vector<float> positions = generateInstanceRelativePositions(PARTICLE_DENSITY, center, PARTICLE_RADIUS, *terrain.terrainManager, terrain.chunk, positionDistribution, generator);
+				positionAmount += positions.size() / 3;
+				doNotOptimize(positions.data());
+			}
+
+			state.setItemsProcessed(positionAmount);
+		});
+	}
+
+	void registerSceneBenchmarks()
+	{
+		registerBenchmark("recalculateVisibility", &sceneData, [](BenchmarkState &state)
+		{
+			vector<VisibilityFlags> visibilityFlags(sceneData.chunkMargins.size());
+
+			size_t queryIndex = 0;
+			while(state.keepRunning())
+			{
+				const glm::vec3 &camera = sceneData.queryPoints[queryIndex];
+				queryIndex = (queryIndex + 1) % sceneData.queryPoints.size();
+
+				recalculateVisibility(&sceneData.chunkMargins, camera.x, camera.z, visibilityFlags);
+				doNotOptimize(visibilityFlags.data());
+			}
+
+			state.setItemsProcessed(state.getIterations() * sceneData.chunkMargins.size()); //Chunks
+		});
+
+		registerBenchmark("findChunk", &sceneData, [](BenchmarkState &state)
+		{
+			while(state.keepRunning())
+			{
+				int indexSum = 0;
+				for(auto &current: sceneData.queryPoints)
+				{
+					int chunkIndex = -1;
+					findChunk(sceneData.scene.chunks, current.x, current.z, chunkIndex);
+					indexSum += chunkIndex;
+				}
+				doNotOptimize(indexSum);
+			}
+
+			state.setItemsProcessed(state.getIterations() * SceneFixture::QUERY_AMOUNT);
+		});
+
+		registerBenchmark("findClosestObject", &sceneData, [](BenchmarkState &state)
+		{
+			size_t queryIndex = 0;
+			while(state.keepRunning())
+			{
+				int chunkIndex = -1, objectIndex = -1, instanceIndex = -1;
+				findClosestObject(sceneData.queryPoints[queryIndex], sceneData.scene.instances, chunkIndex, objectIndex, instanceIndex);
+				queryIndex = (queryIndex + 1) % sceneData.queryPoints.size();
+				doNotOptimize(instanceIndex);
+			}
+
+			state.setItemsProcessed(state.getIterations() * sceneData.getInstanceAmount());
+		});
+
+		//CPU part of makeRenderingScene: instance matrices are built and sorted into chunk quads
+		registerBenchmark("makeRenderingScene/arrangeInstances", &sceneData, [](BenchmarkState &state)
+		{
+			const int chunkAmount = sceneData.scene.instances.size();
+			while(state.keepRunning())
+			{
+				for(int chunkIndex = 0; chunkIndex < chunkAmount; chunkIndex++)
+				{
+					const ChunkMargins &margins = sceneData.chunkMargins[chunkIndex];
+					for(auto &currentInstance: sceneData.scene.instances[chunkIndex])
+					{
+						//4 elements for 4 parts of chunk
+						vector<glm::mat4> arrangement[4];
+						vector<glm::mat3> rotation[4];
+
+						arrangeInstances(currentInstance.positions, margins, arrangement, rotation);
+						doNotOptimize(arrangement[0].data());
+					}
+				}
+			}
+
+			state.setItemsProcessed(state.getIterations() * sceneData.getInstanceAmount());
+		});
+	}
+}
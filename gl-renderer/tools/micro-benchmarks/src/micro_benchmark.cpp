@@ -0,0 +1,283 @@
+/* micro_benchmark.cpp
+ * Small harness for CPU micro-benchmarks in the manner of Google Benchmark: fixtures, calibrated iteration amount, JSON report
+ *
+ * Author: Artem Hiblov
+ */
+
+#include "micro_benchmark.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "log.h"
+#include "utils/json_tools.h"
+
+using namespace std;
+using namespace std::chrono;
+using namespace renderer;
+using namespace renderer::benchmarks;
+using namespace renderer::utils;
+
+namespace
+{
+	constexpr double MIN_RUN_TIME = 0.5; //Seconds. Iteration amount grows until a run takes at least this
+	constexpr double RUN_TIME_HEADROOM = 1.4; //Next run aims a bit above minimal time, so calibration ends sooner
+	constexpr double MAX_ITERATION_GROWTH = 10.;
+	constexpr double MIN_MEASURABLE_TIME = 1e-9;
+	constexpr int64_t MAX_ITERATIONS = 1000000000;
+
+	constexpr double NANOSECONDS_IN_SECOND = 1e9;
+
+	constexpr int NAME_COLUMN_WIDTH = 40;
+	constexpr int TIME_COLUMN_WIDTH = 16;
+	constexpr int ITERATIONS_COLUMN_WIDTH = 12;
+
+	struct RegisteredBenchmark
+	{
+		string name;
+		Fixture *fixture; //Non-owning pointer
+		BenchmarkFunction function;
+	};
+
+	struct BenchmarkResult
+	{
+		string name;
+		int64_t iterations;
+		double realTime; //Nanoseconds per iteration
+		double cpuTime; //Nanoseconds per iteration
+		double itemsPerSecond; //0 if benchmark doesn't count items
+	};
+
+	vector<RegisteredBenchmark> registeredBenchmarks;
+
+
+
+	/*
+	@brief Increases iteration amount until run takes minimal time
+	*/
+	BenchmarkResult runBenchmark(const RegisteredBenchmark &benchmark);
+
+	bool writeReport(const string &path, const string &executable, const vector<BenchmarkResult> &results);
+}
+
+BenchmarkState::BenchmarkState(int64_t iterationAmount):
+	iterations(iterationAmount), remainingIterations(iterationAmount), isStarted(false), isTiming(false), cpuStart(0), realTime(0.), cpuTime(0.), itemsProcessed(0)
+{
+}
+
+bool BenchmarkState::keepRunning()
+{
+	if(!isStarted)
+	{
+		isStarted = true;
+		startTimer();
+	}
+
+	if(remainingIterations > 0)
+	{
+		remainingIterations--;
+		return true;
+	}
+
+	stopTimer();
+	return false;
+}
+
+void BenchmarkState::pauseTiming()
+{
+	stopTimer();
+}
+
+void BenchmarkState::resumeTiming()
+{
+	startTimer();
+}
+
+void BenchmarkState::setItemsProcessed(int64_t amount)
+{
+	itemsProcessed = amount;
+}
+
+int64_t BenchmarkState::getIterations() const
+{
+	return iterations;
+}
+
+double BenchmarkState::getRealTime() const
+{
+	return realTime;
+}
+
+double BenchmarkState::getCpuTime() const
+{
+	return cpuTime;
+}
+
+int64_t BenchmarkState::getItemsProcessed() const
+{
+	return itemsProcessed;
+}
+
+void BenchmarkState::startTimer()
+{
+	if(isTiming)
+		return;
+
+	isTiming = true;
+	realStart = steady_clock::now();
+	cpuStart = clock();
+}
+
+void BenchmarkState::stopTimer()
+{
+	if(!isTiming)
+		return;
+
+	isTiming = false;
+	realTime += duration<double>(steady_clock::now() - realStart).count();
+	cpuTime += static_cast<double>(clock() - cpuStart) / CLOCKS_PER_SEC;
+}
+
+Fixture::~Fixture()
+{
+}
+
+bool Fixture::setUp()
+{
+	return true;
+}
+
+void Fixture::tearDown()
+{
+}
+
+void renderer::benchmarks::registerBenchmark(const string &name, Fixture *fixture, BenchmarkFunction function)
+{
+	registeredBenchmarks.push_back({name, fixture, move(function)});
+}
+
+bool renderer::benchmarks::runBenchmarks(const string &filter, const string &reportPath, const string &executable)
+{
+	ostringstream header;
+	header << left << setw(NAME_COLUMN_WIDTH) << "Benchmark" << right << setw(TIME_COLUMN_WIDTH) << "Time, ns" << setw(TIME_COLUMN_WIDTH) << "CPU, ns"
+		<< setw(ITERATIONS_COLUMN_WIDTH) << "Iterations";
+	Log::getInstance().info(header.str());
+
+	vector<BenchmarkResult> results;
+	for(auto &current: registeredBenchmarks)
+	{
+		if(!filter.empty() && current.name.find(filter) == string::npos)
+			continue;
+
+		if(current.fixture && !current.fixture->setUp())
+		{
+			Log::getInstance().warning(current.name + " is skipped, fixture can't be set up");
+			continue;
+		}
+
+		BenchmarkResult result = runBenchmark(current);
+
+		if(current.fixture)
+			current.fixture->tearDown();
+
+		ostringstream line;
+		line << left << setw(NAME_COLUMN_WIDTH) << result.name << right << fixed << setprecision(0) << setw(TIME_COLUMN_WIDTH) << result.realTime
+			<< setw(TIME_COLUMN_WIDTH) << result.cpuTime << setw(ITERATIONS_COLUMN_WIDTH) << result.iterations;
+		Log::getInstance().info(line.str());
+
+		results.push_back(result);
+	}
+
+	if(results.empty())
+	{
+		Log::getInstance().error(string("No benchmarks match filter \"") + filter + "\"");
+		return false;
+	}
+
+	if(!writeReport(reportPath, executable, results))
+	{
+		Log::getInstance().error(string("Can't write ") + reportPath);
+		return false;
+	}
+
+	Log::getInstance().info(string("Micro-benchmark report is written to ") + reportPath);
+
+	return true;
+}
+
+namespace
+{
+	BenchmarkResult runBenchmark(const RegisteredBenchmark &benchmark)
+	{
+		int64_t iterations = 1;
+		while(true)
+		{
+			BenchmarkState state(iterations);
+			benchmark.function(state);
+
+			const double runTime = state.getRealTime();
+			if(runTime >= MIN_RUN_TIME || iterations >= MAX_ITERATIONS)
+			{
+				BenchmarkResult result;
+				result.name = benchmark.name;
+				result.iterations = iterations;
+				result.realTime = runTime * NANOSECONDS_IN_SECOND / iterations;
+				result.cpuTime = state.getCpuTime() * NANOSECONDS_IN_SECOND / iterations;
+				result.itemsPerSecond = (state.getItemsProcessed() > 0) ? state.getItemsProcessed() / runTime : 0.;
+
+				return result;
+			}
+
+			double multiplier = min(MIN_RUN_TIME * RUN_TIME_HEADROOM / max(runTime, MIN_MEASURABLE_TIME), MAX_ITERATION_GROWTH);
+			iterations = min(max(static_cast<int64_t>(iterations * multiplier), iterations + 1), MAX_ITERATIONS);
+		}
+	}
+
+	bool writeReport(const string &path, const string &executable, const vector<BenchmarkResult> &results)
+	{
+		ofstream data(path);
+		if(!data.is_open())
+			return false;
+
+		time_t now = time(nullptr);
+
+		data << "{\n";
+		data << "\t\"context\": {\n";
+		data << "\t\t\"date\": \"" << put_time(localtime(&now), "%Y-%m-%dT%H:%M:%S") << "\",\n";
+		data << "\t\t\"executable\": \"" << escapeJsonString(executable) << "\",\n";
+		data << "\t\t\"num_cpus\": " << thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+		data << "\t\t\"library_build_type\": \"release\"\n";
+#else
+		data << "\t\t\"library_build_type\": \"debug\"\n";
+#endif
+		data << "\t},\n";
+
+		data << "\t\"benchmarks\": [\n";
+		data << fixed << setprecision(3);
+		for(size_t i = 0; i < results.size(); i++)
+		{
+			const BenchmarkResult &current = results[i];
+
+			data << "\t\t{\n";
+			data << "\t\t\t\"name\": \"" << escapeJsonString(current.name) << "\",\n";
+			data << "\t\t\t\"run_name\": \"" << escapeJsonString(current.name) << "\",\n";
+			data << "\t\t\t\"run_type\": \"iteration\",\n";
+			data << "\t\t\t\"iterations\": " << current.iterations << ",\n";
+			data << "\t\t\t\"real_time\": " << current.realTime << ",\n";
+			data << "\t\t\t\"cpu_time\": " << current.cpuTime << ",\n";
+			data << "\t\t\t\"time_unit\": \"ns\"";
+			if(current.itemsPerSecond > 0.)
+				data << ",\n\t\t\t\"items_per_second\": " << current.itemsPerSecond;
+			data << "\n\t\t}" << ((i + 1 < results.size()) ? ",\n" : "\n");
+		}
+		data << "\t]\n";
+		data << "}\n";
+
+		return static_cast<bool>(data);
+	}
+}
@@ -0,0 +1,111 @@
+/* micro_benchmark.h
+ * Small harness for CPU micro-benchmarks in the manner of Google Benchmark: fixtures, calibrated iteration amount, JSON report
+ *
+ * Author: Artem Hiblov
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+
+namespace renderer::benchmarks
+{
+
+/*
+@brief Keeps compiler from throwing away computation whose result isn't used
+*/
+template<typename T>
+inline void doNotOptimize(const T &value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/*
+Benchmark body is written as
+
+	//Preparation, not measured
+	while(state.keepRunning())
+	{
+		//Measured code
+	}
+
+Timing starts on the first keepRunning() call and stops after the last iteration.
+*/
+class BenchmarkState
+{
+public:
+	explicit BenchmarkState(int64_t iterationAmount);
+
+	bool keepRunning();
+
+	/*
+	@brief Excludes preparation inside the loop from measured time
+	*/
+	void pauseTiming();
+	void resumeTiming();
+
+	/*
+	@brief Sets amount of items (bytes, queries, instances) processed by the whole run. Reported per second
+	*/
+	void setItemsProcessed(int64_t amount);
+
+	int64_t getIterations() const;
+	double getRealTime() const; //Seconds
+	double getCpuTime() const; //Seconds
+	int64_t getItemsProcessed() const;
+
+private:
+	void startTimer();
+	void stopTimer();
+
+
+
+	const int64_t iterations;
+	int64_t remainingIterations;
+
+	bool isStarted;
+	bool isTiming;
+
+	std::chrono::steady_clock::time_point realStart;
+	std::clock_t cpuStart; //Process time on Linux, wall time on Windows
+	double realTime;
+	double cpuTime;
+
+	int64_t itemsProcessed;
+};
+
+/*
+Data shared by benchmarks. Prepared once before every benchmark that uses it and released after
+*/
+class Fixture
+{
+public:
+	virtual ~Fixture();
+
+	/*
+	@return false if data can't be prepared, benchmark is skipped then
+	*/
+	virtual bool setUp();
+	virtual void tearDown();
+};
+
+typedef std::function<void(BenchmarkState&)> BenchmarkFunction;
+
+/*
+@brief Adds benchmark to run list
+@param[in] fixture - can be nullptr. Non-owning pointer, must live until benchmarks are run
+*/
+void registerBenchmark(const std::string &name, Fixture *fixture, BenchmarkFunction function);
+
+/*
+@brief Runs every registered benchmark until it takes minimal time, prints results and writes them in Google Benchmark JSON format
+@param[in] filter - substring of benchmark name. Empty for all benchmarks
+@param[in] executable - for report context
+*/
+bool runBenchmarks(const std::string &filter, const std::string &reportPath, const std::string &executable);
+
+}
@@ -0,0 +1,349 @@
+/* main.cpp
+ * Scene generator entry point. Writes a synthetic scene of given size for scaling tests and adds its chunks to terrain description
+ * Must be started from the renderer working directory, so object libraries and terrain description are found the same way
+ *
+ * Author: Artem Hiblov
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "log.h"
+#include "data/heightmap.h"
+#include "data/mesh.h"
+#include "data/object_file_paths.h"
+#include "data/scene.h"
+#include "data/terrain_file_paths.h"
+#include "loaders/mesh_loader.h"
+#include "loaders/terrain_loader.h"
+#include "utils/editor_tools.h"
+
+using namespace std;
+using namespace renderer;
+using namespace renderer::data;
+using namespace renderer::loaders;
+using namespace renderer::utils;
+
+namespace
+{
+	const char *OBJECT_DESCRIPTION_PATH = "objects/object-description";
+	const char *LIBRARIES_PATH = "objects/libraries";
+	const char *TERRAIN_DESCRIPTION_PATH = "terrain/terrain-description";
+
+	const char *ARGUMENT_CHUNKS = "chunks";
+	const char *ARGUMENT_INSTANCES = "instances";
+	const char *ARGUMENT_PARTICLES = "particles";
+	const char *ARGUMENT_RENDERER = "renderer";
+	const char *ARGUMENT_FOG = "fog";
+	const char *ARGUMENT_POST_EFFECT = "post-effect";
+	const char *ARGUMENT_SEED = "seed";
+	const char *ARGUMENT_TEMPLATE_CHUNK = "template-chunk";
+	const char *ARGUMENT_PARTICLE_OBJECT = "particle-object";
+
+	const char *SYNTHETIC_CHUNK_PREFIX = "synthetic-"; //Chunks of the previous run are replaced
+	const char *FEATURE_BASIC = "--";
+	const char *FEATURE_INSTANCING = "instancing";
+	const char *DIRECTIONAL_LIGHT_STRING = "directional";
+
+	constexpr float LIGHT_DIRECTION_X = -0.5f;
+	constexpr float LIGHT_DIRECTION_Y = -1.f;
+	constexpr float LIGHT_DIRECTION_Z = -0.3f;
+	constexpr int FOG_COLOUR = 200; //Light grey
+
+	constexpr float CAMERA_HEIGHT = 3.f; //Above terrain
+	constexpr float CAMERA_VERTICAL_ROTATION = -10.f * 3.14159f / 180.f;
+
+	constexpr float MAX_ROTATION = 360.f; //Degrees
+	constexpr float PARTICLE_MIN_RADIUS = 2.f;
+	constexpr float PARTICLE_MAX_RADIUS = 6.f;
+	constexpr float PARTICLE_MIN_DENSITY = 0.25f;
+	constexpr float PARTICLE_MAX_DENSITY = 1.f;
+
+	constexpr int RANDOM_SHIFT = 8; //32-bit generator output to 24 bits
+	constexpr double RANDOM_RANGE = 16777216.; //2^24
+
+	struct GeneratorParameters
+	{
+		string scenePath;
+		int chunksPerSide = 4;
+		int instancesPerChunk = 50;
+		int particleGroupsPerChunk = 2;
+		string rendererType = "forward";
+		bool isFogEnabled = false;
+		string postprocessingEffect = FEATURE_BASIC;
+		uint32_t seed = 1; //The same seed gives the same scene
+		string templateChunk; //Terrain of all chunks. Empty for the first chunk of description
+		string particleObject = "grass";
+	};
+
+
+
+	/*
+	@brief Reads generator parameters. Scene path is the first argument, the rest are name-value pairs
+	*/
+	bool parseArguments(int argc, const char **argv, GeneratorParameters &parameters);
+
+	/*
+	@brief Collects object names from object description and all libraries
+	*/
+	void collectObjectNames(vector<string> &names);
+
+	/*
+	@brief Returns value in [from; to). Distributions of <random> differ between standard libraries, raw output of mt19937 doesn't
+	*/
+	float getRandomValue(mt19937 &generator, float from, float to);
+
+	/*
+	@brief Interpolates height between heightmap vertices
+	@param[in] x, z - distance from chunk origin along X and along negative Z
+	*/
+	float sampleHeight(const Heightmap &heightmap, float x, float z);
+}
+
+int main(int argc, const char **argv)
+{
+	GeneratorParameters parameters;
+	if(!parseArguments(argc, argv, parameters))
+	{
+		Log::getInstance().error("Usage: scene-generator <scene path> [chunks <per side>] [instances <per chunk>] [particles <groups per chunk>] [renderer <type>] "
+			"[fog] [post-effect <effect>] [seed <value>] [template-chunk <name>] [particle-object <name>]");
+		return 1;
+	}
+
+	//Terrain
+
+	map<string, TerrainFilePaths> terrainDescription;
+	if(!loadTerrainDescription(TERRAIN_DESCRIPTION_PATH, terrainDescription))
+		return 1;
+
+	for(auto iter = terrainDescription.begin(); iter != terrainDescription.end();)
+	{
+		if(iter->first.compare(0, strlen(SYNTHETIC_CHUNK_PREFIX), SYNTHETIC_CHUNK_PREFIX) == 0)
+			iter = terrainDescription.erase(iter);
+		else iter++;
+	}
+
+	if(parameters.templateChunk.empty() && !terrainDescription.empty())
+		parameters.templateChunk = terrainDescription.begin()->first;
+
+	auto templateIter = terrainDescription.find(parameters.templateChunk);
+	if(templateIter == terrainDescription.end())
+	{
+		Log::getInstance().error(string("Can't find description of \"") + parameters.templateChunk + "\" chunk");
+		return 1;
+	}
+
+	const TerrainFilePaths templatePaths(templateIter->second.meshPath, templateIter->second.texturePath);
+
+	Mesh templateMesh;
+	Heightmap heightmap;
+	float sideLength = 0.f;
+	if(!loadTerrain(templatePaths.meshPath, nullptr, templateMesh, heightmap, sideLength))
+		return 1;
+
+	//Objects
+
+	vector<string> objectNames;
+	collectObjectNames(objectNames);
+	objectNames.erase(remove(objectNames.begin(), objectNames.end(), parameters.particleObject), objectNames.end());
+	if(objectNames.empty() && parameters.instancesPerChunk > 0)
+	{
+		Log::getInstance().error("Object libraries are empty");
+		return 1;
+	}
+
+	//Scene
+
+	mt19937 generator(parameters.seed);
+
+	const int chunkAmount = parameters.chunksPerSide * parameters.chunksPerSide;
+
+	Scene scene;
+	scene.rendererType = parameters.rendererType;
+	scene.fog.enable = parameters.isFogEnabled;
+	scene.fog.red = scene.fog.green = scene.fog.blue = FOG_COLOUR;
+	scene.postprocessingEffect = parameters.postprocessingEffect;
+	scene.terrainTexturing = FEATURE_BASIC;
+	scene.light = Light(DIRECTIONAL_LIGHT_STRING, LIGHT_DIRECTION_X, LIGHT_DIRECTION_Y, LIGHT_DIRECTION_Z);
+	scene.instances.resize(chunkAmount);
+	scene.particles.resize(chunkAmount);
+
+	for(int row = 0; row < parameters.chunksPerSide; row++)
+	{
+		for(int column = 0; column < parameters.chunksPerSide; column++)
+		{
+			const int index = row * parameters.chunksPerSide + column;
+
+			ChunkData chunk(string(SYNTHETIC_CHUNK_PREFIX) + to_string(row) + "-" + to_string(column), column * sideLength, -row * sideLength); //Chunk spreads to negative Z
+			terrainDescription[chunk.name] = TerrainFilePaths(templatePaths.meshPath, templatePaths.texturePath);
+
+			map<string, vector<float>> positions; //By object name, one instance group per object
+			for(int i = 0; i < parameters.instancesPerChunk; i++)
+			{
+				const string &name = objectNames[generator() % objectNames.size()];
+
+				float x = getRandomValue(generator, 0.f, sideLength);
+				float z = getRandomValue(generator, 0.f, sideLength);
+				float rotation = getRandomValue(generator, 0.f, MAX_ROTATION);
+
+				vector<float> &groupPositions = positions[name];
+				groupPositions.push_back(chunk.x + x);
+				groupPositions.push_back(sampleHeight(heightmap, x, z));
+				groupPositions.push_back(chunk.z - z);
+				groupPositions.push_back(rotation);
+			}
+
+			for(auto &[name, groupPositions]: positions)
+				scene.instances[index].push_back(InstanceArray(name, FEATURE_BASIC, move(groupPositions)));
+
+			for(int i = 0; i < parameters.particleGroupsPerChunk; i++)
+			{
+				float radius = getRandomValue(generator, PARTICLE_MIN_RADIUS, min(PARTICLE_MAX_RADIUS, sideLength / 2.f));
+				float x = getRandomValue(generator, radius, sideLength - radius); //Whole area is inside the chunk
+				float z = getRandomValue(generator, radius, sideLength - radius);
+				float density = getRandomValue(generator, PARTICLE_MIN_DENSITY, PARTICLE_MAX_DENSITY);
+
+				scene.particles[index].push_back(ParticleSet(parameters.particleObject, FEATURE_INSTANCING, chunk.x + x, chunk.z - z, radius, density));
+			}
+
+			scene.chunks.push_back(move(chunk));
+		}
+	}
+
+	//Camera looks along the grid from its middle
+	const float gridCenter = parameters.chunksPerSide * sideLength / 2.f;
+	const float cameraHeight = sampleHeight(heightmap, fmod(gridCenter, sideLength), fmod(gridCenter, sideLength)) + CAMERA_HEIGHT;
+	scene.camera = Camera(gridCenter, cameraHeight, -gridCenter, 0.f, CAMERA_VERTICAL_ROTATION);
+
+	if(!saveTerrainDescription(TERRAIN_DESCRIPTION_PATH, terrainDescription))
+		return 1;
+
+	saveScene(parameters.scenePath, scene);
+
+	Log::getInstance().info(string("Scene ") + parameters.scenePath + " is generated: " + to_string(chunkAmount) + " chunks, " +
+		to_string(chunkAmount * parameters.instancesPerChunk) + " instances, " + to_string(chunkAmount * parameters.particleGroupsPerChunk) + " particle groups");
+
+	return 0;
+}
+
+namespace
+{
+	bool parseArguments(int argc, const char **argv, GeneratorParameters &parameters)
+	{
+		if(argc < 2)
+			return false;
+
+		parameters.scenePath = argv[1];
+
+		for(int i = 2; i < argc; i++)
+		{
+			if(strcmp(argv[i], ARGUMENT_FOG) == 0)
+			{
+				parameters.isFogEnabled = true;
+				continue;
+			}
+
+			if(i + 1 >= argc)
+			{
+				Log::getInstance().error(string("No value is provided for \"") + argv[i] + "\"");
+				return false;
+			}
+
+			if(strcmp(argv[i], ARGUMENT_CHUNKS) == 0)
+				parameters.chunksPerSide = atoi(argv[i+1]);
+			else if(strcmp(argv[i], ARGUMENT_INSTANCES) == 0)
+				parameters.instancesPerChunk = atoi(argv[i+1]);
+			else if(strcmp(argv[i], ARGUMENT_PARTICLES) == 0)
+				parameters.particleGroupsPerChunk = atoi(argv[i+1]);
+			else if(strcmp(argv[i], ARGUMENT_RENDERER) == 0)
+				parameters.rendererType = argv[i+1];
+			else if(strcmp(argv[i], ARGUMENT_POST_EFFECT) == 0)
+				parameters.postprocessingEffect = argv[i+1];
+			else if(strcmp(argv[i], ARGUMENT_SEED) == 0)
+				parameters.seed = strtoul(argv[i+1], nullptr, 10);
+			else if(strcmp(argv[i], ARGUMENT_TEMPLATE_CHUNK) == 0)
+				parameters.templateChunk = argv[i+1];
+			else if(strcmp(argv[i], ARGUMENT_PARTICLE_OBJECT) == 0)
+				parameters.particleObject = argv[i+1];
+			else
+			{
+				Log::getInstance().error(string("Unknown parameter \"") + argv[i] + "\"");
+				return false;
+			}
+
+			i++;
+		}
+
+		if(parameters.chunksPerSide < 1 || parameters.instancesPerChunk < 0 || parameters.particleGroupsPerChunk < 0)
+		{
+			Log::getInstance().error("Amounts must not be negative, at least one chunk is needed");
+			return false;
+		}
+
+		return true;
+	}
+
+	void collectObjectNames(vector<string> &names)
+	{
+		map<string, ObjectFilePaths> description;
+		loadObjectDescription(OBJECT_DESCRIPTION_PATH, description);
+
+		ifstream data(LIBRARIES_PATH);
+		if(data.is_open())
+		{
+			int libraryAmount = 0;
+			data >> libraryAmount;
+
+			for(int i = 0; i < libraryAmount; i++)
+			{
+				string libraryPath;
+				data >> libraryPath;
+				loadObjectDescription(libraryPath, description);
+			}
+		}
+		else Log::getInstance().warning("Can't read list of libraries");
+
+		for(auto &[name, paths]: description) //Map is sorted, so the order doesn't depend on description files
+			names.push_back(name);
+	}
+
+	float getRandomValue(mt19937 &generator, float from, float to)
+	{
+		//24 bits fit float mantissa exactly. Rounding to float may still reach the bound, so result is kept below it
+		double unit = (generator() >> RANDOM_SHIFT) / RANDOM_RANGE;
+		float value = static_cast<float>(from + (to - from) * unit);
+
+		return min<>(value, nextafter(to, from));
+	}
+
+	float sampleHeight(const Heightmap &heightmap, float x, float z)
+	{
+		const int lastIndex = static_cast<int>(heightmap.heights.size()) - 1;
+		if(lastIndex < 1 || heightmap.gridStep <= 0.f)
+			return 0.f;
+
+		float column = clamp(x / heightmap.gridStep, 0.f, static_cast<float>(lastIndex));
+		float row = clamp(z / heightmap.gridStep, 0.f, static_cast<float>(lastIndex));
+
+		int columnIndex = min(static_cast<int>(column), lastIndex - 1);
+		int rowIndex = min(static_cast<int>(row), lastIndex - 1);
+		float columnFraction = column - columnIndex;
+		float rowFraction = row - rowIndex;
+
+		const vector<float> &nearRow = heightmap.heights[rowIndex];
+		const vector<float> &farRow = heightmap.heights[rowIndex + 1];
+
+		float nearHeight = nearRow[columnIndex] + (nearRow[columnIndex + 1] - nearRow[columnIndex]) * columnFraction;
+		float farHeight = farRow[columnIndex] + (farRow[columnIndex + 1] - farRow[columnIndex]) * columnFraction;
+
+		return nearHeight + (farHeight - nearHeight) * rowFraction;
+	}
+}